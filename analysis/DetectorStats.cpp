@@ -10,6 +10,9 @@
 #include <iostream>
 #include <fstream>
 #include <tuple>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include "TFile.h"
 #include "TDirectory.h"
 #include "TCanvas.h"
@@ -27,12 +30,15 @@
 ///@param sim_type "pct" or "its"
 ///@param sim_run_data_path Path to directory with simulation data.
 ///@param event_data Pointer to event data (time of events, number of hits/multiplicities)
+///@param num_threads Number of threads used to read the RU data files.
+///                   Zero uses one thread per hardware thread.
 DetectorStats::DetectorStats(Detector::DetectorConfigBase config,
                              std::map<std::string, double> sim_params,
                              unsigned long sim_time_ns,
                              std::string sim_type,
                              const char* sim_run_data_path,
-                             std::shared_ptr<EventData> event_data)
+                             std::shared_ptr<EventData> event_data,
+                             unsigned int num_threads)
   : mConfig(config)
   , mSimParams(sim_params)
   , mSimTimeNs(sim_time_ns)
@@ -55,6 +61,52 @@ DetectorStats::DetectorStats(Detector::DetectorConfigBase config,
       mNumLayers++;
     }
   }
+
+  readReadoutUnits(num_threads);
+}
+
+
+///@brief Read the data files for all RUs in all layers, using a pool of worker threads.
+///       Each worker takes the next RU that has not been read yet, until all RUs are done.
+///       ROOT is not thread safe, so the plotting is done afterwards in plotDetector().
+///@param num_threads Number of worker threads. Zero uses one thread per hardware thread.
+void DetectorStats::readReadoutUnits(unsigned int num_threads)
+{
+  std::vector<std::pair<ITSLayerStats*, unsigned int>> jobs;
+
+  for(auto layer_it = mLayerStats.begin(); layer_it != mLayerStats.end(); layer_it++) {
+    if(*layer_it != nullptr) {
+      for(unsigned int RU_num = 0; RU_num < (*layer_it)->getNumReadoutUnits(); RU_num++)
+        jobs.emplace_back(*layer_it, RU_num);
+    }
+  }
+
+  if(num_threads == 0)
+    num_threads = std::max(1U, std::thread::hardware_concurrency());
+
+  num_threads = std::min<std::size_t>(num_threads, jobs.size());
+
+  std::cout << "Reading data for " << jobs.size() << " RUs using ";
+  std::cout << num_threads << " threads" << std::endl;
+
+  std::atomic<std::size_t> next_job(0);
+  std::vector<std::thread> workers;
+
+  for(unsigned int i = 0; i < num_threads; i++) {
+    workers.emplace_back([&jobs, &next_job]() {
+        std::size_t job;
+        while((job = next_job++) < jobs.size())
+          jobs[job].first->readReadoutUnit(jobs[job].second);
+      });
+  }
+
+  for(auto it = workers.begin(); it != workers.end(); it++)
+    it->join();
+
+  for(auto layer_it = mLayerStats.begin(); layer_it != mLayerStats.end(); layer_it++) {
+    if(*layer_it != nullptr)
+      (*layer_it)->finishReadoutUnits();
+  }
 }
 
 
@@ -45,13 +45,16 @@ class DetectorStats {
 
   std::vector<double> mTrigReadoutExclFilteringCoverage;
 
+  void readReadoutUnits(unsigned int num_threads);
+
 public:
   DetectorStats(Detector::DetectorConfigBase config,
                 std::map<std::string, double> sim_params,
                 unsigned long sim_time_ns,
                 std::string sim_type,
                 const char* sim_run_data_path,
-                std::shared_ptr<EventData> event_data);
+                std::shared_ptr<EventData> event_data,
+                unsigned int num_threads = 0);
 
   void plotDetector(bool create_png, bool create_pdf);
 };
@@ -53,11 +53,32 @@ ITSLayerStats::ITSLayerStats(unsigned int layer_num, unsigned int num_staves,
     exit(-1);
   }
 
-  // Create and parse RU data
+  // Create RU objects, the data files are read by readReadoutUnit()
+  mRUStats.reserve(mNumReadoutUnits);
   for(unsigned int RU_num = 0; RU_num < mNumReadoutUnits; RU_num++) {
     mRUStats.emplace_back(layer_num, RU_num, sim_time_ns, path, sim_type, event_data);
-    mProtocolRatesMbps.push_back(mRUStats.back().getProtocolRateMbps());
-    mDataRatesMbps.push_back(mRUStats.back().getDataRateMbps());
+  }
+}
+
+
+///@brief Read and parse the data files for one RU in this layer. Can be called
+///       in parallel for different RUs, in this or other layers.
+///@param RU_num Readout unit number
+void ITSLayerStats::readReadoutUnit(unsigned int RU_num)
+{
+  mRUStats[RU_num].readFiles();
+}
+
+
+///@brief Print the messages from reading each RU (in RU order), and gather the data
+///       and protocol rates for the layer. Call after readReadoutUnit() has been
+///       called for all RUs in the layer.
+void ITSLayerStats::finishReadoutUnits(void)
+{
+  for(auto it = mRUStats.begin(); it != mRUStats.end(); it++) {
+    std::cout << it->getReadLog();
+    mProtocolRatesMbps.push_back(it->getProtocolRateMbps());
+    mDataRatesMbps.push_back(it->getDataRateMbps());
   }
 }
 
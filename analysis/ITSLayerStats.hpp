@@ -91,6 +91,9 @@ public:
   ITSLayerStats(unsigned int layer_num, unsigned int num_staves,
                 unsigned long sim_time_ns, std::string sim_type,
                 const char* path, std::shared_ptr<EventData> event_data);
+  unsigned int getNumReadoutUnits(void) const {return mNumReadoutUnits;}
+  void readReadoutUnit(unsigned int RU_num);
+  void finishReadoutUnits(void);
   void plotLayer(bool create_png, bool create_pdf);
   double getTriggerCoverage(uint64_t trigger_id) const;
   uint64_t getNumTriggers(void) {return mNumTriggers;}
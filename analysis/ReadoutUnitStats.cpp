@@ -12,10 +12,12 @@
 #include "ReadoutUnitStats.hpp"
 #include "Detector/ITS/ITSDetectorConfig.hpp"
 #include "Detector/PCT/PCTDetectorConfig.hpp"
+#include "ReadoutUnit/RUEventLog.hpp"
 #include <sstream>
 #include <fstream>
 #include <iostream>
 #include <cstdlib>
+#include <cstring>
 #include <algorithm>
 
 #include "TCanvas.h"
@@ -32,6 +34,56 @@
 #include "misc.h"
 
 
+///@brief Open and read an RU event log file. Exits if the file can not be read.
+///@param filename Path and name of event log file
+///@param log_type Expected type of log
+///@param out Stream to write progress messages to
+///@return Pointer to RUEventLogReader object with the events from the file
+static std::unique_ptr<RUEventLogReader> openEventLog(const std::string& filename,
+                                                      RUEventLogType log_type,
+                                                      std::ostream& out)
+{
+  std::unique_ptr<RUEventLogReader> log;
+
+  out << "Opening file: " << filename << std::endl;
+
+  try {
+    log.reset(new RUEventLogReader(filename, log_type));
+  }
+  catch(std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    exit(-1);
+  }
+
+  if(log->getTruncated())
+    std::cerr << "Warning: " << filename << " ends with an incomplete chunk" << std::endl;
+
+  return log;
+}
+
+
+///@brief Get the trigger IDs of the busyv/flush/abort/fatal events for a data link,
+///       for all chips on the link, in ascending order.
+///@param log Event log with RUTriggerEventRecord records
+///@param link_id Data link ID
+///@return Vector with trigger IDs
+static std::vector<uint64_t> getTriggerEvents(const RUEventLogReader& log, uint32_t link_id)
+{
+  std::vector<uint64_t> trigger_ids(log.getNumRecords(link_id));
+
+  for(uint64_t i = 0; i < trigger_ids.size(); i++) {
+    RUTriggerEventRecord record;
+    std::memcpy(&record, log.getRecord(link_id, i), sizeof(record));
+    trigger_ids[i] = record.trigger_id;
+  }
+
+  // Events for different chips on a link are not necessarily logged in trigger order
+  std::sort(trigger_ids.begin(), trigger_ids.end());
+
+  return trigger_ids;
+}
+
+
 ///@brief Constructor for ITSLayerStats
 ///@param layer_num ITS Layer number
 ///@param num_staves Number of staves simulated in this layer
@@ -40,6 +92,7 @@
 ///@param path Path to simulation data directory
 ///@param sim_type "pct" or "its"
 ///@param event_data Pointer to event data (time of events, number of hits/multiplicities)
+///@note  The data files are not read until readFiles() is called.
 ReadoutUnitStats::ReadoutUnitStats(unsigned int layer, unsigned int stave,
                                    unsigned long sim_time_ns, const char* path,
                                    std::string sim_type, std::shared_ptr<EventData> event_data)
@@ -49,9 +102,18 @@ ReadoutUnitStats::ReadoutUnitStats(unsigned int layer, unsigned int stave,
   , mSimDataPath(path)
   , mSimType(sim_type)
   , mEventData(event_data)
+{
+}
+
+
+///@brief Read and parse the RU's data files. This does not use ROOT, and only accesses
+///       this object, so readFiles() can be called for different ReadoutUnitStats objects
+///       in parallel. Progress messages are buffered, and can be retrieved afterwards
+///       with getReadLog().
+void ReadoutUnitStats::readFiles(void)
 {
   std::stringstream ss_file_path_base;
-  ss_file_path_base << path << "/" << "RU_" << layer << "_" << stave;
+  ss_file_path_base << mSimDataPath << "/" << "RU_" << mLayer << "_" << mStave;
 
   readTrigActionsFile(ss_file_path_base.str());
   readBusyEventFiles(ss_file_path_base.str());
@@ -61,13 +123,87 @@ ReadoutUnitStats::ReadoutUnitStats(unsigned int layer, unsigned int stave,
 }
 
 
+///@brief Read the trigger actions file for the RU, and calculate trigger sent coverage.
+///       The trigger actions are kept as runs of consecutive triggers with identical
+///       actions, and are never expanded to per-trigger vectors.
+///       Supports the run-length encoded event log format written by the simulation,
+///       the uncompressed event log format, and the format used before the event logs.
+///@param file_path_base Path to simulation run data directory
 void ReadoutUnitStats::readTrigActionsFile(std::string file_path_base)
 {
   std::stringstream ss_filename;
   ss_filename  << file_path_base << "_trigger_actions.dat";
   std::string filename = ss_filename.str();
 
-  std::cout << "Opening file: " << filename << std::endl;
+  RUEventLogFileHeader header;
+  uint64_t unknown_trig_action_count = 0;
+
+  mNumTriggers = 0;
+
+  if(readRUEventLogFileHeader(filename, header) == false) {
+    unknown_trig_action_count = readLegacyTrigActionsFile(filename);
+  } else if(header.log_type == RU_LOG_TRIGGER_ACTIONS_RLE) {
+    std::unique_ptr<RUEventLogReader> trig_actions_log =
+      openEventLog(filename, RU_LOG_TRIGGER_ACTIONS_RLE, mLog);
+    mNumCtrlLinks = trig_actions_log->getNumLinks();
+
+    if(trig_actions_log->getRecordSize() != sizeof(RUTriggerActionRunHeader) + mNumCtrlLinks) {
+      std::cerr << "Error: unexpected record size in " << filename << std::endl;
+      exit(-1);
+    }
+
+    for(uint64_t i = 0; i < trig_actions_log->getNumRecords(0); i++) {
+      const char* record = trig_actions_log->getRecord(0, i);
+      RUTriggerActionRunHeader run_header;
+
+      std::memcpy(&run_header, record, sizeof(run_header));
+
+      unknown_trig_action_count +=
+        addTriggerActionRun(reinterpret_cast<const uint8_t*>(record + sizeof(run_header)),
+                            run_header.num_triggers);
+    }
+  } else {
+    std::unique_ptr<RUEventLogReader> trig_actions_log =
+      openEventLog(filename, RU_LOG_TRIGGER_ACTIONS, mLog);
+    mNumCtrlLinks = trig_actions_log->getNumLinks();
+
+    for(uint64_t i = 0; i < trig_actions_log->getNumRecords(0); i++) {
+      const char* record = trig_actions_log->getRecord(0, i);
+      unknown_trig_action_count +=
+        addTriggerActionRun(reinterpret_cast<const uint8_t*>(record), 1);
+    }
+  }
+
+  mTrigSentMeanCoverage /= mNumTriggers;
+  mTrigSentExclFilteringMeanCoverage /= mNumTriggers;
+
+  mLog << "Num triggers: " << mNumTriggers << std::endl;
+  mLog << "Num links: " << mNumCtrlLinks << std::endl;
+  mLog << "Num trigger action runs: " << mTriggerActionRuns.size() << std::endl;
+
+  mLog << "Number of unknown trigger actions: " << unknown_trig_action_count << std::endl;
+
+  mLog << "Links with filter mismatch: ";
+  for(auto it = mTriggerMismatch.begin(); it != mTriggerMismatch.end(); it++) {
+    if(it == mTriggerMismatch.begin())
+       mLog << *it;
+    else
+      mLog << ", " << *it;
+  }
+  mLog << std::endl;
+}
+
+
+///@brief Read trigger actions file in the format used before the event logs were introduced
+///       File format:
+///         uint64_t: number of triggers
+///         uint8_t:  number of control links
+///         For each trigger ID, one uint8_t link action per control link
+///@param filename Path and name of trigger actions file
+///@return Number of unknown trigger actions in file
+uint64_t ReadoutUnitStats::readLegacyTrigActionsFile(std::string filename)
+{
+  mLog << "Opening file: " << filename << std::endl;
   std::ifstream ru_stats_file(filename.c_str(), std::ios_base::in | std::ios_base::binary);
 
   if(!ru_stats_file.is_open()) {
@@ -75,108 +211,140 @@ void ReadoutUnitStats::readTrigActionsFile(std::string file_path_base)
     exit(-1);
   }
 
-  uint64_t num_triggers;
-  uint8_t num_ctrl_links;
-
-  std::cout << "sizeof(uint8_t): " << sizeof(uint8_t) << std::endl;
+  uint64_t num_triggers = 0;
+  uint8_t num_ctrl_links = 0;
+  uint64_t unknown_trig_action_count = 0;
 
   ru_stats_file.read((char*)&num_triggers, sizeof(num_triggers));
   ru_stats_file.read((char*)&num_ctrl_links, sizeof(num_ctrl_links));
 
-  mNumTriggers = num_triggers;
   mNumCtrlLinks = num_ctrl_links;
 
-  std::cout << "Num triggers: " << num_triggers << std::endl;
-  std::cout << "Num links: " << mNumCtrlLinks << std::endl;
+  std::vector<uint8_t> trig_actions(num_ctrl_links);
+
+  for(uint64_t trigger_id = 0; trigger_id < num_triggers; trigger_id++) {
+    if(!ru_stats_file.read((char*)trig_actions.data(), num_ctrl_links)) {
+      std::cerr << "Error reading " << num_triggers << ", got only " << trigger_id << std::endl;
+      exit(-1);
+    }
 
-  mTrigSentCoverage.resize(num_triggers);
-  mTrigSentExclFilteringCoverage.resize(num_triggers);
-  mTriggerActions.resize(num_triggers);
+    unknown_trig_action_count += addTriggerActionRun(trig_actions.data(), 1);
+  }
+
+  return unknown_trig_action_count;
+}
 
-  uint64_t trigger_id = 0;
-  uint8_t trig_action = 0;
+
+///@brief Add a run of consecutive triggers with identical trigger actions. The run is merged
+///       with the previous run if they have the same actions. Trigger sent coverage is
+///       calculated once for the whole run.
+///@param trig_actions Trigger action for each control link (mNumCtrlLinks entries)
+///@param num_triggers Number of triggers in run
+///@return Number of unknown trigger actions in the run
+uint64_t ReadoutUnitStats::addTriggerActionRun(const uint8_t* trig_actions, uint64_t num_triggers)
+{
+  uint64_t first_trigger_id = mNumTriggers;
+  uint8_t coverage = 0;
+  uint8_t links_filtered = 0;
   uint64_t unknown_trig_action_count = 0;
 
-  // Read trigger action byte, one per link, for each trigger ID,
-  // and calculate coverage etc.
-  while(trigger_id < num_triggers && ru_stats_file.good()) {
-    uint8_t coverage = 0;
-    uint8_t links_filtered = 0;
-
-    for(unsigned int link_id = 0; link_id < num_ctrl_links; link_id++) {
-      ru_stats_file.read((char*)&trig_action, sizeof(uint8_t));
-      //mTriggerActions[trigger_id][link_id] = trig_action;
-      mTriggerActions[trigger_id].push_back(trig_action);
-
-      std::cout << "Trigger " << trigger_id;
-      std::cout << ": RU" << mLayer << "." << mStave << ": ";
-
-      switch(trig_action) {
-      case TRIGGER_SENT:
-        std::cout << "TRIGGER_SENT" << std::endl;
-        coverage++;
-        //links_included++;
-        break;
+  if(num_triggers == 0)
+    return 0;
 
-      case TRIGGER_NOT_SENT_BUSY:
-        std::cout << "TRIGGER_NOT_SENT_BUSY" << std::endl;
-        //links_included++;
-        break;
+  mNumTriggers += num_triggers;
 
-      case TRIGGER_FILTERED:
-        std::cout << "TRIGGER_FILTERED" << std::endl;
-        links_filtered++;
-        break;
-      default:
-        // This should never happen
-        std::cout << "UNKNOWN" << std::endl;
-        unknown_trig_action_count++;
-        break;
-      }
+  if(!mTriggerActionRuns.empty() &&
+     std::equal(trig_actions, trig_actions+mNumCtrlLinks,
+                mTriggerActionRuns.back().mTrigActions.begin()))
+  {
+    TriggerActionRun& run = mTriggerActionRuns.back();
+
+    run.mNumTriggers += num_triggers;
+    mTrigSentMeanCoverage += run.mTrigSentCoverage*num_triggers;
+    mTrigSentExclFilteringMeanCoverage += run.mTrigSentExclFilteringCoverage*num_triggers;
+
+    if(run.mFilterMismatch) {
+      for(uint64_t i = 0; i < num_triggers; i++)
+        mTriggerMismatch.push_back(first_trigger_id+i);
     }
 
-    mTrigSentCoverage[trigger_id] = (double)coverage/num_ctrl_links;
-    mTrigSentExclFilteringCoverage[trigger_id] = (double)(coverage+links_filtered)/num_ctrl_links;
+    return run.mUnknownTrigActions*num_triggers;
+  }
 
-    mTrigSentMeanCoverage += mTrigSentCoverage[trigger_id];
-    mTrigSentExclFilteringMeanCoverage += mTrigSentExclFilteringCoverage[trigger_id];
+  mLog << "Triggers " << first_trigger_id << " to " << mNumTriggers-1;
+  mLog << ": RU" << mLayer << "." << mStave << ": ";
+
+  for(unsigned int link_id = 0; link_id < mNumCtrlLinks; link_id++) {
+    switch(trig_actions[link_id]) {
+    case TRIGGER_SENT:
+      mLog << "TRIGGER_SENT ";
+      coverage++;
+      break;
+
+    case TRIGGER_NOT_SENT_BUSY:
+      mLog << "TRIGGER_NOT_SENT_BUSY ";
+      break;
+
+    case TRIGGER_FILTERED:
+      mLog << "TRIGGER_FILTERED ";
+      links_filtered++;
+      break;
+
+    default:
+      // This should never happen
+      mLog << "UNKNOWN ";
+      unknown_trig_action_count++;
+      break;
+    }
+  }
+  mLog << std::endl;
+
+  TriggerActionRun run;
 
-    std::cout << "Trigger " << trigger_id << std::endl;
-    std::cout << "Coverage: " << mTrigSentCoverage[trigger_id] << std::endl;
-    std::cout << "Coverage excluding filtered triggers: "<< mTrigSentExclFilteringCoverage[trigger_id] << std::endl;
+  run.mFirstTriggerId = first_trigger_id;
+  run.mNumTriggers = num_triggers;
+  run.mTrigActions.assign(trig_actions, trig_actions+mNumCtrlLinks);
+  run.mTrigSentCoverage = (double)coverage/mNumCtrlLinks;
+  run.mTrigSentExclFilteringCoverage = (double)(coverage+links_filtered)/mNumCtrlLinks;
+  run.mUnknownTrigActions = unknown_trig_action_count;
 
-    // Keep a record of those triggers that were filtered for some, but not all control links
-    if(links_filtered != 0 && links_filtered != num_ctrl_links)
-      mTriggerMismatch.push_back(trigger_id);
+  // Keep a record of those triggers that were filtered for some, but not all control links
+  run.mFilterMismatch = links_filtered != 0 && links_filtered != mNumCtrlLinks;
 
-    trigger_id++;
+  if(run.mFilterMismatch) {
+    for(uint64_t i = 0; i < num_triggers; i++)
+      mTriggerMismatch.push_back(first_trigger_id+i);
   }
 
-  mTrigSentMeanCoverage /= mNumTriggers;
-  mTrigSentExclFilteringMeanCoverage /= mNumTriggers;
+  mLog << "Coverage: " << run.mTrigSentCoverage << std::endl;
+  mLog << "Coverage excluding filtered triggers: ";
+  mLog << run.mTrigSentExclFilteringCoverage << std::endl;
 
-  if(trigger_id != num_triggers) {
-    std::cerr << "Error reading " << num_triggers << ", got only " << trigger_id << std::endl;
-    exit(-1);
-  }
+  mTrigSentMeanCoverage += run.mTrigSentCoverage*num_triggers;
+  mTrigSentExclFilteringMeanCoverage += run.mTrigSentExclFilteringCoverage*num_triggers;
 
-  std::cout << "Number of unknown trigger actions: " << unknown_trig_action_count << std::endl;
+  mTriggerActionRuns.push_back(run);
 
-  std::cout << "Links with filter mismatch: ";
-  for(auto it = mTriggerMismatch.begin(); it != mTriggerMismatch.end(); it++) {
-    if(it == mTriggerMismatch.begin())
-       std::cout << *it;
-    else
-      std::cout << ", " << *it;
-  }
-  std::cout << std::endl;
+  return unknown_trig_action_count*num_triggers;
+}
+
+
+///@brief Get the run of trigger actions that a trigger belongs to
+///@param trigger_id Trigger ID, must be less than mNumTriggers
+const TriggerActionRun& ReadoutUnitStats::getTriggerActionRun(uint64_t trigger_id) const
+{
+  auto it = std::upper_bound(mTriggerActionRuns.begin(), mTriggerActionRuns.end(), trigger_id,
+                             [](uint64_t id, const TriggerActionRun& run) {
+                               return id < run.mFirstTriggerId;
+                             });
+  return *(--it);
 }
 
 
 ///@brief Reads the RUs busy event files, and initializes LinkStats objects for each link
 ///       found with the various busy event data.
 ///       Expects readTrigActionsFile() to have been called first, because the
-///       mTrigSentCoverage vector needs to have been set up for some of the calculations here.
+///       mTriggerActionRuns vector needs to have been set up for some of the calculations here.
 ///@todo  Should have added a function for reading the busyv/flush/ro_abort/fatal
 ///       event files, since they all share the same format, but that required
 ///       some structural changes and I was too lazy to do it..
@@ -195,92 +363,47 @@ void ReadoutUnitStats::readBusyEventFiles(std::string file_path_base)
   ss_abort_events << file_path_base << "_ro_abort_events.dat";
   ss_fatal_events << file_path_base << "_fatal_events.dat";
 
-  std::string busy_events_filename = ss_busy_events.str();
-  std::string busyv_events_filename = ss_busyv_events.str();
-  std::string flush_events_filename = ss_flush_events.str();
-  std::string abort_events_filename = ss_abort_events.str();
-  std::string fatal_events_filename = ss_fatal_events.str();
-
-  std::cout << "Opening file: " << busy_events_filename << std::endl;
-  std::ifstream busy_file(busy_events_filename, std::ios_base::in | std::ios_base::binary);
-
-  if(!busy_file.is_open()) {
-    std::cerr << "Error opening file " << busy_events_filename << std::endl;
-    exit(-1);
-  }
-
-  std::cout << "Opening file: " << busyv_events_filename << std::endl;
-  std::ifstream busyv_file(busyv_events_filename, std::ios_base::in | std::ios_base::binary);
-
-  if(!busyv_file.is_open()) {
-    std::cerr << "Error opening file " << busyv_events_filename << std::endl;
-    exit(-1);
-  }
-
-  std::cout << "Opening file: " << flush_events_filename << std::endl;
-  std::ifstream flush_file(flush_events_filename, std::ios_base::in | std::ios_base::binary);
-
-  if(!flush_file.is_open()) {
-    std::cerr << "Error opening file " << flush_events_filename << std::endl;
-    exit(-1);
-  }
-
-  std::cout << "Opening file: " << abort_events_filename << std::endl;
-  std::ifstream abort_file(abort_events_filename, std::ios_base::in | std::ios_base::binary);
-
-  if(!abort_file.is_open()) {
-    std::cerr << "Error opening file " << abort_events_filename << std::endl;
-    exit(-1);
-  }
-
-  std::cout << "Opening file: " << fatal_events_filename << std::endl;
-  std::ifstream fatal_file(fatal_events_filename, std::ios_base::in | std::ios_base::binary);
-
-  if(!fatal_file.is_open()) {
-    std::cerr << "Error opening file " << fatal_events_filename << std::endl;
-    exit(-1);
-  }
-
-  uint8_t num_data_links_busy_file = 0;
-  uint8_t num_data_links_busyv_file = 0;
-  uint8_t num_data_links_flush_file = 0;
-  uint8_t num_data_links_abort_file = 0;
-  uint8_t num_data_links_fatal_file = 0;
-
-  busy_file.read((char*)&num_data_links_busy_file, sizeof(uint8_t));
-  busyv_file.read((char*)&num_data_links_busyv_file, sizeof(uint8_t));
-  flush_file.read((char*)&num_data_links_flush_file, sizeof(uint8_t));
-  abort_file.read((char*)&num_data_links_abort_file, sizeof(uint8_t));
-  fatal_file.read((char*)&num_data_links_fatal_file, sizeof(uint8_t));
-
-  if(num_data_links_busy_file != num_data_links_busyv_file ||
-     num_data_links_busy_file != num_data_links_flush_file ||
-     num_data_links_busy_file != num_data_links_abort_file ||
-     num_data_links_busy_file != num_data_links_fatal_file)
+  std::unique_ptr<RUEventLogReader> busy_log = openEventLog(ss_busy_events.str(),
+                                                            RU_LOG_BUSY_EVENTS, mLog);
+  std::unique_ptr<RUEventLogReader> busyv_log = openEventLog(ss_busyv_events.str(),
+                                                             RU_LOG_BUSYV_EVENTS, mLog);
+  std::unique_ptr<RUEventLogReader> flush_log = openEventLog(ss_flush_events.str(),
+                                                             RU_LOG_FLUSH_EVENTS, mLog);
+  std::unique_ptr<RUEventLogReader> abort_log = openEventLog(ss_abort_events.str(),
+                                                             RU_LOG_RO_ABORT_EVENTS, mLog);
+  std::unique_ptr<RUEventLogReader> fatal_log = openEventLog(ss_fatal_events.str(),
+                                                             RU_LOG_FATAL_EVENTS, mLog);
+
+  uint32_t num_data_links_busy_file = busy_log->getNumLinks();
+  uint32_t num_data_links_busyv_file = busyv_log->getNumLinks();
+
+  if(num_data_links_busy_file != busyv_log->getNumLinks() ||
+     num_data_links_busy_file != flush_log->getNumLinks() ||
+     num_data_links_busy_file != abort_log->getNumLinks() ||
+     num_data_links_busy_file != fatal_log->getNumLinks())
   {
     std::cerr << "Error: number of data links in busy/busyv/flush/abort/fatal ";
     std::cerr << "files does not match." << std::endl;
     exit(-1);
   }
 
-  std::cout << std::endl << std::endl;
-  std::cout << "Number of data links: ";
-  std::cout << int(num_data_links_busy_file);
-  std::cout << std::endl;
-  std::cout << "-------------------------------------------------" << std::endl;
+  mLog << std::endl << std::endl;
+  mLog << "Number of data links: ";
+  mLog << int(num_data_links_busy_file);
+  mLog << std::endl;
+  mLog << "-------------------------------------------------" << std::endl;
 
 
   // Iterate through data for each link
-  for(uint8_t link_count = 0; link_count < num_data_links_busy_file; link_count++) {
+  for(uint32_t link_count = 0; link_count < num_data_links_busy_file; link_count++) {
 
-    std::cout << "Data link " << int(link_count) << std::endl;
+    mLog << "Data link " << int(link_count) << std::endl;
 
     // Add a new LinkStats entry
     mLinkStats.emplace_back(mLayer, mStave, link_count);
 
     // Number of busy events for this link
-    uint64_t num_busy_events = 0;
-    busy_file.read((char*)&num_busy_events, sizeof(uint64_t));
+    uint64_t num_busy_events = busy_log->getNumRecords(link_count);
 
 
     //--------------------------------------------------------------------------
@@ -290,19 +413,20 @@ void ReadoutUnitStats::readBusyEventFiles(std::string file_path_base)
     // Iterate through busy events for this link
     for(uint64_t event_count = 0; event_count < num_busy_events; event_count++) {
       BusyTime busy_time;
-      uint64_t busy_on_trigger = 0;
-      uint64_t busy_off_trigger = 0;
+      RUBusyEventRecord busy_record;
 
-      busy_file.read((char*)&busy_time.mStartTimeNs, sizeof(uint64_t));
-      busy_file.read((char*)&busy_time.mEndTimeNs, sizeof(uint64_t));
+      std::memcpy(&busy_record, busy_log->getRecord(link_count, event_count), sizeof(busy_record));
+
+      busy_time.mStartTimeNs = busy_record.busy_on_time_ns;
+      busy_time.mEndTimeNs = busy_record.busy_off_time_ns;
 
       busy_time.mBusyTimeNs = busy_time.mEndTimeNs - busy_time.mStartTimeNs;
 
       // Keep track of busy time for all links, as well as for individual links (below)
       mAllBusyTime.push_back(busy_time.mBusyTimeNs);
 
-      busy_file.read((char*)&busy_on_trigger, sizeof(uint64_t));
-      busy_file.read((char*)&busy_off_trigger, sizeof(uint64_t));
+      uint64_t busy_on_trigger = busy_record.busy_on_trigger_id;
+      uint64_t busy_off_trigger = busy_record.busy_off_trigger_id;
 
       // Add entry with data about when the link went busy,
       // and when it went out of busy, for this busy event
@@ -322,13 +446,13 @@ void ReadoutUnitStats::readBusyEventFiles(std::string file_path_base)
       mLinkStats.back().mBusyTriggerLengths.push_back(1 + (busy_off_trigger-busy_on_trigger));
       mAllBusyTriggerLengths.push_back(1 + (busy_off_trigger-busy_on_trigger));
 
-      std::cout << "Busy event " << event_count << std::endl;
-      std::cout << "\tBusy on time: " << busy_time.mStartTimeNs << std::endl;
-      std::cout << "\tBusy off time: " << busy_time.mEndTimeNs << std::endl;
-      std::cout << "\tBusy time: " << busy_time.mBusyTimeNs << std::endl;
+      mLog << "Busy event " << event_count << std::endl;
+      mLog << "\tBusy on time: " << busy_time.mStartTimeNs << std::endl;
+      mLog << "\tBusy off time: " << busy_time.mEndTimeNs << std::endl;
+      mLog << "\tBusy time: " << busy_time.mBusyTimeNs << std::endl;
 
-      std::cout << "\tBusy on trigger: " << busy_on_trigger << std::endl;
-      std::cout << "\tBusy off trigger: " << busy_off_trigger << std::endl;
+      mLog << "\tBusy on trigger: " << busy_on_trigger << std::endl;
+      mLog << "\tBusy off trigger: " << busy_off_trigger << std::endl;
     }
 
 
@@ -337,10 +461,10 @@ void ReadoutUnitStats::readBusyEventFiles(std::string file_path_base)
     //--------------------------------------------------------------------------
 
     // Number of busy violation events for this link
-    uint64_t num_busyv_events = 0;
-    busyv_file.read((char*)&num_busyv_events, sizeof(uint64_t));
+    std::vector<uint64_t> busyv_trigger_ids = getTriggerEvents(*busyv_log, link_count);
+    uint64_t num_busyv_events = busyv_trigger_ids.size();
 
-    std::cout << "Number of busyv events: " << num_busyv_events << std::endl;
+    mLog << "Number of busyv events: " << num_busyv_events << std::endl;
 
     uint64_t busyv_sequence_count = 0;
 
@@ -350,9 +474,7 @@ void ReadoutUnitStats::readBusyEventFiles(std::string file_path_base)
 
     // Iterate through busy violation events for this link
     for(uint64_t event_count = 0; event_count < num_busyv_events; event_count++) {
-      uint64_t busyv_trigger_id = 0;
-
-      busyv_file.read((char*)&busyv_trigger_id, sizeof(uint64_t));
+      uint64_t busyv_trigger_id = busyv_trigger_ids[event_count];
 
       // Subtract one link per trigger id, for each busyv event
       mTrigReadoutCoverage[busyv_trigger_id]--;
@@ -382,8 +504,8 @@ void ReadoutUnitStats::readBusyEventFiles(std::string file_path_base)
 
       mLinkStats.back().mBusyVTriggers.push_back(busyv_trigger_id);
 
-      std::cout << "Busy violation event " << event_count << std::endl;
-      std::cout << "\tTrigger id: " << busyv_trigger_id << std::endl ;
+      mLog << "Busy violation event " << event_count << std::endl;
+      mLog << "\tTrigger id: " << busyv_trigger_id << std::endl ;
     }
 
     if(busyv_sequence_count > 0) {
@@ -398,19 +520,17 @@ void ReadoutUnitStats::readBusyEventFiles(std::string file_path_base)
     //--------------------------------------------------------------------------
 
     // Number of busy violation events for this link
-    uint64_t num_flush_events = 0;
-    flush_file.read((char*)&num_flush_events, sizeof(uint64_t));
+    std::vector<uint64_t> flush_trigger_ids = getTriggerEvents(*flush_log, link_count);
+    uint64_t num_flush_events = flush_trigger_ids.size();
 
-    std::cout << "Number of flushed incomplete events: ";
-    std::cout << num_flush_events << std::endl;
+    mLog << "Number of flushed incomplete events: ";
+    mLog << num_flush_events << std::endl;
 
     uint64_t flush_sequence_count = 0;
 
     // Iterate through flushed incomplete events for this link
     for(uint64_t event_count = 0; event_count < num_flush_events; event_count++) {
-      uint64_t flush_trigger_id = 0;
-
-      flush_file.read((char*)&flush_trigger_id, sizeof(uint64_t));
+      uint64_t flush_trigger_id = flush_trigger_ids[event_count];
 
       // Subtract one link per trigger id, for each flush event
       mTrigReadoutCoverage[flush_trigger_id]--;
@@ -440,8 +560,8 @@ void ReadoutUnitStats::readBusyEventFiles(std::string file_path_base)
 
       mLinkStats.back().mFlushTriggers.push_back(flush_trigger_id);
 
-      std::cout << "Flushed incomplete event " << event_count << std::endl;
-      std::cout << "\tTrigger id: " << flush_trigger_id << std::endl ;
+      mLog << "Flushed incomplete event " << event_count << std::endl;
+      mLog << "\tTrigger id: " << flush_trigger_id << std::endl ;
     }
 
 
@@ -450,19 +570,17 @@ void ReadoutUnitStats::readBusyEventFiles(std::string file_path_base)
     //--------------------------------------------------------------------------
 
     // Number of readout abort events for this link
-    uint64_t num_abort_events = 0;
-    abort_file.read((char*)&num_abort_events, sizeof(uint64_t));
+    std::vector<uint64_t> abort_trigger_ids = getTriggerEvents(*abort_log, link_count);
+    uint64_t num_abort_events = abort_trigger_ids.size();
 
-    std::cout << "Number of readout abort events: ";
-    std::cout << num_abort_events << std::endl;
+    mLog << "Number of readout abort events: ";
+    mLog << num_abort_events << std::endl;
 
     uint64_t abort_sequence_count = 0;
 
     // Iterate through flushed incomplete events for this link
     for(uint64_t event_count = 0; event_count < num_abort_events; event_count++) {
-      uint64_t abort_trigger_id = 0;
-
-      abort_file.read((char*)&abort_trigger_id, sizeof(uint64_t));
+      uint64_t abort_trigger_id = abort_trigger_ids[event_count];
 
       // Subtract one link per trigger id, for each readout abort event
       mTrigReadoutCoverage[abort_trigger_id]--;
@@ -492,8 +610,8 @@ void ReadoutUnitStats::readBusyEventFiles(std::string file_path_base)
 
       mLinkStats.back().mAbortTriggers.push_back(abort_trigger_id);
 
-      std::cout << "Readout abort event " << event_count << std::endl;
-      std::cout << "\tTrigger id: " << abort_trigger_id << std::endl ;
+      mLog << "Readout abort event " << event_count << std::endl;
+      mLog << "\tTrigger id: " << abort_trigger_id << std::endl ;
     }
 
 
@@ -502,19 +620,17 @@ void ReadoutUnitStats::readBusyEventFiles(std::string file_path_base)
     //--------------------------------------------------------------------------
 
     // Number of fatal events for this link
-    uint64_t num_fatal_events = 0;
-    fatal_file.read((char*)&num_fatal_events, sizeof(uint64_t));
+    std::vector<uint64_t> fatal_trigger_ids = getTriggerEvents(*fatal_log, link_count);
+    uint64_t num_fatal_events = fatal_trigger_ids.size();
 
-    std::cout << "Number of fatal events: ";
-    std::cout << num_fatal_events << std::endl;
+    mLog << "Number of fatal events: ";
+    mLog << num_fatal_events << std::endl;
 
     uint64_t fatal_sequence_count = 0;
 
     // Iterate through fatal events for this link
     for(uint64_t event_count = 0; event_count < num_fatal_events; event_count++) {
-      uint64_t fatal_trigger_id = 0;
-
-      fatal_file.read((char*)&fatal_trigger_id, sizeof(uint64_t));
+      uint64_t fatal_trigger_id = fatal_trigger_ids[event_count];
 
       // Subtract one link per trigger id, for each fatal event
       mTrigReadoutCoverage[fatal_trigger_id]--;
@@ -544,24 +660,28 @@ void ReadoutUnitStats::readBusyEventFiles(std::string file_path_base)
 
       mLinkStats.back().mFatalTriggers.push_back(fatal_trigger_id);
 
-      std::cout << "Fatal event " << event_count << std::endl;
-      std::cout << "\tTrigger id: " << fatal_trigger_id << std::endl ;
+      mLog << "Fatal event " << event_count << std::endl;
+      mLog << "\tTrigger id: " << fatal_trigger_id << std::endl ;
     }
   } // iterate through each data link
 
 
   // Finish calculation of readout trigger coverage
-  for(uint64_t trig_id = 0; trig_id < mNumTriggers; trig_id++) {
-    mTrigReadoutCoverage[trig_id] -= (1 - mTrigSentCoverage[trig_id]) * num_data_links_busyv_file;
-    mTrigReadoutCoverage[trig_id] /= num_data_links_busyv_file;
+  for(auto run = mTriggerActionRuns.begin(); run != mTriggerActionRuns.end(); run++) {
+    uint64_t end_trig_id = run->mFirstTriggerId + run->mNumTriggers;
+
+    for(uint64_t trig_id = run->mFirstTriggerId; trig_id < end_trig_id; trig_id++) {
+      mTrigReadoutCoverage[trig_id] -= (1 - run->mTrigSentCoverage) * num_data_links_busyv_file;
+      mTrigReadoutCoverage[trig_id] /= num_data_links_busyv_file;
 
-    mTrigReadoutExclFilteringCoverage[trig_id] -=
-      (1 - mTrigSentExclFilteringCoverage[trig_id]) * num_data_links_busyv_file;
+      mTrigReadoutExclFilteringCoverage[trig_id] -=
+        (1 - run->mTrigSentExclFilteringCoverage) * num_data_links_busyv_file;
 
-    mTrigReadoutExclFilteringCoverage[trig_id] /= num_data_links_busyv_file;
+      mTrigReadoutExclFilteringCoverage[trig_id] /= num_data_links_busyv_file;
 
-    mTrigReadoutMeanCoverage += mTrigReadoutCoverage[trig_id];
-    mTrigReadoutExclFilteringMeanCoverage += mTrigReadoutExclFilteringCoverage[trig_id];
+      mTrigReadoutMeanCoverage += mTrigReadoutCoverage[trig_id];
+      mTrigReadoutExclFilteringMeanCoverage += mTrigReadoutExclFilteringCoverage[trig_id];
+    }
   }
 
   mTrigReadoutMeanCoverage /= mNumTriggers;
@@ -575,8 +695,8 @@ void ReadoutUnitStats::readBusyEventFiles(std::string file_path_base)
 void ReadoutUnitStats::readProtocolUtilizationFile(std::string file_path_base)
 {
   if(mLinkStats.empty()) {
-    std::cout << "ReadoutUnitStats::readProtocolUtilizationFile(): called without";
-    std::cout << " initializing LinkStats objects first." << std::endl;
+    std::cerr << "ReadoutUnitStats::readProtocolUtilizationFile(): called without";
+    std::cerr << " initializing LinkStats objects first." << std::endl;
     exit(-1);
   }
 
@@ -589,7 +709,7 @@ void ReadoutUnitStats::readProtocolUtilizationFile(std::string file_path_base)
 
   std::string prot_util_filename = ss_prot_util.str();
 
-  std::cout << "Opening file: " << prot_util_filename << std::endl;
+  mLog << "Opening file: " << prot_util_filename << std::endl;
   std::ifstream prot_util_file(prot_util_filename, std::ios_base::in);
 
   if(!prot_util_file.is_open()) {
@@ -601,8 +721,8 @@ void ReadoutUnitStats::readProtocolUtilizationFile(std::string file_path_base)
   std::getline(prot_util_file, csv_header);
 
   if(csv_header.length() == 0) {
-    std::cout << "ReadoutUnitStats::readProtocolUtilizationFile(): ";
-    std::cout << "Error reading or empty CSV header read." << std::endl;
+    std::cerr << "ReadoutUnitStats::readProtocolUtilizationFile(): ";
+    std::cerr << "Error reading or empty CSV header read." << std::endl;
     exit(-1);
   }
 
@@ -613,7 +733,7 @@ void ReadoutUnitStats::readProtocolUtilizationFile(std::string file_path_base)
     mProtocolUtilization[header_field] = 0;
     mProtUtilIndex[index] = header_field;
 
-    std::cout << "Found field: " << header_field << std::endl;
+    mLog << "Found field: " << header_field << std::endl;
 
     // Remove the current field, accounting for both with
     // or without semicolon at the end
@@ -628,8 +748,8 @@ void ReadoutUnitStats::readProtocolUtilizationFile(std::string file_path_base)
 
   for(unsigned int link_count = 0; link_count < num_data_links; link_count++) {
     if(prot_util_file.good() == false) {
-      std::cout << "ReadoutUnitStats::readProtocolUtilizationFile(): CSV file not ";
-      std::cout << "good before " << num_data_links << "links have been read." << std::endl;
+      mLog << "ReadoutUnitStats::readProtocolUtilizationFile(): CSV file not ";
+      mLog << "good before " << num_data_links << "links have been read." << std::endl;
     }
 
     mLinkStats[link_count].mProtUtilIndex = mProtUtilIndex;
@@ -658,32 +778,32 @@ void ReadoutUnitStats::readProtocolUtilizationFile(std::string file_path_base)
     }
 
     if(index != mProtUtilIndex.size()) {
-      std::cout << "Incorrect number of fields on line " << link_count+1;
-      std::cout << " in file " << prot_util_filename << std::endl;
+      std::cerr << "Incorrect number of fields on line " << link_count+1;
+      std::cerr << " in file " << prot_util_filename << std::endl;
       exit(-1);
     }
   }
 
 
-  std::cout << std::endl << std::endl;
-  std::cout << "Printing link utilization stats - totals:" << std::endl;
-  std::cout << "-----------------------------------------" << std::endl;
+  mLog << std::endl << std::endl;
+  mLog << "Printing link utilization stats - totals:" << std::endl;
+  mLog << "-----------------------------------------" << std::endl;
 
   for(auto it = mProtUtilIndex.begin(); it != mProtUtilIndex.end(); it++) {
-    std::cout << it->second << ": " << mProtocolUtilization[it->second] << std::endl;
+    mLog << it->second << ": " << mProtocolUtilization[it->second] << std::endl;
   }
 
-  std::cout << std::endl << std::endl;
+  mLog << std::endl << std::endl;
 
   for(unsigned int link_count = 0; link_count < num_data_links; link_count++) {
-    std::cout << std::endl << std::endl;
-    std::cout << "Printing link utilization stats - link " << link_count << ":" << std::endl;
-    std::cout << "-----------------------------------------" << std::endl;
+    mLog << std::endl << std::endl;
+    mLog << "Printing link utilization stats - link " << link_count << ":" << std::endl;
+    mLog << "-----------------------------------------" << std::endl;
 
     for(auto it = mProtUtilIndex.begin(); it != mProtUtilIndex.end(); it++) {
-      std::cout << it->second << ": " << mLinkStats[link_count].mProtocolUtilization[it->second] << std::endl;
+      mLog << it->second << ": " << mLinkStats[link_count].mProtocolUtilization[it->second] << std::endl;
     }
-    std::cout << std::endl << std::endl;
+    mLog << std::endl << std::endl;
   }
 }
 
@@ -694,8 +814,8 @@ void ReadoutUnitStats::readProtocolUtilizationFile(std::string file_path_base)
 void ReadoutUnitStats::readDataRateFile(std::string file_path_base)
 {
   if(mLinkStats.empty()) {
-    std::cout << "ReadoutUnitStats::readDataRateFile(): called without";
-    std::cout << " initializing LinkStats objects first." << std::endl;
+    std::cerr << "ReadoutUnitStats::readDataRateFile(): called without";
+    std::cerr << " initializing LinkStats objects first." << std::endl;
     exit(-1);
   }
 
@@ -705,7 +825,7 @@ void ReadoutUnitStats::readDataRateFile(std::string file_path_base)
 
   std::string data_rate_filename = ss_data_rate.str();
 
-  std::cout << "Opening file: " << data_rate_filename << std::endl;
+  mLog << "Opening file: " << data_rate_filename << std::endl;
   std::ifstream data_rate_file(data_rate_filename, std::ios_base::in);
 
   if(!data_rate_file.is_open()) {
@@ -717,8 +837,8 @@ void ReadoutUnitStats::readDataRateFile(std::string file_path_base)
   std::getline(data_rate_file, csv_header);
 
   if(csv_header.length() == 0) {
-    std::cout << "ReadoutUnitStats::readDataRateFile(): ";
-    std::cout << "Error reading or empty CSV header read." << std::endl;
+    std::cerr << "ReadoutUnitStats::readDataRateFile(): ";
+    std::cerr << "Error reading or empty CSV header read." << std::endl;
     exit(-1);
   }
 
@@ -733,7 +853,7 @@ void ReadoutUnitStats::readDataRateFile(std::string file_path_base)
     // Index used to find correct field when reading in data later
     mDataRateIndex[index] = header_field;
 
-    std::cout << "Found field: " << header_field << std::endl;
+    mLog << "Found field: " << header_field << std::endl;
 
     // Remove the current field, accounting for both with
     // or without semicolon at the end
@@ -771,8 +891,8 @@ void ReadoutUnitStats::readDataRateFile(std::string file_path_base)
     }
 
     if(index != mDataRateIndex.size()) {
-      std::cout << "Incorrect number of fields on line " << line_num;
-      std::cout << " in file " << data_rate_filename << std::endl;
+      std::cerr << "Incorrect number of fields on line " << line_num;
+      std::cerr << " in file " << data_rate_filename << std::endl;
       exit(-1);
     }
   }
@@ -796,15 +916,15 @@ void ReadoutUnitStats::calcDataRates(void)
 
   double sim_time = mSimTimeNs/(1.0E9);
 
-  std::cout << "data_bytes: " << data_bytes << std::endl;
-  std::cout << "protocol_bytes: " << protocol_bytes << std::endl;
-  std::cout << "sim_time: " << sim_time << std::endl;
+  mLog << "data_bytes: " << data_bytes << std::endl;
+  mLog << "protocol_bytes: " << protocol_bytes << std::endl;
+  mLog << "sim_time: " << sim_time << std::endl;
 
   mDataRateMbps = 8*(data_bytes/sim_time)/(1E6);
   mProtocolRateMbps = 8*(protocol_bytes/sim_time)/(1E6);
 
-  std::cout << "mDataRateMbps: " << mDataRateMbps << std::endl;
-  std::cout << "mProtocolRateMbps: " << mProtocolRateMbps << std::endl;
+  mLog << "mDataRateMbps: " << mDataRateMbps << std::endl;
+  mLog << "mProtocolRateMbps: " << mProtocolRateMbps << std::endl;
 }
 
 
@@ -812,7 +932,7 @@ void ReadoutUnitStats::calcDataRates(void)
 ///       (Number of ctrl links the trigger was sent to) / Number of ctrl links
 double ReadoutUnitStats::getTrigSentCoverage(uint64_t trigger_id) const
 {
-  return mTrigSentCoverage[trigger_id];
+  return getTriggerActionRun(trigger_id).mTrigSentCoverage;
 }
 
 
@@ -822,7 +942,7 @@ double ReadoutUnitStats::getTrigSentCoverage(uint64_t trigger_id) const
 ///       ) / (Number of control links)
 double ReadoutUnitStats::getTrigSentExclFilteringCoverage(uint64_t trigger_id) const
 {
-  return mTrigSentExclFilteringCoverage[trigger_id];
+  return getTriggerActionRun(trigger_id).mTrigSentExclFilteringCoverage;
 }
 
 
@@ -1327,8 +1447,9 @@ void ReadoutUnitStats::plotRU(bool create_png, bool create_pdf)
                       Form("Alpide Trigger Control Link Efficiency - RU %i:%i", mLayer, mStave),
                       mNumTriggers,0,mNumTriggers);
 
-  for(uint64_t trig_id = 0; trig_id < mNumTriggers; trig_id++) {
-    h9->Fill(trig_id, mTrigSentCoverage[trig_id]);
+  for(auto run = mTriggerActionRuns.begin(); run != mTriggerActionRuns.end(); run++) {
+    for(uint64_t i = 0; i < run->mNumTriggers; i++)
+      h9->Fill(run->mFirstTriggerId+i, run->mTrigSentCoverage);
   }
 
   scale_eff_plot_y_range(h9);
@@ -1357,8 +1478,9 @@ void ReadoutUnitStats::plotRU(bool create_png, bool create_pdf)
                        Form("Alpide Trigger Control Link Efficiency Excluding Filtering - RU %i:%i", mLayer, mStave),
                        mNumTriggers,0,mNumTriggers);
 
-  for(uint64_t trig_id = 0; trig_id < mNumTriggers; trig_id++) {
-    h10->Fill(trig_id, mTrigSentExclFilteringCoverage[trig_id]);
+  for(auto run = mTriggerActionRuns.begin(); run != mTriggerActionRuns.end(); run++) {
+    for(uint64_t i = 0; i < run->mNumTriggers; i++)
+      h10->Fill(run->mFirstTriggerId+i, run->mTrigSentExclFilteringCoverage);
   }
 
   scale_eff_plot_y_range(h10);
@@ -17,6 +17,7 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <sstream>
 
 //using std::uint8_t;
 
@@ -42,6 +43,29 @@ static const uint8_t TRIGGER_FILTERED = 2;
 /* }; */
 
 
+///@brief A run of consecutive triggers that had the same actions on all control links
+struct TriggerActionRun {
+  uint64_t mFirstTriggerId;
+  uint64_t mNumTriggers;
+
+  // Index: ctrl_link_id
+  std::vector<uint8_t> mTrigActions;
+
+  // Ratio between number of links the triggers were sent to, and the total number of links.
+  double mTrigSentCoverage;
+
+  // Ratio between number of links the triggers were sent to,
+  // and the total number of links minus filtered links/triggers.
+  double mTrigSentExclFilteringCoverage;
+
+  // Number of unknown trigger actions per trigger
+  unsigned int mUnknownTrigActions;
+
+  // Triggers were filtered for some, but not all control links
+  bool mFilterMismatch;
+};
+
+
 class ReadoutUnitStats {
   std::vector<LinkStats> mLinkStats;
 
@@ -128,18 +152,9 @@ class ReadoutUnitStats {
   // Index in CSV file versus header field
   std::map<unsigned int, std::string> mDataRateIndex;
 
-  // Index: [trigger_id][ctrl_link_id]
-  std::vector<std::vector<uint8_t>> mTriggerActions;
-
-  // Index: trigger id
-  // For each trigger it has the ratio between number of links a
-  // trigger was sent to, and the total number of links.
-  std::vector<double> mTrigSentCoverage;
-
-  // Index: trigger id
-  // For each trigger it has the ratio between number of links a
-  // trigger was sent to, and the total number of links minus filtered links/triggers.
-  std::vector<double> mTrigSentExclFilteringCoverage;
+  // Trigger actions and trigger sent coverage, as runs of consecutive triggers
+  // with identical actions. Ordered by trigger id, and covers all triggers.
+  std::vector<TriggerActionRun> mTriggerActionRuns;
 
   std::vector<double> mTrigReadoutCoverage;
 
@@ -172,7 +187,13 @@ class ReadoutUnitStats {
 
   std::shared_ptr<EventData> mEventData;
 
+  // Progress messages from readFiles()
+  std::stringstream mLog;
+
   void readTrigActionsFile(std::string file_path_base);
+  uint64_t readLegacyTrigActionsFile(std::string filename);
+  uint64_t addTriggerActionRun(const uint8_t* trig_actions, uint64_t num_triggers);
+  const TriggerActionRun& getTriggerActionRun(uint64_t trigger_id) const;
   void readBusyEventFiles(std::string file_path_base);
   void readProtocolUtilizationFile(std::string file_path_base);
   void readDataRateFile(std::string file_path_base);
@@ -192,6 +213,10 @@ public:
   ReadoutUnitStats(unsigned int layer, unsigned int stave,
                    unsigned long sim_time_ns, const char* path,
                    std::string sim_type, std::shared_ptr<EventData> event_data);
+  void readFiles(void);
+  std::string getReadLog(void) const {
+    return mLog.str();
+  }
   double getTrigSentCoverage(uint64_t trigger_id) const;
   double getTrigSentExclFilteringCoverage(uint64_t trigger_id) const;
   double getTrigReadoutCoverage(uint64_t trigger_id) const;
@@ -1,20 +1,13 @@
 import struct
 import read_settings
+from read_ru_event_log import *
 from its_chip_position import *
 
-# File format for busy event file:
-#
-#   Header:
-#   uint8_t:  number of data links
-#
-#   For each data link:
-#       Header:
-#          uint64_t: Number of "busy events"
-#       Data (for each busy event)
-#          uint64_t: time of BUSY_ON
-#          uint64_t: time of BUSY_OFF
-#          uint64_t: trigger ID when BUSY_ON occured
-#          uint64_t: trigger ID when BUSY_OFF occured
+# Busy event file is an RU event log (see read_ru_event_log.py), with one record per busy event:
+#   uint64_t: time of BUSY_ON
+#   uint64_t: time of BUSY_OFF
+#   uint64_t: trigger ID when BUSY_ON occured
+#   uint64_t: trigger ID when BUSY_OFF occured
 def read_busy_event_file(filename: str):
     """Read a file with busy on/off events.
     Parameters:
@@ -24,37 +17,19 @@ def read_busy_event_file(filename: str):
     """
     event_data = list()
 
-    with open(filename, 'rb') as file:
-        file_data = file.read()
+    log_type, num_data_links, link_records = read_ru_event_log(filename, [RUEventLogType.BUSY_EVENTS])
 
-        num_data_links = int(file_data[0])
-        idx = 1
+    for data_link_id in range(0, num_data_links):
+        link_data = list()
 
-        for data_link_id in range(0, num_data_links):
-            link_data = list()
+        for busy_on_time_ns, busy_off_time_ns, busy_on_trig_id, busy_off_trig_id in \
+                struct.iter_unpack('QQQQ', link_records[data_link_id]):
+            link_data.append({'busy_on_time_ns': busy_on_time_ns,
+                              'busy_off_time_ns': busy_off_time_ns,
+                              'busy_on_trig_id': busy_on_trig_id,
+                              'busy_off_trig_id': busy_off_trig_id})
 
-            num_events = struct.unpack('Q', file_data[idx:idx+8])[0] # uint64_t
-            idx += 8
-
-            for event_num in range(0, num_events):
-                busy_on_time_ns = struct.unpack('Q', file_data[idx:idx+8])[0]  # uint64_t
-                idx += 8
-
-                busy_off_time_ns = struct.unpack('Q', file_data[idx:idx + 8])[0]  # uint64_t
-                idx += 8
-
-                busy_on_trig_id = struct.unpack('Q', file_data[idx:idx + 8])[0]  # uint64_t
-                idx += 8
-
-                busy_off_trig_id = struct.unpack('Q', file_data[idx:idx + 8])[0]  # uint64_t
-                idx += 8
-
-                link_data.append({'busy_on_time_ns': busy_on_time_ns,
-                                  'busy_off_time_ns': busy_off_time_ns,
-                                  'busy_on_trig_id': busy_on_trig_id,
-                                  'busy_off_trig_id': busy_off_trig_id})
-
-            event_data.append({'link_id': data_link_id, 'event_data': link_data})
+        event_data.append({'link_id': data_link_id, 'event_data': link_data})
 
     return event_data
 
@@ -88,20 +63,11 @@ def fix_position_and_chip_id(position: dict(), data_link_id: int, broken_chip_id
     return fixed_chip_id
 
 
-# File format for busyv/flush/abort/fatal event files:
-#
-#   Header:
-#   uint8_t:  number of data links
-#
-#   For each data link:
-#       uint8_t: Number of chips with data for this link
-#
-#       For each chip in data link which has data:
-#          Header:
-#             uint8_t:  Chip ID
-#             uint64_t: Number of "readout abort events"
-#          Data (for each trigger chip was in readout abort)
-#             uint64_t: trigger ID for readout abort event
+# Busyv/flush/abort/fatal event files are RU event logs (see read_ru_event_log.py),
+# with one record per event:
+#   uint64_t: trigger ID for the event
+#   uint32_t: chip ID
+#   uint32_t: reserved
 def read_busyv_event_file(filename: str, layer: int, stave: int):
     """Read a file with busy violation, flush incomplete, readout abort or fatal events. Same file format is used for all of those files.
     Parameters:
@@ -114,51 +80,39 @@ def read_busyv_event_file(filename: str, layer: int, stave: int):
     """
     event_data = list()
 
-    with open(filename, 'rb') as file:
-        file_data = file.read()
-
-        num_data_links = int(file_data[0])
-        idx = 1
-
-        for data_link_id in range(0, num_data_links):
-            link_data = list()
-
-            num_chips_with_data = int(file_data[idx])
-            idx += 1
-
-            print('num chips with data: ', num_chips_with_data)
-
-            for chip_num in range(0,num_chips_with_data):
-                chip_event_data = list()
+    log_type, num_data_links, link_records = read_ru_event_log(filename, [RUEventLogType.BUSYV_EVENTS,
+                                                                          RUEventLogType.FLUSH_EVENTS,
+                                                                          RUEventLogType.RO_ABORT_EVENTS,
+                                                                          RUEventLogType.FATAL_EVENTS])
 
-                chip_id = int(file_data[idx])
-                idx += 1
+    for data_link_id in range(0, num_data_links):
+        link_data = list()
 
-                sub_stave_and_module_id = data_link_id_to_sub_stave_and_module_id(data_link_id, layer)
-                position = {'layer_id': layer,
-                            'stave_id': stave,
-                            'sub_stave_id': sub_stave_and_module_id['sub_stave_id'],
-                            'module_id': sub_stave_and_module_id['module_id'],
-                            'module_chip_id': 0}
+        # Key: chip id, value: list of trigger ids
+        chip_events = dict()
 
-                # Due to a bug in the SystemC code, the chips send out the lower 4 bits of the
-                # global chip ID, instead of their local chip ID. This function repairs it
-                chip_id = fix_position_and_chip_id(position, data_link_id, chip_id)
+        for event_trig_num, chip_id, reserved in struct.iter_unpack('QII', link_records[data_link_id]):
+            chip_events.setdefault(chip_id, list()).append(event_trig_num)
 
-                global_chip_id = position_to_global_chip_id(position)
+        print('num chips with data: ', len(chip_events))
 
-                num_events = struct.unpack('Q', file_data[idx:idx+8])[0] # uint64_t
-                idx += 8
+        for chip_id in sorted(chip_events):
+            sub_stave_and_module_id = data_link_id_to_sub_stave_and_module_id(data_link_id, layer)
+            position = {'layer_id': layer,
+                        'stave_id': stave,
+                        'sub_stave_id': sub_stave_and_module_id['sub_stave_id'],
+                        'module_id': sub_stave_and_module_id['module_id'],
+                        'module_chip_id': 0}
 
-                for event_num in range(0, num_events):
-                    event_trig_num = struct.unpack('Q', file_data[idx:idx+8])[0]  # uint64_t
-                    idx += 8
+            # Due to a bug in the SystemC code, the chips send out the lower 4 bits of the
+            # global chip ID, instead of their local chip ID. This function repairs it
+            fix_position_and_chip_id(position, data_link_id, chip_id)
 
-                    chip_event_data.append(event_trig_num)
+            global_chip_id = position_to_global_chip_id(position)
 
-                link_data.append({'global_chip_id': global_chip_id, 'trig_id': chip_event_data})
+            link_data.append({'global_chip_id': global_chip_id, 'trig_id': sorted(chip_events[chip_id])})
 
-            event_data.append({'link_id': data_link_id, 'event_data': link_data})
+        event_data.append({'link_id': data_link_id, 'event_data': link_data})
 
     return event_data
 
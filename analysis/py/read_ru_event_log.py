@@ -0,0 +1,88 @@
+import struct
+from enum import IntEnum
+
+
+class RUEventLogType(IntEnum):
+    TRIGGER_ACTIONS = 0
+    BUSY_EVENTS = 1
+    BUSYV_EVENTS = 2
+    FLUSH_EVENTS = 3
+    RO_ABORT_EVENTS = 4
+    FATAL_EVENTS = 5
+    TRIGGER_ACTIONS_RLE = 6
+
+
+RU_EVENT_LOG_MAGIC = b'ALPRULOG'
+RU_EVENT_LOG_VERSION = 1
+RU_EVENT_LOG_CHUNK_MAGIC = 0x4B4E4843
+RU_EVENT_LOG_ALL_LINKS = 0xFFFFFFFF
+
+
+# File format for readout unit event logs (see src/ReadoutUnit/RUEventLog.hpp):
+#
+#   File header:
+#     char[8]:  magic, "ALPRULOG"
+#     uint32_t: version
+#     uint32_t: log type
+#     uint32_t: number of links (control links for trigger actions, data links for the others)
+#     uint32_t: record size in bytes
+#
+#   Chunks, until end of file:
+#     Chunk header:
+#       uint32_t: chunk magic, "CHNK"
+#       uint32_t: link ID (0xFFFFFFFF for trigger actions, where a record covers all links)
+#       uint32_t: number of records
+#       uint32_t: reserved
+#     Data:
+#       number of records * record size bytes
+#
+#   Records for a link are in the order they were logged. An incomplete chunk at the
+#   end of the file (from an aborted simulation) is ignored.
+def read_ru_event_log(filename: str, log_types: list):
+    """Read a readout unit event log file, and gather the records per link.
+    Parameters:
+        filename: full path of filename to read
+        log_types: list of expected log types
+    Return:
+        Tuple with log type, number of links, and a list with the record data (bytes) for
+        each link. The list only has one entry for the trigger actions logs.
+    """
+    with open(filename, 'rb') as file:
+        file_data = file.read()
+
+    if file_data[0:8] != RU_EVENT_LOG_MAGIC:
+        raise ValueError('Not an RU event log file: ' + filename)
+
+    version, file_log_type, num_links, record_size = struct.unpack('IIII', file_data[8:24])
+
+    if version != RU_EVENT_LOG_VERSION:
+        raise ValueError('Unsupported RU event log version in file: ' + filename)
+
+    if file_log_type not in log_types:
+        raise ValueError('Unexpected RU event log type in file: ' + filename)
+
+    per_link = file_log_type not in [RUEventLogType.TRIGGER_ACTIONS,
+                                     RUEventLogType.TRIGGER_ACTIONS_RLE]
+    link_data = [bytearray() for i in range(0, num_links if per_link else 1)]
+    idx = 24
+
+    while idx + 16 <= len(file_data):
+        chunk_magic, link_id, num_records, reserved = struct.unpack('IIII', file_data[idx:idx+16])
+        idx += 16
+
+        if chunk_magic != RU_EVENT_LOG_CHUNK_MAGIC:
+            raise ValueError('Corrupt chunk in RU event log file: ' + filename)
+
+        chunk_size = num_records * record_size
+
+        if idx + chunk_size > len(file_data):
+            print('Warning:', filename, 'ends with an incomplete chunk')
+            break
+
+        if link_id == RU_EVENT_LOG_ALL_LINKS:
+            link_id = 0
+
+        link_data[link_id] += file_data[idx:idx+chunk_size]
+        idx += chunk_size
+
+    return file_log_type, num_links, link_data
@@ -17,6 +17,20 @@ def read_settings(filename: str):
     # Convert values from strings to bool, int and floats
 
     cfg_dict['alpide']['chip_continuous_mode'] = True if cfg_dict['alpide']['chip_continuous_mode'].lower() == 'true' else False
+    if 'clock_skipping_enable' in cfg_dict['alpide']:
+        cfg_dict['alpide']['clock_skipping_enable'] = True if cfg_dict['alpide']['clock_skipping_enable'].lower() == 'true' else False
+    if 'frame_model_layers' in cfg_dict['alpide']:
+        frame_model_layers = cfg_dict['alpide']['frame_model_layers'].strip('"')
+        cfg_dict['alpide']['frame_model_layers'] = [int(layer) for layer in frame_model_layers.split(";")] if frame_model_layers else []
+    if 'frame_model_validation' in cfg_dict['alpide']:
+        cfg_dict['alpide']['frame_model_validation'] = True if cfg_dict['alpide']['frame_model_validation'].lower() == 'true' else False
+    if 'hybrid_model_layers' in cfg_dict['alpide']:
+        hybrid_model_layers = cfg_dict['alpide']['hybrid_model_layers'].strip('"')
+        cfg_dict['alpide']['hybrid_model_layers'] = [int(layer) for layer in hybrid_model_layers.split(";")] if hybrid_model_layers else []
+    if 'hybrid_meb_threshold' in cfg_dict['alpide']:
+        cfg_dict['alpide']['hybrid_meb_threshold'] = int(cfg_dict['alpide']['hybrid_meb_threshold'])
+    if 'hybrid_frame_fifo_threshold' in cfg_dict['alpide']:
+        cfg_dict['alpide']['hybrid_frame_fifo_threshold'] = int(cfg_dict['alpide']['hybrid_frame_fifo_threshold'])
     cfg_dict['alpide']['data_long_enable'] = True if cfg_dict['alpide']['data_long_enable'].lower() == 'true' else False
     cfg_dict['alpide']['matrix_readout_speed_fast'] = True if cfg_dict['alpide']['matrix_readout_speed_fast'].lower() == 'true' else False
     cfg_dict['alpide']['strobe_extension_enable'] = True if cfg_dict['alpide']['strobe_extension_enable'].lower() == 'true' else False
@@ -29,9 +43,13 @@ def read_settings(filename: str):
     cfg_dict['data_output']['write_vcd'] = True if cfg_dict['data_output']['write_vcd'].lower() == 'true' else False
     cfg_dict['data_output']['write_vcd_clock'] = True if cfg_dict['data_output']['write_vcd_clock'].lower() == 'true' else False
     cfg_dict['data_output']['data_rate_interval_ns'] = int(cfg_dict['data_output']['data_rate_interval_ns'])
+    if 'telemetry_interval_ns' in cfg_dict['data_output']:
+        cfg_dict['data_output']['telemetry_interval_ns'] = int(cfg_dict['data_output']['telemetry_interval_ns'])
 
     cfg_dict['event']['average_event_rate_ns'] = int(cfg_dict['event']['average_event_rate_ns'])
     cfg_dict['event']['monte_carlo_file_type'] = cfg_dict['event']['monte_carlo_file_type'].lower()
+    if 'monte_carlo_prefetch_depth' in cfg_dict['event']:
+        cfg_dict['event']['monte_carlo_prefetch_depth'] = int(cfg_dict['event']['monte_carlo_prefetch_depth'])
     cfg_dict['event']['qed_noise_input'] = True if cfg_dict['event']['qed_noise_input'].lower() == 'true' else False
     cfg_dict['event']['random_cluster_generation'] = True if cfg_dict['event']['random_cluster_generation'].lower() == 'true' else False
     cfg_dict['event']['random_hit_generation'] = True if cfg_dict['event']['random_hit_generation'].lower() == 'true' else False
@@ -77,6 +95,15 @@ def read_settings(filename: str):
 
     cfg_dict['simulation']['n_events'] = int(cfg_dict['simulation']['n_events'])
     cfg_dict['simulation']['random_seed'] = int(cfg_dict['simulation']['random_seed'])
+    if 'shard_count' in cfg_dict['simulation']:
+        cfg_dict['simulation']['shard_count'] = int(cfg_dict['simulation']['shard_count'])
+        cfg_dict['simulation']['shard_index'] = int(cfg_dict['simulation']['shard_index'])
+    if 'threads' in cfg_dict['simulation']:
+        cfg_dict['simulation']['threads'] = int(cfg_dict['simulation']['threads'])
+    if 'log_module_levels' in cfg_dict['simulation']:
+        cfg_dict['simulation']['log_module_levels'] = cfg_dict['simulation']['log_module_levels'].strip('"')
+    if 'log_progress_interval_ms' in cfg_dict['simulation']:
+        cfg_dict['simulation']['log_progress_interval_ms'] = int(cfg_dict['simulation']['log_progress_interval_ms'])
     cfg_dict['simulation']['single_chip'] = True if cfg_dict['simulation']['single_chip'].lower() == 'true' else False
     cfg_dict['simulation']['system_continuous_mode'] = True if cfg_dict['simulation']['system_continuous_mode'].lower() == 'true' else False
     cfg_dict['simulation']['system_continuous_period_ns'] = int(cfg_dict['simulation']['system_continuous_period_ns'])
@@ -1,6 +1,7 @@
 import struct
 from enum import IntEnum
 import pandas as pd
+from read_ru_event_log import read_ru_event_log, RUEventLogType
 
 
 class TrigActions(IntEnum):
@@ -9,20 +10,19 @@ class TrigActions(IntEnum):
     TRIGGER_FILTERED = 2
 
 
-# File format for trigger actions file:
+# Trigger actions file is an RU event log (see read_ru_event_log.py), where the records are
+# in trigger ID order, starting at trigger ID 0.
 #
-#   Header:
-#   uint64_t: number of triggers
-#   uint8_t:  number of control links
+# The simulation writes the log run-length encoded (TRIGGER_ACTIONS_RLE), with one record
+# per run of consecutive triggers that had the same actions:
+#   uint32_t: number of triggers in run
+#   uint8_t:  link action for control link 0
+#   uint8_t:  link action for control link 1
+#   ...
+#   uint8_t:  link action for control link n-1
 #
-#   For each trigger ID:
-#     Control link 0:
-#       uint8_t: link action
-#     Control link 1:
-#       uint8_t: link action
-#     ...
-#     Control link n-1:
-#       uint8_t: link action
+# The uncompressed log (TRIGGER_ACTIONS) has one record per trigger ID, with only the link
+# actions (one uint8_t per control link).
 
 def read_trig_actions_file(filename: str) -> pd.DataFrame:
     """Read a file with trigger actions (sent, filtered, not sent due to busy)
@@ -32,39 +32,40 @@ def read_trig_actions_file(filename: str) -> pd.DataFrame:
         Pandas dataframe with trigger actions per link
     """
 
-    with open(filename, 'rb') as file:
-        file_data = file.read()
+    log_type, num_ctrl_links, records = read_ru_event_log(filename,
+                                                          [RUEventLogType.TRIGGER_ACTIONS,
+                                                           RUEventLogType.TRIGGER_ACTIONS_RLE])
+    trig_actions = records[0]
 
-        num_triggers = struct.unpack('Q', file_data[0:8])[0]  # uint64_t
-        idx = 8
+    df_headers = ['trig_id']
 
-        num_ctrl_links = int(file_data[idx])
-        idx += 1
+    # Note: Only care about first link currently (as they are all the same..)
+    #for link_id in range(0, num_ctrl_links):
+        #link_str = 'link_' + str(link_id) + '_trig_action'
+        #df_headers.append(link_str)
+    df_headers.append('link_0_trig_action')
 
-        df_headers = ['trig_id']
+    df_rows = []
 
-        # Note: Only care about first link currently (as they are all the same..)
-        #for link_id in range(0, num_ctrl_links):
-            #link_str = 'link_' + str(link_id) + '_trig_action'
-            #df_headers.append(link_str)
-        df_headers.append('link_0_trig_action')
+    if log_type == RUEventLogType.TRIGGER_ACTIONS_RLE:
+        record_size = 4 + num_ctrl_links
+        trig_id = 0
 
-        df_rows = []
+        for idx in range(0, len(trig_actions), record_size):
+            run_length = struct.unpack('I', trig_actions[idx:idx+4])[0]
 
-        for trig_id in range(0, num_triggers):
-            df_row = [trig_id]
-
-            for link_num in range(0, num_ctrl_links):
-                trig_action = file_data[idx]
-                idx += 1
+            # Note: Only care about first link currently (as they are all the same..)
+            for i in range(0, run_length):
+                df_rows.append([trig_id, trig_actions[idx+4]])
+                trig_id += 1
+    else:
+        num_triggers = len(trig_actions) // num_ctrl_links
 
-                # Note: Only care about first link currently (as they are all the same..)
-                if link_num == 0:
-                    df_row.append(trig_action)
-
-            df_rows.append(df_row)
+        for trig_id in range(0, num_triggers):
+            # Note: Only care about first link currently (as they are all the same..)
+            df_rows.append([trig_id, trig_actions[trig_id*num_ctrl_links]])
 
-        trig_actions_df = pd.DataFrame(df_rows, columns=df_headers)
+    trig_actions_df = pd.DataFrame(df_rows, columns=df_headers)
 
     return trig_actions_df
 
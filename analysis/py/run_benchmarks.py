@@ -0,0 +1,383 @@
+import argparse
+import hashlib
+import json
+import os
+import shutil
+import subprocess
+import sys
+import time
+
+from run_sharded_sim import get_latest_run_dir
+
+
+# Top directory of the simulation project. The simulation is run from here, since the
+# settings files refer to files in config/ with relative paths.
+SIM_PROJECT_DIR = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..'))
+
+SCENARIO_DIR = os.path.join(SIM_PROJECT_DIR, 'config', 'benchmarks')
+
+# Output files that differ between runs of the same simulation, and are left out of the
+# output checksums. settings.txt is the input, and is compared separately.
+NON_DETERMINISTIC_FILES = ['settings.txt', 'timestamp.txt', 'telemetry.csv',
+                           'process_profile.txt', 'process_profile.csv']
+
+# Default limits for flagging a regression in compare
+DEFAULT_MAX_THROUGHPUT_DROP = 0.05
+DEFAULT_MAX_RSS_INCREASE = 0.10
+
+
+def get_scenarios():
+    """Get the names of the benchmark scenarios, ie. the settings files in config/benchmarks
+    Return:
+        Sorted list of scenario names
+    """
+    return sorted(os.path.splitext(f)[0] for f in os.listdir(SCENARIO_DIR) if f.endswith('.txt'))
+
+
+def file_checksum(filename: str):
+    """Calculate SHA-256 checksum of a file
+    Parameters:
+        filename: full path of file
+    Return:
+        Checksum as hex string
+    """
+    sha = hashlib.sha256()
+
+    with open(filename, 'rb') as f:
+        for chunk in iter(lambda: f.read(1 << 20), b''):
+            sha.update(chunk)
+
+    return sha.hexdigest()
+
+
+def settings_checksum(filename: str):
+    """Calculate SHA-256 checksum of a simulation settings file, without output_dir_prefix.
+    The output directory is different for every benchmark run, and does not affect the output.
+    Parameters:
+        filename: full path of settings file
+    Return:
+        Checksum as hex string
+    """
+    sha = hashlib.sha256()
+
+    with open(filename, 'rb') as f:
+        for line in f:
+            if not line.startswith(b'output_dir_prefix='):
+                sha.update(line)
+
+    return sha.hexdigest()
+
+
+def read_event_count(run_dir: str):
+    """Read the number of events simulated from simulation_info.txt
+    Parameters:
+        run_dir: simulation output directory
+    Return:
+        Sum of triggered and untriggered events simulated, or None if the file does not exist
+    """
+    info_filename = os.path.join(run_dir, 'simulation_info.txt')
+
+    if not os.path.exists(info_filename):
+        return None
+
+    events = 0
+
+    with open(info_filename) as f:
+        for line in f:
+            if line.startswith('Number of') and 'events simulated' in line:
+                events += int(line.split(':')[1])
+
+    return events
+
+
+def run_scenario(sim_binary: str, scenario: str, output_dir: str, sim_args: list):
+    """Run the simulation for a benchmark scenario, and measure wall time and peak memory use
+    Parameters:
+        sim_binary: path to simulation executable
+        scenario: name of scenario (settings file in config/benchmarks without .txt)
+        output_dir: directory to store the simulation output for the scenario in
+        sim_args: additional command line arguments for the simulation
+    Return:
+        Dictionary with the results for the scenario
+    """
+    # The simulation is run from SIM_PROJECT_DIR, so the paths passed to it must be absolute
+    output_dir = os.path.abspath(output_dir)
+
+    if os.path.exists(output_dir):
+        shutil.rmtree(output_dir)
+    os.makedirs(output_dir)
+
+    # The simulation writes missing (default) settings back to the settings file,
+    # so it is run with a copy to keep the checked in file unchanged
+    settings_filename = os.path.join(output_dir, 'settings.txt')
+    shutil.copy2(os.path.join(SCENARIO_DIR, scenario + '.txt'), settings_filename)
+
+    output_dir_prefix = os.path.join(output_dir, 'sim_output')
+    cmd = [os.path.abspath(sim_binary), '--cfg', settings_filename,
+           '--output_dir_prefix', output_dir_prefix] + sim_args
+
+    print('Running scenario', scenario, ':', ' '.join(cmd))
+
+    with open(os.path.join(output_dir, 'sim.log'), 'w') as log_file:
+        start_time = time.monotonic()
+        proc = subprocess.Popen(cmd, cwd=SIM_PROJECT_DIR, stdout=log_file,
+                                stderr=subprocess.STDOUT)
+
+        # wait4 gives the resource usage of this process only, ru_maxrss is in kB on Linux
+        _, status, rusage = os.wait4(proc.pid, 0)
+        wall_time = time.monotonic() - start_time
+        proc.returncode = os.waitstatus_to_exitcode(status)
+
+    result = {'exit_code': proc.returncode,
+              'wall_time_s': wall_time,
+              'peak_rss_kb': rusage.ru_maxrss}
+
+    run_dir = get_latest_run_dir(output_dir_prefix) if os.path.exists(output_dir_prefix) else None
+    events = read_event_count(run_dir) if run_dir is not None else None
+
+    if proc.returncode != 0 or events is None:
+        print('Scenario', scenario, 'failed, see', os.path.join(output_dir, 'sim.log'))
+        result['failed'] = True
+        return result
+
+    result['failed'] = False
+    result['events'] = events
+    result['events_per_s'] = events / wall_time if wall_time > 0 else 0
+    result['settings_checksum'] = settings_checksum(os.path.join(run_dir, 'settings.txt'))
+    result['checksums'] = {f: file_checksum(os.path.join(run_dir, f))
+                           for f in sorted(os.listdir(run_dir))
+                           if f not in NON_DETERMINISTIC_FILES and
+                           os.path.isfile(os.path.join(run_dir, f))}
+
+    print('Scenario {}: {:.1f} s, {} events, {:.1f} events/s, peak RSS {} kB'.format(
+        scenario, wall_time, events, result['events_per_s'], result['peak_rss_kb']))
+
+    return result
+
+
+def run_benchmarks(sim_binary: str, output_dir: str, scenarios: list, sim_args: list):
+    """Run benchmark scenarios, and write the results to results.json in the output directory
+    Parameters:
+        sim_binary: path to simulation executable
+        output_dir: directory to store simulation output and results in
+        scenarios: list of scenario names to run
+        sim_args: additional command line arguments for the simulation
+    Return:
+        Dictionary with results
+    """
+    os.makedirs(output_dir, exist_ok=True)
+
+    results = {'sim_binary': os.path.abspath(sim_binary),
+               'sim_args': sim_args,
+               'date': time.strftime('%Y-%m-%d %H:%M:%S'),
+               'scenarios': {}}
+
+    for scenario in scenarios:
+        results['scenarios'][scenario] = run_scenario(sim_binary, scenario,
+                                                      os.path.join(output_dir, scenario),
+                                                      sim_args)
+
+    results_filename = os.path.join(output_dir, 'results.json')
+
+    with open(results_filename, 'w') as f:
+        json.dump(results, f, indent=2)
+
+    print('Benchmark results written to', results_filename)
+
+    return results
+
+
+def compare_results(baseline: dict, results: dict,
+                    max_throughput_drop: float = DEFAULT_MAX_THROUGHPUT_DROP,
+                    max_rss_increase: float = DEFAULT_MAX_RSS_INCREASE):
+    """Compare benchmark results from two builds
+    Parameters:
+        baseline: results from the reference build
+        results: results from the build to check
+        max_throughput_drop: events/s drop (relative) flagged as a regression
+        max_rss_increase: peak RSS increase (relative) flagged as a regression
+    Return:
+        List of problems found (strings). Empty if there were no regressions or output diffs.
+    """
+    problems = []
+
+    for scenario, base in sorted(baseline['scenarios'].items()):
+        if scenario not in results['scenarios']:
+            print('{:<25} missing'.format(scenario))
+            problems.append(scenario + ': not run')
+            continue
+
+        res = results['scenarios'][scenario]
+
+        if base['failed'] or res['failed']:
+            print('{:<25} failed (baseline: {}, new: {})'.format(scenario, base['failed'],
+                                                                res['failed']))
+            if res['failed'] and not base['failed']:
+                problems.append(scenario + ': failed')
+            continue
+
+        throughput_change = res['events_per_s'] / base['events_per_s'] - 1
+        rss_change = res['peak_rss_kb'] / base['peak_rss_kb'] - 1
+
+        print('{:<25} {:>12.1f} -> {:>12.1f} events/s ({:+6.1f} %)   '
+              '{:>9} -> {:>9} kB RSS ({:+6.1f} %)'.format(
+                  scenario, base['events_per_s'], res['events_per_s'], 100*throughput_change,
+                  base['peak_rss_kb'], res['peak_rss_kb'], 100*rss_change))
+
+        if throughput_change < -max_throughput_drop:
+            problems.append('{}: throughput dropped {:.1f} %'.format(scenario,
+                                                                     -100*throughput_change))
+        if rss_change > max_rss_increase:
+            problems.append('{}: peak RSS increased {:.1f} %'.format(scenario, 100*rss_change))
+
+        if base['settings_checksum'] != res['settings_checksum']:
+            print('    settings differ, output diffs may be expected')
+
+        problems += compare_output(scenario, base, res)
+
+    return problems
+
+
+def compare_output(scenario: str, base: dict, res: dict):
+    """Compare the number of events and the output file checksums for a scenario
+    Parameters:
+        scenario: name of scenario
+        base: results for the scenario from the reference run
+        res: results for the scenario from the run to check
+    Return:
+        List of differences found (strings)
+    """
+    problems = []
+
+    if base['events'] != res['events']:
+        problems.append('{}: {} events simulated, baseline has {}'.format(
+            scenario, res['events'], base['events']))
+
+    for filename in sorted(set(base['checksums']) | set(res['checksums'])):
+        if filename not in res['checksums']:
+            problems.append('{}: {} missing'.format(scenario, filename))
+        elif filename not in base['checksums']:
+            problems.append('{}: {} not in baseline'.format(scenario, filename))
+        elif base['checksums'][filename] != res['checksums'][filename]:
+            problems.append('{}: {} differs'.format(scenario, filename))
+
+    return problems
+
+
+def check_determinism(sim_binary: str, output_dir: str, scenarios: list, threads: int,
+                      sim_args: list):
+    """Run benchmark scenarios with 0 threads as the reference, and with 1 and multiple
+    threads for the parallel chip evaluation, and check that the output files are identical
+    Parameters:
+        sim_binary: path to simulation executable
+        output_dir: directory to store simulation output in
+        scenarios: list of scenario names to run
+        threads: number of threads to compare with the reference run
+        sim_args: additional command line arguments for the simulation
+    Return:
+        List of problems found (strings). Empty if the output was identical.
+    """
+    problems = []
+
+    for scenario in scenarios:
+        scenario_dir = os.path.join(output_dir, scenario)
+        runs = {}
+
+        for num_threads in [0, 1, threads]:
+            runs[num_threads] = run_scenario(sim_binary, scenario,
+                                             os.path.join(scenario_dir,
+                                                          'threads_' + str(num_threads)),
+                                             sim_args + ['-t', str(num_threads)])
+
+        if any(run['failed'] for run in runs.values()):
+            problems.append(scenario + ': failed')
+            continue
+
+        for num_threads in [1, threads]:
+            scenario_problems = compare_output(scenario + ' (threads={})'.format(num_threads),
+                                               runs[0], runs[num_threads])
+            print('{:<25} threads=0 vs threads={}: {}'.format(
+                scenario, num_threads, 'differs' if scenario_problems else 'identical'))
+            problems += scenario_problems
+
+    return problems
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='Run end-to-end simulation benchmarks, '
+                                                 'and compare the results from two builds')
+    subparsers = parser.add_subparsers(dest='command')
+
+    run_parser = subparsers.add_parser('run', help='Run benchmark scenarios')
+    run_parser.add_argument('sim_binary', help='Path to simulation executable')
+    run_parser.add_argument('output_dir', help='Directory for simulation output and results.json')
+    run_parser.add_argument('--scenarios', default=None,
+                            help='Comma separated list of scenarios to run '
+                                 '(default: all in config/benchmarks)')
+    run_parser.add_argument('sim_args', nargs=argparse.REMAINDER,
+                            help='Additional arguments for simulation (e.g. -t <threads>)')
+
+    compare_parser = subparsers.add_parser('compare', help='Compare results from two builds')
+    compare_parser.add_argument('baseline', help='results.json from reference build')
+    compare_parser.add_argument('results', help='results.json from build to check')
+    compare_parser.add_argument('--max_throughput_drop', type=float,
+                                default=DEFAULT_MAX_THROUGHPUT_DROP,
+                                help='Relative drop in events/s flagged as regression')
+    compare_parser.add_argument('--max_rss_increase', type=float,
+                                default=DEFAULT_MAX_RSS_INCREASE,
+                                help='Relative increase in peak RSS flagged as regression')
+
+    determinism_parser = subparsers.add_parser('determinism',
+                                               help='Check that the output is the same with '
+                                                    '0, 1 and N threads')
+    determinism_parser.add_argument('sim_binary', help='Path to simulation executable')
+    determinism_parser.add_argument('output_dir', help='Directory for simulation output')
+    determinism_parser.add_argument('--scenarios', default=None,
+                                    help='Comma separated list of scenarios to run '
+                                         '(default: all in config/benchmarks)')
+    determinism_parser.add_argument('--threads', type=int, default=4,
+                                    help='Number of threads to compare with zero threads')
+    determinism_parser.add_argument('sim_args', nargs=argparse.REMAINDER,
+                                    help='Additional arguments for simulation')
+
+    subparsers.add_parser('list', help='List benchmark scenarios')
+
+    args = parser.parse_args()
+
+    if args.command in ['run', 'determinism']:
+        scenarios = args.scenarios.split(',') if args.scenarios else get_scenarios()
+        unknown = [s for s in scenarios if s not in get_scenarios()]
+        if len(unknown) > 0:
+            parser.error('Unknown scenario(s): ' + ', '.join(unknown))
+
+    if args.command == 'run':
+        results = run_benchmarks(args.sim_binary, args.output_dir, scenarios, args.sim_args)
+        if any(r['failed'] for r in results['scenarios'].values()):
+            sys.exit(1)
+    elif args.command == 'compare':
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        with open(args.results) as f:
+            results = json.load(f)
+        problems = compare_results(baseline, results, args.max_throughput_drop,
+                                   args.max_rss_increase)
+        for problem in problems:
+            print('REGRESSION:', problem)
+        if len(problems) > 0:
+            sys.exit(1)
+        print('No regressions or output diffs.')
+    elif args.command == 'determinism':
+        if args.threads < 2:
+            parser.error('--threads must be at least 2')
+        problems = check_determinism(args.sim_binary, args.output_dir, scenarios, args.threads,
+                                     args.sim_args)
+        for problem in problems:
+            print('NOT DETERMINISTIC:', problem)
+        if len(problems) > 0:
+            sys.exit(1)
+        print('Output is the same with 0, 1 and', args.threads, 'threads.')
+    elif args.command == 'list':
+        for scenario in get_scenarios():
+            print(scenario)
+    else:
+        parser.print_help()
@@ -0,0 +1,279 @@
+import argparse
+import csv
+import os
+import re
+import shutil
+import subprocess
+
+
+# Files that are written per chip, and have to be merged from all the shards.
+# Each shard only writes rows for the chips it simulated, except for the readout stats,
+# which have rows for the hits in all chips (see merge_readout_stats()).
+ALPIDE_STATS_FILE = 'Alpide_stats.csv'
+MEB_HISTO_FILE = 'Alpide_MEB_histograms.csv'
+CHIP_STATS_FILES = [ALPIDE_STATS_FILE,
+                    'Alpide_frame_model_validation.csv',
+                    'Alpide_hybrid_model_stats.csv']
+READOUT_STATS_FILES = ['triggered_readout_stats.csv', 'untriggered_readout_stats.csv']
+
+# Files that describe the simulation process of each shard (run time, memory use, profiling),
+# which can not be merged. They are kept for every shard as shard_<n>_<filename>.
+PER_SHARD_FILES = ['telemetry.csv', 'process_profile.txt', 'process_profile.csv']
+
+# Column with unique chip ID in the per chip files
+CHIP_ID_COLUMN = 5
+
+# The remaining files in the shard output directories are either per RU (RU_*), and only
+# exist in the shard that simulated the RU, or they are the same for all the shards and are
+# taken from the first shard. The event generator runs for the whole detector in every
+# shard, so its output and the simulation info/settings do not depend on the shard.
+
+
+def read_csv(filename: str):
+    """Read semicolon separated CSV file written by the simulation
+    Parameters:
+        filename: full path of CSV file to read
+    Return:
+        Tuple with header (list of strings) and rows (list of lists of strings)
+    """
+    with open(filename, newline='') as f:
+        rows = [row for row in csv.reader(f, delimiter=';') if len(row) > 0]
+
+    return rows[0], rows[1:]
+
+
+def write_csv(filename: str, header: list, rows: list, trailing_newline: bool = False):
+    """Write semicolon separated CSV file in the same format as the simulation
+    Parameters:
+        filename: full path of CSV file to write
+        header: list of column names
+        rows: list of rows, each a list of values
+        trailing_newline: end the last row with a newline
+    """
+    lines = [';'.join(header)] + [';'.join(str(v) for v in row) for row in rows]
+
+    with open(filename, 'w') as f:
+        f.write('\n'.join(lines))
+        if trailing_newline:
+            f.write('\n')
+
+
+def get_latest_run_dir(output_dir_prefix: str):
+    """Find the simulation output directory with the highest run number in a prefix directory
+    Parameters:
+        output_dir_prefix: output directory prefix used for the simulation
+    Return:
+        Full path of run_<n> directory, or None if there are no run directories
+    """
+    runs = [d for d in os.listdir(output_dir_prefix) if re.match(r'^run_\d+$', d)]
+
+    if len(runs) == 0:
+        return None
+
+    runs.sort(key=lambda d: int(d[len('run_'):]))
+
+    return os.path.join(output_dir_prefix, runs[-1])
+
+
+def merge_chip_stats(shard_dirs: list, filename: str, merged_dir: str):
+    """Merge files with one row per chip (Alpide_stats.csv etc.) from the shards
+    Parameters:
+        shard_dirs: list of shard output directories
+        filename: name of per chip stats file
+        merged_dir: output directory for merged files
+    Return:
+        List with set of chip IDs in the file for each shard, or None if the file
+        does not exist in any of the shards
+    """
+    header = None
+    rows = []
+    shard_chips = []
+
+    for shard_dir in shard_dirs:
+        shard_filename = os.path.join(shard_dir, filename)
+        if not os.path.exists(shard_filename):
+            shard_chips.append(set())
+            continue
+
+        shard_header, shard_rows = read_csv(shard_filename)
+        header = header or shard_header
+        rows += shard_rows
+        shard_chips.append(set(int(row[CHIP_ID_COLUMN]) for row in shard_rows))
+
+    if header is None:
+        return None
+
+    # Chips are written in order of (unique) chip ID by the simulation
+    rows.sort(key=lambda row: int(row[CHIP_ID_COLUMN]))
+    write_csv(os.path.join(merged_dir, filename), header, rows, trailing_newline=True)
+
+    return shard_chips
+
+
+def merge_meb_histograms(shard_dirs: list, merged_dir: str):
+    """Merge Alpide_MEB_histograms.csv files from the shards. There is one column per
+    chip, and one row per number of MEBs in use.
+    Parameters:
+        shard_dirs: list of shard output directories
+        merged_dir: output directory for merged files
+    """
+    first_column = None
+    columns = {}
+
+    for shard_dir in shard_dirs:
+        header, rows = read_csv(os.path.join(shard_dir, MEB_HISTO_FILE))
+        first_column = first_column or header[0]
+
+        for col, chip_name in enumerate(header[1:], start=1):
+            columns[chip_name] = {int(row[0]): row[col] for row in rows}
+
+    chip_names = sorted(columns.keys(), key=lambda name: int(name.split()[-1]))
+    max_meb = max([max(histo.keys(), default=0) for histo in columns.values()], default=0)
+
+    rows = [[meb] + [columns[name].get(meb, 0) for name in chip_names] for meb in range(max_meb+1)]
+    write_csv(os.path.join(merged_dir, MEB_HISTO_FILE), [first_column] + chip_names, rows)
+
+
+def merge_readout_stats(shard_dirs: list, shard_chips: list, filename: str, merged_dir: str):
+    """Merge pixel readout stats files from the shards. Every shard sees the hits for all
+    chips, but only chips simulated in a shard have valid readout counts there.
+    Parameters:
+        shard_dirs: list of shard output directories
+        shard_chips: list with set of chip IDs simulated in each shard
+        filename: name of readout stats file
+        merged_dir: output directory for merged files
+    """
+    rows = []
+    found = False
+
+    for shard_dir, chips in zip(shard_dirs, shard_chips):
+        shard_filename = os.path.join(shard_dir, filename)
+        if not os.path.exists(shard_filename):
+            continue
+
+        found = True
+        _, shard_rows = read_csv(shard_filename)
+        rows += [row for row in shard_rows if int(row[0]) in chips]
+
+    if not found:
+        return
+
+    max_count = max([len(row)-2 for row in rows], default=0)
+    rows = [row + ['0']*(max_count+2-len(row)) for row in rows]
+    rows.sort(key=lambda row: int(row[0]))
+
+    header = ['Chip ID'] + [str(count) for count in range(max_count+1)]
+    write_csv(os.path.join(merged_dir, filename), header, rows)
+
+
+def merge_shards(shard_dirs: list, merged_dir: str):
+    """Merge output directories from a sharded simulation, so that they look like a single run
+    Parameters:
+        shard_dirs: list of shard output directories, ordered by shard index
+        merged_dir: output directory for merged files
+    """
+    os.makedirs(merged_dir, exist_ok=True)
+
+    merged_files = CHIP_STATS_FILES + [MEB_HISTO_FILE] + READOUT_STATS_FILES
+
+    for shard_num, shard_dir in enumerate(shard_dirs):
+        for filename in os.listdir(shard_dir):
+            if filename in merged_files:
+                continue
+            if filename in PER_SHARD_FILES:
+                shutil.copy2(os.path.join(shard_dir, filename),
+                             os.path.join(merged_dir, 'shard_{}_{}'.format(shard_num, filename)))
+                continue
+            if shard_num > 0 and not filename.startswith('RU_'):
+                continue
+            shutil.copy2(os.path.join(shard_dir, filename), merged_dir)
+
+    # Make the settings file describe an unsharded simulation
+    settings_filename = os.path.join(merged_dir, 'settings.txt')
+    if os.path.exists(settings_filename):
+        with open(settings_filename) as f:
+            settings = f.read()
+        settings = re.sub(r'(?m)^shard_count=.*$', 'shard_count=1', settings)
+        settings = re.sub(r'(?m)^shard_index=.*$', 'shard_index=0', settings)
+        with open(settings_filename, 'w') as f:
+            f.write(settings)
+
+    shard_chips = merge_chip_stats(shard_dirs, ALPIDE_STATS_FILE, merged_dir)
+
+    for filename in CHIP_STATS_FILES[1:]:
+        merge_chip_stats(shard_dirs, filename, merged_dir)
+
+    merge_meb_histograms(shard_dirs, merged_dir)
+
+    for filename in READOUT_STATS_FILES:
+        merge_readout_stats(shard_dirs, shard_chips, filename, merged_dir)
+
+
+def run_shards(sim_binary: str, num_shards: int, output_dir_prefix: str, sim_args: list):
+    """Run a sharded ITS simulation, with one process per shard, and merge the results
+    Parameters:
+        sim_binary: path to simulation executable
+        num_shards: number of shards (and processes) to split the detector into
+        output_dir_prefix: output directory prefix. Shard n is stored in shard_<n>/run_<id>,
+                           and the merged results in merged/
+        sim_args: additional command line arguments passed to all shards
+    Return:
+        Path to merged output directory
+    """
+    processes = []
+
+    for shard in range(num_shards):
+        shard_prefix = os.path.join(output_dir_prefix, 'shard_' + str(shard))
+        log_file = open(os.path.join(output_dir_prefix, 'shard_' + str(shard) + '.log'), 'w')
+
+        cmd = [sim_binary] + sim_args + ['--shard_index', str(shard),
+                                         '--shard_count', str(num_shards),
+                                         '--output_dir_prefix', shard_prefix]
+
+        print('Starting shard', shard, ':', ' '.join(cmd))
+        processes.append((subprocess.Popen(cmd, stdout=log_file, stderr=subprocess.STDOUT), log_file))
+
+    failed = False
+    for shard, (proc, log_file) in enumerate(processes):
+        if proc.wait() != 0:
+            print('Shard', shard, 'failed with exit code', proc.returncode)
+            failed = True
+        log_file.close()
+
+    if failed:
+        raise RuntimeError('One or more shards failed')
+
+    shard_dirs = [get_latest_run_dir(os.path.join(output_dir_prefix, 'shard_' + str(shard)))
+                  for shard in range(num_shards)]
+    merged_dir = os.path.join(output_dir_prefix, 'merged')
+
+    merge_shards(shard_dirs, merged_dir)
+
+    return merged_dir
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='Run and/or merge sharded ITS simulations')
+    subparsers = parser.add_subparsers(dest='command')
+
+    run_parser = subparsers.add_parser('run', help='Run simulation shards in parallel and merge them')
+    run_parser.add_argument('sim_binary', help='Path to simulation executable')
+    run_parser.add_argument('num_shards', type=int, help='Number of shards/processes')
+    run_parser.add_argument('output_dir_prefix', help='Output directory prefix')
+    run_parser.add_argument('sim_args', nargs=argparse.REMAINDER,
+                            help='Additional arguments for simulation (e.g. -s <seed> -n <events>)')
+
+    merge_parser = subparsers.add_parser('merge', help='Merge output directories from shards')
+    merge_parser.add_argument('merged_dir', help='Output directory for merged files')
+    merge_parser.add_argument('shard_dirs', nargs='+', help='Shard output directories, in shard order')
+
+    args = parser.parse_args()
+
+    if args.command == 'run':
+        os.makedirs(args.output_dir_prefix, exist_ok=True)
+        merged_dir = run_shards(args.sim_binary, args.num_shards, args.output_dir_prefix, args.sim_args)
+        print('Merged simulation output:', merged_dir)
+    elif args.command == 'merge':
+        merge_shards(args.shard_dirs, args.merged_dir)
+    else:
+        parser.print_help()
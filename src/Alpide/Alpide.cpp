@@ -8,11 +8,17 @@
  */
 
 #include "Alpide.hpp"
+#include "ParallelChipEvaluator.hpp"
 #include "alpide_constants.hpp"
 #include "../misc/vcd_trace.hpp"
+#include "../Log/Log.hpp"
+#include "../Profiling/ProcessProfiler.hpp"
 #include <string>
 #include <sstream>
 
+///@brief Saturation value for Alpide::mDtuStableCycles (larger than any DTU delay)
+#define DTU_STABLE_CYCLES_MAX 0xFFFF
+
 
 SC_HAS_PROCESS(Alpide);
 ///@brief Constructor for Alpide.
@@ -20,15 +26,10 @@ SC_HAS_PROCESS(Alpide);
 ///@param[in] global_chip_id Global chip ID that uniquely identifies chip in simulation
 ///@param[in] local_chip_id Chip ID that identifies chip in the stave or module
 ///@param[in] chip_cfg Chip configuration
-///@param[in] outer_barrel_mode True: outer barrel mode. False: inner barrel mode
-///@param[in] outer_barrel_master Only relevant if in OB mode.
-///           True: OB master. False: OB slave
+///@param[in] flavor Inner barrel chip, outer barrel master, or outer barrel slave
 ///@param[in] outer_barrel_slave_count Number of slave chips connected to outer barrel master
-///@param[in] min_busy_cycles Minimum number of cycles that the internal busy signal has to be
-///           asserted before the chip transmits BUSY_ON
 Alpide::Alpide(sc_core::sc_module_name name, const int global_chip_id, const int local_chip_id,
-               const AlpideConfig& chip_cfg, bool outer_barrel_mode, bool outer_barrel_master,
-               int outer_barrel_slave_count)
+               const AlpideConfig& chip_cfg, AlpideFlavor flavor, int outer_barrel_slave_count)
   : sc_core::sc_module(name)
   , s_control_input("s_control_input")
   , s_data_output("s_data_output")
@@ -36,9 +37,9 @@ Alpide::Alpide(sc_core::sc_module_name name, const int global_chip_id, const int
   , s_local_bus_data_in(outer_barrel_slave_count)
   , s_local_busy_in(outer_barrel_slave_count)
   , s_dmu_fifo(DMU_FIFO_SIZE)
-  , s_dtu_delay_fifo(chip_cfg.dtu_delay_cycles+1)
-  , s_dtu_delay_fifo_trig(chip_cfg.dtu_delay_cycles+1)
-  , s_busy_fifo(BUSY_FIFO_SIZE)
+  , s_dtu_delay_fifo(flavor == ALPIDE_OB_SLAVE ? 1 : chip_cfg.dtu_delay_cycles+1)
+  , s_dtu_delay_fifo_trig(flavor == ALPIDE_OB_SLAVE ? 1 : chip_cfg.dtu_delay_cycles+1)
+  , s_busy_fifo(flavor == ALPIDE_OB_SLAVE ? 1 : BUSY_FIFO_SIZE)
   , s_frame_start_fifo(TRU_FRAME_FIFO_SIZE)
   , s_frame_end_fifo(TRU_FRAME_FIFO_SIZE)
   , mGlobalChipId(global_chip_id)
@@ -47,11 +48,18 @@ Alpide::Alpide(sc_core::sc_module_name name, const int global_chip_id, const int
   , mStrobeExtensionEnable(chip_cfg.strobe_extension)
   , mStrobeLengthNs(chip_cfg.strobe_length_ns)
   , mMinBusyCycles(chip_cfg.min_busy_cycles)
-  , mObMode(outer_barrel_mode)
-  , mObMaster(outer_barrel_master)
+  , mFlavor(flavor)
   , mObSlaveCount(outer_barrel_slave_count)
+  , mClockSkippingEnable(chip_cfg.clock_skipping)
+  , mFrameModel(chip_cfg.matrix_readout_speed, chip_cfg.data_long_en)
+  , mFrameModelEnable(chip_cfg.frame_model || chip_cfg.hybrid_model)
+  , mFrameModelValidation(chip_cfg.frame_model_validation && !chip_cfg.frame_model)
+  , mHybridEnable(chip_cfg.hybrid_model && !chip_cfg.frame_model)
+  , mHybridMebThreshold(chip_cfg.hybrid_meb_threshold)
+  , mHybridFrameFifoThreshold(chip_cfg.hybrid_frame_fifo_threshold)
+  , mParallelEvaluator(ParallelChipEvaluator::getInstance())
 {
-  mEnableDtuDelay = chip_cfg.dtu_delay_cycles > 0;
+  mEnableDtuDelay = chip_cfg.dtu_delay_cycles > 0 && flavor != ALPIDE_OB_SLAVE;
 
   s_chip_ready_out(s_chip_ready_internal);
   s_local_busy_out(s_busy_status);
@@ -83,62 +91,91 @@ Alpide::Alpide(sc_core::sc_module_name name, const int global_chip_id, const int
 
   mDataWordCount = std::make_shared<std::map<AlpideDataType, uint64_t>>();
 
-  mTRU = new TopReadoutUnit("TRU", global_chip_id, local_chip_id, mDataWordCount);
-
-  // Allocate/create/name SystemC FIFOs for the regions and connect the
-  // Region Readout Units (RRU) FIFO outputs to Top Readout Unit (TRU) FIFO inputs
-  mRRUs.reserve(N_REGIONS);
-  for(int i = 0; i < N_REGIONS; i++) {
-    std::stringstream ss;
-    ss << "RRU_" << i;
-    mRRUs[i] = new RegionReadoutUnit(ss.str().c_str(),
-                                     this,
-                                     i,
-                                     REGION_FIFO_SIZE,
-                                     chip_cfg.matrix_readout_speed,
-                                     chip_cfg.data_long_en);
-
-    mRRUs[i]->s_system_clk_in(s_system_clk_in);
-    mRRUs[i]->s_frame_readout_start_in(s_frame_readout_start);
-    mRRUs[i]->s_readout_abort_in(s_readout_abort);
-    mRRUs[i]->s_region_event_start_in(s_region_event_start);
-    mRRUs[i]->s_region_event_pop_in(s_region_event_pop);
-    mRRUs[i]->s_region_data_read_in(s_region_data_read[i]);
-
-    mRRUs[i]->s_frame_readout_done_out(s_frame_readout_done[i]);
-    mRRUs[i]->s_region_fifo_empty_out(s_region_fifo_empty[i]);
-    mRRUs[i]->s_region_valid_out(s_region_valid[i]);
-    mRRUs[i]->s_region_data_out(s_region_data[i]);
-
-    mTRU->s_region_fifo_empty_in[i](s_region_fifo_empty[i]);
-    mTRU->s_region_valid_in[i](s_region_valid[i]);
-    mTRU->s_region_data_in[i](s_region_data[i]);
-    mTRU->s_region_data_read_out[i](s_region_data_read[i]);
-  }
-
-  mTRU->s_clk_in(s_system_clk_in);
-  mTRU->s_readout_abort_in(s_readout_abort);
-  mTRU->s_fatal_state_in(s_fatal_state);
-  mTRU->s_region_event_start_out(s_region_event_start);
-  mTRU->s_region_event_pop_out(s_region_event_pop);
-  mTRU->s_frame_start_fifo_output(s_frame_start_fifo);
-  mTRU->s_frame_end_fifo_output(s_frame_end_fifo);
-  mTRU->s_dmu_fifo_input(s_dmu_fifo);
+  // The frame level model reads out the MEBs and writes to the DMU FIFO directly,
+  // see frameReadoutFast() and topReadoutFast(). In hybrid mode the chip starts with
+  // the frame level model, and the TRU is enabled when it switches to cycle accurate.
+  if(!chip_cfg.frame_model) {
+    mTRU = new TopReadoutUnit("TRU", global_chip_id, local_chip_id, mDataWordCount,
+                              chip_cfg.clock_skipping);
+
+    // Allocate/create/name SystemC FIFOs for the regions and connect the
+    // Region Readout Units (RRU) FIFO outputs to Top Readout Unit (TRU) FIFO inputs
+    mRRUs.reserve(N_REGIONS);
+    for(int i = 0; i < N_REGIONS; i++) {
+      std::stringstream ss;
+      ss << "RRU_" << i;
+      mRRUs.push_back(new RegionReadoutUnit(ss.str().c_str(),
+                                            this,
+                                            i,
+                                            REGION_FIFO_SIZE,
+                                            chip_cfg.matrix_readout_speed,
+                                            chip_cfg.data_long_en));
+
+      mRRUs[i]->s_system_clk_in(s_system_clk_in);
+      mRRUs[i]->s_frame_readout_start_in(s_frame_readout_start);
+      mRRUs[i]->s_readout_abort_in(s_readout_abort);
+      mRRUs[i]->s_region_event_start_in(s_region_event_start);
+      mRRUs[i]->s_region_event_pop_in(s_region_event_pop);
+      mRRUs[i]->s_region_data_read_in(s_region_data_read[i]);
+
+      mRRUs[i]->s_frame_readout_done_out(s_frame_readout_done[i]);
+      mRRUs[i]->s_region_fifo_empty_out(s_region_fifo_empty[i]);
+      mRRUs[i]->s_region_valid_out(s_region_valid[i]);
+      mRRUs[i]->s_region_data_out(s_region_data[i]);
+
+      mTRU->s_region_fifo_empty_in[i](s_region_fifo_empty[i]);
+      mTRU->s_region_valid_in[i](s_region_valid[i]);
+      mTRU->s_region_data_in[i](s_region_data[i]);
+      mTRU->s_region_data_read_out[i](s_region_data_read[i]);
+    }
+
+    mTRU->s_clk_in(s_system_clk_in);
+    mTRU->s_readout_abort_in(s_readout_abort);
+    mTRU->s_fatal_state_in(s_fatal_state);
+    mTRU->s_region_event_start_out(s_region_event_start);
+    mTRU->s_region_event_pop_out(s_region_event_pop);
+    mTRU->s_frame_start_fifo_output(s_frame_start_fifo);
+    mTRU->s_frame_end_fifo_output(s_frame_end_fifo);
+    mTRU->s_dmu_fifo_input(s_dmu_fifo);
+    mTRU->setEnable(!mHybridEnable);
+  }
 
   // Initialize DTU delay FIFO with idle words
-  sc_uint<24> dw_idle_data = ((uint32_t) DW_IDLE << 16) |
-                             ((uint32_t) DW_IDLE << 8) |
-                              (uint32_t) DW_IDLE;
+  if(mEnableDtuDelay) {
+    sc_uint<24> dw_idle_data = ((uint32_t) DW_IDLE << 16) |
+                               ((uint32_t) DW_IDLE << 8) |
+                                (uint32_t) DW_IDLE;
 
-  while(s_dtu_delay_fifo.num_free() > 0) {
-    s_dtu_delay_fifo.nb_write(dw_idle_data);
-    s_dtu_delay_fifo_trig.nb_write(0);
+    while(s_dtu_delay_fifo.num_free() > 0) {
+      s_dtu_delay_fifo.nb_write(dw_idle_data);
+      s_dtu_delay_fifo_trig.nb_write(0);
+    }
   }
 
   s_control_input.register_transport(std::bind(&Alpide::processCommand,
                                                this, std::placeholders::_1));
 
-  SC_METHOD(mainMethod);
+  // Register the main method that is specialized for this chip's flavor and DTU delay
+  // setting, so that the per clock cycle code does not have to check them
+  switch(flavor) {
+  case ALPIDE_IB:
+    if(mEnableDtuDelay) {
+      SC_METHOD(mainMethodIBDtuDelay);
+    } else {
+      SC_METHOD(mainMethodIB);
+    }
+    break;
+  case ALPIDE_OB_MASTER:
+    if(mEnableDtuDelay) {
+      SC_METHOD(mainMethodObMasterDtuDelay);
+    } else {
+      SC_METHOD(mainMethodObMaster);
+    }
+    break;
+  case ALPIDE_OB_SLAVE:
+    SC_METHOD(mainMethodObSlave);
+    break;
+  }
   sensitive_pos << s_system_clk_in;
 
   SC_METHOD(triggerMethod);
@@ -150,7 +187,7 @@ Alpide::Alpide(sc_core::sc_module_name name, const int global_chip_id, const int
   dont_initialize();
 
   // Only IB/OB-master chips need the busy FIFO method
-  if(!outer_barrel_mode || (outer_barrel_mode && outer_barrel_master)) {
+  if(flavor != ALPIDE_OB_SLAVE) {
     SC_METHOD(busyFifoMethod);
     sensitive << s_busy_status;
     dont_initialize();
@@ -173,14 +210,195 @@ void Alpide::newEvent(uint64_t event_time)
 }
 
 
+///@brief Called by SystemC when all ports are bound. Sets up the clock period and the
+///       events that wake up mainMethod() when clock skipping is enabled.
+void Alpide::end_of_elaboration(void)
+{
+  if(!mClockSkippingEnable)
+    return;
+
+  sc_clock* clk = dynamic_cast<sc_clock*>(s_system_clk_in.get_interface());
+
+  if(clk == nullptr) {
+    SC_REPORT_WARNING(name(), "Clock input is not an sc_clock, clock skipping disabled");
+    mClockSkippingEnable = false;
+    return;
+  }
+
+  mClockPeriod = clk->period().value();
+
+  mWakeUpEvents |= s_strobe_n.value_changed_event();
+  mWakeUpEvents |= s_dmu_fifo.data_written_event();
+  mWakeUpEvents |= s_busy_fifo.data_written_event();
+
+  if(mFlavor == ALPIDE_OB_MASTER) {
+    for(unsigned int i = 0; i < mObSlaveCount; i++) {
+      mWakeUpEvents |= s_local_bus_data_in[i]->data_written_event();
+      mWakeUpEvents |= s_local_busy_in[i].value_changed_event();
+    }
+  }
+}
+
+
+///@brief Release the pixel hit side channel of the data words that are still queued in the
+///       chip's region FIFOs, DMU FIFO and frame level model, so that their pixels are
+///       counted as not read out in the pixel readout stats. Call it when the simulation
+///       has stopped, and before the readout stats are written. It is safe to call more
+///       than once.
+void Alpide::releaseQueuedPixelRefs(void)
+{
+  AlpideDataWord data_word;
+
+  for(auto rru_it = mRRUs.begin(); rru_it != mRRUs.end(); rru_it++)
+    (*rru_it)->flushRegionFifo();
+
+  while(s_dmu_fifo.nb_read(data_word))
+    data_word.releasePixelRefs(false);
+
+  for(auto frame_it = mFrameModelFrames.begin(); frame_it != mFrameModelFrames.end(); frame_it++) {
+    for(auto word_it = frame_it->begin(); word_it != frame_it->end(); word_it++)
+      word_it->data_word.releasePixelRefs(false);
+  }
+}
+
+
+///@brief Called by SystemC at the end of the simulation. Releases the pixel hit side channel
+///       of data words that were never transmitted, if it was not already done.
+void Alpide::end_of_simulation(void)
+{
+  releaseQueuedPixelRefs();
+}
+
+
 ///@brief Data transmission SystemC method. Currently runs on 40MHz clock.
+///       When clock skipping is enabled, the method goes to sleep when the chip is idle
+///       (see getChipIdle()), and is woken up by a new strobe, data in the DMU or busy
+///       FIFOs, or (for OB masters) data or busy from the slave chips. The clock cycles
+///       that were skipped are accounted for in the bunch counter when it wakes up again.
+///       The method is specialized for the chip flavor and for whether the DTU delay is
+///       enabled, see the mainMethodIB() etc. wrappers below.
 ///@todo Implement more advanced data transmission method.
+template <AlpideFlavor FLAVOR, bool DTU_DELAY>
 void Alpide::mainMethod(void)
 {
+  if(mSleeping) {
+    if(!s_system_clk_in.posedge()) {
+      // Woken up between clock edges. Revert to static sensitivity (clock)
+      // and process the change on the next clock edge, like we would have
+      // done if we had not been sleeping.
+      next_trigger();
+      return;
+    }
+
+    uint64_t skipped_cycles = (sc_time_stamp().value() - mLastClockCycleTime) / mClockPeriod - 1;
+    mBunchCounter = (mBunchCounter + skipped_cycles) % LHC_ORBIT_BUNCH_COUNT;
+    mClockCycleCount += skipped_cycles;
+    mSleeping = false;
+  } else if(mClockSkippingEnable && getChipIdle<FLAVOR>()) {
+    // Nothing would change on the outputs this clock cycle, skip it
+    // and sleep until something happens.
+    mSleeping = true;
+    next_trigger(mWakeUpEvents);
+    return;
+  }
+
+  mLastClockCycleTime = sc_time_stamp().value();
+  mClockCycleCount++;
+
   strobeInput();
-  frameReadout();
-  dataTransmission();
-  updateBusyStatus();
+  if(mHybridEnable)
+    updateHybridModel();
+  if(mFrameModelEnable)
+    frameReadoutFast();
+  else
+    frameReadout();
+  dataTransmission<FLAVOR, DTU_DELAY>();
+  updateBusyStatus<FLAVOR>();
+}
+
+
+void Alpide::mainMethodIB(void)
+{
+  PROFILE_PROCESS("Alpide::mainMethodIB");
+  mainMethod<ALPIDE_IB, false>();
+}
+
+
+void Alpide::mainMethodIBDtuDelay(void)
+{
+  PROFILE_PROCESS("Alpide::mainMethodIBDtuDelay");
+  mainMethod<ALPIDE_IB, true>();
+}
+
+
+void Alpide::mainMethodObMaster(void)
+{
+  PROFILE_PROCESS("Alpide::mainMethodObMaster");
+  mainMethod<ALPIDE_OB_MASTER, false>();
+}
+
+
+void Alpide::mainMethodObMasterDtuDelay(void)
+{
+  PROFILE_PROCESS("Alpide::mainMethodObMasterDtuDelay");
+  mainMethod<ALPIDE_OB_MASTER, true>();
+}
+
+
+///@brief OB slaves do not transmit data themselves, so the DTU delay is not used
+void Alpide::mainMethodObSlave(void)
+{
+  PROFILE_PROCESS("Alpide::mainMethodObSlave");
+  mainMethod<ALPIDE_OB_SLAVE, false>();
+}
+
+
+///@brief Check if the chip is idle, ie. processing a clock cycle would not change
+///       anything other than the bunch counter. This is the case when there is no strobe,
+///       no events in the MEBs or frame FIFOs, nothing to transmit, the data output has
+///       been IDLE for as long as the DTU delay, and the chip is not busy.
+///       Should be called at the start of a clock cycle, before the state is updated.
+///@return True if chip is idle
+template <AlpideFlavor FLAVOR>
+bool Alpide::getChipIdle(void)
+{
+  if(mStrobeActive || s_strobe_n.read() == false)
+    return false;
+
+  if(getNumEvents() > 0 || s_fromu_readout_state.read() != WAIT_FOR_EVENTS)
+    return false;
+
+  if(!mFrameModelFrames.empty() || mFrameModelTruState != FRAME_MODEL_TRU_IDLE)
+    return false;
+
+  if(s_frame_start_fifo.nb_can_get() || s_frame_end_fifo.nb_can_get())
+    return false;
+
+  if(s_dmu_fifo.num_available() > 0 || s_busy_fifo.num_available() > 0)
+    return false;
+
+  if(s_busy_status || s_frame_fifo_busy || s_multi_event_buffers_busy ||
+     s_readout_abort || s_fatal_state || mBusyCycleCount > 0)
+    return false;
+
+  if(FLAVOR == ALPIDE_OB_SLAVE)
+    return true; // OB slaves do not transmit any data themselves
+
+  // Wait until the DTU delay FIFO is filled with the same (IDLE) data
+  if(mDtuStableCycles <= (unsigned int)(s_dtu_delay_fifo.num_available() + s_dtu_delay_fifo.num_free()))
+    return false;
+
+  if(FLAVOR == ALPIDE_OB_MASTER) {
+    if(mObDwBytesRemaining > 0)
+      return false;
+
+    for(unsigned int i = 0; i < mObSlaveCount; i++) {
+      if(s_local_bus_data_in[i]->num_available() > 0 || s_local_busy_in[i].read())
+        return false;
+    }
+  }
+
+  return true;
 }
 
 
@@ -207,6 +425,8 @@ ControlResponsePayload Alpide::processCommand(ControlRequestPayload const &reque
 ///       There is not automatic trigger/strobe synthesizer implemented here.
 void Alpide::triggerMethod(void)
 {
+  PROFILE_PROCESS("Alpide::triggerMethod");
+
   uint64_t time_now = sc_time_stamp().value();
 
   mTriggersReceived++;
@@ -241,6 +461,8 @@ void Alpide::triggerMethod(void)
 
 void Alpide::strobeDurationMethod(void)
 {
+  PROFILE_PROCESS("Alpide::strobeDurationMethod");
+
   if(s_strobe_n.read() == true) {
     // Strobe was inactive - start of strobing interval
     s_strobe_n = false;
@@ -354,8 +576,17 @@ void Alpide::strobeInput(void)
   // Make sure we can't trigger first on the wrong end of strobe by checking chip_ready signal
   else if(s_strobe_n.read() == true && mStrobeActive == true) {
     // Latch event/pixels if chip was ready, ie. there was a free MEB for this strobe
+    // With parallel evaluation the hits are latched later in this clock cycle,
+    // see latchDeferredHits()
     if(s_chip_ready_internal) {
-      this->getEventFrame(mStrobeStartTime, time_now, mEventIdCount).feedHitsToPixelMatrix(*this);
+      if(mParallelEvaluator) {
+        mDeferredLatchPending = true;
+        mDeferredLatchStartTime = mStrobeStartTime;
+        mDeferredLatchEndTime = time_now;
+        mParallelEvaluator->addPendingChip(this);
+      } else {
+        feedHitsToPixelMatrix(*this, mStrobeStartTime, time_now);
+      }
       mEventIdCount++;
     }
 
@@ -377,8 +608,8 @@ void Alpide::strobeInput(void)
     // (ie go out of data overrun mode) when the frame fifo has been cleared.
     if(frame_start_fifo_empty && frame_end_fifo_empty) {
       if(s_readout_abort == true) {
-        std::cout << "@ " << time_now << " ns:\t" << "Alpide global chip ID: " << mGlobalChipId;
-        std::cout << " exited data overrun mode." << std::endl;
+        LOG(LOG_INFO, LOG_MODULE_ALPIDE) << "@ " << time_now << " ns:\t" << "Alpide global chip ID: "
+                                         << mGlobalChipId << " exited data overrun mode.";
       }
 
       s_frame_fifo_busy = false;
@@ -389,8 +620,8 @@ void Alpide::strobeInput(void)
       s_readout_abort = true;
 
       if(s_fatal_state == false) {
-        std::cout << "@ " << time_now << " ns:\t" << "Alpide global chip ID: " << mGlobalChipId;
-        std::cout << " entered fatal mode." << std::endl;
+        LOG(LOG_WARNING, LOG_MODULE_ALPIDE) << "@ " << time_now << " ns:\t" << "Alpide global chip ID: "
+                                            << mGlobalChipId << " entered fatal mode.";
       }
 
       ///@todo The FATAL overflow bit/signal has to be cleared by a RORST/GRST command
@@ -401,8 +632,8 @@ void Alpide::strobeInput(void)
       ///@todo Need to clear RRU FIFOs, and MEBs when entering this state
 
       if(s_readout_abort == false) {
-        std::cout << "@ " << time_now << " ns:\t" << "Alpide global chip ID: " << mGlobalChipId;
-        std::cout << " entered data overrun mode." << std::endl;
+        LOG(LOG_INFO, LOG_MODULE_ALPIDE) << "@ " << time_now << " ns:\t" << "Alpide global chip ID: "
+                                         << mGlobalChipId << " entered data overrun mode.";
       }
 
       s_frame_fifo_busy = true;
@@ -452,11 +683,21 @@ void Alpide::frameReadout(void)
 
     // If there is only 1 MEB in use, but strobe is still active,
     // then this event is not ready to be read out yet.
-    if(MEBs_in_use > 1 || (MEBs_in_use == 1 && mStrobeActive == false))
+    if(MEBs_in_use > 1 || (MEBs_in_use == 1 && mStrobeActive == false)) {
       s_fromu_readout_state = REGION_READOUT_START;
+
+      if(mFrameModelValidation)
+        mFrameModelValidationStartCycle = mClockCycleCount;
+    }
     break;
 
   case REGION_READOUT_START:
+    // The RRUs have not started reading out the event yet, and its hits have been
+    // latched also when they were deferred to the parallel evaluator
+    if(mFrameModelValidation)
+      mFrameModelValidationPredictedCycles =
+        mFrameModel.getReadoutCycles(getMaxRegionHitsInOldestEvent());
+
     s_frame_readout_start = true;
     s_frame_readout_done_all = false;
     s_fromu_readout_state = WAIT_FOR_REGION_READOUT;
@@ -494,6 +735,11 @@ void Alpide::frameReadout(void)
 
     s_frame_end_fifo.nb_put(mNextFrameEndWord);
 
+    // Frames that were aborted in data overrun mode are not compared with the frame model
+    if(mFrameModelValidation && !s_readout_abort)
+      mFrameModelDeviation.add(mClockCycleCount - mFrameModelValidationStartCycle,
+                               mFrameModelValidationPredictedCycles);
+
     // Delete the event/frame in matrix/multi-event-buffer that has just been read out
     deleteEvent(time_now);
     s_fromu_readout_state = WAIT_FOR_EVENTS;
@@ -509,6 +755,245 @@ void Alpide::frameReadout(void)
 }
 
 
+///@brief Frame level replacement for frameReadout() and the RRUs, used when the frame model
+///       is enabled. When the FROMU starts reading out an event, the whole frame is read out
+///       of the MEB at once by AlpideFrameModel, which gives the data words in the frame and
+///       the readout duration. The frame end word is added to the frame end FIFO, and the
+///       event is deleted from the MEB, when the readout duration has passed. The data words
+///       are written to the DMU FIFO by topReadoutFast().
+void Alpide::frameReadoutFast(void)
+{
+  uint64_t time_now = sc_time_stamp().value();
+  int MEBs_in_use = getNumEvents();
+
+  // Bunch counter wraps around each orbit
+  mBunchCounter++;
+  if(mBunchCounter == LHC_ORBIT_BUNCH_COUNT)
+    mBunchCounter = 0;
+
+  // Update signal with number of event buffers
+  s_event_buffers_used_debug = MEBs_in_use;
+
+  switch(s_fromu_readout_state.read()) {
+  case WAIT_FOR_EVENTS:
+    // If there is only 1 MEB in use, but strobe is still active,
+    // then this event is not ready to be read out yet.
+    // New frames are not started while waiting to switch to cycle accurate in hybrid mode
+    if((MEBs_in_use > 1 || (MEBs_in_use == 1 && mStrobeActive == false)) && !mHybridSwitchPending) {
+      mFrameModelFrames.emplace_back();
+
+      // The event is discarded without reading it out in data overrun mode.
+      // If the hits for the event have not been latched yet, the frame is read out by
+      // commitDeferredHits() later in this clock cycle. Its frame start word is not
+      // available to topReadoutFast() before the next clock cycle anyway.
+      if(s_readout_abort) {
+        mFrameModelReadoutDoneCycle = mClockCycleCount;
+      } else if(mDeferredLatchPending && MEBs_in_use == 1) {
+        mFrameModelReadoutDeferred = true;
+        mFrameModelReadoutDeferredTime = time_now;
+      } else {
+        mFrameModelReadoutDoneCycle = mClockCycleCount +
+          mFrameModel.readoutFrame(*this, mClockCycleCount, time_now, mFrameModelFrames.back());
+      }
+
+      s_fromu_readout_state = WAIT_FOR_REGION_READOUT;
+    }
+    break;
+
+  case WAIT_FOR_REGION_READOUT:
+    if(s_readout_abort || mClockCycleCount >= mFrameModelReadoutDoneCycle) {
+      if(!s_readout_abort) {
+        mNextFrameEndWord.flushed_incomplete = s_flushed_incomplete;
+
+        ///@todo Strobe extended not implemented yet
+        mNextFrameEndWord.strobe_extended = false;
+        mNextFrameEndWord.busy_transition = false;
+      }
+
+      s_flushed_incomplete = false;
+      s_frame_end_fifo.nb_put(mNextFrameEndWord);
+
+      // Delete the event/frame in matrix/multi-event-buffer that has just been read out
+      deleteEvent(time_now);
+      s_fromu_readout_state = WAIT_FOR_EVENTS;
+    }
+    break;
+
+  default:
+    s_fromu_readout_state = WAIT_FOR_EVENTS;
+    break;
+  }
+
+  topReadoutFast();
+}
+
+
+///@brief Frame level replacement for the TRU. Writes the chip header, the data words from
+///       the frame model and the chip trailer (or a chip empty frame) to the DMU FIFO, at
+///       most one word per clock cycle, using the frame start and end FIFOs like the TRU.
+///       Data words are not written before the clock cycle they would have been available
+///       to the TRU in the cycle accurate model.
+void Alpide::topReadoutFast(void)
+{
+  // Same condition for writing to the DMU FIFO as in the TRU
+  if(s_dmu_fifo.num_free() <= 1)
+    return;
+
+  FrameStartFifoWord frame_start_word;
+  FrameEndFifoWord frame_end_word;
+  AlpideDataWord data_out;
+
+  switch(mFrameModelTruState) {
+  case FRAME_MODEL_TRU_IDLE:
+    if(!s_frame_start_fifo.nb_peek(frame_start_word))
+      return;
+
+    if(frame_start_word.busy_violation) {
+      // Only chip header and trailer for busy violations
+      data_out = AlpideChipHeader(mLocalChipId, frame_start_word);
+      mFrameModelTruState = FRAME_MODEL_TRU_BUSY_VIOLATION;
+    } else if(mFrameModelFrames.empty()) {
+      return; // Readout of the frame has not started yet
+    } else if(mFrameModelFrames.front().empty() && !s_readout_abort) {
+      // Wait for the readout to finish before sending out an empty frame
+      if(!s_frame_end_fifo.nb_get(frame_end_word))
+        return;
+
+      s_frame_start_fifo.nb_get(frame_start_word);
+      data_out = AlpideChipEmptyFrame(mLocalChipId, frame_start_word);
+      mFrameModelFrames.pop_front();
+    } else {
+      data_out = AlpideChipHeader(mLocalChipId, frame_start_word);
+      mFrameModelTruState = FRAME_MODEL_TRU_DATA;
+    }
+    break;
+
+  case FRAME_MODEL_TRU_BUSY_VIOLATION:
+  {
+    FrameEndFifoWord busyv_frame_end_word = {false, false, false};
+
+    s_frame_start_fifo.nb_get(frame_start_word);
+    data_out = AlpideChipTrailer(frame_start_word, busyv_frame_end_word,
+                                 s_fatal_state, s_readout_abort);
+    mFrameModelTruState = FRAME_MODEL_TRU_IDLE;
+    break;
+  }
+
+  case FRAME_MODEL_TRU_DATA:
+  {
+    std::deque<FrameModelWord>& frame_words = mFrameModelFrames.front();
+
+    // Data that has not been sent out yet is discarded in data overrun mode
+    if(s_readout_abort) {
+      for(auto it = frame_words.begin(); it != frame_words.end(); it++)
+        it->data_word.releasePixelRefs(false);
+      frame_words.clear();
+    }
+
+    if(!frame_words.empty()) {
+      if(frame_words.front().ready_cycle > mClockCycleCount)
+        return;
+
+      data_out = frame_words.front().data_word;
+      frame_words.pop_front();
+
+#ifdef PIXEL_DEBUG
+      if(data_out.data_type == ALPIDE_DATA_SHORT ||
+         data_out.data_type == ALPIDE_DATA_LONG) {
+        for(auto pix_it = data_out.pixel_refs->mPixels.begin();
+            pix_it != data_out.pixel_refs->mPixels.end();
+            pix_it++)
+        {
+          (*pix_it)->mTRU = true;
+          (*pix_it)->mTRUTime = sc_time_stamp().value();
+        }
+      }
+#endif
+    } else {
+      // Wait for the readout to finish before sending out the trailer
+      if(!s_frame_end_fifo.nb_get(frame_end_word))
+        return;
+
+      s_frame_start_fifo.nb_get(frame_start_word);
+      data_out = AlpideChipTrailer(frame_start_word, frame_end_word,
+                                   s_fatal_state, s_readout_abort);
+      mFrameModelFrames.pop_front();
+      mFrameModelTruState = FRAME_MODEL_TRU_IDLE;
+    }
+    break;
+  }
+  }
+
+  // The pixels in a data word that was dropped because the DMU FIFO was full
+  // were not read out
+  if(!s_dmu_fifo.nb_write(data_out))
+    data_out.releasePixelRefs(false);
+
+  (*mDataWordCount)[data_out.data_type]++;
+}
+
+
+///@brief Latch the pixel hits for the strobe that ended on the last rising clock edge into
+///       the newest MEB. Called by the parallel evaluator on the falling clock edge, from
+///       one of its worker threads, so it must only touch data that belongs to this chip.
+void Alpide::latchDeferredHits(void)
+{
+  feedHitsToPixelMatrix(*this, mDeferredLatchStartTime, mDeferredLatchEndTime);
+}
+
+
+///@brief Finish the clock cycle after the deferred hits have been latched. Called by the
+///       parallel evaluator from the SystemC thread, for one chip at a time.
+void Alpide::commitDeferredHits(void)
+{
+  mDeferredLatchPending = false;
+
+  if(mFrameModelReadoutDeferred) {
+    mFrameModelReadoutDeferred = false;
+    mFrameModelReadoutDoneCycle = mClockCycleCount +
+      mFrameModel.readoutFrame(*this, mClockCycleCount, mFrameModelReadoutDeferredTime,
+                               mFrameModelFrames.back());
+  }
+}
+
+
+///@brief Switch between the frame level model and the cycle accurate readout in hybrid mode.
+///       The chip switches to the cycle accurate readout when the number of MEBs in use or
+///       frames in the frame FIFO reaches the thresholds, and back to the frame level model
+///       when both are below the thresholds again. The switch is done on a frame boundary,
+///       when neither model is reading out or transmitting a frame. While waiting to switch
+///       to cycle accurate, the frame level model does not start on new frames.
+void Alpide::updateHybridModel(void)
+{
+  bool occupancy_high = getNumEvents() >= (int)mHybridMebThreshold ||
+                        s_frame_start_fifo.used() >= (int)mHybridFrameFifoThreshold;
+
+  mHybridSwitchPending = (occupancy_high == mFrameModelEnable);
+
+  if(!mHybridSwitchPending || s_fromu_readout_state.read() != WAIT_FOR_EVENTS)
+    return;
+
+  if(mFrameModelEnable) {
+    if(!mFrameModelFrames.empty() || mFrameModelTruState != FRAME_MODEL_TRU_IDLE)
+      return;
+
+    mHybridFrameModelCycles += mClockCycleCount - mHybridModelStartCycle;
+    mHybridSwitchesToCycleAccurate++;
+  } else {
+    if(s_frame_start_fifo.nb_can_get() || !mTRU->getIdle())
+      return;
+
+    mHybridCycleAccurateCycles += mClockCycleCount - mHybridModelStartCycle;
+    mHybridSwitchesToFrameModel++;
+  }
+
+  mHybridModelStartCycle = mClockCycleCount;
+  mFrameModelEnable = !mFrameModelEnable;
+  mTRU->setEnable(!mFrameModelEnable);
+  mHybridSwitchPending = false;
+}
+
+
 ///@brief Read out data from Data Management Unit (DMU) FIFO, feed data through
 ///       Data Transfer Unit (DTU) FIFO, and output data on "serial" line.
 ///       Data is not actually serialized here, it is transmitted as 24-bit words.
@@ -521,6 +1006,9 @@ void Alpide::frameReadout(void)
 ///       cycles that the DTU in the Alpide chip adds to data transmission.
 ///
 ///       Should be called one time per clock cycle.
+///       FLAVOR and DTU_DELAY are compile time constants, so only the code for the chip's
+///       flavor is left in each specialization of this function.
+template <AlpideFlavor FLAVOR, bool DTU_DELAY>
 void Alpide::dataTransmission(void)
 {
   uint64_t time_now = sc_time_stamp().value();
@@ -531,7 +1019,7 @@ void Alpide::dataTransmission(void)
 
 
 
-  if(mObMode && !mObMaster) {
+  if(FLAVOR == ALPIDE_OB_SLAVE) {
     return; // Outer barrel slave does not transmit data
   }
 
@@ -544,7 +1032,7 @@ void Alpide::dataTransmission(void)
   // -------------------
   // Outer barrel master
   // -------------------
-  if(mObMode && mObMaster) {
+  if(FLAVOR == ALPIDE_OB_MASTER) {
 
     // Prioritize busy words over data words, but don't break up data words
     if((s_busy_fifo.num_available() > 0) && mObDwBytesRemaining == 0) {
@@ -604,24 +1092,20 @@ void Alpide::dataTransmission(void)
           // which trigger ID the data belongs to. Delay with DTU cycles
           // so that it comes out at the same time as the corresponding data
           mDataOutTrigId = mObDataWord.trigger_id;
-        } else if(mObDataWord.data_type == ALPIDE_DATA_SHORT) {
-          // When DATA_SHORT/LONG are finally put out on the DTU FIFO, we can be sure that
-          // the pixels in the data word was read out, and can increase readout counters.
-          ///@todo Use dynamic cast here?
-          static_cast<AlpideDataShort*>(&mObDataWord)->increasePixelReadoutCount();
-#ifdef PIXEL_DEBUG
-          mObDataWord.mPixel->mAlpideDataOut = true;
-          mObDataWord.mPixel->mAlpideDataOutTime = time_now;
-#endif
-        } else if(mObDataWord.data_type == ALPIDE_DATA_LONG) {
-          ///@todo Use dynamic cast here?
-          static_cast<AlpideDataLong*>(&mObDataWord)->increasePixelReadoutCount();
+        } else if(mObDataWord.data_type == ALPIDE_DATA_SHORT ||
+                  mObDataWord.data_type == ALPIDE_DATA_LONG) {
 #ifdef PIXEL_DEBUG
-          for(auto pix_it = mObDataWord.mPixels.begin(); pix_it != mObDataWord.mPixels.end(); pix_it++) {
+          for(auto pix_it = mObDataWord.pixel_refs->mPixels.begin();
+              pix_it != mObDataWord.pixel_refs->mPixels.end();
+              pix_it++)
+          {
             (*pix_it)->mAlpideDataOut = true;
             (*pix_it)->mAlpideDataOutTime = time_now;
           }
 #endif
+          // When DATA_SHORT/LONG are finally put out on the DTU FIFO, we can be sure that
+          // the pixels in the data word was read out, and can increase readout counters.
+          mObDataWord.releasePixelRefs(true);
         }
       }
 
@@ -640,7 +1124,7 @@ void Alpide::dataTransmission(void)
   // --------------------------
   // Inner barrel chip (master)
   // --------------------------
-  else if(mObMode == false) {
+  else if(FLAVOR == ALPIDE_IB) {
     AlpideDataWord data_word = AlpideIdle();
 
     // Prioritize busy words over data words
@@ -655,26 +1139,20 @@ void Alpide::dataTransmission(void)
       // Update trigger id signal used by AlpideDataParser to know
       // which trigger ID the data belongs to
       mDataOutTrigId = data_word.trigger_id;
-    } else if(data_word.data_type == ALPIDE_DATA_SHORT) {
-      // When DATA_SHORT/LONG are finally put out on the DTU FIFO, we can be sure that
-      // the pixels in the data word was read out, and can increase readout counters.
-      ///@todo Use dynamic cast here?
-      auto data_short = static_cast<AlpideDataShort*>(&data_word);
-      data_short->increasePixelReadoutCount();
-#ifdef PIXEL_DEBUG
-      data_short->mPixel->mAlpideDataOut = true;
-      data_short->mPixel->mAlpideDataOutTime = time_now;
-#endif
-    } else if(data_word.data_type == ALPIDE_DATA_LONG) {
-      ///@todo Use dynamic cast here?
-      auto data_long = static_cast<AlpideDataLong*>(&data_word);
-      data_long->increasePixelReadoutCount();
+    } else if(data_word.data_type == ALPIDE_DATA_SHORT ||
+              data_word.data_type == ALPIDE_DATA_LONG) {
 #ifdef PIXEL_DEBUG
-      for(auto pix_it = data_long->mPixels.begin(); pix_it != data_long->mPixels.end(); pix_it++) {
+      for(auto pix_it = data_word.pixel_refs->mPixels.begin();
+          pix_it != data_word.pixel_refs->mPixels.end();
+          pix_it++)
+      {
         (*pix_it)->mAlpideDataOut = true;
         (*pix_it)->mAlpideDataOutTime = time_now;
       }
 #endif
+      // When DATA_SHORT/LONG are finally put out on the DTU FIFO, we can be sure that
+      // the pixels in the data word was read out, and can increase readout counters.
+      data_word.releasePixelRefs(true);
     }
 
     dw_dtu_fifo_input = data_word.data[2] << 16 |
@@ -683,6 +1161,17 @@ void Alpide::dataTransmission(void)
   }
 
 
+  // Used to check when the data output has settled, for clock skipping
+  if(dw_dtu_fifo_input == mDtuLastInput && mDataOutTrigId == mDtuLastTrigId) {
+    if(mDtuStableCycles < DTU_STABLE_CYCLES_MAX)
+      mDtuStableCycles++;
+  } else {
+    mDtuStableCycles = 0;
+    mDtuLastInput = dw_dtu_fifo_input;
+    mDtuLastTrigId = mDataOutTrigId;
+  }
+
+
   // --------------------------
   // DTU encoding delay
   // --------------------------
@@ -690,7 +1179,7 @@ void Alpide::dataTransmission(void)
   // If delaying of data through DTU FIFO is enabled (to simulate encoding
   // delay in DTU), then read data from DTU FIFO output, or IDLE if FIFO is
   // empty.
-  if(mEnableDtuDelay) {
+  if(DTU_DELAY) {
     s_dtu_delay_fifo.nb_write(dw_dtu_fifo_input);
     if(s_dtu_delay_fifo.nb_read(dw_dtu_fifo_output) == false) {
       sc_uint<24> dw_idle_data = ((uint32_t) DW_IDLE << 16) |
@@ -720,15 +1209,14 @@ void Alpide::dataTransmission(void)
   // Send out 1 byte per 40MHz cycle in OB mode, 3 bytes in IB mode
   // Only the most significant byte is used in the FIFO in OB mode
   socket_dw.data.push_back(dw_dtu_fifo_output >> 16);
-  if(mObMode == false) {
+  if(FLAVOR == ALPIDE_IB) {
     socket_dw.data.push_back((dw_dtu_fifo_output >> 8) & 0xFF );
     socket_dw.data.push_back(dw_dtu_fifo_output & 0xFF);
   }
 
-  // Only output data to socket for IB chips and OB master chips
+  // Only IB chips and OB master chips get here.
   // Socket not used by OB slave chips, and can be left unbound
-  if(!mObMode || (mObMode && mObMaster))
-    s_data_output->put(socket_dw);
+  s_data_output->put(socket_dw);
 
   // Debug signal of DTU FIFO input just for adding to VCD trace
   s_serial_data_dtu_input_debug = dw_dtu_fifo_input;
@@ -752,6 +1240,7 @@ bool Alpide::getFrameReadoutDone(void)
 
 
 ///@brief Update internal busy status signals
+template <AlpideFlavor FLAVOR>
 void Alpide::updateBusyStatus(void)
 {
   if(mChipContinuousMode) {
@@ -772,7 +1261,7 @@ void Alpide::updateBusyStatus(void)
 
   // For OB masters: Also check the slave chips' busy lines,
   // and assert the busy status if any of the slaves are busy
-  if(mObMode && mObMaster) {
+  if(FLAVOR == ALPIDE_OB_MASTER) {
     // Check busy status of slave chips in OB
     for(auto busy_it = s_local_busy_in.begin(); busy_it != s_local_busy_in.end(); busy_it++)
       slave_busy_status = slave_busy_status || busy_it->read();
@@ -805,6 +1294,8 @@ void Alpide::updateBusyStatus(void)
 
 void Alpide::busyFifoMethod(void)
 {
+  PROFILE_PROCESS("Alpide::busyFifoMethod");
+
   AlpideDataWord dw_busy;
 
   if(s_busy_status) {
@@ -874,9 +1365,11 @@ void Alpide::addTraces(sc_trace_file *wf, std::string name_prefix) const
   addTrace(wf, alpide_name_prefix, "busy_violation_count", mBusyViolations);
   addTrace(wf, alpide_name_prefix, "flushed_incomplete_count", mFlushedIncompleteCount);
 
-  mTRU->addTraces(wf, alpide_name_prefix);
+  // The RRUs and TRU are not created when the frame level model is used
+  if(mTRU != nullptr)
+    mTRU->addTraces(wf, alpide_name_prefix);
 
-  for(int i = 0; i < N_REGIONS; i++)
+  for(unsigned int i = 0; i < mRRUs.size(); i++)
     mRRUs[i]->addTraces(wf, alpide_name_prefix);
 
 }
@@ -13,6 +13,7 @@
 
 #include "AlpideConfig.hpp"
 #include "AlpideDataWord.hpp"
+#include "AlpideFrameModel.hpp"
 #include "AlpideInterface.hpp"
 #include "PixelMatrix.hpp"
 #include "PixelFrontEnd.hpp"
@@ -28,8 +29,21 @@
 
 #include <vector>
 #include <list>
+#include <deque>
 #include <string>
 
+class ParallelChipEvaluator;
+
+
+///@brief Chip flavors. The code that runs every clock cycle in the Alpide class is
+///       specialized for each flavor at compile time, and the stave/module builders
+///       select the flavor when they create the chips.
+enum AlpideFlavor {
+  ALPIDE_IB = 0,        ///< Inner barrel chip, transmits its own data at 1200 Mbps
+  ALPIDE_OB_MASTER = 1, ///< Outer barrel master, transmits data for itself and its slaves
+  ALPIDE_OB_SLAVE = 2   ///< Outer barrel slave, data and busy are forwarded by the master
+};
+
 
 /// Alpide main class. Currently it only implements the MEBs,
 /// no RRU FIFOs, and no TRU FIFO. It will be used to run some initial
@@ -118,7 +132,9 @@ private:
   sc_signal<sc_uint<24>> s_serial_data_out;
   sc_signal<uint64_t>    s_serial_data_trig_id;
 
-  ///@brief FIFO used to represent the encoding delay in the DTU
+  ///@brief FIFO used to represent the encoding delay in the DTU.
+  ///       The DTU FIFOs and the busy FIFO are not used by OB slaves, which create
+  ///       them with the minimum size.
   sc_fifo<sc_uint<24>> s_dtu_delay_fifo;
 
   ///@brief FIFO used to delay trigger output signal s_serial_data_trig_id_exp
@@ -140,8 +156,9 @@ private:
   tlm::tlm_fifo<FrameStartFifoWord> s_frame_start_fifo;
   tlm::tlm_fifo<FrameEndFifoWord> s_frame_end_fifo;
 
+  ///@brief Region and Top Readout Units. Not created when only the frame level model is used.
   std::vector<RegionReadoutUnit*> mRRUs;
-  TopReadoutUnit* mTRU;
+  TopReadoutUnit* mTRU = nullptr;
 
   FrameEndFifoWord mNextFrameEndWord;
 
@@ -152,6 +169,13 @@ private:
     REGION_READOUT_DONE = 3
   };
 
+  ///@brief States for the TRU emulation in the frame level model
+  enum FrameModelTruState {
+    FRAME_MODEL_TRU_IDLE = 0,
+    FRAME_MODEL_TRU_DATA = 1,
+    FRAME_MODEL_TRU_BUSY_VIOLATION = 2
+  };
+
 private:
   int mGlobalChipId;
   int mLocalChipId;
@@ -168,8 +192,7 @@ private:
   uint64_t mStrobeStartTime;
   uint16_t mMinBusyCycles;
 
-  bool mObMode;
-  bool mObMaster;
+  const AlpideFlavor mFlavor;
 
   ///@brief Number of slave chips connected to outer barrel master
   const unsigned int mObSlaveCount;
@@ -233,26 +256,128 @@ private:
   ///@brief Counts of how many data words of each type has been transmitted
   std::shared_ptr<std::map<AlpideDataType, uint64_t>> mDataWordCount;
 
+  ///@brief Allow mainMethod() to skip clock cycles (sleep) while the chip is idle
+  bool mClockSkippingEnable;
+
+  ///@brief True while mainMethod() is sleeping
+  bool mSleeping = false;
+
+  ///@brief Clock period, used to count the clock cycles that were skipped while sleeping.
+  ///       Zero if the clock input is not an sc_clock (clock skipping is disabled then).
+  uint64_t mClockPeriod = 0;
+
+  ///@brief Simulation time of the last clock cycle that mainMethod() processed
+  uint64_t mLastClockCycleTime = 0;
+
+  ///@brief Number of consecutive clock cycles where the input to the DTU delay FIFO
+  ///       (and the trigger ID) did not change. When it reaches the DTU delay, the data
+  ///       output is guaranteed to stay the same as long as the chip is idle.
+  unsigned int mDtuStableCycles = 0;
+  sc_uint<24> mDtuLastInput = 0;
+  uint64_t mDtuLastTrigId = 0;
+
+  ///@brief Events that wake mainMethod() up when it is sleeping
+  sc_event_or_list mWakeUpEvents;
+
+  ///@brief Number of clock cycles since the start of the simulation, including the
+  ///       cycles that were skipped while sleeping
+  uint64_t mClockCycleCount = 0;
+
+  ///@brief Frame level model, used instead of the RRUs and TRU when mFrameModelEnable is
+  ///       set, and to predict the readout duration when mFrameModelValidation is set.
+  AlpideFrameModel mFrameModel;
+  bool mFrameModelEnable;
+  bool mFrameModelValidation;
+
+  ///@brief Data words for the frames that are being read out or waiting for the TRU,
+  ///       in the frame level model. An empty deque is an empty frame.
+  std::deque<std::deque<FrameModelWord>> mFrameModelFrames;
+
+  ///@brief Clock cycle when the frame that is being read out by the FROMU is done
+  uint64_t mFrameModelReadoutDoneCycle = 0;
+
+  FrameModelTruState mFrameModelTruState = FRAME_MODEL_TRU_IDLE;
+
+  ///@brief Clock cycle and predicted duration for the frame readout in validation mode
+  uint64_t mFrameModelValidationStartCycle = 0;
+  uint64_t mFrameModelValidationPredictedCycles = 0;
+
+  FrameModelDeviation mFrameModelDeviation;
+
+  ///@brief Hybrid mode, where mFrameModelEnable is switched on and off depending on the
+  ///       MEB and frame FIFO occupancy. See updateHybridModel().
+  bool mHybridEnable;
+  unsigned int mHybridMebThreshold;
+  unsigned int mHybridFrameFifoThreshold;
+
+  ///@brief True while waiting for a frame boundary to switch model in hybrid mode
+  bool mHybridSwitchPending = false;
+
+  ///@brief Hybrid mode stats: number of switches between the models, and the number of
+  ///       clock cycles spent in each model before the current one started
+  uint64_t mHybridSwitchesToCycleAccurate = 0;
+  uint64_t mHybridSwitchesToFrameModel = 0;
+  uint64_t mHybridFrameModelCycles = 0;
+  uint64_t mHybridCycleAccurateCycles = 0;
+  uint64_t mHybridModelStartCycle = 0;
+
+  ///@brief Evaluator that latches the hits at the end of a strobe in parallel with the
+  ///       other chips, or nullptr if the hits are latched directly by strobeInput().
+  ///       The stimuli classes always create one.
+  ParallelChipEvaluator* mParallelEvaluator;
+
+  ///@brief True from the end of a strobe until the evaluator has latched the hits,
+  ///       with the strobe interval to latch hits for
+  bool mDeferredLatchPending = false;
+  uint64_t mDeferredLatchStartTime = 0;
+  uint64_t mDeferredLatchEndTime = 0;
+
+  ///@brief True when the frame level model started reading out an event that had not been
+  ///       latched yet. The frame is read out by commitDeferredHits(), with the time below.
+  bool mFrameModelReadoutDeferred = false;
+  uint64_t mFrameModelReadoutDeferredTime = 0;
+
   void newEvent(uint64_t event_time);
-  void mainMethod(void);
+
+  ///@brief Main method specialized for flavor and DTU delay. The non-template wrappers
+  ///       are registered as SystemC methods by the constructor (SC_METHOD does not
+  ///       accept template functions).
+  template <AlpideFlavor FLAVOR, bool DTU_DELAY> void mainMethod(void);
+  void mainMethodIB(void);
+  void mainMethodIBDtuDelay(void);
+  void mainMethodObMaster(void);
+  void mainMethodObMasterDtuDelay(void);
+  void mainMethodObSlave(void);
   void triggerMethod(void);
   void strobeDurationMethod(void);
   void busyFifoMethod(void);
 
   void strobeInput(void);
   void frameReadout(void); // FROMU
-  void dataTransmission(void);
-  void updateBusyStatus(void);
+  void frameReadoutFast(void); // FROMU, frame level model
+  void topReadoutFast(void); // TRU, frame level model
+  void updateHybridModel(void);
+  template <AlpideFlavor FLAVOR, bool DTU_DELAY> void dataTransmission(void);
+  template <AlpideFlavor FLAVOR> void updateBusyStatus(void);
   bool getFrameReadoutDone(void);
+  template <AlpideFlavor FLAVOR> bool getChipIdle(void);
+  void end_of_elaboration(void);
+  void end_of_simulation(void);
+  void latchDeferredHits(void);
+  void commitDeferredHits(void);
   ControlResponsePayload processCommand(ControlRequestPayload const &request);
 
+  friend class ParallelChipEvaluator;
+
 public:
   Alpide(sc_core::sc_module_name name, const int global_chip_id, const int local_chip_id,
-         const AlpideConfig& chip_cfg, bool outer_barrel_mode = false,
-         bool outer_barrel_master = false, int outer_barrel_slave_count = 0);
+         const AlpideConfig& chip_cfg, AlpideFlavor flavor = ALPIDE_IB,
+         int outer_barrel_slave_count = 0);
   int getGlobalChipId(void) {return mGlobalChipId;}
+  AlpideFlavor getFlavor(void) const {return mFlavor;}
   int getLocalChipId(void) {return mLocalChipId;}
   void addTraces(sc_trace_file *wf, std::string name_prefix) const;
+  void releaseQueuedPixelRefs(void);
 
   uint64_t getTriggersReceivedCount(void) const {return mTriggersReceived;}
   uint64_t getTriggersAcceptedCount(void) const {return mTriggersAccepted;}
@@ -260,6 +385,18 @@ public:
   uint64_t getBusyCount(void) const {return mBusyTransitions;}
   uint64_t getBusyViolationCount(void) const {return mBusyViolations;}
   uint64_t getFlushedIncompleteCount(void) const {return mFlushedIncompleteCount;}
+  bool getFrameModelEnable(void) const {return mFrameModelEnable;}
+  bool getFrameModelValidation(void) const {return mFrameModelValidation;}
+  const FrameModelDeviation& getFrameModelDeviation(void) const {return mFrameModelDeviation;}
+  bool getHybridEnable(void) const {return mHybridEnable;}
+  uint64_t getHybridSwitchesToCycleAccurate(void) const {return mHybridSwitchesToCycleAccurate;}
+  uint64_t getHybridSwitchesToFrameModel(void) const {return mHybridSwitchesToFrameModel;}
+  uint64_t getHybridFrameModelCycles(void) const {
+    return mHybridFrameModelCycles + (mFrameModelEnable ? mClockCycleCount - mHybridModelStartCycle : 0);
+  }
+  uint64_t getHybridCycleAccurateCycles(void) const {
+    return mHybridCycleAccurateCycles + (mFrameModelEnable ? 0 : mClockCycleCount - mHybridModelStartCycle);
+  }
   uint64_t getDataWordCount(AlpideDataType dw) const {
     if(mDataWordCount->find(dw) != mDataWordCount->end()) return (*mDataWordCount)[dw]; else return 0;
   }
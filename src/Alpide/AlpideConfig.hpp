@@ -34,6 +34,31 @@ struct AlpideConfig {
 
   ///@brief True for fast readout (2 clock cycles), false is slow (4 cycles).
   bool matrix_readout_speed;
+
+  ///@brief Let the chip skip clock cycles (sleep) while it is idle, and wake up
+  ///       when there is a strobe or data to process. Does not change the output.
+  bool clock_skipping;
+
+  ///@brief Use the frame level model (AlpideFrameModel) for the readout, instead of
+  ///       the cycle accurate Region Readout Units and Top Readout Unit
+  bool frame_model;
+
+  ///@brief Compare the readout duration in the cycle accurate model with the duration
+  ///       predicted by the frame level model. Not used when frame_model is set.
+  bool frame_model_validation;
+
+  ///@brief Hybrid mode: use the frame level model while the chip is far from busy, and
+  ///       switch to the cycle accurate readout when the MEB or frame FIFO occupancy
+  ///       reaches the thresholds below. Not used when frame_model is set.
+  bool hybrid_model;
+
+  ///@brief Number of MEBs in use that makes a chip in hybrid mode switch to the cycle
+  ///       accurate readout
+  unsigned int hybrid_meb_threshold;
+
+  ///@brief Number of frames in the frame FIFO that makes a chip in hybrid mode switch to
+  ///       the cycle accurate readout
+  unsigned int hybrid_frame_fifo_threshold;
 };
 
 
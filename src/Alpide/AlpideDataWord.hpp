@@ -16,6 +16,8 @@
 #include <cstdint>
 #include <ostream>
 #include <memory>
+#include <type_traits>
+#include <vector>
 
 // Ignore warnings about use of auto_ptr and unused parameters in SystemC library
 #pragma GCC diagnostic push
@@ -201,24 +203,33 @@ struct FrameEndFifoWord {
 };
 
 
+///@brief Side channel for the pixel hits in a DATA SHORT/LONG word. The PixelHit objects are
+///       only needed for pixel readout statistics (and PIXEL_DEBUG), so this is only allocated
+///       when the pixel hits have a PixelReadoutStats object. The data words only hold a
+///       pointer to it, so they can be copied through the FIFOs and signals as plain data.
+///       It is allocated by the region readout unit, and deleted by releasePixelRefs() when
+///       the data word is transmitted by the chip, flushed or dropped, or by
+///       Alpide::releaseQueuedPixelRefs() when the simulation ends.
+struct AlpidePixelRefs {
+  std::vector<PixelHitPtr> mPixels;
+};
+
+
 ///@brief The FIFOs in the Alpide chip are 24 bits, or 3 bytes, wide.
 ///       This is a base class for the data words that holds 3 bytes,
 ///       and is used as the data type in the SystemC FIFO templates.
 ///       This class shouldn't be used on its own, the various types
 ///       of data words are implemented in derived classes.
+///       The derived classes only have constructors, and do not add any members,
+///       so that they can be copied to AlpideDataWord without slicing anything.
 class AlpideDataWord
 {
-//protected:
 public:
-  // mPixel and mPixels is used by derived classes AlpideDataShort and AlpideDataLong
-  // It's kind of stupid to put them in the base class, but since the SystemC FIFOs in
-  // the Alpide code works on AlpideDataWord directly, some kind of virtual copy constructor
-  // would be necessary to correctly copy AlpideDataShort and AlpideDataLong.
-  // Easier to just put them here
-  std::shared_ptr<PixelHit> mPixel = nullptr;
-  std::vector<std::shared_ptr<PixelHit>> mPixels;
+  ///@brief Pixel hits for DATA SHORT/LONG words, or nullptr if the pixel hits don't
+  ///       have readout statistics. Copies of the data word share the same object, which
+  ///       is owned by the data word that is in the FIFOs.
+  AlpidePixelRefs* pixel_refs = nullptr;
 
-public:
   uint8_t data[3];
   AlpideDataType data_type;
   unsigned int size;
@@ -227,10 +238,13 @@ public:
   ///       Does not exist in the real Alpide data stream.
   uint64_t trigger_id;
 
+  ///@brief Also compares the pixel hit side channel, so that a signal carrying a copy of the
+  ///       data word is never left with a pointer to a side channel that was released
   inline bool operator==(const AlpideDataWord& rhs) const {
     return (this->data[0] == rhs.data[0] &&
             this->data[1] == rhs.data[1] &&
-            this->data[2] == rhs.data[2]);
+            this->data[2] == rhs.data[2] &&
+            this->pixel_refs == rhs.pixel_refs);
   }
 
   inline friend void sc_trace(sc_trace_file *tf, const AlpideDataWord& dw,
@@ -249,9 +263,27 @@ public:
     return stream;
   }
 
-  virtual ~AlpideDataWord() {}
+  ///@brief Delete the pixel hit side channel for this data word (if any). Call this when
+  ///       the data word leaves the chip, or is discarded, but only for one of the copies.
+  ///@param[in] read_out True if the data word was transmitted, and the readout count should
+  ///                    be increased for the pixel hits in the data word.
+  inline void releasePixelRefs(bool read_out) {
+    if(pixel_refs == nullptr)
+      return;
+
+    if(read_out) {
+      for(auto pix_it = pixel_refs->mPixels.begin(); pix_it != pixel_refs->mPixels.end(); pix_it++)
+        (*pix_it)->increaseReadoutCount();
+    }
+
+    delete pixel_refs;
+    pixel_refs = nullptr;
+  }
 };
 
+static_assert(std::is_trivially_copyable<AlpideDataWord>::value,
+              "AlpideDataWord should be trivially copyable");
+
 
 
 class AlpideIdle : public AlpideDataWord
@@ -392,18 +424,21 @@ public:
 class AlpideDataShort : public AlpideDataWord
 {
 public:
-  AlpideDataShort(uint8_t encoder_id, uint16_t addr, const std::shared_ptr<PixelHit> &pixel)
+  AlpideDataShort(uint8_t encoder_id, uint16_t addr, const PixelHitPtr &pixel)
     {
-      mPixel = pixel;
+#ifndef PIXEL_DEBUG
+      if(pixel->hasPixelReadoutStatsObj())
+#endif
+      {
+        pixel_refs = new AlpidePixelRefs();
+        pixel_refs->mPixels.push_back(pixel);
+      }
       data[2] = DW_DATA_SHORT | ((encoder_id & 0x0F) << 2) | ((addr >> 8) & 0x03);
       data[1] = addr & 0xFF;
       data[0] = DW_IDLE;
       data_type = ALPIDE_DATA_SHORT;
       size = DW_DATA_SHORT_SIZE;
     }
-  void increasePixelReadoutCount(void) {
-    mPixel->increaseReadoutCount();
-  }
 };
 
 
@@ -411,19 +446,22 @@ class AlpideDataLong : public AlpideDataWord
 {
 public:
   AlpideDataLong(uint8_t encoder_id, uint16_t addr, uint8_t hitmap,
-                 const std::vector<std::shared_ptr<PixelHit>> &pixel_vec)
+                 const std::vector<PixelHitPtr> &pixel_vec)
     {
-      mPixels = pixel_vec;
+      // All the pixel hits in the cluster come from the same event generator
+#ifndef PIXEL_DEBUG
+      if(pixel_vec.front()->hasPixelReadoutStatsObj())
+#endif
+      {
+        pixel_refs = new AlpidePixelRefs();
+        pixel_refs->mPixels = pixel_vec;
+      }
       data[2] = DW_DATA_LONG | ((encoder_id & 0x0F) << 2) | ((addr >> 8) & 0x03);
       data[1] = addr & 0xFF;
       data[0] = hitmap & 0x7F;
       data_type = ALPIDE_DATA_LONG;
       size = DW_DATA_LONG_SIZE;
     }
-  void increasePixelReadoutCount(void) {
-    for(auto pix_it = mPixels.begin(); pix_it != mPixels.end(); pix_it++)
-      (*pix_it)->increaseReadoutCount();
-  }
 };
 
 
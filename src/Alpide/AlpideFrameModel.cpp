@@ -0,0 +1,135 @@
+/**
+ * @file   AlpideFrameModel.cpp
+ * @author Simon Voigt Nesbo
+ * @date   October 16, 2026
+ * @brief  Frame level (transaction level) model of the Alpide readout.
+ *         See AlpideFrameModel.hpp for details.
+ */
+
+#include "AlpideFrameModel.hpp"
+#include <vector>
+
+
+///@brief Constructor for AlpideFrameModel
+///@param[in] matrix_readout_speed True for fast readout (2 clock cycles), false is slow.
+///@param[in] clustering_enabled Enable clustering and use of DATA LONG words
+AlpideFrameModel::AlpideFrameModel(bool matrix_readout_speed, bool clustering_enabled)
+  : mPixelReadoutCycles(matrix_readout_speed ? 2 : 3)
+  , mClusteringEnabled(clustering_enabled)
+{
+}
+
+
+///@brief Get the number of clock cycles from the FROMU starts reading out a frame until
+///       the frame is done and the event is deleted from the MEB.
+///@param[in] max_region_hits Number of pixel hits in the region with most hits in the frame
+///@return Readout duration in clock cycles
+uint64_t AlpideFrameModel::getReadoutCycles(unsigned int max_region_hits) const
+{
+  if(max_region_hits == 0)
+    return 7;
+  else
+    return 8 + mPixelReadoutCycles*(max_region_hits+1);
+}
+
+
+///@brief Read out all the pixel hits in the oldest event in the MEB, and create the data
+///       words for the frame in the same order and with the same clustering as the RRUs.
+///       A REGION HEADER is added before the data words of each region that has hits.
+///       The chip header and trailer are not included.
+///@param[in,out] matrix Pixel matrix to read out the oldest event from. The event
+///                      is not deleted, and the pixel hits are not counted as read out
+///                      until the data words are transmitted.
+///@param[in] start_cycle Clock cycle the frame readout started
+///@param[in] time_now Current simulation time
+///@param[out] words Data words in the frame are added here, with the clock cycle each word
+///                  is available to the TRU
+///@return Readout duration in clock cycles
+uint64_t AlpideFrameModel::readoutFrame(PixelMatrix& matrix, uint64_t start_cycle,
+                                        uint64_t time_now, std::deque<FrameModelWord>& words) const
+{
+  unsigned int max_region_hits = 0;
+
+  for(int region = 0; region < N_REGIONS; region++) {
+    if(matrix.regionEmpty(region))
+      continue;
+
+    // The region header is available at the same time as the first data word in the region
+    size_t region_header_index = words.size();
+    words.push_back({AlpideRegionHeader(region), 0});
+
+    uint64_t pixel_read_cycle = start_cycle + 3 + mPixelReadoutCycles;
+    unsigned int region_hits = 0;
+
+    bool cluster_started = false;
+    uint8_t encoder_id = 0;
+    uint16_t base_addr = 0;
+    uint8_t hitmap = 0;
+    std::vector<PixelHitPtr> cluster_vec;
+
+    while(true) {
+      PixelHitPtr p = matrix.readPixelRegion(region, time_now);
+
+      if(*p == NoPixelHit) {
+        if(cluster_started) {
+          if(hitmap == 0)
+            words.push_back({AlpideDataShort(encoder_id, base_addr, cluster_vec[0]),
+                             pixel_read_cycle+1});
+          else
+            words.push_back({AlpideDataLong(encoder_id, base_addr, hitmap, cluster_vec),
+                             pixel_read_cycle+1});
+        }
+        break;
+      }
+
+#ifdef PIXEL_DEBUG
+      p->mRRU = true;
+      p->mRRUTime = time_now;
+#endif
+
+      if(!mClusteringEnabled) {
+        words.push_back({AlpideDataShort(p->getPriEncNumInRegion(), p->getPriEncPixelAddress(), p),
+                         pixel_read_cycle+1});
+      } else if(cluster_started &&
+                p->getPriEncNumInRegion() == encoder_id &&
+                p->getPriEncPixelAddress() <= (base_addr+DATA_LONG_PIXMAP_SIZE)) {
+        unsigned int hitmap_pixel_num = (p->getPriEncPixelAddress() - base_addr) - 1;
+        hitmap |= 1 << hitmap_pixel_num;
+        cluster_vec.push_back(p);
+
+        if(hitmap_pixel_num == DATA_LONG_PIXMAP_SIZE-1) {
+          words.push_back({AlpideDataLong(encoder_id, base_addr, hitmap, cluster_vec),
+                           pixel_read_cycle+1});
+          cluster_started = false;
+        }
+      } else {
+        // Send out the previous cluster before starting a new one
+        if(cluster_started) {
+          if(hitmap == 0)
+            words.push_back({AlpideDataShort(encoder_id, base_addr, cluster_vec[0]),
+                             pixel_read_cycle+1});
+          else
+            words.push_back({AlpideDataLong(encoder_id, base_addr, hitmap, cluster_vec),
+                             pixel_read_cycle+1});
+        }
+
+        cluster_started = true;
+        encoder_id = p->getPriEncNumInRegion();
+        base_addr = p->getPriEncPixelAddress();
+        hitmap = 0;
+        cluster_vec.clear();
+        cluster_vec.push_back(p);
+      }
+
+      region_hits++;
+      pixel_read_cycle += mPixelReadoutCycles;
+    }
+
+    words[region_header_index].ready_cycle = words[region_header_index+1].ready_cycle;
+
+    if(region_hits > max_region_hits)
+      max_region_hits = region_hits;
+  }
+
+  return getReadoutCycles(max_region_hits);
+}
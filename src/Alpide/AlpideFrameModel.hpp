@@ -0,0 +1,85 @@
+/**
+ * @file   AlpideFrameModel.hpp
+ * @author Simon Voigt Nesbo
+ * @date   October 16, 2026
+ * @brief  Frame level (transaction level) model of the Alpide readout. Instead of running
+ *         the Region Readout Units (RRU) and Top Readout Unit (TRU) every clock cycle, a
+ *         whole frame is read out of the Multi Event Buffer (MEB) at once, and the data
+ *         words, the clock cycle each word would be available to the TRU, and the readout
+ *         duration are calculated from the MEB contents.
+ *
+ *         Readout timing, relative to the clock cycle the FROMU starts a frame readout,
+ *         with P = 2 (fast) or 3 (slow) clock cycles per pixel in the matrix readout:
+ *           - Pixel number j (0, 1, ..) in a region is read out at cycle 3 + P + P*j
+ *           - A DATA SHORT/LONG word is available one cycle after the pixel following the
+ *             cluster (or the last pixel of a full DATA LONG cluster) was read out
+ *           - The frame is done (MEB deleted and frame end word pushed) after 7 cycles for
+ *             an empty frame, and 8 + P*(N+1) cycles when the region with most pixel hits
+ *             has N hits
+ *
+ *         Back pressure from full region FIFOs, and the cycles spent by the TRU waiting
+ *         for region data, are not modelled. A frame that is flushed in continuous mode
+ *         while it is being read out is still sent out in full, since all its data words
+ *         are created when the readout starts. The validation mode in the Alpide class
+ *         compares the readout duration with the cycle accurate model.
+ */
+
+
+///@addtogroup alpide
+///@{
+#ifndef ALPIDE_FRAME_MODEL_HPP
+#define ALPIDE_FRAME_MODEL_HPP
+
+#include "AlpideDataWord.hpp"
+#include "PixelMatrix.hpp"
+#include <deque>
+#include <cstdint>
+
+
+///@brief Data word in a frame, with the clock cycle it is available to the TRU
+struct FrameModelWord {
+  AlpideDataWord data_word;
+  uint64_t ready_cycle;
+};
+
+
+///@brief Deviation between the readout duration in the cycle accurate model and the
+///       duration predicted by the frame model, accumulated over all frames of a chip
+struct FrameModelDeviation {
+  uint64_t frames = 0;
+  uint64_t readout_cycles_sum = 0;
+  uint64_t predicted_cycles_sum = 0;
+  uint64_t abs_deviation_sum = 0;
+  uint64_t abs_deviation_max = 0;
+
+  void add(uint64_t readout_cycles, uint64_t predicted_cycles) {
+    uint64_t abs_deviation = readout_cycles > predicted_cycles ?
+                             readout_cycles - predicted_cycles :
+                             predicted_cycles - readout_cycles;
+    frames++;
+    readout_cycles_sum += readout_cycles;
+    predicted_cycles_sum += predicted_cycles;
+    abs_deviation_sum += abs_deviation;
+    if(abs_deviation > abs_deviation_max)
+      abs_deviation_max = abs_deviation;
+  }
+};
+
+
+class AlpideFrameModel
+{
+  ///@brief Clock cycles per pixel in the matrix readout
+  unsigned int mPixelReadoutCycles;
+
+  bool mClusteringEnabled;
+
+public:
+  AlpideFrameModel(bool matrix_readout_speed, bool clustering_enabled);
+  uint64_t getReadoutCycles(unsigned int max_region_hits) const;
+  uint64_t readoutFrame(PixelMatrix& matrix, uint64_t start_cycle, uint64_t time_now,
+                        std::deque<FrameModelWord>& words) const;
+};
+
+
+#endif
+///@}
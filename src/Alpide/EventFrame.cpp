@@ -45,7 +45,7 @@ EventFrame::EventFrame(const EventFrame& e)
 }
 
 
-void EventFrame::addHit(const std::shared_ptr<PixelHit>& p)
+void EventFrame::addHit(const PixelHitPtr& p)
 {
   mHitSet.insert(p);
 }
@@ -34,12 +34,12 @@ private:
 
   int mEventId;
   int mChipId;
-  std::set<std::shared_ptr<PixelHit>> mHitSet;
+  std::set<PixelHitPtr> mHitSet;
 
 public:
   EventFrame(uint64_t event_start_time_ns, uint64_t event_end_time_ns, uint64_t event_id);
   EventFrame(const EventFrame& e);
-  void addHit(const std::shared_ptr<PixelHit>& p);
+  void addHit(const PixelHitPtr& p);
   void feedHitsToPixelMatrix(PixelMatrix &matrix) const;
   int getEventSize(void) const {return mHitSet.size();}
   int getEventId(void) const {return mEventId;}
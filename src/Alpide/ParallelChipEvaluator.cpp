@@ -0,0 +1,140 @@
+/**
+ * @file   ParallelChipEvaluator.cpp
+ * @author Simon Voigt Nesbo
+ * @date   October 16, 2026
+ * @brief  Evaluates the chip local work of the Alpide chips for a clock cycle on a pool
+ *         of worker threads. See ParallelChipEvaluator.hpp for details.
+ */
+
+#include "ParallelChipEvaluator.hpp"
+#include "Alpide.hpp"
+#include "../Profiling/ProcessProfiler.hpp"
+#include <stdexcept>
+
+
+ParallelChipEvaluator* ParallelChipEvaluator::sInstance = nullptr;
+
+
+SC_HAS_PROCESS(ParallelChipEvaluator);
+///@brief Constructor for ParallelChipEvaluator. Only one evaluator can exist at a time,
+///       the chips find it with getInstance() when they are created.
+///@param[in] name SystemC module name
+///@param[in] num_threads Number of threads to evaluate the chips with, including the
+///                       SystemC thread. With 0 or 1 the chips are evaluated by the
+///                       SystemC thread only, and no worker threads are started.
+///@throw runtime_error If an evaluator already exists
+ParallelChipEvaluator::ParallelChipEvaluator(sc_core::sc_module_name name,
+                                             unsigned int num_threads)
+  : sc_core::sc_module(name)
+  , mNextChip(0)
+{
+  if(sInstance != nullptr)
+    throw std::runtime_error("Only one parallel chip evaluator can be created.");
+
+  for(unsigned int i = 1; i < num_threads; i++)
+    mWorkers.emplace_back(&ParallelChipEvaluator::workerThread, this);
+
+  sInstance = this;
+
+  SC_METHOD(evaluateMethod);
+  sensitive_neg << s_system_clk_in;
+  dont_initialize();
+}
+
+
+ParallelChipEvaluator::~ParallelChipEvaluator()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStop = true;
+  }
+  mStartCond.notify_all();
+
+  for(auto it = mWorkers.begin(); it != mWorkers.end(); it++)
+    it->join();
+
+  sInstance = nullptr;
+}
+
+
+///@brief Latch the deferred pixel hits for the chips that registered on the rising clock
+///       edge, and commit the results in registration order.
+///@throw Rethrows the first exception thrown while latching the hits
+void ParallelChipEvaluator::evaluateMethod(void)
+{
+  PROFILE_PROCESS("ParallelChipEvaluator::evaluateMethod");
+
+  if(mPendingChips.empty())
+    return;
+
+  mNextChip = 0;
+
+  if(mWorkers.empty() || mPendingChips.size() < MIN_CHIPS_PER_DISPATCH) {
+    evaluatePendingChips();
+  } else {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mWorkersBusy = mWorkers.size();
+      mGeneration++;
+    }
+    mStartCond.notify_all();
+
+    evaluatePendingChips();
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDoneCond.wait(lock, [this]{return mWorkersBusy == 0;});
+  }
+
+  if(mWorkerException) {
+    std::exception_ptr e = mWorkerException;
+    mWorkerException = nullptr;
+    std::rethrow_exception(e);
+  }
+
+  for(auto it = mPendingChips.begin(); it != mPendingChips.end(); it++)
+    (*it)->commitDeferredHits();
+
+  mPendingChips.clear();
+}
+
+
+///@brief Latch the deferred hits for pending chips until there are none left.
+///       Called by the SystemC thread and the worker threads at the same time.
+void ParallelChipEvaluator::evaluatePendingChips(void)
+{
+  try {
+    size_t chip_index;
+    while((chip_index = mNextChip++) < mPendingChips.size())
+      mPendingChips[chip_index]->latchDeferredHits();
+  } catch(...) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if(!mWorkerException)
+      mWorkerException = std::current_exception();
+  }
+}
+
+
+void ParallelChipEvaluator::workerThread(void)
+{
+  uint64_t generation = 0;
+
+  while(true) {
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mStartCond.wait(lock, [&]{return mStop || mGeneration != generation;});
+
+      if(mStop)
+        return;
+
+      generation = mGeneration;
+    }
+
+    evaluatePendingChips();
+
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mWorkersBusy--;
+    }
+    mDoneCond.notify_one();
+  }
+}
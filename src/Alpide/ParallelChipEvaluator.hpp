@@ -0,0 +1,106 @@
+/**
+ * @file   ParallelChipEvaluator.hpp
+ * @author Simon Voigt Nesbo
+ * @date   October 16, 2026
+ * @brief  Evaluates the chip local work of the Alpide chips for a clock cycle on a pool
+ *         of worker threads.
+ *
+ *         The SystemC kernel runs the processes of all the chips one at a time, and the
+ *         signals, FIFOs and events used by those processes are not thread safe, so the
+ *         clock processes themselves can not run in parallel. Instead, the chips defer
+ *         the work that only touches their own data to this evaluator. Currently this is
+ *         latching the pixel hits from the front end into the MEB at the end of a strobe,
+ *         which is the most expensive step per event for chips with many hits.
+ *
+ *         On the rising clock edge, the chips register with addPendingChip(). On the
+ *         falling edge of the same clock cycle, evaluateMethod() latches the hits for all
+ *         pending chips in parallel, and then commits the results one chip at a time, in
+ *         the order the chips were registered (see Alpide::commitDeferredHits()). Since the
+ *         parallel part only touches chip local data, and the commit is done in a fixed
+ *         order, the results are the same for any number of threads. The evaluator is
+ *         also used without worker threads, so that the hits are latched at the same point
+ *         in the clock cycle whether the simulation is run with one thread or many.
+ *
+ *         Latching the hits does not release any PixelHit references (the front end still
+ *         holds the hits), so the worker threads do not use the PixelHitPool or the
+ *         PixelReadoutStats objects.
+ */
+
+
+///@addtogroup alpide
+///@{
+#ifndef PARALLEL_CHIP_EVALUATOR_HPP
+#define PARALLEL_CHIP_EVALUATOR_HPP
+
+// Ignore warnings about use of auto_ptr and unused parameters in SystemC library
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#include <systemc.h>
+#pragma GCC diagnostic pop
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Alpide;
+
+
+class ParallelChipEvaluator : public sc_core::sc_module
+{
+public:
+  ///@brief 40MHz LHC clock
+  sc_in_clk s_system_clk_in;
+
+private:
+  ///@brief Dispatching to the worker threads is not worth it for a few chips,
+  ///       they are evaluated by the SystemC thread instead
+  static const size_t MIN_CHIPS_PER_DISPATCH = 8;
+
+  static ParallelChipEvaluator* sInstance;
+
+  ///@brief Chips with deferred work in the current clock cycle, in registration order
+  std::vector<Alpide*> mPendingChips;
+
+  ///@brief Index of next chip in mPendingChips to evaluate
+  std::atomic<size_t> mNextChip;
+
+  ///@brief Worker threads. The SystemC thread also evaluates chips while it waits
+  ///       for the workers, so there is one less worker than the number of threads.
+  std::vector<std::thread> mWorkers;
+
+  std::mutex mMutex;
+  std::condition_variable mStartCond;
+  std::condition_variable mDoneCond;
+
+  ///@brief Incremented every time the workers are started
+  uint64_t mGeneration = 0;
+  unsigned int mWorkersBusy = 0;
+  bool mStop = false;
+
+  ///@brief First exception thrown by a worker thread, rethrown by evaluateMethod()
+  std::exception_ptr mWorkerException;
+
+  void evaluateMethod(void);
+  void evaluatePendingChips(void);
+  void workerThread(void);
+
+public:
+  ParallelChipEvaluator(sc_core::sc_module_name name, unsigned int num_threads);
+  ~ParallelChipEvaluator();
+  unsigned int getNumThreads(void) const {return mWorkers.size()+1;}
+
+  ///@brief Register a chip that has deferred work to do in this clock cycle.
+  ///       Must be called from the chip's clock process, on the rising clock edge.
+  void addPendingChip(Alpide* chip) {mPendingChips.push_back(chip);}
+
+  ///@brief Get the evaluator, or nullptr if none was created
+  static ParallelChipEvaluator* getInstance(void) {return sInstance;}
+};
+
+
+#endif
+///@}
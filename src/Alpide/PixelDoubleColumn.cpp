@@ -9,27 +9,208 @@
 #include <stdexcept>
 
 
+#ifdef PIXEL_DOUBLE_COLUMN_BITMAP
+
 ///@brief Set a pixel in a pixel double column object.
 ///@param[in] col_num column number of pixel, must be 0 or 1.
 ///@param[in] row_num row number of pixel, must be in the range 0 to N_PIXEL_ROWS-1
 ///@return True if insertion of pixel succeeded, false if not (pixel already existed)
+///@throws std::out_of_range if col_num or row_num is not in the specified range.
 bool PixelDoubleColumn::setPixel(unsigned int col_num, unsigned int row_num)
 {
-  return pixelColumn.insert(std::make_shared<PixelHit>(col_num, row_num)).second;
+#ifdef EXCEPTION_CHECKS
+  // Out of range exception check
+  if(row_num >= N_PIXEL_ROWS) {
+    throw std::out_of_range ("row_num");
+  } else if(col_num >= 2) {
+    throw std::out_of_range ("col_num");
+  }
+#endif
+
+  return setBit((row_num<<1) + ((col_num&1)^(row_num&1)));
+}
+
+
+///@brief Set a pixel in a pixel double column object, using PixelHitPtr handle to PixelHit object.
+///       The PixelHit object is only stored in the side table if it has a PixelReadoutStats
+///       object (or always, if PIXEL_DEBUG is defined). If pixel already exists in double
+///       column, then a pointer to the PixelHit pixel is added as a duplicate hit to the
+///       existing hit, like the std::set backend does. If the existing hit was not stored in
+///       the side table, the new hit is stored instead, so that it is still counted when the
+///       pixel is read out. No PixelHit objects are created here, since this function is
+///       called from the worker threads of ParallelChipEvaluator.
+///@param[in] pixel PixelHitPtr handle to PixelHit object.
+///@return True if insertion of pixel succeeded, false if not (pixel already existed)
+bool PixelDoubleColumn::setPixel(const PixelHitPtr &pixel)
+{
+  unsigned int addr = pixel->getPriEncPixelAddress();
+  bool pixel_inserted = setBit(addr);
+
+#ifdef PIXEL_DEBUG
+  bool store_pixel_hit = true;
+#else
+  bool store_pixel_hit = pixel->hasPixelReadoutStatsObj();
+#endif
+
+  if(pixel_inserted) {
+    if(store_pixel_hit)
+      mPixelHitTable.push_back(std::make_pair(std::uint16_t(addr), pixel));
+  } else if(store_pixel_hit) {
+    auto it = mPixelHitTable.begin();
+
+    while(it != mPixelHitTable.end() && it->first != addr)
+      it++;
+
+    if(it == mPixelHitTable.end())
+      mPixelHitTable.push_back(std::make_pair(std::uint16_t(addr), pixel));
+    else
+      it->second->addDuplicatePixel(pixel);
+  }
+
+  return pixel_inserted;
 }
 
 
-///@brief Set a pixel in a pixel double column object, using shared_ptr to PixelHit object.
+///@brief Set the bit for a priority encoder address in the occupancy bitmap
+///@param[in] addr Priority encoder address of pixel
+///@return True if the bit was set, false if it was already set
+bool PixelDoubleColumn::setBit(unsigned int addr)
+{
+  unsigned int word = addr >> 6;
+  std::uint64_t bit = std::uint64_t(1) << (addr & 63);
+
+  if(mBitmap[word] & bit)
+    return false;
+
+  mBitmap[word] |= bit;
+  mBitmapWordsInUse |= (1 << word);
+  mPixelHitCount++;
+
+  return true;
+}
+
+
+///@brief Remove and return the PixelHit object for a priority encoder address from
+///       the side table. If there is no PixelHit for this address in the side table,
+///       a new PixelHit object is created from the address.
+///@param[in] addr Priority encoder address of pixel
+///@return PixelHitPtr to PixelHit object
+PixelHitPtr PixelDoubleColumn::takePixelHit(unsigned int addr)
+{
+  for(auto it = mPixelHitTable.begin(); it != mPixelHitTable.end(); it++) {
+    if(it->first == addr) {
+      PixelHitPtr pixel = it->second;
+
+      // Order of the side table does not matter, swap with last entry to erase
+      *it = mPixelHitTable.back();
+      mPixelHitTable.pop_back();
+
+      return pixel;
+    }
+  }
+
+  unsigned int row = addr >> 1;
+  unsigned int col = mColBase | ((addr&1) ^ (row&1));
+
+  return makePixelHit(col, row);
+}
+
+
+///@brief Clear (flush) contents of double column
+void PixelDoubleColumn::clear(void) {
+  while(mBitmapWordsInUse) {
+    unsigned int word = __builtin_ctz(mBitmapWordsInUse);
+    mBitmap[word] = 0;
+    mBitmapWordsInUse &= ~(1 << word);
+  }
+
+  mPixelHitCount = 0;
+  mPixelHitTable.clear();
+}
+
+
+///@brief Read out the next pixel from this double column, and erase it from the MEB.
+///       Pixels are read out in an order corresponding to that of the priority encoder
+///       in the Alpide chip, which is simply the lowest bit set in the occupancy bitmap.
+///@return PixelHitPtr to PixelHit with hit coordinates. If no pixel hits exist, a PixelHitPtr
+///       to NoPixelHit is returned (PixelHit object with coords = (-1,-1)).
+PixelHitPtr PixelDoubleColumn::readPixel(void) {
+  if(mPixelHitCount == 0)
+    return makePixelHit(NoPixelHit);
+
+  unsigned int word = __builtin_ctz(mBitmapWordsInUse);
+  unsigned int addr = (word << 6) | __builtin_ctzll(mBitmap[word]);
+
+  // Remove the pixel when it has been read out
+  mBitmap[word] &= mBitmap[word] - 1;
+  if(mBitmap[word] == 0)
+    mBitmapWordsInUse &= ~(1 << word);
+  mPixelHitCount--;
+
+  return takePixelHit(addr);
+}
+
+
+///@brief Check if there is a hit or not for the pixel specified by col_num and row_num,
+///       without deleting the pixel from the MEB.
+///@param[in] col_num column number of pixel, must be 0 or 1.
+///@param[in] row_num row number of pixel, must be in the range 0 to N_PIXEL_ROWS-1
+///@return True if there is a hit, false if not.
+///@throws std::out_of_range if col_num or row_num is not in the specified range.
+bool PixelDoubleColumn::inspectPixel(unsigned int col_num, unsigned int row_num) {
+#ifdef EXCEPTION_CHECKS
+  // Out of range exception check
+  if(row_num >= N_PIXEL_ROWS) {
+    throw std::out_of_range ("row_num");
+  } else if(col_num >= 2) {
+    throw std::out_of_range ("col_num");
+  }
+#endif
+
+  unsigned int addr = (row_num<<1) + ((col_num&1)^(row_num&1));
+
+  return (mBitmap[addr >> 6] >> (addr & 63)) & 1;
+}
+
+
+///@brief Returns how many pixel hits (in this double column) that have not been read out from the MEBs yet
+unsigned int PixelDoubleColumn::pixelHitsRemaining(void) {
+  return mPixelHitCount;
+}
+
+
+///@brief Set the double column number (within the pixel matrix) of this double column.
+///       Used to get the correct absolute column number for pixels that are read out.
+///@param[in] double_col_num Double column number, 0 to (N_PIXEL_COLS/2)-1
+void PixelDoubleColumn::setDoubleColumnNum(unsigned int double_col_num) {
+  mColBase = double_col_num << 1;
+}
+
+
+#else // Default std::set backend
+
+
+///@brief Set a pixel in a pixel double column object.
+///@param[in] col_num column number of pixel, must be 0 or 1.
+///@param[in] row_num row number of pixel, must be in the range 0 to N_PIXEL_ROWS-1
+///@return True if insertion of pixel succeeded, false if not (pixel already existed)
+bool PixelDoubleColumn::setPixel(unsigned int col_num, unsigned int row_num)
+{
+  return pixelColumn.insert(makePixelHit(col_num, row_num)).second;
+}
+
+
+///@brief Set a pixel in a pixel double column object, using PixelHitPtr handle to PixelHit object.
 ///       If pixel already exists in double column, then a pointer to the PixelHit pixel is
 ///       added as a duplicate hit to the existing hit that is already in the double column.
-///@param[in] pixel shared pointer to PixelHit object.
+///@param[in] pixel PixelHitPtr handle to PixelHit object.
 ///@return True if insertion of pixel succeeded, false if not (pixel already existed)
-bool PixelDoubleColumn::setPixel(const std::shared_ptr<PixelHit> &pixel)
+bool PixelDoubleColumn::setPixel(const PixelHitPtr &pixel)
 {
   bool pixel_inserted = pixelColumn.insert(pixel).second;
 
   if(pixel_inserted == false) {
-    std::shared_ptr<PixelHit> pix_original = *pixelColumn.find(pixel);
+    PixelHitPtr pix_original = *pixelColumn.find(pixel);
     pix_original->addDuplicatePixel(pixel);
   }
 
@@ -45,14 +226,14 @@ void PixelDoubleColumn::clear(void) {
 ///@brief Read out the next pixel from this double column, and erase it from the MEB.
 ///       Pixels are read out in an order corresponding to that of the priority encoder
 ///       in the Alpide chip.
-///@return shared_ptr to PixelHit with hit coordinates. If no pixel hits exist, a shared_ptr
+///@return PixelHitPtr to PixelHit with hit coordinates. If no pixel hits exist, a PixelHitPtr
 ///       to NoPixelHit is returned (PixelHit object with coords = (-1,-1)).
-std::shared_ptr<PixelHit> PixelDoubleColumn::readPixel(void) {
+PixelHitPtr PixelDoubleColumn::readPixel(void) {
   if(pixelColumn.size() == 0)
-    return std::make_shared<PixelHit>(NoPixelHit);
+    return makePixelHit(NoPixelHit);
 
   // Read out the next (prioritized) pixel
-  std::shared_ptr<PixelHit> pixel = *pixelColumn.begin();
+  PixelHitPtr pixel = *pixelColumn.begin();
 
   // Remove the pixel when it has been read out
   pixelColumn.erase(pixelColumn.begin());
@@ -90,3 +271,11 @@ bool PixelDoubleColumn::inspectPixel(unsigned int col_num, unsigned int row_num)
 unsigned int PixelDoubleColumn::pixelHitsRemaining(void) {
   return pixelColumn.size();
 }
+
+
+///@brief Set the double column number (within the pixel matrix) of this double column.
+///       Not needed by the std::set backend, since the PixelHit objects are always stored.
+void PixelDoubleColumn::setDoubleColumnNum(unsigned int) {
+}
+
+#endif
@@ -4,6 +4,12 @@
  * @date   August 31, 2018
  * @brief  PixelDoubleColumn class
  *
+ *         Two storage backends are available for the double column:
+ *         - Default: std::set of PixelHit objects, sorted by PixelPriorityEncoder.
+ *         - PIXEL_DOUBLE_COLUMN_BITMAP: A 1024-bit occupancy bitmap in priority
+ *           encoder order. PixelHit objects are only kept in a (small) side table
+ *           when they carry readout statistics (or when PIXEL_DEBUG is defined).
+ *         The backend is selected at build time, see CMakeLists.txt.
  */
 
 
@@ -15,21 +21,59 @@
 #include "alpide_constants.hpp"
 #include "PixelPriorityEncoder.hpp"
 #include <set>
+#include <vector>
+#include <utility>
 #include <memory>
 #include <cstdint>
 
 
+#ifdef PIXEL_DOUBLE_COLUMN_BITMAP
+///@brief Number of pixels in a double column (ie. number of priority encoder addresses)
+#define N_PIXELS_PER_DOUBLE_COL (2*N_PIXEL_ROWS)
+
+///@brief Number of 64-bit words in double column occupancy bitmap
+#define N_DOUBLE_COL_BITMAP_WORDS (N_PIXELS_PER_DOUBLE_COL/64)
+#endif
+
+
 class PixelDoubleColumn
 {
 private:
-  std::set<std::shared_ptr<PixelHit>, PixelPriorityEncoder> pixelColumn;
+#ifdef PIXEL_DOUBLE_COLUMN_BITMAP
+  ///@brief Occupancy bitmap. Bit N in the bitmap corresponds to priority encoder
+  ///       address N, so the lowest bit set is the next pixel to be read out.
+  std::uint64_t mBitmap[N_DOUBLE_COL_BITMAP_WORDS] = {0};
+
+  ///@brief Bit N is set when word N in mBitmap is non-zero
+  std::uint16_t mBitmapWordsInUse = 0;
+
+  ///@brief Number of bits set in mBitmap
+  unsigned int mPixelHitCount = 0;
+
+  ///@brief Column number of the first (even) column in this double column.
+  ///       Used to recreate the absolute column number for pixels that are read out
+  ///       without a PixelHit object in the side table.
+  unsigned int mColBase = 0;
+
+  ///@brief Side table with PixelHit objects for hits that need them (for readout stats).
+  ///       Key is priority encoder address of the pixel. Only a handful of hits are
+  ///       expected per double column, so a plain vector is used.
+  std::vector<std::pair<std::uint16_t, PixelHitPtr>> mPixelHitTable;
+
+  bool setBit(unsigned int addr);
+  PixelHitPtr takePixelHit(unsigned int addr);
+#else
+  std::set<PixelHitPtr, PixelPriorityEncoder> pixelColumn;
+#endif
+
 public:
   bool setPixel(unsigned int col_num, unsigned int row_num);
-  bool setPixel(const std::shared_ptr<PixelHit> &pixel);
+  bool setPixel(const PixelHitPtr &pixel);
   void clear(void);
   bool inspectPixel(unsigned int col_num, unsigned int row_num);
-  std::shared_ptr<PixelHit> readPixel(void);
+  PixelHitPtr readPixel(void);
   unsigned int pixelHitsRemaining(void);
+  void setDoubleColumnNum(unsigned int double_col_num);
 };
 
 
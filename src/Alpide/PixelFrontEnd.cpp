@@ -6,14 +6,27 @@
  */
 
 #include "PixelFrontEnd.hpp"
+#include <algorithm>
 
 
 ///@brief Input a pixel to the pixel front end.
-///       Pixels are added to the end of the "pixel queue"
+///       Pixels are added to the end of the "pixel queue". Hits are normally input in
+///       time order, but if a hit goes active before the last hit in the queue it is
+///       inserted so that the queue stays ordered by the time the hits go active.
 ///@param p Pixel hit input to front end
-void PixelFrontEnd::pixelFrontEndInput(const std::shared_ptr<PixelHit>& p)
+void PixelFrontEnd::pixelFrontEndInput(const PixelHitPtr& p)
 {
-  mHitQueue.push_back(p);
+  if(mHitQueue.empty() ||
+     mHitQueue.back()->getActiveTimeStart() <= p->getActiveTimeStart())
+  {
+    mHitQueue.push_back(p);
+  } else {
+    auto pos = std::upper_bound(mHitQueue.begin(), mHitQueue.end(), p->getActiveTimeStart(),
+                                [](uint64_t t, const PixelHitPtr& pix) {
+                                  return t < pix->getActiveTimeStart();
+                                });
+    mHitQueue.insert(pos, p);
+  }
 
 #ifdef PIXEL_DEBUG
   std::uint64_t time_now = sc_time_stamp().value();
@@ -47,32 +60,31 @@ void PixelFrontEnd::removeInactiveHits(uint64_t time_now)
 }
 
 
-///@brief Create a new event frame for the desired time interval
+///@brief Latch the pixel hits that are active in the event frame (strobe interval)
+///       between event_start and event_end into the newest MEB of the pixel matrix.
+///       The hit queue is ordered by the time the hits go active, and since all the hits
+///       are assumed to have the same "active time" (time over threshold), it is also
+///       ordered by the time they go inactive. The hits that are active in the event frame
+///       are then a contiguous range in the queue, which is found with binary search.
+///@param[out] matrix Pixel matrix to feed the hits to
 ///@param[in] event_start Start time of event frame (time when strobe signal went high).
 ///@param[in] event_end End time of event frame (time when strobe signal went low again).
-///@param[in] event_id ID to mark event with
-///@return EventFrame with pixel hits that are active between event_start and event_end
-EventFrame PixelFrontEnd::getEventFrame(uint64_t event_start,
-                                        uint64_t event_end,
-                                        uint64_t event_id) const
+void PixelFrontEnd::feedHitsToPixelMatrix(PixelMatrix& matrix,
+                                          uint64_t event_start,
+                                          uint64_t event_end) const
 {
-  EventFrame e(event_start, event_end, event_id);
+  // First hit that is still active at the start of the event frame
+  auto first = std::lower_bound(mHitQueue.begin(), mHitQueue.end(), event_start,
+                                [](const PixelHitPtr& pix, uint64_t t) {
+                                  return pix->getActiveTimeEnd() < t;
+                                });
 
-  for(auto pix_it = mHitQueue.begin(); pix_it != mHitQueue.end(); pix_it++) {
-    // All the hits are ordered in time in the hit queue.
-    // If this hit is not active, it could be that:
-    // 1) We haven't reached the newer hits which would be active for this event yet
-    // 2) We have gone through the hits that are active for this event, and have now
-    //    reached hits that are "too new" (event queue size is larger than 0 then)
-    if((*pix_it)->isActive(e.getEventStartTime(), e.getEventEndTime())) {
-      e.addHit(*pix_it);
-    } else if (e.getEventSize() > 0) {
-      // Case 2. There won't be any more hits now, so we can break.
-      /// @todo Is this check worth it performance wise, or is it better to just iterate
-      ///       through the whole list?
-      break;
-    }
-  }
+  // First hit that goes active after the end of the event frame
+  auto last = std::upper_bound(first, mHitQueue.end(), event_end,
+                               [](uint64_t t, const PixelHitPtr& pix) {
+                                 return t < pix->getActiveTimeStart();
+                               });
 
-  return e;
+  for(auto pix_it = first; pix_it != last; pix_it++)
+    matrix.setPixel(*pix_it);
 }
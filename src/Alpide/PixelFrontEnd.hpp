@@ -10,20 +10,22 @@
 
 #include <deque>
 #include <vector>
-#include "EventFrame.hpp"
+#include "PixelHit.hpp"
+#include "PixelMatrix.hpp"
 
 class PixelFrontEnd {
 private:
-  std::deque<std::shared_ptr<PixelHit>> mHitQueue;
+  ///@brief Queue of pixel hits, ordered by the time the hits go active
+  std::deque<PixelHitPtr> mHitQueue;
 
 protected:
-  EventFrame getEventFrame(uint64_t event_start,
-                           uint64_t event_end,
-                           uint64_t event_id) const;
+  void feedHitsToPixelMatrix(PixelMatrix& matrix,
+                             uint64_t event_start,
+                             uint64_t event_end) const;
 
 public:
   PixelFrontEnd() {}
-  void pixelFrontEndInput(const std::shared_ptr<PixelHit>& p);
+  void pixelFrontEndInput(const PixelHitPtr& p);
   void removeInactiveHits(uint64_t time_now);
 };
 
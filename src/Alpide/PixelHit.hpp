@@ -4,6 +4,10 @@
  * @date   August 14, 2018
  * @brief  Class for a pixel hit
  *
+ *         PixelHit objects that are passed around in the simulation are allocated
+ *         from a pool (PixelHitPool), and referenced with PixelHitPtr handles which
+ *         keep an intrusive (non-atomic) reference count in the PixelHit object.
+ *         Use makePixelHit() to create them.
  */
 #ifndef PIXEL_HIT_HPP
 #define PIXEL_HIT_HPP
@@ -22,6 +26,9 @@
 #include <algorithm>
 #include <memory>
 #include <vector>
+#include <new>
+#include <utility>
+#include <cstddef>
 
 using std::uint64_t;
 
@@ -29,6 +36,80 @@ class PixelPriorityEncoder;
 
 class PixelHit;
 
+
+///@brief Handle to a PixelHit object allocated with makePixelHit().
+///       Works like std::shared_ptr<PixelHit>, but the reference count is stored
+///       in the PixelHit object itself and is not atomic. A pixel hit belongs to
+///       one chip, and is only handled by one thread at a time. The PixelHit object
+///       is destructed and returned to PixelHitPool when the last handle to it goes away.
+class PixelHitPtr
+{
+private:
+  PixelHit* mPixel;
+
+  void acquire(void) const;
+  void release(void);
+
+public:
+  PixelHitPtr() : mPixel(nullptr) {}
+  PixelHitPtr(std::nullptr_t) : mPixel(nullptr) {}
+  explicit PixelHitPtr(PixelHit* pixel);
+  PixelHitPtr(const PixelHitPtr& other);
+  PixelHitPtr(PixelHitPtr&& other) : mPixel(other.mPixel) {other.mPixel = nullptr;}
+  ~PixelHitPtr() {release();}
+
+  PixelHitPtr& operator=(const PixelHitPtr& other);
+  PixelHitPtr& operator=(PixelHitPtr&& other);
+
+  PixelHit* get(void) const {return mPixel;}
+  PixelHit* operator->(void) const {return mPixel;}
+  PixelHit& operator*(void) const {return *mPixel;}
+  explicit operator bool(void) const {return mPixel != nullptr;}
+
+  bool operator==(const PixelHitPtr& rhs) const {return mPixel == rhs.mPixel;}
+  bool operator!=(const PixelHitPtr& rhs) const {return mPixel != rhs.mPixel;}
+  bool operator<(const PixelHitPtr& rhs) const {return mPixel < rhs.mPixel;}
+  bool operator==(std::nullptr_t) const {return mPixel == nullptr;}
+  bool operator!=(std::nullptr_t) const {return mPixel != nullptr;}
+};
+
+
+///@brief Slab allocator for PixelHit objects. Memory is allocated in slabs of
+///       SLAB_SIZE objects, and freed objects are put on a free list and reused
+///       for new hits. This avoids a heap allocation for every single pixel hit,
+///       and keeps the memory footprint at the peak number of live hits.
+///       The slabs are kept for reuse, and are not released to the OS.
+class PixelHitPool
+{
+private:
+  static const std::size_t SLAB_SIZE = 4096;
+
+  ///@brief Free slots are linked together in the free list
+  struct alignas(8) Slot {
+    Slot* mNextFree;
+  };
+
+  std::size_t mSlotSize;
+  std::vector<std::unique_ptr<unsigned char[]>> mSlabs;
+  std::size_t mSlotsLeftInSlab = 0;
+  unsigned char* mNextInSlab = nullptr;
+  Slot* mFreeList = nullptr;
+
+  std::uint64_t mSlotsInUse = 0;
+  std::uint64_t mSlotsInUsePeak = 0;
+
+public:
+  explicit PixelHitPool(std::size_t slot_size);
+  void* allocate(void);
+  void deallocate(void* p);
+
+  std::uint64_t getSlotsInUse(void) const {return mSlotsInUse;}
+  std::uint64_t getSlotsInUsePeak(void) const {return mSlotsInUsePeak;}
+  std::uint64_t getSlotsAllocated(void) const {return mSlabs.size()*SLAB_SIZE;}
+
+  static PixelHitPool& getInstance(void);
+};
+
 /**
    @brief A struct that indicates a hit in a region, at the pixel identified by the col and row
    variables.
@@ -36,8 +117,17 @@ class PixelHit;
 class PixelHit
 {
   friend class PixelPriorityEncoder;
+  friend class PixelHitPtr;
 
 private:
+  ///@brief Reference count used by PixelHitPtr. Not copied when the PixelHit is copied.
+  struct RefCount {
+    unsigned int mCount = 0;
+    RefCount() {}
+    RefCount(const RefCount&) {}
+    RefCount& operator=(const RefCount&) {return *this;}
+  } mRefCount;
+
   int mCol;
   int mRow;
   unsigned int mChipId;
@@ -46,7 +136,7 @@ private:
   uint64_t mActiveTimeEndNs = 0;
   unsigned int mReadoutCount = 0;
   std::shared_ptr<PixelReadoutStats> mPixelReadoutStats;
-  std::vector<std::shared_ptr<PixelHit>> mDuplicatePixels;
+  std::vector<PixelHitPtr> mDuplicatePixels;
 
 public:
 #ifdef PIXEL_DEBUG
@@ -90,6 +180,7 @@ public:
   unsigned int getReadoutCount(void) const;
   void increaseReadoutCount(void);
   void setPixelReadoutStatsObj(const std::shared_ptr<PixelReadoutStats> &pix_stats);
+  bool hasPixelReadoutStatsObj(void) const;
   void setActiveTimeStart(uint64_t start_time_ns);
   void setActiveTimeEnd(uint64_t end_time_ns);
   uint64_t getActiveTimeStart(void) const;
@@ -97,7 +188,7 @@ public:
   bool isActive(uint64_t time_now_ns) const;
   bool isActive(uint64_t strobe_start_time_ns, uint64_t strobe_end_time_ns) const;
 
-  void addDuplicatePixel(const std::shared_ptr<PixelHit>& pixel);
+  void addDuplicatePixel(const PixelHitPtr& pixel);
 };
 
 const PixelHit NoPixelHit(-1,-1);
@@ -301,6 +392,13 @@ inline void PixelHit::setPixelReadoutStatsObj(const std::shared_ptr<PixelReadout
   mPixelReadoutStats = pix_stats;
 }
 
+///@brief Check if this pixel hit has a PixelReadoutStats object, ie. if readout
+///       counts for this hit are recorded when it is destructed.
+inline bool PixelHit::hasPixelReadoutStatsObj(void) const
+{
+  return mPixelReadoutStats != nullptr;
+}
+
 inline void PixelHit::setActiveTimeStart(uint64_t start_time_ns)
 {
   mActiveTimeStartNs = start_time_ns;
@@ -343,9 +441,135 @@ inline bool PixelHit::isActive(uint64_t strobe_start_time_ns, uint64_t strobe_en
 }
 
 
-inline void PixelHit::addDuplicatePixel(const std::shared_ptr<PixelHit>& pixel)
+inline void PixelHit::addDuplicatePixel(const PixelHitPtr& pixel)
 {
   mDuplicatePixels.push_back(pixel);
 }
 
+
+///@brief Create a new PixelHit object in the PixelHitPool.
+///@param[in] args Arguments passed to the PixelHit constructor
+///@return PixelHitPtr handle to the new PixelHit object
+template<class... Args>
+inline PixelHitPtr makePixelHit(Args&&... args)
+{
+  void* mem = PixelHitPool::getInstance().allocate();
+
+  try {
+    return PixelHitPtr(new (mem) PixelHit(std::forward<Args>(args)...));
+  } catch(...) {
+    PixelHitPool::getInstance().deallocate(mem);
+    throw;
+  }
+}
+
+
+inline PixelHitPtr::PixelHitPtr(PixelHit* pixel)
+  : mPixel(pixel)
+{
+  acquire();
+}
+
+
+inline PixelHitPtr::PixelHitPtr(const PixelHitPtr& other)
+  : mPixel(other.mPixel)
+{
+  acquire();
+}
+
+
+inline PixelHitPtr& PixelHitPtr::operator=(const PixelHitPtr& other)
+{
+  other.acquire();
+  release();
+  mPixel = other.mPixel;
+  return *this;
+}
+
+
+inline PixelHitPtr& PixelHitPtr::operator=(PixelHitPtr&& other)
+{
+  if(this != &other) {
+    release();
+    mPixel = other.mPixel;
+    other.mPixel = nullptr;
+  }
+  return *this;
+}
+
+
+inline void PixelHitPtr::acquire(void) const
+{
+  if(mPixel)
+    mPixel->mRefCount.mCount++;
+}
+
+
+///@brief Decrease reference count, and destruct the PixelHit object and return
+///       its memory to the pool if this was the last reference to it.
+inline void PixelHitPtr::release(void)
+{
+  if(mPixel && --mPixel->mRefCount.mCount == 0) {
+    PixelHit* pixel = mPixel;
+    mPixel = nullptr;
+    pixel->~PixelHit();
+    PixelHitPool::getInstance().deallocate(pixel);
+  }
+}
+
+
+inline PixelHitPool::PixelHitPool(std::size_t slot_size)
+  : mSlotSize((std::max(slot_size, sizeof(Slot)) + alignof(Slot) - 1) & ~(alignof(Slot) - 1))
+{
+}
+
+
+///@brief Get memory for one PixelHit object. Takes a slot from the free list if
+///       available, or from the current slab. A new slab is allocated when needed.
+inline void* PixelHitPool::allocate(void)
+{
+  void* p;
+
+  if(mFreeList) {
+    p = mFreeList;
+    mFreeList = mFreeList->mNextFree;
+  } else {
+    if(mSlotsLeftInSlab == 0) {
+      mSlabs.emplace_back(new unsigned char[SLAB_SIZE*mSlotSize]);
+      mNextInSlab = mSlabs.back().get();
+      mSlotsLeftInSlab = SLAB_SIZE;
+    }
+    p = mNextInSlab;
+    mNextInSlab += mSlotSize;
+    mSlotsLeftInSlab--;
+  }
+
+  if(++mSlotsInUse > mSlotsInUsePeak)
+    mSlotsInUsePeak = mSlotsInUse;
+
+  return p;
+}
+
+
+///@brief Return memory for a PixelHit object (that has been destructed) to the pool
+inline void PixelHitPool::deallocate(void* p)
+{
+  Slot* slot = static_cast<Slot*>(p);
+  slot->mNextFree = mFreeList;
+  mFreeList = slot;
+  mSlotsInUse--;
+}
+
+
+///@brief Get the global PixelHit pool.
+///       Allocated on first use and never destructed, since PixelHit objects may still
+///       be referenced by static/global objects when the program exits.
+inline PixelHitPool& PixelHitPool::getInstance(void)
+{
+  static_assert(alignof(PixelHit) <= alignof(Slot), "PixelHit alignment too large for pool");
+
+  static PixelHitPool* pool = new PixelHitPool(sizeof(PixelHit));
+  return *pool;
+}
+
 #endif
@@ -10,39 +10,91 @@
  */
 
 #include <iostream>
+#include <stdexcept>
 #include "PixelMatrix.hpp"
 
 
 ///@brief Indicate to the Alpide that we are starting on a new event. If the call is
-///       successful a new MEB slice is created, and the next calls to setPixel will add pixels
-///       to the new event.
+///       successful the next free MEB slot is taken into use, and the next calls to setPixel
+///       will add pixels to the new event.
 ///@param[in] event_time Simulation time when the event is pushed/latched into MEB
 ///                  (use current simulation time).
+///@throw out_of_range If all N_MULTI_EVENT_BUFFERS MEBs are already in use
 void PixelMatrix::newEvent(uint64_t event_time)
 {
+  if(mNumMEBsInUse == N_MULTI_EVENT_BUFFERS) {
+    throw std::out_of_range("No free MEBs");
+  }
+
   // Update the histogram value for the previous MEB size, with the duration
   // that has passed since the last update, before pushing this event to the MEBs
-  unsigned int MEB_size = mColumnBuffs.size();
+  unsigned int MEB_size = mNumMEBsInUse;
   mMEBHistogram[MEB_size] += event_time - mMEBHistoLastUpdateTime;
   mMEBHistoLastUpdateTime = event_time;
 
-  mColumnBuffs.push(std::vector<PixelDoubleColumn>(N_PIXEL_COLS/2));
-  mColumnBuffsPixelsLeft.push_back(int(0)); // 0 hits so far for this event
+  mNumMEBsInUse++;
+
+  MultiEventBuffer& new_event_buffer = getNewestMEB();
+
+  // Allocate double columns the first time this MEB slot is used.
+  // The slot is cleared when the event is deleted, so it is empty already.
+  if(new_event_buffer.mDoubleCols.empty()) {
+    new_event_buffer.mDoubleCols.resize(N_PIXEL_COLS/2);
+
+#ifdef PIXEL_DOUBLE_COLUMN_BITMAP
+    // The bitmap double columns need to know their column number to recreate
+    // the pixel coordinates when the pixels are read out
+    for(unsigned int i = 0; i < new_event_buffer.mDoubleCols.size(); i++)
+      new_event_buffer.mDoubleCols[i].setDoubleColumnNum(i);
+#endif
+  }
+
+  new_event_buffer.mPixelsLeft = 0; // 0 hits so far for this event
 }
 
 
-///@brief Flush the oldest event by clearing all double columns and setting its size to zero
-void PixelMatrix::flushOldestEvent(void)
+///@brief Clear all double columns in an MEB slot, and set its size to zero.
+///       The double columns are only cleared if there are hits left in the MEB.
+///@param[in,out] meb Reference to MEB slot
+void PixelMatrix::clearMEB(MultiEventBuffer& meb)
 {
-  if(mColumnBuffs.empty() == false) {
-    std::vector<PixelDoubleColumn>& oldest_event_buffer = mColumnBuffs.front();
-    int& oldest_event_buffer_hits_remaining = mColumnBuffsPixelsLeft.front();
-
-    for(auto it = oldest_event_buffer.begin(); it != oldest_event_buffer.end(); it++) {
+  if(meb.mPixelsLeft != 0) {
+    for(auto it = meb.mDoubleCols.begin(); it != meb.mDoubleCols.end(); it++) {
       it->clear();
     }
 
-    oldest_event_buffer_hits_remaining = 0;
+    for(int i = 0; i < N_REGIONS; i++)
+      meb.mRegionPixelsLeft[i] = 0;
+
+    meb.mPixelsLeft = 0;
+    meb.mRegionsNotEmpty = 0;
+  }
+}
+
+
+///@brief Get a mask with the bits set for the regions that the double column range
+///       from start_double_col to stop_double_col (exclusive) overlaps with.
+///@param[in]  start_double_col Start of range in terms of double columns
+///@param[in]  stop_double_col End of range in terms of double columns
+///@return Region mask
+std::uint32_t PixelMatrix::getRegionMask(int start_double_col, int stop_double_col) const
+{
+  int start_region = start_double_col / N_PIXEL_DOUBLE_COLS_PER_REGION;
+  int stop_region = (stop_double_col-1) / N_PIXEL_DOUBLE_COLS_PER_REGION;
+
+  // Set bits start_region to stop_region
+  std::uint64_t mask = ((std::uint64_t(1) << (stop_region+1)) - 1) &
+                       ~((std::uint64_t(1) << start_region) - 1);
+
+  return mask;
+}
+
+
+///@brief Flush the oldest event by clearing all double columns and setting its size to zero
+void PixelMatrix::flushOldestEvent(void)
+{
+  if(mNumMEBsInUse > 0) {
+    clearMEB(getOldestMEB());
   }
 }
 
@@ -56,12 +108,15 @@ void PixelMatrix::deleteEvent(uint64_t time_now)
   if(getNumEvents() > 0) {
     // Update the histogram value for the previous MEB size, with the duration
     // that has passed since the last update, before popping this MEB.
-    unsigned int MEB_size = mColumnBuffs.size();
+    unsigned int MEB_size = mNumMEBsInUse;
     mMEBHistogram[MEB_size] += time_now - mMEBHistoLastUpdateTime;
     mMEBHistoLastUpdateTime = time_now;
 
-    mColumnBuffsPixelsLeft.pop_front();
-    mColumnBuffs.pop();
+    // Clear the slot in place so it is ready for reuse
+    clearMEB(getOldestMEB());
+
+    mOldestMEB = (mOldestMEB+1) % N_MULTI_EVENT_BUFFERS;
+    mNumMEBsInUse--;
   }
 #ifdef EXCEPTION_CHECKS
   // Out of range exception check
@@ -82,7 +137,7 @@ void PixelMatrix::setPixel(unsigned int col, unsigned int row)
 {
 #ifdef EXCEPTION_CHECKS
   // Out of range exception check
-  if(mColumnBuffs.empty() == true) {
+  if(mNumMEBsInUse == 0) {
     throw std::out_of_range("No events");
   }else if(row >= N_PIXEL_ROWS) {
     throw std::out_of_range("row");
@@ -92,11 +147,13 @@ void PixelMatrix::setPixel(unsigned int col, unsigned int row)
 #endif
 
   // Set the pixel
-  std::vector<PixelDoubleColumn>& current_event_buffer = mColumnBuffs.back();
-  int& current_event_buffer_hits_remaining = mColumnBuffsPixelsLeft.back();
+  MultiEventBuffer& current_event_buffer = getNewestMEB();
 
-  if(current_event_buffer[col/2].setPixel(col%2, row)) {
-    current_event_buffer_hits_remaining++;
+  if(current_event_buffer.mDoubleCols[col/2].setPixel(col%2, row)) {
+    unsigned int region = col / N_PIXEL_COLS_PER_REGION;
+    current_event_buffer.mPixelsLeft++;
+    current_event_buffer.mRegionPixelsLeft[region]++;
+    current_event_buffer.mRegionsNotEmpty |= (1u << region);
     mLatchedPixelHitCount++;
   } else {
     mDuplicatePixelHitCount++;
@@ -112,11 +169,11 @@ void PixelMatrix::setPixel(unsigned int col, unsigned int row)
 ///@param[in] col Column (0 to N_PIXEL_COLS-1).
 ///@param[in] row Row (0 to N_PIXEL_ROWS-1).
 ///@throw out_of_range If there are no events, or if col or row is outside the allowed range
-void PixelMatrix::setPixel(const std::shared_ptr<PixelHit> &pixel)
+void PixelMatrix::setPixel(const PixelHitPtr &pixel)
 {
 #ifdef EXCEPTION_CHECKS
   // Out of range exception check
-  if(mColumnBuffs.empty() == true) {
+  if(mNumMEBsInUse == 0) {
     throw std::out_of_range("No events");
   }else if(pixel->getRow() >= N_PIXEL_ROWS) {
     throw std::out_of_range("row");
@@ -126,11 +183,13 @@ void PixelMatrix::setPixel(const std::shared_ptr<PixelHit> &pixel)
 #endif
 
   // Set the pixel
-  std::vector<PixelDoubleColumn>& current_event_buffer = mColumnBuffs.back();
-  int& current_event_buffer_hits_remaining = mColumnBuffsPixelsLeft.back();
+  MultiEventBuffer& current_event_buffer = getNewestMEB();
 
-  if(current_event_buffer[pixel->getCol()/2].setPixel(pixel)) {
-    current_event_buffer_hits_remaining++;
+  if(current_event_buffer.mDoubleCols[pixel->getCol()/2].setPixel(pixel)) {
+    unsigned int region = pixel->getCol() / N_PIXEL_COLS_PER_REGION;
+    current_event_buffer.mPixelsLeft++;
+    current_event_buffer.mRegionPixelsLeft[region]++;
+    current_event_buffer.mRegionsNotEmpty |= (1u << region);
     mLatchedPixelHitCount++;
 #ifdef PIXEL_DEBUG
     std::uint64_t time_now = sc_time_stamp().value();
@@ -166,9 +225,9 @@ bool PixelMatrix::regionEmpty(int start_double_col, int stop_double_col) {
   }
 #endif
 
-  // Do we have any stored events?
-  if(mColumnBuffs.empty() == false) {
-    std::vector<PixelDoubleColumn>& oldest_event_buffer = mColumnBuffs.front();
+  // Do we have any stored events, with pixels left in the regions for these columns?
+  if((getRegionsNotEmptyMask() & getRegionMask(start_double_col, stop_double_col)) != 0) {
+    std::vector<PixelDoubleColumn>& oldest_event_buffer = getOldestMEB().mDoubleCols;
 
     // Search for the first column that has pixels
     for(int i = start_double_col; i < stop_double_col; i++) {
@@ -183,10 +242,10 @@ bool PixelMatrix::regionEmpty(int start_double_col, int stop_double_col) {
 }
 
 
-///@brief  Check if a region of the pixel matrix is empty
+///@brief  Check if a region of the pixel matrix is empty (in the oldest event).
+///        Uses the region mask for the oldest MEB, and does not search the double columns.
 ///@param[in]  region The region number to check
-///@return PixelHit with hit coordinates. If no pixel hits exist, NoPixelHit is returned
-///        (PixelHit object with coords = (-1,-1)).
+///@return True if empty
 ///@throw  std::out_of_range if region is less than zero, or greater than N_REGIONS-1
 bool PixelMatrix::regionEmpty(int region) {
 #ifdef EXCEPTION_CHECKS
@@ -194,10 +253,7 @@ bool PixelMatrix::regionEmpty(int region) {
     throw std::out_of_range("region");
 #endif
 
-  int start_double_col = N_PIXEL_DOUBLE_COLS_PER_REGION*region;
-  int stop_double_col = (N_PIXEL_DOUBLE_COLS_PER_REGION*(region+1));
-
-  return regionEmpty(start_double_col, stop_double_col);
+  return (getRegionsNotEmptyMask() & (1u << region)) == 0;
 }
 
 
@@ -211,17 +267,17 @@ bool PixelMatrix::regionEmpty(int region) {
 ///@param[in]  time_now Simulation time when this readout is occuring
 ///@param[in]  start_double_col Start double column to start searching for pixels to readout from
 ///@param[in]  stop_double_col Stop searching for pixels to read out when reaching this column
-///@return shared_ptr to PixelHit with hit coordinates. If no pixel hits exist, NoPixelHit is returned
+///@return PixelHitPtr to PixelHit with hit coordinates. If no pixel hits exist, NoPixelHit is returned
 ///        (PixelHit object with coords = (-1,-1)).
 ///@throw  std::out_of_range if start_double_col is less than zero, or larger
 ///        than (N_PIXEL_COLS/2)-1.
 ///@throw  std::out_of_range if stop_double_col is less than one, or larger
 ///        than N_PIXEL_COLS/2.
 ///@throw  std::out_of_range if stop_double_col is greater than or equal to start_double_col
-std::shared_ptr<PixelHit> PixelMatrix::readPixel(uint64_t time_now, int start_double_col,
-                                                  int stop_double_col)
+PixelHitPtr PixelMatrix::readPixel(uint64_t time_now, int start_double_col,
+                                   int stop_double_col)
 {
-  std::shared_ptr<PixelHit> pixel_retval = std::make_shared<PixelHit>(NoPixelHit);
+  PixelHitPtr pixel_retval = makePixelHit(NoPixelHit);
 
 #ifdef EXCEPTION_CHECKS
   // Out of range exception check
@@ -234,18 +290,19 @@ std::shared_ptr<PixelHit> PixelMatrix::readPixel(uint64_t time_now, int start_do
   }
 #endif
 
-  // Do we have any stored events?
-  if(mColumnBuffs.empty() == false) {
-    std::vector<PixelDoubleColumn>& oldest_event_buffer = mColumnBuffs.front();
-    int& oldest_event_buffer_hits_remaining = mColumnBuffsPixelsLeft.front();
+  // Do we have any stored events, with pixels left in the regions for these columns?
+  if((getRegionsNotEmptyMask() & getRegionMask(start_double_col, stop_double_col)) != 0) {
+    MultiEventBuffer& oldest_event_buffer = getOldestMEB();
 
     // Search for the first column that has pixels to read out
-    //for(auto it = oldest_event_buffer.begin(); it != oldest_event_buffer.end(); it++) {
     for(int i = start_double_col; i < stop_double_col; i++) {
-      if(oldest_event_buffer[i].pixelHitsRemaining() > 0) {
-        pixel_retval = oldest_event_buffer[i].readPixel();
+      if(oldest_event_buffer.mDoubleCols[i].pixelHitsRemaining() > 0) {
+        pixel_retval = oldest_event_buffer.mDoubleCols[i].readPixel();
 
-        oldest_event_buffer_hits_remaining--;
+        unsigned int region = i / N_PIXEL_DOUBLE_COLS_PER_REGION;
+        oldest_event_buffer.mPixelsLeft--;
+        if(--oldest_event_buffer.mRegionPixelsLeft[region] == 0)
+          oldest_event_buffer.mRegionsNotEmpty &= ~(1u << region);
         break;
       }
     }
@@ -264,10 +321,10 @@ std::shared_ptr<PixelHit> PixelMatrix::readPixel(uint64_t time_now, int start_do
 ///@param[in]  region The region number to read out a pixel from
 ///@param[in]  time_now Simulation time when this readout is occuring. Required for updating
 ///                   histogram data in case an MEB is done reading out.
-///@return shared_ptr to PixelHit with hit coordinates. If no pixel hits exist,
+///@return PixelHitPtr to PixelHit with hit coordinates. If no pixel hits exist,
 ///        NoPixelHit is returned (PixelHit object with coords = (-1,-1)).
 ///@throw  std::out_of_range if region is less than zero, or greater than N_REGIONS-1
-std::shared_ptr<PixelHit> PixelMatrix::readPixelRegion(int region, uint64_t time_now) {
+PixelHitPtr PixelMatrix::readPixelRegion(int region, uint64_t time_now) {
 #ifdef EXCEPTION_CHECKS
   if(region < 0 || region >= N_REGIONS)
     throw std::out_of_range("region");
@@ -284,25 +341,42 @@ std::shared_ptr<PixelHit> PixelMatrix::readPixelRegion(int region, uint64_t time
 ///@return Number of hits in oldest event. If there are no events left, return zero.
 int PixelMatrix::getHitsRemainingInOldestEvent(void)
 {
-  if(mColumnBuffs.empty() == true) {
+  if(mNumMEBsInUse == 0) {
     return 0;
   }
   else {
-    return mColumnBuffsPixelsLeft.front();
+    return getOldestMEB().mPixelsLeft;
   }
 }
 
 
+///@brief Get the number of hits left in the region with most hits in the oldest event.
+///@return Number of hits, or 0 if there are no events.
+int PixelMatrix::getMaxRegionHitsInOldestEvent(void)
+{
+  int max_hits = 0;
+
+  if(mNumMEBsInUse > 0) {
+    MultiEventBuffer& oldest_event_buffer = getOldestMEB();
+
+    for(int region = 0; region < N_REGIONS; region++) {
+      if(oldest_event_buffer.mRegionPixelsLeft[region] > max_hits)
+        max_hits = oldest_event_buffer.mRegionPixelsLeft[region];
+    }
+  }
+
+  return max_hits;
+}
+
+
 ///@brief Get total number of hits in all Multi Event Buffers.
 ///@return Total number of hits.
 int PixelMatrix::getHitTotalAllEvents(void)
 {
   int hit_sum = 0;
 
-  if(mColumnBuffs.empty() == false) {
-    for(std::list<int>::iterator it = mColumnBuffsPixelsLeft.begin(); it != mColumnBuffsPixelsLeft.end(); it++) {
-      hit_sum += *it;
-    }
+  for(unsigned int i = 0; i < mNumMEBsInUse; i++) {
+    hit_sum += mMEBs[(mOldestMEB+i) % N_MULTI_EVENT_BUFFERS].mPixelsLeft;
   }
 
   return hit_sum;
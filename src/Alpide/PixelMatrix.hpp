@@ -19,26 +19,49 @@
 
 #include "PixelDoubleColumn.hpp"
 #include <vector>
-#include <queue>
-#include <list>
 #include <map>
 #include <memory>
 #include <cstdint>
 
 
+///@brief A Multi Event Buffer (MEB) slot in PixelMatrix. The slots are allocated
+///       once and reused (cleared in place) for the following events.
+struct MultiEventBuffer
+{
+  ///@brief The pixel double columns in this MEB. Allocated the first time the
+  ///       slot is used.
+  std::vector<PixelDoubleColumn> mDoubleCols;
+
+  ///@brief Number of pixels left (not read out yet) in this MEB
+  int mPixelsLeft = 0;
+
+  ///@brief Number of pixels left in each region of this MEB
+  std::uint16_t mRegionPixelsLeft[N_REGIONS] = {0};
+
+  ///@brief Bit N is set when region N has pixels left in this MEB
+  std::uint32_t mRegionsNotEmpty = 0;
+};
+
+
 class PixelMatrix
 {
 private:
-  ///@brief mColumnBuffs holds multi event buffers of pixel columns
-  ///       The queue represent the MEBs, and the vector the pixel columns.
-  ///@todo  Implement event ID somewhere. Maybe make an MEB class, and use it as
-  ///       the datatype for this queue?
-  std::queue< std::vector<PixelDoubleColumn> > mColumnBuffs;
+  ///@brief mMEBs holds the multi event buffers of pixel columns, used as a ring buffer.
+  ///@todo  Implement event ID somewhere?
+  MultiEventBuffer mMEBs[N_MULTI_EVENT_BUFFERS];
+
+  ///@brief Index of the oldest MEB in mMEBs
+  unsigned int mOldestMEB = 0;
 
-  ///@brief Each entry here corresponds to one entry in mColumnBuffs. This variable
-  ///       keeps track of the number of pixel left in the columns in each entry in
-  ///       mColumnBuffs.
-  std::list<int> mColumnBuffsPixelsLeft;
+  ///@brief Number of MEBs in use
+  unsigned int mNumMEBsInUse = 0;
+
+  MultiEventBuffer& getOldestMEB(void) {return mMEBs[mOldestMEB];}
+  MultiEventBuffer& getNewestMEB(void) {
+    return mMEBs[(mOldestMEB+mNumMEBsInUse-1) % N_MULTI_EVENT_BUFFERS];
+  }
+  void clearMEB(MultiEventBuffer& meb);
+  std::uint32_t getRegionMask(int start_double_col, int stop_double_col) const;
 
   ///@brief This map contains histogram values over MEB usage. The key is the number
   ///       of MEBs in use, and the value is the total time duration for that key.
@@ -65,15 +88,19 @@ public:
   void deleteEvent(uint64_t event_time);
   void flushOldestEvent(void);
   void setPixel(unsigned int col, unsigned int row);
-  void setPixel(const std::shared_ptr<PixelHit> &pixel);
+  void setPixel(const PixelHitPtr &pixel);
   bool regionEmpty(int start_double_col, int stop_double_col);
   bool regionEmpty(int region);
-  std::shared_ptr<PixelHit> readPixel(uint64_t time_now,
-                                      int start_double_col = 0,
-                                      int stop_double_col = N_PIXEL_COLS/2);
-  std::shared_ptr<PixelHit> readPixelRegion(int region, uint64_t time_now);
-  int getNumEvents(void) {return mColumnBuffs.size();}
+  PixelHitPtr readPixel(uint64_t time_now,
+                        int start_double_col = 0,
+                        int stop_double_col = N_PIXEL_COLS/2);
+  PixelHitPtr readPixelRegion(int region, uint64_t time_now);
+  int getNumEvents(void) {return mNumMEBsInUse;}
+  std::uint32_t getRegionsNotEmptyMask(void) {
+    return mNumMEBsInUse > 0 ? getOldestMEB().mRegionsNotEmpty : 0;
+  }
   int getHitsRemainingInOldestEvent(void);
+  int getMaxRegionHitsInOldestEvent(void);
   int getHitTotalAllEvents(void);
   std::map<unsigned int, std::uint64_t> getMEBHisto(void) const {
     return mMEBHistogram;
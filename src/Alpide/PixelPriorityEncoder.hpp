@@ -43,8 +43,8 @@ public:
      @param rightIn Right side argument
      @return True if leftIn has highest priority, false if rightIn has higest priority
   */
-  bool operator()(const std::shared_ptr<PixelHit> &leftIn,
-                  const std::shared_ptr<PixelHit> &rightIn)
+  bool operator()(const PixelHitPtr &leftIn,
+                  const PixelHitPtr &rightIn)
     {
       if(leftIn->mRow < rightIn->mRow)
         return true;
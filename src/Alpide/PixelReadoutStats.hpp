@@ -2,10 +2,20 @@
  * @file   PixelReadoutStats.hpp
  * @author Simon Voigt Nesbo
  * @date   August 13, 2018
- * @brief  Header file for PixelReadoutStats class. This class holds a map that stores counts of how
- *         many times a pixel hit was read out. The key in the map is how many times a pixel
- *         hit was read out, and value is for how many pixel hit this occured.
- *         Readout efficiency and pile up statistics can be calculated using this map.
+ * @brief  Header file for PixelReadoutStats class. This class holds counts of how many times
+ *         a pixel hit was read out, per chip. For each chip it stores for how many pixel hits
+ *         each readout count occured. Readout efficiency and pile up statistics can be
+ *         calculated using these counts.
+ *
+ *         addReadoutCount() is called every time a PixelHit is destroyed, so the counts are
+ *         stored in a dense array indexed by global chip id (which is contiguous for all the
+ *         detectors), with a small fixed number of bins per chip. The array grows to the
+ *         highest chip id in use. The rare readout counts that do not fit in the bins go in
+ *         an overflow map.
+ *
+ *         PixelHit objects are only destroyed on the SystemC thread (the parallel chip
+ *         evaluator latches hits that are still referenced by the chip's hit queue),
+ *         so the counts are not protected against concurrent updates.
  */
 
 
@@ -15,54 +25,109 @@
 #define PIXEL_READOUT_STATS_HPP
 
 #include <map>
+#include <vector>
 #include <cstdint>
 #include <fstream>
 #include <iostream>
 
 class PixelReadoutStats
 {
+public:
+  /// Number of readout counts (0 to READOUT_COUNT_BINS-1) that have a dedicated bin.
+  /// Pixel hits are rarely read out more than a few times.
+  static const unsigned int READOUT_COUNT_BINS = 8;
+
+  ///@brief Readout stats for the pixel hits in one chip
+  struct ChipReadoutCounts {
+    ///Number of pixel hits that were read out a number of times, index = readout count
+    ///e.g.
+    /// mBins[0] == 100 --> 100 hits were never read out
+    /// mBins[1] == 550 --> 550 hits were read out once
+    /// mBins[2] == 300 --> 300 hits were read out twice
+    std::uint64_t mBins[READOUT_COUNT_BINS] = {};
+
+    ///Key = readout count (>= READOUT_COUNT_BINS), value = number of pixel hits
+    std::map<unsigned int, std::uint64_t> mOverflow;
+
+    ///True if any pixel hits were counted for this chip
+    bool mUsed = false;
+
+    inline void add(unsigned int count, std::uint64_t num_hits) {
+      if(count < READOUT_COUNT_BINS)
+        mBins[count] += num_hits;
+      else
+        mOverflow[count] += num_hits;
+      mUsed = true;
+    }
+
+    inline std::uint64_t get(unsigned int count) const {
+      if(count < READOUT_COUNT_BINS)
+        return mBins[count];
+
+      auto it = mOverflow.find(count);
+      return it != mOverflow.end() ? it->second : 0;
+    }
+
+    ///@brief Highest readout count that any pixel hit in this chip had
+    inline unsigned int getHighestReadoutCount(void) const {
+      if(!mOverflow.empty())
+        return mOverflow.rbegin()->first;
+
+      for(unsigned int count = READOUT_COUNT_BINS-1; count > 0; count--) {
+        if(mBins[count] != 0)
+          return count;
+      }
+      return 0;
+    }
+  };
+
 private:
   ///@brief Readout stats for pixel hits.
-  ///Outer key = Chip id
-  ///Inner key = number of times pixel hit was read out (or pile up value)
-  ///Value = number of pixel hits that was read out this number of times
-  ///e.g.
-  /// mReadoutStats[0] == 100 --> 100 hits were never read out
-  /// mReadoutStats[1] == 550 --> 550 hits were read out once
-  /// mReadoutStats[2] == 300 --> 300 hits were read out twice
-  ///
-  /// The sum of values for mReadoutStats[1..N] equals the total number of hits that were read out
-  std::map<unsigned int, std::map<unsigned int, std::uint64_t>> mReadoutStats;
+  ///Index = global chip id
+  std::vector<ChipReadoutCounts> mReadoutStats;
 
 public:
   ///@brief Add readout count for a pixel hits.
   ///@param[in] count The number of times a particular pixel hit was read out
   ///@param[in] chip_id The chip that this pixel belonged to
   inline void addReadoutCount(unsigned int count, unsigned int chip_id) {
-    mReadoutStats[chip_id][count]++;
+    if(chip_id >= mReadoutStats.size())
+      mReadoutStats.resize(chip_id+1);
+
+    mReadoutStats[chip_id].add(count, 1);
   }
 
   ///@brief Get the number of pixel hits that were not read out
   ///@param[in] chip_id Chip to get this count for
   ///@return Number of pixel hits that were not read out
-  inline unsigned int getNotReadOutCount(unsigned int chip_id) {
-    return mReadoutStats[chip_id][0];
+  inline unsigned int getNotReadOutCount(unsigned int chip_id) const {
+    if(chip_id >= mReadoutStats.size())
+      return 0;
+
+    return mReadoutStats[chip_id].mBins[0];
   }
 
   ///@brief Get the number of pixel hits that were actually read out
   //////@param[in] chip_id Chip to get this count for
   ///@return Number of pixel hits that were read out
-  inline unsigned int getReadOutCount(unsigned int chip_id) {
+  inline unsigned int getReadOutCount(unsigned int chip_id) const {
     unsigned int read_out_count = 0;
 
-    for(auto stats_it = mReadoutStats[chip_id].begin(); stats_it != mReadoutStats[chip_id].end(); stats_it++) {
-      if(stats_it->first != 0)
-        read_out_count += stats_it->second;
-    }
+    if(chip_id >= mReadoutStats.size())
+      return 0;
+
+    const ChipReadoutCounts& chip_stats = mReadoutStats[chip_id];
+
+    for(unsigned int count = 1; count < READOUT_COUNT_BINS; count++)
+      read_out_count += chip_stats.mBins[count];
+
+    for(auto it = chip_stats.mOverflow.begin(); it != chip_stats.mOverflow.end(); it++)
+      read_out_count += it->second;
+
     return read_out_count;
   }
 
-  ///@brief Create a CSV file with pixel readout stats versus chip ID
+  ///@brief Create a CSV file with pixel readout stats versus chip ID.
   inline void writeToFile(const std::string& filename) const {
     std::ofstream file(filename);
 
@@ -71,13 +136,11 @@ public:
 
       std::cout << "Writing pixel readout stats to: \"" << filename << "\"" << std::endl;
 
-      // The key in innermost map has the number of times a specific pixel was read out
-      // We're looking for the highest number so we know how far the CSV header should go
+      // We're looking for the highest number of times a specific pixel was read out,
+      // so we know how far the CSV header should go
       for(auto chip_it = mReadoutStats.begin(); chip_it != mReadoutStats.end(); chip_it++) {
-        for(auto pixel_it = chip_it->second.begin(); pixel_it != chip_it->second.end(); pixel_it++) {
-          if(pixel_it->first > highest_readout_count)
-            highest_readout_count = pixel_it->first;
-        }
+        if(chip_it->mUsed && chip_it->getHighestReadoutCount() > highest_readout_count)
+          highest_readout_count = chip_it->getHighestReadoutCount();
       }
 
       // Write CSV header
@@ -87,28 +150,17 @@ public:
       }
 
 
-      // Write readout stats per chip
-      for(auto chip_it = mReadoutStats.begin(); chip_it != mReadoutStats.end(); chip_it++) {
+      // Write readout stats per chip, for the chips that had pixel hits
+      for(unsigned int chip_id = 0; chip_id < mReadoutStats.size(); chip_id++) {
+        if(!mReadoutStats[chip_id].mUsed)
+          continue;
+
         file << std::endl;
-        file << chip_it->first; // Write chip ID to CSV file
-
-        unsigned int readout_count = 0;
-
-        // Write readout counts for this chip. Assumes that the map is ordered
-        for(auto pixel_it = chip_it->second.begin(); pixel_it != chip_it->second.end(); pixel_it++) {
-          // Fill in zeros in CSV for readout counts that are not in the map
-          while(pixel_it->first > readout_count) {
-            file << ";" << 0;
-            readout_count++;
-          }
-          file << ";" << pixel_it->second;
-          readout_count++;
-        }
+        file << chip_id; // Write chip ID to CSV file
 
-        // Fill in zeros for the remaining readout counts that were not in the map
-        while(readout_count <= highest_readout_count) {
-          file << ";" << 0;
-          readout_count++;
+        // Write readout counts for this chip, with zeros for readout counts that did not occur
+        for(unsigned int count = 0; count <= highest_readout_count; count++) {
+          file << ";" << mReadoutStats[chip_id].get(count);
         }
       }
       file.close();
@@ -9,6 +9,7 @@
 #include <iostream>
 #include "RegionReadoutUnit.hpp"
 #include "../misc/vcd_trace.hpp"
+#include "../Profiling/ProcessProfiler.hpp"
 
 
 
@@ -59,6 +60,8 @@ RegionReadoutUnit::RegionReadoutUnit(sc_core::sc_module_name name,
 ///       Region Readout Unit (RRU). NOTE: Should run at system clock frequency (40MHz).
 void RegionReadoutUnit::regionUnitProcess(void)
 {
+  PROFILE_PROCESS("RegionReadoutUnit::regionUnitProcess");
+
   if(mIdle) {
     // Revert to static sensitivity (clocked), and wait till next clock cycle
     // because dynamic sensitivity to signal changes triggers the method
@@ -442,6 +445,8 @@ void RegionReadoutUnit::regionHeaderFSM(void)
 ///       Moore FSM style combinatorial output from region header FSM
 void RegionReadoutUnit::regionHeaderFSMOutput(void)
 {
+  PROFILE_PROCESS("RegionReadoutUnit::regionHeaderFSMOutput");
+
   // Next state logic
   switch(s_rru_header_state.read()) {
   case HEADER_FSM::HEADER:
@@ -476,7 +481,7 @@ bool RegionReadoutUnit::readoutNextPixel(PixelMatrix& matrix)
   int64_t time_now = sc_time_stamp().value();
 
 
-  std::shared_ptr<PixelHit> p = matrix.readPixelRegion(mRegionId, time_now);
+  PixelHitPtr p = matrix.readPixelRegion(mRegionId, time_now);
 
 #ifdef EXCEPTION_CHECKS
   if(*p == NoPixelHit && matrix.regionEmpty(mRegionId) == false)
@@ -578,7 +583,8 @@ bool RegionReadoutUnit::readoutNextPixel(PixelMatrix& matrix)
 }
 
 
-///@brief Flush the region fifo. Used in data overrun mode. The function assumes that
+///@brief Flush the region fifo. Used in data overrun mode, and for the data words that are
+///       left in the fifo at the end of the simulation. The function assumes that
 ///       the fifo can be flushed in one clock cycle.
 void RegionReadoutUnit::flushRegionFifo(void)
 {
@@ -586,6 +592,9 @@ void RegionReadoutUnit::flushRegionFifo(void)
 
   while(s_region_fifo.used() > 0) {
     s_region_fifo.nb_get(data);
+
+    // The pixels in flushed data words were not read out
+    data.releasePixelRefs(false);
   }
 }
 
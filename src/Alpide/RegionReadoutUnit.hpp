@@ -141,7 +141,7 @@ private:
   /// currently being read out. They need to be included in the AlpideDataShort/AlpideDataLong
   /// words, so that we can both increase and decrease PixelHit's readout counter, both when
   /// reading out pixel in readoutNextPixel(), and when flushing RRU FIFO in case of readout abort.
-  std::vector<std::shared_ptr<PixelHit>> mPixelClusterVec;
+  std::vector<PixelHitPtr> mPixelClusterVec;
 
   unsigned int mFifoSizeLimit;
 
@@ -167,13 +167,13 @@ private:
 private:
   bool readoutNextPixel(PixelMatrix& matrix);
   void updateRegionDataOut(void);
-  void flushRegionFifo(void);
 
 public:
   RegionReadoutUnit(sc_core::sc_module_name name, PixelMatrix* matrix,
                     unsigned int region_num, unsigned int fifo_size,
                     bool matrix_readout_speed, bool cluster_enable);
   void regionUnitProcess(void);
+  void flushRegionFifo(void);
   void regionHeaderFSMOutput(void);
   bool regionMatrixReadoutFSM(void);
   bool regionValidFSM(void);
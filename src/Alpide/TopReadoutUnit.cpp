@@ -7,6 +7,7 @@
 
 #include "TopReadoutUnit.hpp"
 #include "../misc/vcd_trace.hpp"
+#include "../Profiling/ProcessProfiler.hpp"
 
 
 SC_HAS_PROCESS(TopReadoutUnit);
@@ -14,15 +15,19 @@ SC_HAS_PROCESS(TopReadoutUnit);
 ///@param[in] name SystemC module name
 //////@param[in] global_chip_id Global chip ID that uniquely identifies chip in simulation
 ///@param[in] local_chip_id Chip ID that identifies chip in the stave or module
+///@param[in] data_word_count Counters for data words transmitted by the chip
+///@param[in] clock_skipping Skip clock cycles in the FSM state update while the TRU is idle
 TopReadoutUnit::TopReadoutUnit(sc_core::sc_module_name name,
                                const unsigned int global_chip_id,
                                const unsigned int local_chip_id,
-                               std::shared_ptr<std::map<AlpideDataType, uint64_t>> data_word_count)
+                               std::shared_ptr<std::map<AlpideDataType, uint64_t>> data_word_count,
+                               bool clock_skipping)
   : sc_core::sc_module(name)
   , mGlobalChipId(global_chip_id)
   , mLocalChipId(local_chip_id)
   , mIdle(false)
   , mDataWordCount(data_word_count)
+  , mClockSkippingEnable(clock_skipping)
 {
   s_tru_current_state = IDLE;
   s_tru_next_state = IDLE;
@@ -36,6 +41,33 @@ TopReadoutUnit::TopReadoutUnit(sc_core::sc_module_name name,
 
   SC_METHOD(topRegionReadoutStateUpdate);
   sensitive_pos << s_clk_in;
+
+  SC_METHOD(regionMaskUpdate);
+  for(int i = 0; i < N_REGIONS; i++)
+    sensitive << s_region_valid_in[i] << s_region_fifo_empty_in[i];
+}
+
+
+///@brief SystemC method that packs the region valid and region fifo empty inputs into
+///       bit masks. Only runs when one of the inputs change, which is much less often than
+///       the TRU FSM runs. The inputs are updated on the rising clock edge, so the masks
+///       have settled by the time topRegionReadoutOutputNextState() reads them.
+void TopReadoutUnit::regionMaskUpdate(void)
+{
+  PROFILE_PROCESS("TopReadoutUnit::regionMaskUpdate");
+
+  uint32_t valid_mask = 0;
+  uint32_t fifo_empty_mask = 0;
+
+  for(int i = 0; i < N_REGIONS; i++) {
+    if(s_region_valid_in[i])
+      valid_mask |= (1u << i);
+    if(s_region_fifo_empty_in[i])
+      fifo_empty_mask |= (1u << i);
+  }
+
+  s_region_valid_mask = valid_mask;
+  s_region_fifo_empty_mask = fifo_empty_mask;
 }
 
 
@@ -44,14 +76,15 @@ TopReadoutUnit::TopReadoutUnit(sc_core::sc_module_name name,
 ///@return True if a valid region was found.
 bool TopReadoutUnit::getNextRegion(unsigned int& region_out)
 {
-  for(int i = 0; i < N_REGIONS; i++) {
-    if(s_region_valid_in[i] == true) {
-      region_out = i;
-      return true;
-    }
+  uint32_t valid_mask = s_region_valid_mask.read();
+
+  if(valid_mask == 0) {
+    region_out = 0;
+    return false;
   }
-  region_out = 0;
-  return false;
+
+  region_out = __builtin_ctz(valid_mask);
+  return true;
 }
 
 
@@ -59,19 +92,31 @@ bool TopReadoutUnit::getNextRegion(unsigned int& region_out)
 ///@return true if no regions are empty
 bool TopReadoutUnit::getNoRegionsEmpty(void)
 {
-  bool or_empty = false;
-
-  for(int i = 0; i < N_REGIONS; i++) {
-    or_empty = or_empty || s_region_fifo_empty_in[i];
-  }
-
-  return !or_empty;
+  return s_region_fifo_empty_mask.read() == 0;
 }
 
 
 ///@brief SystemC method for updating the current state of the TRU's FSM
 void TopReadoutUnit::topRegionReadoutStateUpdate(void)
 {
+  PROFILE_PROCESS("TopReadoutUnit::topRegionReadoutStateUpdate");
+
+  if(mStateUpdateSleeping) {
+    // Woken up between clock edges, wait for the next clock edge
+    if(!s_clk_in.posedge()) {
+      next_trigger();
+      return;
+    }
+    mStateUpdateSleeping = false;
+  } else if(mClockSkippingEnable && mIdle && !s_write_dmu_fifo &&
+            s_tru_current_state.read() == s_tru_next_state.read()) {
+    // The FSM is idle and waiting for the frame start fifo, and nothing would
+    // change here until then. Sleep until the FSM is woken up.
+    mStateUpdateSleeping = true;
+    next_trigger(s_frame_start_fifo_output->ok_to_peek() | E_enabled);
+    return;
+  }
+
   s_tru_current_state = s_tru_next_state;
 
   E_update_fsm.notify(12.5, SC_NS);
@@ -80,29 +125,32 @@ void TopReadoutUnit::topRegionReadoutStateUpdate(void)
   AlpideDataWord data_out;
   std::uint64_t time_now = sc_time_stamp().value();
   if(s_write_dmu_fifo) {
-    s_dmu_fifo_input->nb_write(s_tru_data.read());
-
     data_out = s_tru_data.read();
 
+    bool dmu_fifo_written = s_dmu_fifo_input->nb_write(data_out);
+
     (*mDataWordCount)[data_out.data_type]++;
 
 #ifdef PIXEL_DEBUG
     if(data_out.data_type == ALPIDE_REGION_TRAILER) {
       std::cerr << "@" << time_now << "ns: Global chip ID " << mGlobalChipId;
       std::cerr << " TRU: Oops, just read out REGION_TRAILER" << std::endl;
-    } else if(data_out.data_type == ALPIDE_DATA_SHORT) {
-      auto data_short = static_cast<AlpideDataShort*>(&data_out);
-      data_short->mPixel->mTRU = true;
-      data_short->mPixel->mTRUTime = time_now;
-    } else if(data_out.data_type == ALPIDE_DATA_LONG) {
-      auto data_long = static_cast<AlpideDataLong*>(&data_out);
-
-      for(auto pix_it = data_long->mPixels.begin(); pix_it != data_long->mPixels.end(); pix_it++) {
+    } else if(data_out.data_type == ALPIDE_DATA_SHORT ||
+              data_out.data_type == ALPIDE_DATA_LONG) {
+      for(auto pix_it = data_out.pixel_refs->mPixels.begin();
+          pix_it != data_out.pixel_refs->mPixels.end();
+          pix_it++)
+      {
         (*pix_it)->mTRU = true;
         (*pix_it)->mTRUTime = time_now;
       }
     }
 #endif
+
+    // The pixels in a data word that was dropped because the DMU FIFO was full
+    // were not read out
+    if(!dmu_fifo_written)
+      data_out.releasePixelRefs(false);
   }
 }
 
@@ -117,6 +165,8 @@ void TopReadoutUnit::topRegionReadoutStateUpdate(void)
 ///@image html TRU_state_machine.png
 void TopReadoutUnit::topRegionReadoutOutputNextState(void)
 {
+  PROFILE_PROCESS("TopReadoutUnit::topRegionReadoutOutputNextState");
+
   std::uint64_t time_now = sc_time_stamp().value();
   // If we were idle with dynamic sensitivity enabled,
   // revert back to static sensitivity now that something happened.
@@ -182,17 +232,18 @@ void TopReadoutUnit::topRegionReadoutOutputNextState(void)
     break;
 
   case IDLE:
-    if(!frame_start_fifo_empty) {
+    if(!frame_start_fifo_empty && mEnable) {
       s_frame_start_fifo_output->nb_peek(mCurrentFrameStartWord);
       s_tru_next_state = WAIT_REGION_DATA;
-    } else if(!s_frame_start_fifo_output->nb_can_get()){
+    } else if(!s_frame_start_fifo_output->nb_can_get() || !mEnable){
       // If we are idle, and will remain idle, change to dynamic sensitivity
-      // and wait for something to be added to the frame start fifo,
-      // and save simulation time by not triggering on every clock cycle.
-      next_trigger(s_frame_start_fifo_output->ok_to_peek());
+      // and wait for something to be added to the frame start fifo (or for
+      // the TRU to be enabled), and save simulation time by not triggering
+      // on every clock cycle.
+      next_trigger(s_frame_start_fifo_output->ok_to_peek() | E_enabled);
       mIdle = true;
     }
-    s_region_event_start_out = !frame_start_fifo_empty;
+    s_region_event_start_out = !frame_start_fifo_empty && mEnable;
     s_region_event_pop_out = false;
     s_region_data_read_out[current_region] = false;
     s_region_data_read_debug = false;
@@ -242,15 +293,11 @@ void TopReadoutUnit::topRegionReadoutOutputNextState(void)
     s_region_event_pop_out = false;
     s_region_event_start_out = false;
 
-    s_region_data_read_out[current_region] =
-      !dmu_data_fifo_full &&
-      !no_regions_valid &&
-      no_regions_empty;
-
-    s_region_data_read_debug =
-      !dmu_data_fifo_full &&
-      !no_regions_valid &&
-      no_regions_empty;
+    // The first region is not read before the REGION_DATA state. Reading it here, while
+    // the chip header is written to the DMU FIFO, would make the RRU move on from its
+    // REGION HEADER without it ever being written to the DMU FIFO.
+    s_region_data_read_out[current_region] = false;
+    s_region_data_read_debug = false;
     break;
 
 
@@ -337,6 +384,19 @@ void TopReadoutUnit::topRegionReadoutOutputNextState(void)
 }
 
 
+///@brief Enable or disable readout of new frames. Used by the Alpide hybrid mode, where the
+///       frames are handled by the frame level model while the TRU is disabled. Should only
+///       be changed on a frame boundary, when the TRU is idle (see getIdle()).
+///@param[in] enable True to enable the TRU
+void TopReadoutUnit::setEnable(bool enable)
+{
+  if(enable && !mEnable)
+    E_enabled.notify(SC_ZERO_TIME);
+
+  mEnable = enable;
+}
+
+
 ///@brief Add SystemC signals to log in VCD trace file.
 ///@param[in,out] wf Pointer to VCD trace file object
 ///@param[in] name_prefix Name prefix to be added to all the trace names
@@ -70,6 +70,12 @@ private:
 
   sc_event E_update_fsm;
 
+  ///@brief Bit N is set when s_region_valid_in[N] is set
+  sc_signal<uint32_t> s_region_valid_mask;
+
+  ///@brief Bit N is set when s_region_fifo_empty_in[N] is set
+  sc_signal<uint32_t> s_region_fifo_empty_mask;
+
   ///@brief Signal copy of all_regions_empty variable, 1 cycle delayed
   sc_signal<bool> s_no_regions_empty_debug;
 
@@ -100,6 +106,18 @@ private:
   /// (Used to disable sensitivity to clock to save simulation time);
   bool mIdle;
 
+  ///@brief Allow topRegionReadoutStateUpdate() to skip clock cycles while the TRU is idle
+  bool mClockSkippingEnable;
+
+  ///@brief True while topRegionReadoutStateUpdate() is sleeping
+  bool mStateUpdateSleeping = false;
+
+  ///@brief New frames are only read out while the TRU is enabled, see setEnable()
+  bool mEnable = true;
+
+  ///@brief Notified when the TRU is enabled, to wake it up if it is idle
+  sc_event E_enabled;
+
   enum TRU_state_t {
     EMPTY = 0,
     IDLE = 1,
@@ -113,6 +131,7 @@ private:
 
   void topRegionReadoutOutputNextState(void);
   void topRegionReadoutStateUpdate(void);
+  void regionMaskUpdate(void);
   //void topRegionReadoutOutputMethod(void);
   bool getNextRegion(unsigned int& region_out);
   bool getNoRegionsEmpty(void);
@@ -120,8 +139,15 @@ private:
 public:
   TopReadoutUnit(sc_core::sc_module_name name,
                  const unsigned int global_chip_id, const unsigned int local_chip_id,
-                 std::shared_ptr<std::map<AlpideDataType, uint64_t>> data_word_count);
+                 std::shared_ptr<std::map<AlpideDataType, uint64_t>> data_word_count,
+                 bool clock_skipping = false);
   void addTraces(sc_trace_file *wf, std::string name_prefix) const;
+  void setEnable(bool enable);
+
+  ///@brief True when the TRU is idle and not reading out a frame
+  bool getIdle(void) const {
+    return s_tru_current_state.read() == IDLE && s_tru_next_state.read() == IDLE;
+  }
 };
 
 
@@ -21,6 +21,8 @@
 #define N_PIXEL_DOUBLE_COLS_PER_REGION (N_PIXEL_COLS_PER_REGION/2)
 #define N_PIXELS_PER_REGION (N_PIXEL_COLS/N_REGIONS)
 
+#define N_MULTI_EVENT_BUFFERS 3
+
 #define REGION_FIFO_SIZE 128
 
 #define TRU_FRAME_FIFO_ALMOST_FULL1 48
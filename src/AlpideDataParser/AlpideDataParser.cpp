@@ -9,6 +9,7 @@
  */
 
 #include "misc/vcd_trace.hpp"
+#include "Profiling/ProcessProfiler.hpp"
 #include "AlpideDataParser.hpp"
 #include <cstddef>
 #include <iostream>
@@ -75,18 +76,7 @@ AlpideEventBuilder::AlpideEventBuilder(unsigned int data_rate_interval_ns,
   , mSaveEvents(save_events)
   , mIncludeHitData(include_hit_data)
 {
-  mProtocolStats[ALPIDE_IDLE] = 0;
-  mProtocolStats[ALPIDE_CHIP_HEADER] = 0;
-  mProtocolStats[ALPIDE_CHIP_TRAILER] = 0;
-  mProtocolStats[ALPIDE_CHIP_EMPTY_FRAME] = 0;
-  mProtocolStats[ALPIDE_REGION_HEADER] = 0;
-  mProtocolStats[ALPIDE_REGION_TRAILER] = 0;
-  mProtocolStats[ALPIDE_DATA_SHORT] = 0;
-  mProtocolStats[ALPIDE_DATA_LONG] = 0;
-  mProtocolStats[ALPIDE_BUSY_ON] = 0;
-  mProtocolStats[ALPIDE_BUSY_OFF] = 0;
-  mProtocolStats[ALPIDE_COMMA] = 0;
-  mProtocolStats[ALPIDE_UNKNOWN] = 0;
+  mProtocolStats.fill(0);
 }
 
 
@@ -127,23 +117,61 @@ void AlpideEventBuilder::popEvent(void)
 }
 
 
-///@brief Takes a 1 byte of Alpide data at a time as input, parses the stream
-///       of data, and depending on the data:
+///@brief Takes a data word of up to 3 bytes of Alpide data as input, and parses the bytes
+///       in the word (MSB first). Depending on the data:
 ///       1) If this is a new Alpide data frame, a new AlpideEventFrame is created in mEvents
 ///       2) If this is data that belongs to the existing and most recent frame, hit data is added
 ///          to that frame.
 ///       3) If these are just idle words etc., nothing is done with them.
-///@param[in] data Byte of Alpide data to parse.
+///       Alpide data words may span several calls to this function (e.g. for outer barrel
+///       links, where the data is input one byte at a time).
+///@param[in] data Alpide data to parse, the first byte is in bits 23:16.
+///@param[in] num_bytes Number of bytes to parse from data (1 to 3)
 ///@param[in] trig_id Trigger ID for the currently incoming data
 ///@param[in] time_now_ns Current simulation time (in nanoseconds)
-void AlpideEventBuilder::inputDataByte(std::uint8_t data, uint64_t trig_id, uint64_t time_now_ns)
+void AlpideEventBuilder::inputDataWord(uint32_t data, unsigned int num_bytes,
+                                       uint64_t trig_id, uint64_t time_now_ns)
+{
+  uint64_t data_interval_num = time_now_ns/mDataIntervalNs;
+
+  // Create entry for interval if it does not exist. It is zero initialized.
+  // All data parsers are called on every clock cycle, and will have the same
+  // intervals recorded, which makes writing data to file easy.
+  if(data_interval_num >= mDataIntervalByteCounts.size()) {
+    mDataIntervalByteCounts.resize(data_interval_num+1, 0);
+    mDataIntervalRecorded.resize(data_interval_num+1, false);
+  }
+  mDataIntervalRecorded[data_interval_num] = true;
+
+  // Fast path for idle words, which is what the links transmit most of the time
+  const uint32_t idle_word = (0xFFFFFFu << (8*(3-num_bytes))) & 0xFFFFFF;
+  if(mDataWordStarted == false && (data & idle_word) == idle_word) {
+    mProtocolStats[ALPIDE_IDLE] += num_bytes;
+    mCurrentDwType = ALPIDE_IDLE;
+    mBusyStatusChanged = false;
+    return;
+  }
+
+  unsigned int& interval_byte_count = mDataIntervalByteCounts[data_interval_num];
+
+  for(unsigned int i = 0; i < num_bytes; i++)
+    processDataByte((data >> (16-8*i)) & 0xFF, trig_id, interval_byte_count);
+}
+
+
+///@brief Parse one byte of Alpide data, see inputDataWord()
+///@param[in] data Byte of Alpide data to parse.
+///@param[in] trig_id Trigger ID for the currently incoming data
+///@param[in,out] interval_byte_count Data byte counter for the current data rate interval
+void AlpideEventBuilder::processDataByte(std::uint8_t data, uint64_t trig_id,
+                                         unsigned int& interval_byte_count)
 {
-  // This function is called repeatedly for each byte of data, but data words are up to 3 bytes
-  // in length. So we have to detect the start of a data word, construct the full data word
-  // consisting of up to 3 bytes, and only act on the data word (e.g. creating a frame, hit
-  // info on data long/short, etc.) when the whole word has been received.
+  // Data words are up to 3 bytes in length. So we have to detect the start of a data word,
+  // construct the full data word consisting of up to 3 bytes, and only act on the data word
+  // (e.g. creating a frame, hit info on data long/short, etc.) when the whole word has been
+  // received.
   if(mDataWordStarted == false) {
-    mCurrentDwType = parseDataByte(data);
+    mCurrentDwType = mDataTypeTable[data];
     mDataWordStarted = true;
     mByteCounterCurrentWord = 0;
     mByteIndexCurrentWord = 2;
@@ -156,13 +184,6 @@ void AlpideEventBuilder::inputDataByte(std::uint8_t data, uint64_t trig_id, uint
   // Increase statistics counters for protocol utilization
   mProtocolStats[mCurrentDwType]++;
 
-  uint64_t data_interval_num = time_now_ns/mDataIntervalNs;
-
-  // Create entry for interval in map, if it does not exist. It is zero initialized.
-  // We want all data parsers to have the same sized maps, makes writing data to file
-  // easy. This will guarantee that.
-  mDataIntervalByteCounts[data_interval_num];
-
   mBusyStatusChanged = false;
 
   // Create new frame/event?
@@ -181,7 +202,7 @@ void AlpideEventBuilder::inputDataByte(std::uint8_t data, uint64_t trig_id, uint
       mDataWordStarted = false;
     }
     // Record data rate stats for every byte of data word
-    mDataIntervalByteCounts[data_interval_num]++;
+    interval_byte_count++;
     break;
 
   case ALPIDE_CHIP_TRAILER:
@@ -210,7 +231,7 @@ void AlpideEventBuilder::inputDataByte(std::uint8_t data, uint64_t trig_id, uint
       mDataWordStarted = false;
     }
     // Record data rate stats for every byte of data word
-    mDataIntervalByteCounts[data_interval_num]++;
+    interval_byte_count++;
     break;
 
   case ALPIDE_CHIP_EMPTY_FRAME:
@@ -229,7 +250,7 @@ void AlpideEventBuilder::inputDataByte(std::uint8_t data, uint64_t trig_id, uint
       mDataWordStarted = false;
     }
     // Record data rate stats for every byte of data word
-    mDataIntervalByteCounts[data_interval_num]++;
+    interval_byte_count++;
     break;
 
   case ALPIDE_REGION_HEADER:
@@ -241,7 +262,7 @@ void AlpideEventBuilder::inputDataByte(std::uint8_t data, uint64_t trig_id, uint
       mDataWordStarted = false;
     }
     // Record data rate stats for every byte of data word
-    mDataIntervalByteCounts[data_interval_num]++;
+    interval_byte_count++;
     break;
 
   case ALPIDE_REGION_TRAILER:
@@ -261,14 +282,14 @@ void AlpideEventBuilder::inputDataByte(std::uint8_t data, uint64_t trig_id, uint
       if(!mEvents.empty() && mIncludeHitData) {
         uint8_t pri_enc_id = (mCurrentDataWord[2] >> 2) & 0x0F;
         uint16_t addr = ((mCurrentDataWord[2] & 0x03) << 8) | mCurrentDataWord[1];
-        mEvents.back().addPixelHit(PixelHit(mCurrentRegion, pri_enc_id, addr));
+        mEvents.back().addPixelHit(PixelHit(mCurrentRegion, pri_enc_id, addr, mEvents.back().getChipId()));
         //std::cout << "\t" << "pri_enc: " << static_cast<unsigned int>(pri_enc_id);
         //std::cout << "\t" << "addr: " << addr << std::endl;
       }
       mDataWordStarted = false;
     }
     // Record data rate stats for every byte of data word
-    mDataIntervalByteCounts[data_interval_num]++;
+    interval_byte_count++;
     break;
 
   case ALPIDE_DATA_LONG:
@@ -285,19 +306,19 @@ void AlpideEventBuilder::inputDataByte(std::uint8_t data, uint64_t trig_id, uint
         //std::cout << "\t" << "hitmap: " << hitmap_bits << std::endl;
 
         // Add hit for base address of cluster
-        mEvents.back().addPixelHit(PixelHit(mCurrentRegion, pri_enc_id, addr));
+        mEvents.back().addPixelHit(PixelHit(mCurrentRegion, pri_enc_id, addr, mEvents.back().getChipId()));
 
         // There's 7 hits in a hitmap
         for(int i = 0; i < 8; i++) {
           // Add a hit for each bit that is set in the hitmap
           if((hitmap >> i) & 0x01)
-            mEvents.back().addPixelHit(PixelHit(mCurrentRegion, pri_enc_id, addr+i+1));
+            mEvents.back().addPixelHit(PixelHit(mCurrentRegion, pri_enc_id, addr+i+1, mEvents.back().getChipId()));
         }
       }
       mDataWordStarted = false;
     }
     // Record data rate stats for every byte of data word
-    mDataIntervalByteCounts[data_interval_num]++;
+    interval_byte_count++;
     break;
 
     // Not used.. checking all 3 bytes at the bottom of this function
@@ -338,10 +359,27 @@ void AlpideEventBuilder::inputDataByte(std::uint8_t data, uint64_t trig_id, uint
 }
 
 
-///@brief A byte from Alpide data stream
+const std::array<AlpideDataType, 256> AlpideEventBuilder::mDataTypeTable =
+  AlpideEventBuilder::createDataTypeTable();
+
+
+///@brief Create lookup table with the data word type for each possible
+///       value of the first byte of a data word
+std::array<AlpideDataType, 256> AlpideEventBuilder::createDataTypeTable(void)
+{
+  std::array<AlpideDataType, 256> table;
+
+  for(unsigned int data = 0; data < 256; data++)
+    table[data] = decodeDataType(data);
+
+  return table;
+}
+
+
+///@brief Decode the data word type from the first byte of an Alpide data word
 ///@param[in] data Alpide data byte
-///@return AlpideDataParsed object with parsed data word type filled in for each byte
-AlpideDataType AlpideEventBuilder::parseDataByte(std::uint8_t data)
+///@return Data word type
+AlpideDataType AlpideEventBuilder::decodeDataType(std::uint8_t data)
 {
   // Parse most significant byte (data is sent MSB first)
   uint8_t data_word_check = data & MASK_DATA;
@@ -413,19 +451,16 @@ AlpideDataParser::AlpideDataParser(sc_core::sc_module_name name, bool word_mode,
 ///       A busy signal indicates if the parser has detected BUSY ON/OFF words.
 void AlpideDataParser::parserInputProcess(void)
 {
+  PROFILE_PROCESS("AlpideDataParser::parserInputProcess");
+
   uint64_t time_now = sc_time_stamp().value();
 
   sc_uint<24> dw = s_serial_data_in.read();
   uint64_t trig_id = s_serial_data_trig_id.read();
 
-  inputDataByte((uint8_t)dw.range(23,16), trig_id, time_now);
-
   // Word mode is used for inner barrel chips
   // Outer barrel chips only output 1 byte per 40MHz clock cycle
-  if(mWordMode) {
-    inputDataByte((uint8_t)dw.range(15,8), trig_id, time_now);
-    inputDataByte((uint8_t)dw.range(7,0), trig_id, time_now);
-  }
+  inputDataWord((uint32_t)dw, mWordMode ? 3 : 1, trig_id, time_now);
 
   if(mBusyStatusChanged) {
     ///@todo Do something smart here? Implement a notification/event maybe?
@@ -17,6 +17,7 @@
 
 #include "Alpide/AlpideDataWord.hpp"
 #include "Alpide/EventFrame.hpp"
+#include <array>
 #include <vector>
 
 // Ignore warnings about use of auto_ptr and unused parameters in SystemC library
@@ -27,6 +28,10 @@
 #pragma GCC diagnostic pop
 
 
+/// Number of AlpideDataType values
+const unsigned int ALPIDE_NUM_DATA_TYPES = ALPIDE_UNKNOWN+1;
+
+
 struct BusyEvent {
   uint64_t mBusyOnTime;
   uint64_t mBusyOffTime;
@@ -97,17 +102,30 @@ private:
   std::vector<AlpideEventFrame> mEvents;
 
   unsigned int mCurrentRegion = 0;
-  std::map<AlpideDataType, uint64_t> mProtocolStats;
 
-  /// Key: time (ns), value: number of data bytes for interval
+  /// Number of bytes received for each data word type, indexed by AlpideDataType
+  std::array<uint64_t, ALPIDE_NUM_DATA_TYPES> mProtocolStats;
+
+  /// Number of data bytes per interval, indexed by interval number (time/mDataIntervalNs).
   /// Data rate is only recorded for chip header/trailer, region header,
   /// and data long/short. Idle and busy on/off are words that the RU does
   /// not have to transmit further upstreams.
   /// Comma, unknown, and region trailer are simply ignored.
-  std::map<uint64_t, unsigned int> mDataIntervalByteCounts;
+  std::vector<unsigned int> mDataIntervalByteCounts;
+
+  /// True for intervals where the parser received any data (including idle words).
+  /// Only these intervals are written to the data rate file.
+  std::vector<bool> mDataIntervalRecorded;
 
   const unsigned int mDataIntervalNs;
 
+  /// Data word type for each possible value of the first byte of a data word
+  static const std::array<AlpideDataType, 256> mDataTypeTable;
+
+  static std::array<AlpideDataType, 256> createDataTypeTable(void);
+  static AlpideDataType decodeDataType(std::uint8_t data);
+  void processDataByte(std::uint8_t data, uint64_t trig_id, unsigned int& interval_byte_count);
+
   /// Key: Chip ID, value: trigger that fatal mode occured
   std::map<unsigned int, std::vector<uint64_t>> mFatalTriggers;
 
@@ -149,8 +167,13 @@ public:
   }
 
   void popEvent(void);
-  void inputDataByte(std::uint8_t data, uint64_t trig_id, uint64_t time_now_ns);
-  AlpideDataType parseDataByte(std::uint8_t data);
+  void inputDataWord(uint32_t data, unsigned int num_bytes, uint64_t trig_id, uint64_t time_now_ns);
+  void inputDataByte(std::uint8_t data, uint64_t trig_id, uint64_t time_now_ns) {
+    inputDataWord((uint32_t)data << 16, 1, trig_id, time_now_ns);
+  }
+  AlpideDataType parseDataByte(std::uint8_t data) const {
+    return mDataTypeTable[data];
+  }
 
   unsigned int getNumEvents(void) const;
   const AlpideEventFrame* getNextEvent(void) const;
@@ -159,11 +182,26 @@ public:
     return mDataIntervalNs;
   }
 
-  std::map<AlpideDataType, uint64_t>& getProtocolStats(void) {
+  const std::array<uint64_t, ALPIDE_NUM_DATA_TYPES>& getProtocolStats(void) const {
     return mProtocolStats;
   }
-  std::map<uint64_t, unsigned int>& getDataIntervalByteCounts(void) {
-    return mDataIntervalByteCounts;
+
+  ///@brief Get number of data rate intervals, ie. the last interval number recorded plus one
+  uint64_t getNumDataIntervals(void) const {
+    return mDataIntervalByteCounts.size();
+  }
+
+  ///@brief Check if the parser received data in a data rate interval
+  bool getDataIntervalRecorded(uint64_t interval_num) const {
+    return interval_num < mDataIntervalRecorded.size() && mDataIntervalRecorded[interval_num];
+  }
+
+  ///@brief Get number of data bytes in a data rate interval (zero if nothing was recorded)
+  unsigned int getDataIntervalByteCount(uint64_t interval_num) const {
+    if(interval_num < mDataIntervalByteCounts.size())
+      return mDataIntervalByteCounts[interval_num];
+    else
+      return 0;
   }
   std::map<unsigned int, std::vector<uint64_t>>& getFatalTriggers(void) {
     return mFatalTriggers;
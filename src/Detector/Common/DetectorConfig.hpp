@@ -19,6 +19,12 @@ namespace Detector {
     unsigned int num_sub_staves_per_full_stave;
     unsigned int num_modules_per_sub_stave;
     unsigned int num_chips_per_module;
+
+    /// Use the frame level Alpide model for the chips in this layer
+    bool frame_model = false;
+
+    /// Use the hybrid frame level/cycle accurate Alpide model for the chips in this layer
+    bool hybrid_model = false;
   };
 
   struct DetectorConfigBase {
@@ -129,4 +129,87 @@ void Detector::writeAlpideStatsToFile(std::string output_path,
     }
   }
 
+
+  // Deviation between the cycle accurate readout and the frame level model,
+  // only written when the validation mode is enabled
+  bool frame_model_validation = false;
+
+  for(auto const & chip_it : alpide_map) {
+    if(chip_it.second != nullptr && chip_it.second->getFrameModelValidation())
+      frame_model_validation = true;
+  }
+
+  if(frame_model_validation) {
+    std::cout << "Writing frame model validation stats to file. " << std::endl;
+
+    std::string validation_filename = output_path + std::string("/Alpide_frame_model_validation.csv");
+    ofstream validation_file(validation_filename);
+
+    validation_file << "Layer ID; Stave ID; Sub-stave ID; Module ID; Local Chip ID; Unique Chip ID; ";
+    validation_file << "Frames; Readout cycles; Predicted readout cycles; ";
+    validation_file << "Mean absolute deviation cycles; Max absolute deviation cycles" << std::endl;
+
+    for(auto const & chip_it : alpide_map) {
+      if(chip_it.second != nullptr && chip_it.second->getFrameModelValidation()) {
+        unsigned int unique_chip_id = chip_it.second->getGlobalChipId();
+        DetectorPosition pos = (*global_chip_id_to_position_func)(unique_chip_id);
+        const FrameModelDeviation& deviation = chip_it.second->getFrameModelDeviation();
+
+        validation_file << pos.layer_id << ";";
+        validation_file << pos.stave_id << ";";
+        validation_file << pos.sub_stave_id << ";";
+        validation_file << pos.module_id << ";";
+        validation_file << pos.module_chip_id << ";";
+        validation_file << unique_chip_id << ";";
+        validation_file << deviation.frames << ";";
+        validation_file << deviation.readout_cycles_sum << ";";
+        validation_file << deviation.predicted_cycles_sum << ";";
+
+        if(deviation.frames > 0)
+          validation_file << (double)deviation.abs_deviation_sum / deviation.frames << ";";
+        else
+          validation_file << 0 << ";";
+
+        validation_file << deviation.abs_deviation_max << std::endl;
+      }
+    }
+  }
+
+
+  // Switches between the frame level and cycle accurate models in hybrid mode
+  bool hybrid_model = false;
+
+  for(auto const & chip_it : alpide_map) {
+    if(chip_it.second != nullptr && chip_it.second->getHybridEnable())
+      hybrid_model = true;
+  }
+
+  if(hybrid_model) {
+    std::cout << "Writing hybrid model stats to file. " << std::endl;
+
+    std::string hybrid_filename = output_path + std::string("/Alpide_hybrid_model_stats.csv");
+    ofstream hybrid_file(hybrid_filename);
+
+    hybrid_file << "Layer ID; Stave ID; Sub-stave ID; Module ID; Local Chip ID; Unique Chip ID; ";
+    hybrid_file << "Switches to cycle accurate; Switches to frame model; ";
+    hybrid_file << "Cycle accurate cycles; Frame model cycles" << std::endl;
+
+    for(auto const & chip_it : alpide_map) {
+      if(chip_it.second != nullptr && chip_it.second->getHybridEnable()) {
+        unsigned int unique_chip_id = chip_it.second->getGlobalChipId();
+        DetectorPosition pos = (*global_chip_id_to_position_func)(unique_chip_id);
+
+        hybrid_file << pos.layer_id << ";";
+        hybrid_file << pos.stave_id << ";";
+        hybrid_file << pos.sub_stave_id << ";";
+        hybrid_file << pos.module_id << ";";
+        hybrid_file << pos.module_chip_id << ";";
+        hybrid_file << unique_chip_id << ";";
+        hybrid_file << chip_it.second->getHybridSwitchesToCycleAccurate() << ";";
+        hybrid_file << chip_it.second->getHybridSwitchesToFrameModel() << ";";
+        hybrid_file << chip_it.second->getHybridCycleAccurateCycles() << ";";
+        hybrid_file << chip_it.second->getHybridFrameModelCycles() << std::endl;
+      }
+    }
+  }
 }
@@ -46,7 +46,7 @@ SingleChip::processCommand(const ControlRequestPayload &request) {
 
 ///@brief Set a pixel in the Alpide chip
 ///@param h Pixel hit
-void SingleChip::pixelInput(const std::shared_ptr<PixelHit>& p)
+void SingleChip::pixelInput(const PixelHitPtr& p)
 {
   mChip->pixelFrontEndInput(p);
 }
@@ -95,7 +95,8 @@ InnerBarrelStave::InnerBarrelStave(sc_core::sc_module_name const &name,
     mChips.push_back(std::make_shared<Alpide>(chip_name.c_str(),
                                               global_chip_id,
                                               pos.module_chip_id,
-                                              chip_cfg));
+                                              chip_cfg,
+                                              ALPIDE_IB));
 
     auto &chip = *mChips.back();
     socket_control_out[i].bind(chip.s_control_input);
@@ -174,8 +175,7 @@ HalfModule::HalfModule(sc_core::sc_module_name const &name,
                                             global_chip_id,
                                             pos.module_chip_id,
                                             cfg,
-                                            true, // Outer barrel mode
-                                            true, // Outer barrel master
+                                            ALPIDE_OB_MASTER,
                                             6));  // 6 outer barrel slaves
 
   auto &master_chip = *mChips.back();
@@ -200,8 +200,7 @@ HalfModule::HalfModule(sc_core::sc_module_name const &name,
                                               global_chip_id,
                                               pos.module_chip_id,
                                               cfg,
-                                              true, // Outer barrel mode
-                                              false)); // Outer barrel slave
+                                              ALPIDE_OB_SLAVE));
 
 
 
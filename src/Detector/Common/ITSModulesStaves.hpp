@@ -69,7 +69,7 @@ namespace ITS {
 
         return vec;
       }
-    void pixelInput(const std::shared_ptr<PixelHit>& p);
+    void pixelInput(const PixelHitPtr& p);
 
   private:
     ControlResponsePayload processCommand(ControlRequestPayload const &request);
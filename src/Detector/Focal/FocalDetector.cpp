@@ -12,6 +12,7 @@
 #include "Detector/Common/DetectorSimulationStats.hpp"
 #include "Detector/Focal/Focal_creator.hpp"
 #include <misc/vcd_trace.hpp>
+#include <Profiling/ProcessProfiler.hpp>
 
 using namespace Focal;
 
@@ -197,7 +198,7 @@ void FocalDetector::buildDetector(const FocalDetectorConfig& config,
 ///@brief Input a pixel to the front end of one of the detector's
 ///       Alpide chip's (if it exists in the detector configuration).
 ///@param pix PixelHit object with pixel matrix coordinates and chip id
-void FocalDetector::pixelInput(const std::shared_ptr<PixelHit>& pix)
+void FocalDetector::pixelInput(const PixelHitPtr& pix)
 {
   // Does the chip exist in our detector/simulation configuration?
   if(mChipMap.find(pix->getChipId()) != mChipMap.end()) {
@@ -245,7 +246,7 @@ void FocalDetector::setPixel(const Detector::DetectorPosition& pos,
 ///@brief Set a pixel in one of the detector's Alpide chip's (if it exists in the
 ///       detector configuration).
 ///@param h Pixel hit data
-void FocalDetector::setPixel(const std::shared_ptr<PixelHit>& p)
+void FocalDetector::setPixel(const PixelHitPtr& p)
 {
   // Does the chip exist in our detector/simulation configuration?
   if(mChipMap.find(p->getChipId()) != mChipMap.end()) {
@@ -257,6 +258,8 @@ void FocalDetector::setPixel(const std::shared_ptr<PixelHit>& p)
 ///@brief SystemC METHOD for distributing triggers to all readout units
 void FocalDetector::triggerMethod(void)
 {
+  PROFILE_PROCESS("FocalDetector::triggerMethod");
+
   int64_t time_now = sc_time_stamp().value();
   std::cout << "@ " << time_now << " ns: \tFocal Detector triggered!" << std::endl;
 
@@ -290,6 +293,36 @@ void FocalDetector::addTraces(sc_trace_file *wf, std::string name_prefix) const
 }
 
 
+///@brief Open the event log files of the readout units. The logs are written while the
+///       simulation runs, and should be opened before it starts.
+///@param[in] output_path Path to simulation output directory
+///@throw runtime_error If one of the files can not be created
+void FocalDetector::openEventLogs(const std::string output_path)
+{
+  for(unsigned int layer = 0; layer < N_LAYERS; layer++) {
+    for(unsigned int stave = 0; stave < mDetectorStaves[layer].size(); stave++){
+      std::stringstream ss;
+      ss << output_path << "/RU_" << layer << "_" << stave;
+
+      mReadoutUnits[layer][stave].openEventLogs(ss.str());
+    }
+  }
+}
+
+
+///@brief Get all the chips in the detector
+///@return Vector with the chips, in chip id order
+std::vector<std::shared_ptr<Alpide>> FocalDetector::getChips(void) const
+{
+  std::vector<std::shared_ptr<Alpide>> chips;
+
+  for(auto it = mChipMap.begin(); it != mChipMap.end(); it++)
+    chips.push_back(it->second);
+
+  return chips;
+}
+
+
 ///@brief Write simulation stats/data to file
 ///@param[in] output_path Path to simulation output directory
 void FocalDetector::writeSimulationStats(const std::string output_path) const
@@ -42,7 +42,7 @@ FocalIbModule::FocalIbModule(sc_core::sc_module_name const &name,
                                               global_chip_id,
                                               pos.module_chip_id,
                                               cfg,
-                                              false)); // Inner barrel mode
+                                              ALPIDE_IB));
 
     auto &chip = *mChips.back();
     chip.s_system_clk_in(s_system_clk_in);
@@ -109,8 +109,7 @@ FocalObModule::FocalObModule(sc_core::sc_module_name const &name,
                                             global_chip_id,
                                             pos.module_chip_id,
                                             cfg,
-                                            true, // Outer barrel mode
-                                            true, // Outer barrel master
+                                            ALPIDE_OB_MASTER,
                                             Focal::CHIPS_PER_FOCAL_OB_MODULE-1)); // number of
                                                                                   // slave chips
 
@@ -136,8 +135,7 @@ FocalObModule::FocalObModule(sc_core::sc_module_name const &name,
                                               global_chip_id,
                                               pos.module_chip_id,
                                               cfg,
-                                              true,    // Outer barrel mode
-                                              false)); // Inner barrel slave
+                                              ALPIDE_OB_SLAVE));
 
     auto &chip = *mChips.back();
     chip.s_system_clk_in(s_system_clk_in);
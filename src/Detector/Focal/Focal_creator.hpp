@@ -116,6 +116,9 @@ namespace Focal {
       , mStavesPerQuadrant(staves_per_quadrant)
       , mConfig(config)
       {
+        // Chips in this layer use the frame level or hybrid model if selected for the layer
+        mConfig.chip_cfg.frame_model = mConfig.layer[layer_id].frame_model;
+        mConfig.chip_cfg.hybrid_model = mConfig.layer[layer_id].hybrid_model;
       }
 
     ///@brief The actual creator function
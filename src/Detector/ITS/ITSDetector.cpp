@@ -12,6 +12,7 @@
 #include "Detector/Common/DetectorSimulationStats.hpp"
 #include "Detector/ITS/ITS_creator.hpp"
 #include <misc/vcd_trace.hpp>
+#include <Profiling/ProcessProfiler.hpp>
 
 using namespace ITS;
 
@@ -33,6 +34,7 @@ ITSDetector::ITSDetector(sc_core::sc_module_name name,
   , mReadoutUnits("RU", ITS::N_LAYERS)
   , mDetectorStaves("Stave", ITS::N_LAYERS)
   , mConfig(config)
+  , mFirstStaveId(ITS::N_LAYERS, 0)
 {
   verifyDetectorConfig(config);
   buildDetector(config, trigger_filter_time, trigger_filter_enable, data_rate_interval_ns);
@@ -74,11 +76,35 @@ void ITSDetector::verifyDetectorConfig(const ITSDetectorConfig& config) const
   {
     throw std::runtime_error("Detector with no staves specified.");
   }
+
+  if(config.shard_count == 0 || config.shard_index >= config.shard_count) {
+    std::string error_msg = "Invalid shard index " + std::to_string(config.shard_index);
+    error_msg += " for shard count " + std::to_string(config.shard_count);
+    throw std::runtime_error(error_msg);
+  }
+
+  if(config.shard_count > 1) {
+    unsigned int num_staves_shard = 0;
+
+    for(unsigned int i = 0; i < N_LAYERS; i++) {
+      unsigned int first_stave, num_staves;
+      ITS_get_shard_stave_range(config, i, first_stave, num_staves);
+      num_staves_shard += num_staves;
+    }
+
+    if(num_staves_shard == 0) {
+      std::string error_msg = "No staves in shard " + std::to_string(config.shard_index);
+      error_msg += ", too many shards specified.";
+      throw std::runtime_error(error_msg);
+    }
+  }
 }
 
 
 ///@brief Allocate memory and create the desired number of staves for each detector layer,
 ///       and create the chip map of chip id vs alpide chip object instance.
+///       When the detector is split into shards, only the staves that belong to the
+///       shard given by config.shard_index are created.
 ///@param config Configuration of the ITS detector to simulate
 ///              (ie. number of staves per layer to include in simulation)
 ///@param trigger_filter_time Readout Units will filter out triggers more closely
@@ -92,20 +118,30 @@ void ITSDetector::buildDetector(const ITSDetectorConfig& config,
                                 unsigned int data_rate_interval_ns)
 {
   for(unsigned int lay_id = 0; lay_id < N_LAYERS; lay_id++) {
-    unsigned int num_staves = config.layer[lay_id].num_staves;
+    unsigned int first_stave, num_staves;
+
+    ITS_get_shard_stave_range(config, lay_id, first_stave, num_staves);
+    mFirstStaveId[lay_id] = first_stave;
 
     std::cout << "Creating " << num_staves;
     std::cout << " RUs and staves for layer " << lay_id;
+    if(config.shard_count > 1)
+      std::cout << " (first stave: " << first_stave << ")";
     std::cout << std::endl;
 
     // Create sc_vectors with ReadoutUnit and Staves for this layer
     mReadoutUnits[lay_id].init(num_staves, RUCreator(lay_id,
                                                      trigger_filter_time,
                                                      trigger_filter_enable,
-                                                     data_rate_interval_ns));
-    mDetectorStaves[lay_id].init(num_staves, StaveCreator(lay_id, mConfig));
-
-    for(unsigned int sta_id = 0; sta_id < config.layer[lay_id].num_staves; sta_id++) {
+                                                     data_rate_interval_ns,
+                                                     first_stave));
+    mDetectorStaves[lay_id].init(num_staves, StaveCreator(lay_id, mConfig, first_stave));
+
+    // Note: sta_id is the index in the sc_vectors, and not the stave id, in this loop.
+    // When the detector is sharded, the busy chain is closed within the staves of the shard.
+    // The busy words are only passed along the chain (they don't affect triggering or the
+    // readout), so the shards don't need to exchange them.
+    for(unsigned int sta_id = 0; sta_id < num_staves; sta_id++) {
       // Connect the busy in/out signals for the RUs in a daisy chain
       // ------------------------------------------------------------
       if(sta_id == num_staves-1) {
@@ -182,12 +218,14 @@ void ITSDetector::buildDetector(const ITSDetectorConfig& config,
 ///@brief Input a pixel to the front end of one of the detector's
 ///       Alpide chip's (if it exists in the detector configuration).
 ///@param pix PixelHit object with pixel matrix coordinates and chip id
-void ITSDetector::pixelInput(const std::shared_ptr<PixelHit>& pix)
+void ITSDetector::pixelInput(const PixelHitPtr& pix)
 {
   // Does the chip exist in our detector/simulation configuration?
   if(mChipMap.find(pix->getChipId()) != mChipMap.end()) {
     mChipMap[pix->getChipId()]->pixelFrontEndInput(pix);
-  } else {
+  } else if(mConfig.shard_count == 1) {
+    // Hits for chips in the other shards are expected (and silently
+    // discarded) when only a shard of the detector is simulated
     std::cout << "Chip " << pix->getChipId() << " does not exist." << std::endl;
   }
 }
@@ -230,7 +268,7 @@ void ITSDetector::setPixel(const Detector::DetectorPosition& pos,
 ///@brief Set a pixel in one of the detector's Alpide chip's (if it exists in the
 ///       detector configuration).
 ///@param h Pixel hit data
-void ITSDetector::setPixel(const std::shared_ptr<PixelHit>& p)
+void ITSDetector::setPixel(const PixelHitPtr& p)
 {
   // Does the chip exist in our detector/simulation configuration?
   if(mChipMap.find(p->getChipId()) != mChipMap.end()) {
@@ -242,6 +280,8 @@ void ITSDetector::setPixel(const std::shared_ptr<PixelHit>& p)
 ///@brief SystemC METHOD for distributing triggers to all readout units
 void ITSDetector::triggerMethod(void)
 {
+  PROFILE_PROCESS("ITSDetector::triggerMethod");
+
   int64_t time_now = sc_time_stamp().value();
   std::cout << "@ " << time_now << " ns: \tITS Detector triggered!" << std::endl;
 
@@ -275,6 +315,36 @@ void ITSDetector::addTraces(sc_trace_file *wf, std::string name_prefix) const
 }
 
 
+///@brief Open the event log files of the readout units. The logs are written while the
+///       simulation runs, and should be opened before it starts.
+///@param[in] output_path Path to simulation output directory
+///@throw runtime_error If one of the files can not be created
+void ITSDetector::openEventLogs(const std::string output_path)
+{
+  for(unsigned int layer = 0; layer < N_LAYERS; layer++) {
+    for(unsigned int stave = 0; stave < mDetectorStaves[layer].size(); stave++){
+      std::stringstream ss;
+      ss << output_path << "/RU_" << layer << "_" << mFirstStaveId[layer]+stave;
+
+      mReadoutUnits[layer][stave].openEventLogs(ss.str());
+    }
+  }
+}
+
+
+///@brief Get all the chips in the detector
+///@return Vector with the chips, in chip id order
+std::vector<std::shared_ptr<Alpide>> ITSDetector::getChips(void) const
+{
+  std::vector<std::shared_ptr<Alpide>> chips;
+
+  for(auto it = mChipMap.begin(); it != mChipMap.end(); it++)
+    chips.push_back(it->second);
+
+  return chips;
+}
+
+
 ///@brief Write simulation stats/data to file
 ///@param[in] output_path Path to simulation output directory
 void ITSDetector::writeSimulationStats(const std::string output_path) const
@@ -286,7 +356,7 @@ void ITSDetector::writeSimulationStats(const std::string output_path) const
   for(unsigned int layer = 0; layer < N_LAYERS; layer++) {
     for(unsigned int stave = 0; stave < mDetectorStaves[layer].size(); stave++){
       std::stringstream ss;
-      ss << output_path << "/RU_" << layer << "_" << stave;
+      ss << output_path << "/RU_" << layer << "_" << mFirstStaveId[layer]+stave;
 
       mReadoutUnits[layer][stave].writeSimulationStats(ss.str());
     }
@@ -36,6 +36,10 @@ namespace ITS {
 
     ITSDetectorConfig mConfig;
 
+    /// Stave id of the first stave in mReadoutUnits/mDetectorStaves, for each layer.
+    /// Nonzero when only a shard of the detector is simulated.
+    std::vector<unsigned int> mFirstStaveId;
+
     unsigned int mNumChips;
 
     void buildDetector(const ITSDetectorConfig& config, unsigned int trigger_filter_time,
@@ -50,14 +54,16 @@ namespace ITS {
                 unsigned int trigger_filter_time,
                 bool trigger_filter_enable,
                 unsigned int data_rate_interval_ns);
-    void pixelInput(const std::shared_ptr<PixelHit>& pix);
-    void setPixel(const std::shared_ptr<PixelHit>& p);
+    void pixelInput(const PixelHitPtr& pix);
+    void setPixel(const PixelHitPtr& p);
     void setPixel(unsigned int chip_id, unsigned int row, unsigned int col);
     void setPixel(const Detector::DetectorPosition& pos,
                   unsigned int row, unsigned int col);
     unsigned int getNumChips(void) const { return mNumChips; }
+    std::vector<std::shared_ptr<Alpide>> getChips(void) const;
     void addTraces(sc_trace_file *wf, std::string name_prefix) const;
     void writeSimulationStats(const std::string output_path) const;
+    void openEventLogs(const std::string output_path);
   };
 
 }
@@ -7,6 +7,7 @@
  */
 
 #include "ITSDetectorConfig.hpp"
+#include <cstdint>
 #include <iostream>
 
 
@@ -72,3 +73,49 @@ Detector::DetectorPosition ITS::ITS_global_chip_id_to_position(unsigned int glob
 
   return position;
 }
+
+
+///@brief Find the range of staves in a layer that belong to the shard selected by
+///       config.shard_index. The staves of all layers are taken in order (layer 0 stave 0
+///       first), and split into config.shard_count contiguous shards with approximately the
+///       same number of chips in each shard. The staves of a layer that belong to a shard
+///       are therefore always contiguous.
+///@param[in] config Detector configuration, with shard index and count
+///@param[in] layer_id Layer to get stave range for
+///@param[out] first_stave First stave in layer that belongs to the shard
+///@param[out] num_staves Number of staves in layer that belong to the shard (can be zero)
+void ITS::ITS_get_shard_stave_range(const ITSDetectorConfig& config, unsigned int layer_id,
+                                    unsigned int& first_stave, unsigned int& num_staves)
+{
+  std::uint64_t total_chips = 0;
+
+  for(unsigned int lay = 0; lay < ITS::N_LAYERS; lay++)
+    total_chips += config.layer[lay].num_staves * ITS::CHIPS_PER_STAVE_IN_LAYER[lay];
+
+  first_stave = 0;
+  num_staves = 0;
+
+  if(config.shard_count <= 1) {
+    num_staves = config.layer[layer_id].num_staves;
+    return;
+  }
+
+  // Number of chips in the staves preceding the current stave
+  std::uint64_t chip_count = 0;
+
+  for(unsigned int lay = 0; lay < layer_id; lay++)
+    chip_count += config.layer[lay].num_staves * ITS::CHIPS_PER_STAVE_IN_LAYER[lay];
+
+  // A stave belongs to the shard its first chip falls into
+  for(unsigned int sta = 0; sta < config.layer[layer_id].num_staves; sta++) {
+    unsigned int stave_shard = (chip_count * config.shard_count) / total_chips;
+
+    if(stave_shard == config.shard_index) {
+      if(num_staves == 0)
+        first_stave = sta;
+      num_staves++;
+    }
+
+    chip_count += ITS::CHIPS_PER_STAVE_IN_LAYER[layer_id];
+  }
+}
@@ -15,7 +15,15 @@
 
 namespace ITS {
   struct ITSDetectorConfig : public Detector::DetectorConfigBase {
+    /// The staves selected by layer[].num_staves can be split into shard_count
+    /// contiguous shards, which are simulated in separate processes. Only the
+    /// staves in shard number shard_index are instantiated by ITSDetector.
+    unsigned int shard_index;
+    unsigned int shard_count;
+
     ITSDetectorConfig()
+      : shard_index(0)
+      , shard_count(1)
       {
         num_layers = ITS::N_LAYERS;
         layer.resize(ITS::N_LAYERS);
@@ -32,6 +40,8 @@ namespace ITS {
 
   unsigned int ITS_position_to_global_chip_id(const Detector::DetectorPosition& pos);
   Detector::DetectorPosition ITS_global_chip_id_to_position(unsigned int global_chip_id);
+  void ITS_get_shard_stave_range(const ITSDetectorConfig& config, unsigned int layer_id,
+                                 unsigned int& first_stave, unsigned int& num_staves);
 }
 
 
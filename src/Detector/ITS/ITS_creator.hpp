@@ -26,14 +26,17 @@ namespace ITS {
     unsigned int mTriggerFilterTime;
     bool mTriggerFilterEnabled;
     unsigned int mDataRateIntervalNs;
+    unsigned int mFirstStaveId;
 
   public:
     RUCreator(unsigned int layer_id, unsigned int trigger_filter_time,
-              bool trigger_filter_enable, unsigned int data_rate_interval_ns)
+              bool trigger_filter_enable, unsigned int data_rate_interval_ns,
+              unsigned int first_stave_id = 0)
       : mLayerId(layer_id)
       , mTriggerFilterTime(trigger_filter_time)
       , mTriggerFilterEnabled(trigger_filter_enable)
       , mDataRateIntervalNs(data_rate_interval_ns)
+      , mFirstStaveId(first_stave_id)
       {
         mNumCtrlLinks = CTRL_LINKS_PER_LAYER[layer_id]/STAVES_PER_LAYER[layer_id];
         mNumDataLinks = DATA_LINKS_PER_LAYER[layer_id]/STAVES_PER_LAYER[layer_id];
@@ -47,7 +50,10 @@ namespace ITS {
       }
 
     ///@brief The actual creator function
-    ReadoutUnit* operator()(const char *name, size_t stave_id) {
+    ///@param name Base name for object
+    ///@param idx Index in sc_vector, offset by the first stave id to get the stave id
+    ReadoutUnit* operator()(const char *name, size_t idx) {
+      size_t stave_id = mFirstStaveId + idx;
       std::string coords_str = std::to_string(mLayerId) + ":" + std::to_string(stave_id);
       std::string ru_name = std::string(name) + coords_str;
 
@@ -70,16 +76,25 @@ namespace ITS {
   class StaveCreator {
     unsigned int mLayerId;
     ITSDetectorConfig mConfig;
+    unsigned int mFirstStaveId;
 
   public:
-    StaveCreator(unsigned int layer_id, const ITSDetectorConfig& config)
+    StaveCreator(unsigned int layer_id, const ITSDetectorConfig& config,
+                 unsigned int first_stave_id = 0)
       : mLayerId(layer_id)
       , mConfig(config)
+      , mFirstStaveId(first_stave_id)
       {
+        // Chips in this layer use the frame level or hybrid model if selected for the layer
+        mConfig.chip_cfg.frame_model = mConfig.layer[layer_id].frame_model;
+        mConfig.chip_cfg.hybrid_model = mConfig.layer[layer_id].hybrid_model;
       }
 
     ///@brief The actual creator function
-    StaveInterface* operator()(const char *name, size_t stave_id) {
+    ///@param name Base name for object
+    ///@param idx Index in sc_vector, offset by the first stave id to get the stave id
+    StaveInterface* operator()(const char *name, size_t idx) {
+      size_t stave_id = mFirstStaveId + idx;
       std::string coords_str = std::to_string(mLayerId) + ":" + std::to_string(stave_id);
       std::string ru_name = std::string(name) + coords_str;
       StaveInterface* new_stave_ptr;
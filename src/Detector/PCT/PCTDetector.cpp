@@ -12,6 +12,7 @@
 #include "Detector/Common/DetectorSimulationStats.hpp"
 #include "Detector/PCT/PCT_creator.hpp"
 #include <misc/vcd_trace.hpp>
+#include <Profiling/ProcessProfiler.hpp>
 
 
 using namespace PCT;
@@ -172,7 +173,7 @@ void PCTDetector::buildDetector(const PCTDetectorConfig& config,
 ///@brief Input a pixel to the front end of one of the detector's
 ///       Alpide chip's (if it exists in the detector configuration).
 ///@param pix PixelHit object with pixel matrix coordinates and chip id
-void PCTDetector::pixelInput(const std::shared_ptr<PixelHit>& pix)
+void PCTDetector::pixelInput(const PixelHitPtr& pix)
 {
   // Does the chip exist in our detector/simulation configuration?
   if(mChipMap.find(pix->getChipId()) != mChipMap.end()) {
@@ -220,7 +221,7 @@ void PCTDetector::setPixel(const Detector::DetectorPosition& pos,
 ///@brief Set a pixel in one of the detector's Alpide chip's (if it exists in the
 ///       detector configuration).
 ///@param h Pixel hit data
-void PCTDetector::setPixel(const std::shared_ptr<PixelHit>& p)
+void PCTDetector::setPixel(const PixelHitPtr& p)
 {
   // Does the chip exist in our detector/simulation configuration?
   if(mChipMap.find(p->getChipId()) != mChipMap.end()) {
@@ -232,6 +233,8 @@ void PCTDetector::setPixel(const std::shared_ptr<PixelHit>& p)
 ///@brief SystemC METHOD for distributing triggers to all readout units
 void PCTDetector::triggerMethod(void)
 {
+  PROFILE_PROCESS("PCTDetector::triggerMethod");
+
   int64_t time_now = sc_time_stamp().value();
   std::cout << "@ " << time_now << " ns: \tPCT Detector triggered!" << std::endl;
 
@@ -272,6 +275,39 @@ void PCTDetector::addTraces(sc_trace_file *wf, std::string name_prefix) const
 }
 
 
+///@brief Open the event log files of the readout units. The logs are written while the
+///       simulation runs, and should be opened before it starts.
+///@param[in] output_path Path to simulation output directory
+///@throw runtime_error If one of the files can not be created
+void PCTDetector::openEventLogs(const std::string output_path)
+{
+  for(unsigned int layer = 0; layer < PCT::N_LAYERS; layer++) {
+    for(unsigned int RU_num_in_layer = 0;
+        RU_num_in_layer < mReadoutUnits[layer].size();
+        RU_num_in_layer++)
+    {
+      std::stringstream ss;
+      ss << output_path << "/RU_" << layer << "_" << RU_num_in_layer;
+
+      mReadoutUnits[layer][RU_num_in_layer].openEventLogs(ss.str());
+    }
+  }
+}
+
+
+///@brief Get all the chips in the detector
+///@return Vector with the chips, in chip id order
+std::vector<std::shared_ptr<Alpide>> PCTDetector::getChips(void) const
+{
+  std::vector<std::shared_ptr<Alpide>> chips;
+
+  for(auto it = mChipMap.begin(); it != mChipMap.end(); it++)
+    chips.push_back(it->second);
+
+  return chips;
+}
+
+
 ///@brief Write simulation stats/data to file
 ///@param[in] output_path Path to simulation output directory
 void PCTDetector::writeSimulationStats(const std::string output_path) const
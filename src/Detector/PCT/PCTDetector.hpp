@@ -48,13 +48,15 @@ namespace PCT {
                 unsigned int trigger_filter_time,
                 bool trigger_filter_enable,
                 unsigned int data_rate_interval_ns);
-    void pixelInput(const std::shared_ptr<PixelHit>& pix);
-    void setPixel(const std::shared_ptr<PixelHit>& p);
+    void pixelInput(const PixelHitPtr& pix);
+    void setPixel(const PixelHitPtr& p);
     void setPixel(unsigned int chip_id, unsigned int row, unsigned int col);
     void setPixel(const Detector::DetectorPosition& pos, unsigned int row, unsigned int col);
     unsigned int getNumChips(void) const { return mNumChips; }
+    std::vector<std::shared_ptr<Alpide>> getChips(void) const;
     void addTraces(sc_trace_file *wf, std::string name_prefix) const;
     void writeSimulationStats(const std::string output_path) const;
+    void openEventLogs(const std::string output_path);
   };
 
 }
@@ -9,6 +9,7 @@
 #include <iostream>
 #include <boost/random/random_device.hpp>
 #include "EventBaseDiscrete.hpp"
+#include "../Log/Log.hpp"
 
 using boost::random::uniform_int_distribution;
 
@@ -44,6 +45,7 @@ EventBaseDiscrete::EventBaseDiscrete(Detector::DetectorConfigBase config,
   , mRandomSeed(random_seed)
   , mEventCount(0)
   , mNextEvent(0)
+  , mNumEvents(event_filenames.size())
   , mLoadAllEvents(load_all)
 {
   if(random_seed == 0) {
@@ -93,6 +95,8 @@ EventBaseDiscrete::EventBaseDiscrete(Detector::DetectorConfigBase config,
 
 EventBaseDiscrete::~EventBaseDiscrete()
 {
+  stopPrefetch();
+
   for(unsigned int i = 0; i < mEvents.size(); i++)
     delete mEvents[i];
 
@@ -103,46 +107,158 @@ EventBaseDiscrete::~EventBaseDiscrete()
 }
 
 
+///@brief Get the index of the next event to use, either randomly or in sequential order
+///@return Event index
+int EventBaseDiscrete::getNextEventIndex(void)
+{
+  int event_index;
+
+  if(mRandomEventOrder) {
+    // Generate random event here
+    event_index = (*mRandEventIdDist)(mRandEventIdGen);
+  } else { // Sequential event order if not random
+    event_index = mNextEvent;
+    mNextEvent++;
+    mNextEvent = mNextEvent % mNumEvents;
+  }
+
+  return event_index;
+}
+
+
 ///@brief Get the next event. If the class was constructed with random_event_order
 ///       set to true, then this will return a random event from the pool of events.
 ///       If not they will be in sequential order.
 ///@return Const pointer to EventDigits object for event.
+///@throw Rethrows exceptions from reading events in the prefetch thread
 const EventDigits* EventBaseDiscrete::getNextEvent(void)
 {
   EventDigits* event = nullptr;
   int current_event_index;
 
+  if(mPrefetchThread.joinable()) {
+    std::unique_lock<std::mutex> lock(mPrefetchMutex);
 
-  if(mRandomEventOrder) {
-    // Generate random event here
-    current_event_index = (*mRandEventIdDist)(mRandEventIdGen);
-  } else { // Sequential event order if not random
-    current_event_index = mNextEvent;
-    mNextEvent++;
-    mNextEvent = mNextEvent % mEventFileNames.size();
-  }
+    mPrefetchQueueNotEmpty.wait(lock, [this]{return !mPrefetchQueue.empty() || mPrefetchError;});
+
+    if(mPrefetchQueue.empty())
+      std::rethrow_exception(mPrefetchError);
+
+    current_event_index = mPrefetchQueue.front().first;
 
-  if(mLoadAllEvents) {
-    if(mEvents.empty() == false) {
-      event = mEvents[current_event_index];
-    } else {
-      std::cout << "Error: No MC events loaded into memory." << std::endl;
-      exit(-1);
-    }
-  } else {
     if(mSingleEvent != nullptr)
       delete mSingleEvent;
 
-    mSingleEvent = readEventFile(mEventPath + QString("/") + mEventFileNames.at(current_event_index));
+    mSingleEvent = mPrefetchQueue.front().second;
     event = mSingleEvent;
+
+    mPrefetchQueue.pop_front();
+    lock.unlock();
+    mPrefetchQueueNotFull.notify_one();
+  } else {
+    current_event_index = getNextEventIndex();
+
+    if(mLoadAllEvents) {
+      if(mEvents.empty() == false) {
+        event = mEvents[current_event_index];
+      } else {
+        std::cout << "Error: No MC events loaded into memory." << std::endl;
+        exit(-1);
+      }
+    } else {
+      if(mSingleEvent != nullptr) {
+        delete mSingleEvent;
+        mSingleEvent = nullptr;
+      }
+
+      // readEvent() may throw for a corrupt event file
+      mSingleEvent = readEvent(current_event_index);
+      event = mSingleEvent;
+    }
   }
 
-  std::cout << "MC Event number: " << current_event_index << std::endl;
+  LOG(LOG_DEBUG, LOG_MODULE_EVENT) << "MC Event number: " << current_event_index;
 
   return event;
 }
 
 
+///@brief Start a thread that reads events ahead of time, so that getNextEvent() does not
+///       have to wait for the event files to be read and parsed. Has no effect when all the
+///       events are loaded into memory.
+///       Must be called after the derived class has been constructed, and before the
+///       first call to getNextEvent().
+///@param depth Maximum number of events to read ahead. Prefetching is disabled if zero.
+void EventBaseDiscrete::startPrefetch(unsigned int depth)
+{
+  if(depth == 0 || mLoadAllEvents || mPrefetchThread.joinable())
+    return;
+
+  mPrefetchDepth = depth;
+  mPrefetchStop = false;
+  mPrefetchThread = std::thread(&EventBaseDiscrete::prefetchThread, this);
+}
+
+
+void EventBaseDiscrete::stopPrefetch(void)
+{
+  if(!mPrefetchThread.joinable())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(mPrefetchMutex);
+    mPrefetchStop = true;
+  }
+
+  mPrefetchQueueNotFull.notify_all();
+  mPrefetchThread.join();
+
+  for(auto it = mPrefetchQueue.begin(); it != mPrefetchQueue.end(); it++)
+    delete it->second;
+
+  mPrefetchQueue.clear();
+}
+
+
+///@brief Prefetch thread. Reads events into the prefetch queue, and waits while
+///       the queue is full. The event index generator (mRandEventIdGen/mNextEvent) is
+///       only used by this thread while prefetching is active.
+void EventBaseDiscrete::prefetchThread(void)
+{
+  while(true) {
+    {
+      std::unique_lock<std::mutex> lock(mPrefetchMutex);
+
+      mPrefetchQueueNotFull.wait(lock, [this]{
+          return mPrefetchStop || mPrefetchQueue.size() < mPrefetchDepth;
+        });
+
+      if(mPrefetchStop)
+        return;
+    }
+
+    int event_index = getNextEventIndex();
+    EventDigits* event = nullptr;
+
+    try {
+      event = readEvent(event_index);
+    } catch(...) {
+      std::lock_guard<std::mutex> lock(mPrefetchMutex);
+      mPrefetchError = std::current_exception();
+      mPrefetchQueueNotEmpty.notify_one();
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mPrefetchMutex);
+      mPrefetchQueue.emplace_back(event_index, event);
+    }
+
+    mPrefetchQueueNotEmpty.notify_one();
+  }
+}
+
+
 ///@brief Create a uniform random distribution used to pick event ID,
 ///       with a range that matches the number of available events.
 void EventBaseDiscrete::createEventIdDistribution(void)
@@ -150,5 +266,5 @@ void EventBaseDiscrete::createEventIdDistribution(void)
   if(mRandEventIdDist != nullptr)
     delete mRandEventIdDist;
 
-  mRandEventIdDist = new uniform_int_distribution<int>(0, mEventFileNames.size()-1);
+  mRandEventIdDist = new uniform_int_distribution<int>(0, mNumEvents-1);
 }
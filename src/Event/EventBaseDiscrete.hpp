@@ -9,8 +9,13 @@
 #ifndef EVENT_BASE_DISCRETE_H
 #define EVENT_BASE_DISCRETE_H
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <QString>
 #include <QStringList>
 #include <boost/random/mersenne_twister.hpp>
@@ -43,13 +48,35 @@ protected:
   int mEventCount;
   int mNextEvent;
 
+  /// Number of events available. One per event file, unless the derived class
+  /// stores several events per file.
+  int mNumEvents;
+
   /// Load all events to memory if true, read one at a time from file if false
   bool mLoadAllEvents;
 
   boost::random::mt19937 mRandEventIdGen;
   boost::random::uniform_int_distribution<int> *mRandEventIdDist;
 
+  /// Events read ahead by the prefetch thread, paired with their event index.
+  /// The event indexes are drawn by the prefetch thread in the same order as
+  /// they would have been drawn by getNextEvent() without prefetching.
+  std::deque<std::pair<int, EventDigits*>> mPrefetchQueue;
+  unsigned int mPrefetchDepth = 0;
+  bool mPrefetchStop = false;
+  std::exception_ptr mPrefetchError;
+  std::thread mPrefetchThread;
+  std::mutex mPrefetchMutex;
+  std::condition_variable mPrefetchQueueNotFull;
+  std::condition_variable mPrefetchQueueNotEmpty;
+
   void createEventIdDistribution(void);
+  int getNextEventIndex(void);
+  void prefetchThread(void);
+
+  ///@brief Stop the prefetch thread. Derived classes must call this in their destructor,
+  ///       since the prefetch thread calls readEvent().
+  void stopPrefetch(void);
 
 public:
   EventBaseDiscrete(Detector::DetectorConfigBase config,
@@ -60,10 +87,11 @@ public:
             bool random_event_order = true,
             int random_seed = 0,
             bool load_all = false);
-  ~EventBaseDiscrete();
+  virtual ~EventBaseDiscrete();
   virtual void readEventFiles() = 0;
-  virtual EventDigits* readEventFile(const QString& event_filename) = 0;
+  virtual EventDigits* readEvent(int event_index) = 0;
   const EventDigits* getNextEvent(void);
+  void startPrefetch(unsigned int depth);
 };
 
 
@@ -50,6 +50,12 @@ EventBinaryITS::EventBinaryITS(Detector::DetectorConfigBase config,
 }
 
 
+EventBinaryITS::~EventBinaryITS()
+{
+  stopPrefetch();
+}
+
+
 ///@brief Read the whole list of event files into memory
 void EventBinaryITS::readEventFiles()
 {
@@ -62,6 +68,15 @@ void EventBinaryITS::readEventFiles()
 }
 
 
+///@brief Read a monte carlo event from the list of event files
+///@param event_index Index of event file in list of event files
+///@return Pointer to EventDigits object with the event that was read from file
+EventDigits* EventBinaryITS::readEvent(int event_index)
+{
+  return readEventFile(mEventPath + QString("/") + mEventFileNames.at(event_index));
+}
+
+
 ///@brief Read a monte carlo event from a binary data file
 ///@param event_filename File name and path of binary data file
 ///@return Pointer to EventDigits object with the event that was read from file
@@ -44,6 +44,7 @@ private:
 
   void readEventFiles();
   EventDigits* readEventFile(const QString& event_filename);
+  EventDigits* readEvent(int event_index);
 
 public:
   EventBinaryITS(Detector::DetectorConfigBase config,
@@ -54,6 +55,7 @@ public:
                  bool random_event_order = true,
                  int random_seed = 0,
                  bool load_all = false);
+  ~EventBinaryITS();
 };
 
 
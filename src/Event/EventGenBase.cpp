@@ -45,7 +45,7 @@ EventGenBase::~EventGenBase()
 ///@param active_time_ns How long the pixel is active in the front end (ie. time over
 ///                      threshold)
 ///@return Vector with shared pointers to pixels in the cluster
-std::vector<std::shared_ptr<PixelHit>>
+std::vector<PixelHitPtr>
 EventGenBase::createCluster(const PixelHit& pix,
                             const uint64_t& start_time_ns,
                             const uint64_t& dead_time_ns,
@@ -67,10 +67,10 @@ EventGenBase::createCluster(const PixelHit& pix,
   //std::cout << "Cluster size: " << cluster_size << std::endl;
 
   //std::vector<std::shared_ptr<PixelHit>> pixel_cluster(cluster_size);
-  std::vector<std::shared_ptr<PixelHit>> pixel_cluster;
+  std::vector<PixelHitPtr> pixel_cluster;
 
   // Always add the "source" hit
-  pixel_cluster.emplace_back(std::make_shared<PixelHit>(pix));
+  pixel_cluster.emplace_back(makePixelHit(pix));
   pixel_cluster.back()->setPixelReadoutStatsObj(readout_stats);
   pixel_cluster.back()->setActiveTimeStart(start_time_ns + dead_time_ns);
   pixel_cluster.back()->setActiveTimeEnd(start_time_ns + dead_time_ns + active_time_ns);
@@ -113,7 +113,7 @@ EventGenBase::createCluster(const PixelHit& pix,
     } while(pixel_already_in_cluster == true);
 
     if(skip_pixel_outside_matrix == false) {
-      pixel_cluster.emplace_back(std::make_shared<PixelHit>(new_cluster_pixel));
+      pixel_cluster.emplace_back(makePixelHit(new_cluster_pixel));
       pixel_cluster.back()->setPixelReadoutStatsObj(readout_stats);
       pixel_cluster.back()->setActiveTimeStart(start_time_ns + dead_time_ns);
       pixel_cluster.back()->setActiveTimeEnd(start_time_ns + dead_time_ns + active_time_ns);
@@ -95,14 +95,14 @@ protected:
 public:
   EventGenBase(sc_core::sc_module_name name, const QSettings* settings, std::string output_path);
   ~EventGenBase();
-  virtual const std::vector<std::shared_ptr<PixelHit>>& getTriggeredEvent(void) const = 0;
-  virtual const std::vector<std::shared_ptr<PixelHit>>& getUntriggeredEvent(void) const = 0;
-  std::vector<std::shared_ptr<PixelHit>> createCluster(const PixelHit& pix,
-                                                       const uint64_t& start_time_ns,
-                                                       const uint64_t& dead_time_ns,
-                                                       const uint64_t& active_time_ns,
-                                                       const std::shared_ptr<PixelReadoutStats> &readout_stats =
-                                                       nullptr);
+  virtual const std::vector<PixelHitPtr>& getTriggeredEvent(void) const = 0;
+  virtual const std::vector<PixelHitPtr>& getUntriggeredEvent(void) const = 0;
+  std::vector<PixelHitPtr> createCluster(const PixelHit& pix,
+                                         const uint64_t& start_time_ns,
+                                         const uint64_t& dead_time_ns,
+                                         const uint64_t& active_time_ns,
+                                         const std::shared_ptr<PixelReadoutStats> &readout_stats =
+                                         nullptr);
   uint64_t getTriggeredEventCount(void) const {return mTriggeredEventCount;}
   uint64_t getUntriggeredEventCount(void) const {return mUntriggeredEventCount;}
   virtual void stopEventGeneration(void) = 0;
@@ -14,9 +14,12 @@
 #include <QDir>
 #include "Alpide/alpide_constants.hpp"
 #include "../utils.hpp"
+#include "Log/Log.hpp"
+#include "Profiling/ProcessProfiler.hpp"
 #include "EventGenITS.hpp"
 #include "EventXMLITS.hpp"
 #include "EventBinaryITS.hpp"
+#include "EventPackedITS.hpp"
 #include "Detector/Focal/FocalDetectorConfig.hpp"
 
 #ifdef ROOT_ENABLED
@@ -46,18 +49,31 @@ EventGenITS::EventGenITS(sc_core::sc_module_name name,
   mBunchCrossingRate_ns = settings->value("its/bunch_crossing_rate_ns").toInt();
   mAverageEventRate_ns = settings->value("event/average_event_rate_ns").toInt();
 
-  if(mRandomHitGeneration) {
-    initRandomHitGen(settings);
+  QString event_stream_mode = settings->value("event/event_stream_mode").toString();
+
+  if(event_stream_mode != "off" && event_stream_mode != "pregenerate" && event_stream_mode != "replay")
+    throw std::runtime_error("Unknown event stream mode: " + event_stream_mode.toStdString());
+
+  if(event_stream_mode == "replay") {
+    // Hits and event times are read from a pregenerated event stream file
+    initEventStream(settings);
   } else {
-    if(mSimType == "its" && mRandomClusterGeneration) {
-      throw std::runtime_error("Random cluster generation for ITS MC sim (data includes clusters)");
+    if(mRandomHitGeneration) {
+      initRandomHitGen(settings);
+    } else {
+      if(mSimType == "its" && mRandomClusterGeneration) {
+        throw std::runtime_error("Random cluster generation for ITS MC sim (data includes clusters)");
+      }
+
+      initMonteCarloHitGen(settings);
     }
 
-    initMonteCarloHitGen(settings);
-  }
+    // Random number is always used for event time (follows exponential distribution)
+    initRandomNumGen(settings);
 
-  // Random number is always used for event time (follows exponential distribution)
-  initRandomNumGen(settings);
+    if(event_stream_mode == "pregenerate")
+      initEventStream(settings);
+  }
 
   if(mCreateCSVFile)
     initCsvEventFileHeader(settings);
@@ -236,6 +252,24 @@ void EventGenITS::initMonteCarloHitGen(const QSettings* settings)
                                           true,
                                           mRandomSeed);
   }
+  else if(monte_carlo_file_type == "packed" && mSimType == "its") {
+    name_filters << "*.evpk";
+    QStringList MC_files = monte_carlo_event_dir.entryList(name_filters);
+
+    if(MC_files.isEmpty()) {
+      std::cerr << "Error: No packed .evpk file found in MC event path";
+      std::cerr << std::endl;
+      exit(-1);
+    }
+
+    mMCPhysicsEvents = new EventPackedITS(mDetectorConfig,
+                                          &ITS::ITS_global_chip_id_to_position,
+                                          &ITS::ITS_position_to_global_chip_id,
+                                          monte_carlo_event_path_str,
+                                          MC_files.first(),
+                                          true,
+                                          mRandomSeed);
+  }
   else if(monte_carlo_file_type == "root" && mSimType == "focal") {
 #ifdef ROOT_ENABLED
     unsigned int random_seed = mRandomSeed;
@@ -336,12 +370,102 @@ void EventGenITS::initMonteCarloHitGen(const QSettings* settings)
                                              true,
                                              mRandomSeed);
     }
+    else if(monte_carlo_file_type == "packed") {
+      name_filters << "*.evpk";
+      QStringList QED_noise_event_files = qed_noise_event_dir.entryList(name_filters);
+
+      if(QED_noise_event_files.isEmpty()) {
+        std::cerr << "Error: No packed .evpk file found in QED/noise event path";
+        std::cerr << std::endl;
+        exit(-1);
+      }
+
+      mMCQedNoiseEvents = new EventPackedITS(mDetectorConfig,
+                                             &ITS::ITS_global_chip_id_to_position,
+                                             &ITS::ITS_position_to_global_chip_id,
+                                             qed_noise_event_path_str,
+                                             QED_noise_event_files.first(),
+                                             true,
+                                             mRandomSeed);
+    }
     else {
       std::cerr << "Error: Unknown MC event format \"";
       std::cerr << monte_carlo_file_type.toStdString() << "\"";
       exit(-1);
     }
   }
+
+  // Read and decode MC events in a separate thread, ahead of when they are needed
+  unsigned int prefetch_depth = settings->value("event/monte_carlo_prefetch_depth").toUInt();
+
+  if(mMCPhysicsEvents != nullptr)
+    mMCPhysicsEvents->startPrefetch(prefetch_depth);
+
+  if(mMCQedNoiseEvents != nullptr)
+    mMCQedNoiseEvents->startPrefetch(prefetch_depth);
+}
+
+
+///@brief Open the event stream file. In pregenerate mode the file is created, and the
+///       generated events are written to it. In replay mode the file is memory mapped, and
+///       the events are read from it instead of being generated.
+///@throw runtime_error If the event stream file can not be opened, or if it was generated
+///       for a different type of simulation (single chip vs. detector) or a different
+///       detector configuration (staves per layer, number of chips) than this one.
+void EventGenITS::initEventStream(const QSettings* settings)
+{
+  std::string filename = settings->value("event/event_stream_file").toString().toStdString();
+  Detector::DetectorConfigBase stream_config = mDetectorConfig;
+  std::uint32_t num_chips = 0;
+
+  // Chips in the detector configuration, all of them get hits from the event generator.
+  // The stave configuration is not used (and not stored) for single chip simulations.
+  if(mSingleChipSimulation) {
+    stream_config.num_layers = 0;
+    num_chips = 1;
+  } else {
+    for(unsigned int layer = 0; layer < stream_config.num_layers; layer++) {
+      const Detector::LayerConfig& layer_cfg = stream_config.layer[layer];
+      num_chips += layer_cfg.num_staves *
+                   layer_cfg.num_sub_staves_per_full_stave *
+                   layer_cfg.num_modules_per_sub_stave *
+                   layer_cfg.num_chips_per_module;
+    }
+  }
+
+  if(settings->value("event/event_stream_mode").toString() == "pregenerate") {
+    std::uint32_t flags = 0;
+
+    if(mQedNoiseGenEnable)
+      flags |= EVENT_STREAM_FLAG_QED_NOISE;
+    if(mRandomHitGeneration)
+      flags |= EVENT_STREAM_FLAG_RANDOM_HITS;
+    if(mSingleChipSimulation)
+      flags |= EVENT_STREAM_FLAG_SINGLE_CHIP;
+
+    std::cout << "Writing events to event stream file: " << filename << std::endl;
+
+    mEventStreamWriter.reset(new EventStreamWriter(filename, flags, mQedNoiseFeedRateNs,
+                                                   stream_config, num_chips));
+  } else {
+    std::cout << "Replaying events from event stream file: " << filename << std::endl;
+
+    mEventStreamReader.reset(new EventStreamReader(filename));
+
+    const EventStreamFileHeader& header = mEventStreamReader->getHeader();
+
+    if(bool(header.flags & EVENT_STREAM_FLAG_SINGLE_CHIP) != mSingleChipSimulation)
+      throw std::runtime_error("Event stream file and simulation differ in single chip setting.");
+
+    mEventStreamReader->checkDetectorConfig(stream_config, num_chips);
+
+    mEventStreamRandomHits = header.flags & EVENT_STREAM_FLAG_RANDOM_HITS;
+    mQedNoiseGenEnable = header.flags & EVENT_STREAM_FLAG_QED_NOISE;
+    mQedNoiseFeedRateNs = header.qed_noise_feed_rate_ns;
+
+    // No random generators or MC files are initialized in replay mode
+    mRandomHitGeneration = false;
+  }
 }
 
 
@@ -439,9 +563,9 @@ void EventGenITS::addCsvEventLine(uint64_t t_delta,
 ///@brief Get a reference to the next "triggered" event. In this event generator this is used
 ///       for collision events, which are discrete events that do not happen continuously,
 ///       and which are typically triggered on.
-///@return Const reference to std::vector<std::shared_ptr<PixelHit>> that
+///@return Const reference to std::vector<PixelHitPtr> that
 ///        contains the hits in the latest event.
-const std::vector<std::shared_ptr<PixelHit>>& EventGenITS::getTriggeredEvent(void) const
+const std::vector<PixelHitPtr>& EventGenITS::getTriggeredEvent(void) const
 {
   return mEventHitVector;
 }
@@ -450,7 +574,7 @@ const std::vector<std::shared_ptr<PixelHit>>& EventGenITS::getTriggeredEvent(voi
 ///@brief Get a reference to the next "untriggered" event. In this event generator this is
 ///       used for QED and noise events, processes that happens continuously.
 ///@return Const reference to std::vector<Hit> that contains the hits in the latest event.
-const std::vector<std::shared_ptr<PixelHit>>& EventGenITS::getUntriggeredEvent(void) const
+const std::vector<PixelHitPtr>& EventGenITS::getUntriggeredEvent(void) const
 {
   return mQedNoiseHitVector;
 }
@@ -661,10 +785,10 @@ void EventGenITS::generateRandomEventData(uint64_t event_time_ns,
       event_pixel_hit_count += 4;
 
       // Create hit with timing information and pointer to readout stats object
-      std::shared_ptr<PixelHit> pix1_shared = std::make_shared<PixelHit>(rand_x1, rand_y1, 0);
-      std::shared_ptr<PixelHit> pix2_shared = std::make_shared<PixelHit>(rand_x1, rand_y2, 0);
-      std::shared_ptr<PixelHit> pix3_shared = std::make_shared<PixelHit>(rand_x2, rand_y1, 0);
-      std::shared_ptr<PixelHit> pix4_shared = std::make_shared<PixelHit>(rand_x2, rand_y2, 0);
+      PixelHitPtr pix1_shared = makePixelHit(rand_x1, rand_y1, 0);
+      PixelHitPtr pix2_shared = makePixelHit(rand_x1, rand_y2, 0);
+      PixelHitPtr pix3_shared = makePixelHit(rand_x2, rand_y1, 0);
+      PixelHitPtr pix4_shared = makePixelHit(rand_x2, rand_y2, 0);
 
       pix1_shared->setActiveTimeStart(event_time_ns+mPixelDeadTime);
       pix2_shared->setActiveTimeStart(event_time_ns+mPixelDeadTime);
@@ -697,11 +821,9 @@ void EventGenITS::generateRandomEventData(uint64_t event_time_ns,
 
       n_particle_hits_scaled = n_particle_hits_unscaled * mMultiplicityScaleFactor[layer];
 
-#ifdef PIXEL_DEBUG
-      std::cout << "@ " << event_time_ns << " ns: ";
-      std::cout << "Generating " << n_particle_hits_scaled;
-      std::cout << " track hits for layer " << layer << "." << std::endl;
-#endif
+      LOG(LOG_TRACE, LOG_MODULE_EVENT) << "@ " << event_time_ns << " ns: "
+                                       << "Generating " << n_particle_hits_scaled
+                                       << " track hits for layer " << layer << ".";
 
       // Generate hits here
       for(unsigned int i = 0; i < n_particle_hits_scaled; i++) {
@@ -766,10 +888,10 @@ void EventGenITS::generateRandomEventData(uint64_t event_time_ns,
         chip_hits[global_chip_id]++;
 
         // Create hit with timing information and pointer to readout stats object
-        std::shared_ptr<PixelHit> pix1_shared = std::make_shared<PixelHit>(rand_x1, rand_y1, global_chip_id);
-        std::shared_ptr<PixelHit> pix2_shared = std::make_shared<PixelHit>(rand_x1, rand_y2, global_chip_id);
-        std::shared_ptr<PixelHit> pix3_shared = std::make_shared<PixelHit>(rand_x2, rand_y1, global_chip_id);
-        std::shared_ptr<PixelHit> pix4_shared = std::make_shared<PixelHit>(rand_x2, rand_y2, global_chip_id);
+        PixelHitPtr pix1_shared = makePixelHit(rand_x1, rand_y1, global_chip_id);
+        PixelHitPtr pix2_shared = makePixelHit(rand_x1, rand_y2, global_chip_id);
+        PixelHitPtr pix3_shared = makePixelHit(rand_x2, rand_y1, global_chip_id);
+        PixelHitPtr pix4_shared = makePixelHit(rand_x2, rand_y2, global_chip_id);
 
         pix1_shared->setActiveTimeStart(event_time_ns+mPixelDeadTime);
         pix2_shared->setActiveTimeStart(event_time_ns+mPixelDeadTime);
@@ -837,11 +959,11 @@ void EventGenITS::generateMonteCarloEventData(uint64_t event_time_ns,
     if(mRandomClusterGeneration) {
       // Create random cluster around pixel hit
 
-      std::vector<std::shared_ptr<PixelHit>> pix_cluster = createCluster(pix,
-                                                                         event_time_ns,
-                                                                         mPixelDeadTime,
-                                                                         mPixelActiveTime,
-                                                                         mTriggeredReadoutStats);
+      std::vector<PixelHitPtr> pix_cluster = createCluster(pix,
+                                                           event_time_ns,
+                                                           mPixelDeadTime,
+                                                           mPixelActiveTime,
+                                                           mTriggeredReadoutStats);
       Detector::DetectorPosition pos;
 
       if(mSimType == "its")
@@ -863,7 +985,7 @@ void EventGenITS::generateMonteCarloEventData(uint64_t event_time_ns,
       // (ie. the cluster hits are already included in the MC data)
 
       // Recreate hit with timing information and pointer to readout stats object
-      std::shared_ptr<PixelHit> pix_shared = std::make_shared<PixelHit>(pix);
+      PixelHitPtr pix_shared = makePixelHit(pix);
       pix_shared->setActiveTimeStart(event_time_ns+mPixelDeadTime);
       pix_shared->setActiveTimeEnd(event_time_ns+mPixelDeadTime+mPixelActiveTime);
       pix_shared->setPixelReadoutStatsObj(mTriggeredReadoutStats);
@@ -886,6 +1008,68 @@ void EventGenITS::generateMonteCarloEventData(uint64_t event_time_ns,
 }
 
 
+///@brief Read the next event of a given type from the event stream file, and put it
+///       in a hit vector.
+///@param[in] type Triggered or untriggered event
+///@param[in] event_time_ns Time when event occured
+///@param[out] hit_vector Vector to put hits in. Old hits in the vector are cleared.
+///@param[in] readout_stats Readout stats object for the hits
+///@param[out] event_pixel_hit_count Total number of pixel hits for this event
+///@param[out] chip_hits Map with number of pixel hits for this event per chip ID
+///@param[out] layer_hits Map with number of pixel hits for this event per layer
+///@return Time till next event of the same type, as it was generated
+///@throw runtime_error If there are no more events of this type in the event stream
+uint64_t EventGenITS::replayEventData(EventStreamType type,
+                                      uint64_t event_time_ns,
+                                      std::vector<PixelHitPtr> &hit_vector,
+                                      const std::shared_ptr<PixelReadoutStats> &readout_stats,
+                                      unsigned int &event_pixel_hit_count,
+                                      std::map<unsigned int, unsigned int> &chip_hits,
+                                      std::map<unsigned int, unsigned int> &layer_hits)
+{
+  EventStreamEventHeader event;
+  const EventStreamHit* hits;
+
+  hit_vector.clear();
+
+  if(mEventStreamReader->getNextEvent(type, event, hits) == false)
+    throw std::runtime_error("End of event stream file reached, no more events.");
+
+  event_pixel_hit_count = event.event_pixel_hit_count;
+
+  // The random hit generator counts 2x2 clusters (not pixels) per chip/layer, and does not
+  // count hits at all in single chip mode. The MC generator counts every pixel, in which case
+  // every pixel has its own cluster id in the event stream.
+  bool count_hits = !(mEventStreamRandomHits && mSingleChipSimulation);
+
+  hit_vector.reserve(event.num_hits);
+
+  for(unsigned int i = 0; i < event.num_hits; i++) {
+    const EventStreamHit& hit = hits[i];
+
+    PixelHitPtr pix = makePixelHit(hit.col, hit.row, hit.chip_id);
+    pix->setActiveTimeStart(event_time_ns+mPixelDeadTime);
+    pix->setActiveTimeEnd(event_time_ns+mPixelDeadTime+mPixelActiveTime);
+    pix->setPixelReadoutStatsObj(readout_stats);
+    hit_vector.push_back(pix);
+
+    if(count_hits && (i == 0 || hit.cluster_id != hits[i-1].cluster_id)) {
+      Detector::DetectorPosition pos;
+
+      if(mSimType == "focal")
+        pos = Focal::Focal_global_chip_id_to_position(hit.chip_id);
+      else
+        pos = ITS::ITS_global_chip_id_to_position(hit.chip_id);
+
+      layer_hits[pos.layer_id]++;
+      chip_hits[hit.chip_id]++;
+    }
+  }
+
+  return event.t_delta_ns;
+}
+
+
 ///@brief Generate the next physics event (in the future).
 ///       1) Generate time till the next physics event
 ///       2) Generate hits for the next event, and put them on the hit queue
@@ -902,32 +1086,42 @@ uint64_t EventGenITS::generateNextPhysicsEvent(void)
 
   mTriggeredEventCount++;
 
-  if(mRandomHitGeneration == true) {
-    generateRandomEventData(time_now, event_pixel_hit_count, chip_hits, layer_hits);
+  if(mEventStreamReader) {
+    t_delta = replayEventData(EVENT_STREAM_TRIGGERED, time_now, mEventHitVector,
+                              mTriggeredReadoutStats, event_pixel_hit_count,
+                              chip_hits, layer_hits);
+    t_delta_cycles = t_delta / mBunchCrossingRate_ns;
   } else {
-    generateMonteCarloEventData(time_now, event_pixel_hit_count, chip_hits, layer_hits);
-  }
+    if(mRandomHitGeneration == true) {
+      generateRandomEventData(time_now, event_pixel_hit_count, chip_hits, layer_hits);
+    } else {
+      generateMonteCarloEventData(time_now, event_pixel_hit_count, chip_hits, layer_hits);
+    }
 
-  // Generate random (exponential distributed) interval till next event/interaction
-  // The exponential distribution only works with double float, that's why it is rounded
-  // to nearest clock cycle. Which is okay, because events in LHC should be synchronous
-  // with bunch crossing clock anyway?
-  // Add +1 because otherwise we risk getting events with 0 t_delta, which obviously is not
-  // physically possible, and also SystemC doesn't allow wait() for 0 clock cycles.
-  t_delta_cycles = std::round((*mRandEventTime)(mRandEventTimeGen)) + 1;
-  t_delta = t_delta_cycles * mBunchCrossingRate_ns;
+    // Generate random (exponential distributed) interval till next event/interaction
+    // The exponential distribution only works with double float, that's why it is rounded
+    // to nearest clock cycle. Which is okay, because events in LHC should be synchronous
+    // with bunch crossing clock anyway?
+    // Add +1 because otherwise we risk getting events with 0 t_delta, which obviously is not
+    // physically possible, and also SystemC doesn't allow wait() for 0 clock cycles.
+    t_delta_cycles = std::round((*mRandEventTime)(mRandEventTimeGen)) + 1;
+    t_delta = t_delta_cycles * mBunchCrossingRate_ns;
+
+    // The random hit generator always creates 2x2 pixel clusters
+    if(mEventStreamWriter)
+      mEventStreamWriter->writeEvent(EVENT_STREAM_TRIGGERED, time_now, t_delta,
+                                     event_pixel_hit_count, mEventHitVector,
+                                     mRandomHitGeneration ? 4 : 1);
+  }
 
   // Write event rate and multiplicity numbers to CSV file
   if(mCreateCSVFile)
     addCsvEventLine(t_delta, event_pixel_hit_count, chip_hits, layer_hits);
 
-  if(mTriggeredEventCount % 100 == 0) {
-    std::cout << "@ " << time_now << " ns: ";
-    std::cout << "\tPhysics event number: " << mTriggeredEventCount;
-    std::cout << "\tt_delta: " << t_delta;
-    std::cout << "\tt_delta_cycles: " << t_delta_cycles;
-    //std::cout << "\tmLastPhysicsEventTimeNs: " << mLastPhysicsEventTimeNs << std::endl;
-  }
+  LOG(LOG_DEBUG, LOG_MODULE_EVENT) << "@ " << time_now << " ns: "
+                                   << "\tPhysics event number: " << mTriggeredEventCount
+                                   << "\tt_delta: " << t_delta
+                                   << "\tt_delta_cycles: " << t_delta_cycles;
 
   return t_delta;
 }
@@ -938,6 +1132,17 @@ void EventGenITS::generateNextQedNoiseEvent(uint64_t event_time_ns)
 {
   mUntriggeredEventCount++;
 
+  if(mEventStreamReader) {
+    unsigned int event_pixel_hit_count;
+    std::map<unsigned int, unsigned int> layer_hits;
+    std::map<unsigned int, unsigned int> chip_hits;
+
+    replayEventData(EVENT_STREAM_UNTRIGGERED, event_time_ns, mQedNoiseHitVector,
+                    mUntriggeredReadoutStats, event_pixel_hit_count,
+                    chip_hits, layer_hits);
+    return;
+  }
+
   mQedNoiseHitVector.clear();
 
   const EventDigits* digits = mMCQedNoiseEvents->getNextEvent();
@@ -952,7 +1157,7 @@ void EventGenITS::generateNextQedNoiseEvent(uint64_t event_time_ns)
     const PixelHit &pix = *digit_it;
 
     // Recreate hit with timing information and pointer to readout stats object
-    std::shared_ptr<PixelHit> pix_shared = std::make_shared<PixelHit>(pix);
+    PixelHitPtr pix_shared = makePixelHit(pix);
     pix_shared->setActiveTimeStart(event_time_ns+mPixelDeadTime);
     pix_shared->setActiveTimeEnd(event_time_ns+mPixelDeadTime+mPixelActiveTime);
     pix_shared->setPixelReadoutStatsObj(mUntriggeredReadoutStats);
@@ -961,12 +1166,18 @@ void EventGenITS::generateNextQedNoiseEvent(uint64_t event_time_ns)
 
     digit_it++;
   }
+
+  if(mEventStreamWriter)
+    mEventStreamWriter->writeEvent(EVENT_STREAM_UNTRIGGERED, event_time_ns, mQedNoiseFeedRateNs,
+                                   mQedNoiseHitVector.size(), mQedNoiseHitVector, 1);
 }
 
 
 ///@brief SystemC controlled method. Creates new physics events (hits)
 void EventGenITS::physicsEventMethod(void)
 {
+  PROFILE_PROCESS("EventGenITS::physicsEventMethod");
+
   if(mStopEventGeneration == false) {
     uint64_t t_delta = generateNextPhysicsEvent();
     E_triggered_event.notify();
@@ -978,6 +1189,8 @@ void EventGenITS::physicsEventMethod(void)
 ///@brief SystemC controlled method. Creates new QED/Noise events (hits)
 void EventGenITS::qedNoiseEventMethod(void)
 {
+  PROFILE_PROCESS("EventGenITS::qedNoiseEventMethod");
+
   if(mStopEventGeneration == false) {
     uint64_t time_now = sc_time_stamp().value();
 
@@ -17,6 +17,7 @@
 #include "Detector/ITS/ITSDetectorConfig.hpp"
 #include "EventGenBase.hpp"
 #include "EventBaseDiscrete.hpp"
+#include "EventStream.hpp"
 
 #ifdef ROOT_ENABLED
 #include "EventRootFocal.hpp"
@@ -38,8 +39,8 @@
 class EventGenITS : public EventGenBase
 {
 private:
-  std::vector<std::shared_ptr<PixelHit>> mEventHitVector;
-  std::vector<std::shared_ptr<PixelHit>> mQedNoiseHitVector;
+  std::vector<PixelHitPtr> mEventHitVector;
+  std::vector<PixelHitPtr> mQedNoiseHitVector;
 
   int mBunchCrossingRate_ns;
   int mAverageEventRate_ns;
@@ -79,7 +80,15 @@ private:
   boost::random::discrete_distribution<> *mRandHitMultiplicity;
 
   /// Exponential distribution used for time between events
-  boost::random::exponential_distribution<double> *mRandEventTime;
+  boost::random::exponential_distribution<double> *mRandEventTime = nullptr;
+
+  /// Event stream file for pregenerated events. The writer is used in pregenerate mode,
+  /// and the reader is used instead of the random/MC hit generation in replay mode.
+  std::unique_ptr<EventStreamWriter> mEventStreamWriter;
+  std::unique_ptr<EventStreamReader> mEventStreamReader;
+
+  /// True if the replayed event stream was generated with random hit generation
+  bool mEventStreamRandomHits = false;
 
   std::ofstream mPhysicsEventsCSVFile;
 
@@ -93,6 +102,14 @@ private:
                                    std::map<unsigned int, unsigned int> &chip_hits,
                                    std::map<unsigned int, unsigned int> &layer_hits);
 
+  uint64_t replayEventData(EventStreamType type,
+                           uint64_t event_time_ns,
+                           std::vector<PixelHitPtr> &hit_vector,
+                           const std::shared_ptr<PixelReadoutStats> &readout_stats,
+                           unsigned int &event_pixel_hit_count,
+                           std::map<unsigned int, unsigned int> &chip_hits,
+                           std::map<unsigned int, unsigned int> &layer_hits);
+
   uint64_t generateNextPhysicsEvent(void);
   void generateNextQedNoiseEvent(uint64_t event_time_ns);
   void readDiscreteDistributionFile(const char* filename,
@@ -100,6 +117,7 @@ private:
   void initRandomHitGen(const QSettings* settings);
   void initRandomNumGen(const QSettings* settings);
   void initMonteCarloHitGen(const QSettings* settings);
+  void initEventStream(const QSettings* settings);
   void initCsvEventFileHeader(const QSettings* settings);
   void addCsvEventLine(uint64_t t_delta,
                        unsigned int event_pixel_hit_count,
@@ -119,8 +137,8 @@ public:
   void setBunchCrossingRate(int rate_ns);
   void stopEventGeneration(void);
 
-  const std::vector<std::shared_ptr<PixelHit>>& getTriggeredEvent(void) const;
-  const std::vector<std::shared_ptr<PixelHit>>& getUntriggeredEvent(void) const;
+  const std::vector<PixelHitPtr>& getTriggeredEvent(void) const;
+  const std::vector<PixelHitPtr>& getUntriggeredEvent(void) const;
 };
 
 #endif
@@ -9,13 +9,15 @@
 #include "Alpide/alpide_constants.hpp"
 #include "Detector/PCT/PCT_constants.hpp"
 #include "../utils.hpp"
+#include "Log/Log.hpp"
+#include "Profiling/ProcessProfiler.hpp"
 #include <boost/random/random_device.hpp>
 #include <stdexcept>
 #include <cmath>
 #include <map>
 #include <QDir>
 
-static bool comparePixelHitActiveTime(const std::shared_ptr<PixelHit>& p1, const std::shared_ptr<PixelHit>& p2);
+static bool comparePixelHitActiveTime(const PixelHitPtr& p1, const PixelHitPtr& p2);
 
 
 SC_HAS_PROCESS(EventGenPCT);
@@ -219,10 +221,10 @@ EventGenPCT::~EventGenPCT()
 
 
 ///@brief Get a reference to the next "triggered" event. Not used in this event generator
-///@return Const reference to an empty std::vector<std::shared_ptr<PixelHit>>
-const std::vector<std::shared_ptr<PixelHit>>& EventGenPCT::getTriggeredEvent(void) const
+///@return Const reference to an empty std::vector<PixelHitPtr>
+const std::vector<PixelHitPtr>& EventGenPCT::getTriggeredEvent(void) const
 {
-  static std::vector<std::shared_ptr<PixelHit>> empty_vec;
+  static std::vector<PixelHitPtr> empty_vec;
 
   return empty_vec;
 }
@@ -232,14 +234,14 @@ const std::vector<std::shared_ptr<PixelHit>>& EventGenPCT::getTriggeredEvent(voi
 ///       used for the particle hits for the pencil beam, since they are continuously
 ///       hitting the detector, and you don't trigger on any kind of collision/event.
 ///@return Const reference to std::vector<Hit> that contains the hits in the latest event.
-const std::vector<std::shared_ptr<PixelHit>>& EventGenPCT::getUntriggeredEvent(void) const
+const std::vector<PixelHitPtr>& EventGenPCT::getUntriggeredEvent(void) const
 {
   return mEventHitVector;
 }
 
 
 ///@brief Compare the active time of two PixelHit objects. Return if p1 is active before p2.
-static bool comparePixelHitActiveTime(const std::shared_ptr<PixelHit>& p1, const std::shared_ptr<PixelHit>& p2)
+static bool comparePixelHitActiveTime(const PixelHitPtr& p1, const PixelHitPtr& p2)
 {
   return (p1->getActiveTimeStart() < p2->getActiveTimeStart());
 }
@@ -271,7 +273,7 @@ void EventGenPCT::generateRandomEventData(unsigned int &particle_count_out,
 
   unsigned int num_particles_total = (unsigned int)rand_particle_count;
 
-  std::cout << "EventGenPCT: generating " << num_particles_total << " particles" << std::endl;
+  LOG(LOG_DEBUG, LOG_MODULE_EVENT) << "EventGenPCT: generating " << num_particles_total << " particles";
 
   for(unsigned int particle_num = 0; particle_num < num_particles_total; particle_num++) {
     // Todo: loop over the layers?
@@ -316,11 +318,11 @@ void EventGenPCT::generateRandomEventData(unsigned int &particle_count_out,
 #endif
 
     if(mRandomClusterGeneration) {
-      std::vector<std::shared_ptr<PixelHit>> pix_cluster = createCluster(pixel,
-                                                                         time_now,
-                                                                         mPixelDeadTime,
-                                                                         mPixelActiveTime,
-                                                                         mUntriggeredReadoutStats);
+      std::vector<PixelHitPtr> pix_cluster = createCluster(pixel,
+                                                           time_now,
+                                                           mPixelDeadTime,
+                                                           mPixelActiveTime,
+                                                           mUntriggeredReadoutStats);
 
       // Update hit counters. createCluster() only generates hits for _one_ chip,
       // if pixels are outside matrix boundaries then they are ignored. Hence it is sufficient
@@ -332,7 +334,7 @@ void EventGenPCT::generateRandomEventData(unsigned int &particle_count_out,
       // Copy pixels from cluster over to the event hit vector
       mEventHitVector.insert(mEventHitVector.end(), pix_cluster.begin(), pix_cluster.end());
     } else {
-      mEventHitVector.emplace_back(std::make_shared<PixelHit>(pixel));
+      mEventHitVector.emplace_back(makePixelHit(pixel));
 
       // Do this after inserting (copy) of pixel, to avoid double registering of
       // readout stats when pixel is destructed
@@ -380,11 +382,11 @@ bool EventGenPCT::generateMonteCarloEventData(unsigned int &particle_count_out,
     if(mRandomClusterGeneration) {
       hit_time = time_now + (*mRandHitTime)(mRandHitTimeGen);
 
-      std::vector<std::shared_ptr<PixelHit>> pix_cluster = createCluster(pixel,
-                                                                         hit_time,
-                                                                         mPixelDeadTime,
-                                                                         mPixelActiveTime,
-                                                                         mUntriggeredReadoutStats);
+      std::vector<PixelHitPtr> pix_cluster = createCluster(pixel,
+                                                           hit_time,
+                                                           mPixelDeadTime,
+                                                           mPixelActiveTime,
+                                                           mUntriggeredReadoutStats);
 
       // Update hit counters. createCluster() only generates hits for _one_ chip,
       // if pixels are outside matrix boundaries then they are ignored. Hence it is sufficient
@@ -396,7 +398,7 @@ bool EventGenPCT::generateMonteCarloEventData(unsigned int &particle_count_out,
       // Copy pixels from cluster over to the event hit vector
       mEventHitVector.insert(mEventHitVector.end(), pix_cluster.begin(), pix_cluster.end());
     } else {
-      mEventHitVector.emplace_back(std::make_shared<PixelHit>(pixel));
+      mEventHitVector.emplace_back(makePixelHit(pixel));
 
       // Very rudimentary algorithm for determining if pixels are in a cluster
       // Pixel hits are assumed to be in a cluster if chip id matches and the difference
@@ -482,8 +484,8 @@ bool EventGenPCT::generateEvent(void)
                     chip_pixel_hits,
                     layer_pixel_hits);
 
-  std::cout << "@ " << time_now << " ns: ";
-  std::cout << "\tEvent number: " << mUntriggeredEventCount;
+  LOG(LOG_DEBUG, LOG_MODULE_EVENT) << "@ " << time_now << " ns: "
+                                   << "\tEvent number: " << mUntriggeredEventCount;
 
   return last_event;
 }
@@ -527,6 +529,8 @@ void EventGenPCT::updateBeamPosition(void)
 ///@brief SystemC controlled method. Creates new physics events (hits)
 void EventGenPCT::physicsEventMethod(void)
 {
+  PROFILE_PROCESS("EventGenPCT::physicsEventMethod");
+
   if(mStopEventGeneration == false && mBeamEndCoordsReached == false) {
     bool last_mc_event = generateEvent();
 
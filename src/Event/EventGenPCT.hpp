@@ -27,7 +27,7 @@ using std::uint64_t;
 class EventGenPCT : public EventGenBase
 {
 private:
-  std::vector<std::shared_ptr<PixelHit>> mEventHitVector;
+  std::vector<PixelHitPtr> mEventHitVector;
 
 #ifdef ROOT_ENABLED
   EventRootPCT* mMCEvents = nullptr;
@@ -107,8 +107,8 @@ public:
   double getBeamCenterCoordX(void) const {return mBeamCenterCoordX_mm;}
   double getBeamCenterCoordY(void) const {return mBeamCenterCoordY_mm;}
 
-  const std::vector<std::shared_ptr<PixelHit>>& getTriggeredEvent(void) const;
-  const std::vector<std::shared_ptr<PixelHit>>& getUntriggeredEvent(void) const;
+  const std::vector<PixelHitPtr>& getTriggeredEvent(void) const;
+  const std::vector<PixelHitPtr>& getUntriggeredEvent(void) const;
 };
 
 
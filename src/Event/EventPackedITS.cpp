@@ -0,0 +1,246 @@
+/**
+ * @file   EventPackedITS.cpp
+ * @author Simon Voigt Nesbo
+ * @date   October 16, 2026
+ * @brief  Class for handling events from AliRoot MC simulations for ITS, stored
+ *         together in one packed and indexed file.
+ */
+
+#include <iostream>
+#include <cstring>
+#include <stdexcept>
+#include "EventPackedITS.hpp"
+
+
+///@brief Constructor for EventPackedITS class, which handles a set of events
+///       stored in a packed event file. The file is memory mapped, and the events
+///       are decoded from the mapped file when they are used.
+///@param config detectorConfig object which specifies which staves in ITS should
+///              be included. Digits for chips that are not included are skipped
+///              when the events are decoded.
+///@param global_chip_id_to_position_func Pointer to function used to determine global
+///                                       chip id based on position
+///@param position_to_global_chip_id_func Pointer to function used to determine position
+///                                       based on global chip id
+///@param path Path to packed event file
+///@param packed_filename File name of packed event file
+///@param random_event_order True to randomize which event is used, false to get events
+///              in sequential order.
+///@param random_seed Random seed for event sequence randomizer.
+///@throw runtime_error If the file can not be opened, or is not a valid packed event file
+EventPackedITS::EventPackedITS(Detector::DetectorConfigBase config,
+                               Detector::t_global_chip_id_to_position_func global_chip_id_to_position_func,
+                               Detector::t_position_to_global_chip_id_func position_to_global_chip_id_func,
+                               const QString& path,
+                               const QString& packed_filename,
+                               bool random_event_order,
+                               int random_seed)
+  : EventBaseDiscrete(config,
+                      global_chip_id_to_position_func,
+                      position_to_global_chip_id_func,
+                      path,
+                      QStringList(packed_filename),
+                      random_event_order,
+                      random_seed,
+                      false)
+  , mFile(path + QString("/") + packed_filename)
+{
+  std::string filename = mFile.fileName().toStdString();
+
+  if(!mFile.open(QIODevice::ReadOnly))
+    throw std::runtime_error("Error opening packed event file: " + filename);
+
+  mSize = mFile.size();
+
+  if(mSize < (qint64)sizeof(EventPackedFileHeader))
+    throw std::runtime_error("Packed event file too short: " + filename);
+
+  mData = mFile.map(0, mSize);
+
+  if(mData == nullptr)
+    throw std::runtime_error("Error memory mapping packed event file: " + filename);
+
+  std::memcpy(&mHeader, mData, sizeof(mHeader));
+
+  if(std::memcmp(mHeader.magic, EVENT_PACKED_MAGIC, sizeof(mHeader.magic)) != 0)
+    throw std::runtime_error("Not a packed event file: " + filename);
+
+  if(mHeader.version != EVENT_PACKED_VERSION)
+    throw std::runtime_error("Unsupported packed event file version: " + filename);
+
+  if(mHeader.num_events == 0)
+    throw std::runtime_error("No events in packed event file: " + filename);
+
+  if(mHeader.index_offset % sizeof(std::uint64_t) != 0 ||
+     mHeader.index_offset < sizeof(EventPackedFileHeader) ||
+     !fitsInFile(mHeader.index_offset, mHeader.num_events*sizeof(std::uint64_t)))
+    throw std::runtime_error("Invalid event index in packed event file: " + filename);
+
+  mIndex = reinterpret_cast<const std::uint64_t*>(mData + mHeader.index_offset);
+
+  // Check that all events start at aligned offsets between the file header and the index,
+  // the event contents are checked against the file size when the events are decoded
+  for(std::uint32_t i = 0; i < mHeader.num_events; i++) {
+    if(mIndex[i] % sizeof(std::uint64_t) != 0 ||
+       mIndex[i] < sizeof(EventPackedFileHeader) ||
+       mIndex[i] + sizeof(EventPackedEventHeader) > mHeader.index_offset)
+      throw std::runtime_error("Invalid offset for event " + std::to_string(i) +
+                               " in packed event file: " + filename);
+  }
+
+  for(auto it = mDetectorPositionList.begin(); it != mDetectorPositionList.end(); it++) {
+    if(it->first >= mChipIncluded.size())
+      mChipIncluded.resize(it->first+1, false);
+    mChipIncluded[it->first] = true;
+  }
+
+  std::cout << "Mapped packed event file " << filename << " with ";
+  std::cout << mHeader.num_events << " events." << std::endl;
+
+  mNumEvents = mHeader.num_events;
+  createEventIdDistribution();
+}
+
+
+///@brief Check that a block of data is within the packed event file
+///@param offset File offset of the data
+///@param size Size of the data in bytes
+///@return True if the data fits in the file
+bool EventPackedITS::fitsInFile(std::uint64_t offset, std::uint64_t size) const
+{
+  return offset <= (std::uint64_t)mSize && size <= (std::uint64_t)mSize - offset;
+}
+
+
+EventPackedITS::~EventPackedITS()
+{
+  stopPrefetch();
+
+  if(mData != nullptr)
+    mFile.unmap(const_cast<uchar*>(mData));
+}
+
+
+///@brief The events are accessed directly in the memory mapped file,
+///       there is nothing to preload.
+void EventPackedITS::readEventFiles()
+{
+}
+
+
+///@brief Decode an event from the packed event file
+///@param event_index Index of event in the packed file
+///@return Pointer to EventDigits object with the digits in the event for the chips
+///        that are included in the simulation
+///@throw runtime_error If the event extends into the index or beyond the end of the file
+EventDigits* EventPackedITS::readEvent(int event_index)
+{
+  std::uint64_t offset = mIndex[event_index];
+  EventPackedEventHeader event_header;
+
+  // Event offsets were checked against the index offset (and alignment) in the constructor
+  std::memcpy(&event_header, mData+offset, sizeof(event_header));
+
+  std::uint64_t n = event_header.num_digits;
+  std::uint64_t chip_id_offset = offset + sizeof(event_header);
+  std::uint64_t col_offset = chip_id_offset + n*sizeof(std::uint32_t);
+  std::uint64_t row_offset = col_offset + n*sizeof(std::uint16_t);
+
+  if(row_offset + n*sizeof(std::uint16_t) > mHeader.index_offset)
+    throw std::runtime_error("Truncated event " + std::to_string(event_index) +
+                             " in packed event file: " + mFile.fileName().toStdString());
+
+  // Events start at 8-byte aligned offsets, so the arrays are naturally aligned
+  const std::uint32_t* chip_id = reinterpret_cast<const std::uint32_t*>(mData+chip_id_offset);
+  const std::uint16_t* col = reinterpret_cast<const std::uint16_t*>(mData+col_offset);
+  const std::uint16_t* row = reinterpret_cast<const std::uint16_t*>(mData+row_offset);
+
+  EventDigits* event = new EventDigits();
+
+  for(std::uint64_t i = 0; i < n; i++) {
+    if(chip_id[i] < mChipIncluded.size() && mChipIncluded[chip_id[i]])
+      event->addHit(col[i], row[i], chip_id[i]);
+  }
+
+  return event;
+}
+
+
+///@brief Create packed event file and write a preliminary file header
+///@param[in] filename Path and name of packed event file
+///@throw runtime_error If the file can not be created
+EventPackedITSWriter::EventPackedITSWriter(const std::string& filename)
+  : mFile(filename, std::ios::out | std::ios::binary | std::ios::trunc)
+  , mPos(0)
+  , mFilename(filename)
+{
+  if(!mFile.is_open())
+    throw std::runtime_error("Error creating packed event file: " + filename);
+
+  // Header is rewritten with the number of events and index offset by finish()
+  EventPackedFileHeader header;
+  std::memset(&header, 0, sizeof(header));
+
+  mFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  mPos += sizeof(header);
+}
+
+
+///@brief Write an event to the packed event file
+///@param[in] event Event with digits to write
+void EventPackedITSWriter::writeEvent(const EventDigits& event)
+{
+  std::size_t n = event.size();
+  EventPackedEventHeader event_header;
+  std::vector<std::uint32_t> chip_id(n);
+  std::vector<std::uint16_t> col(n);
+  std::vector<std::uint16_t> row(n);
+
+  event_header.num_digits = n;
+  event_header.reserved = 0;
+
+  std::size_t i = 0;
+  for(auto it = event.getDigitsIterator(); it != event.getDigitsEndIterator(); it++, i++) {
+    chip_id[i] = it->getChipId();
+    col[i] = it->getCol();
+    row[i] = it->getRow();
+  }
+
+  mIndex.push_back(mPos);
+
+  mFile.write(reinterpret_cast<const char*>(&event_header), sizeof(event_header));
+  mFile.write(reinterpret_cast<const char*>(chip_id.data()), n*sizeof(std::uint32_t));
+  mFile.write(reinterpret_cast<const char*>(col.data()), n*sizeof(std::uint16_t));
+  mFile.write(reinterpret_cast<const char*>(row.data()), n*sizeof(std::uint16_t));
+  mPos += sizeof(event_header) + n*(sizeof(std::uint32_t) + 2*sizeof(std::uint16_t));
+
+  // Pad to 8 bytes so that the next event is aligned
+  static const char padding[8] = {0};
+  std::size_t padding_size = (8 - mPos % 8) % 8;
+  mFile.write(padding, padding_size);
+  mPos += padding_size;
+}
+
+
+///@brief Write the event index, update the file header and close the file
+///@throw runtime_error If writing to the file failed
+void EventPackedITSWriter::finish(void)
+{
+  EventPackedFileHeader header;
+  std::memcpy(header.magic, EVENT_PACKED_MAGIC, sizeof(header.magic));
+  header.version = EVENT_PACKED_VERSION;
+  header.num_events = mIndex.size();
+  header.index_offset = mPos;
+
+  mFile.write(reinterpret_cast<const char*>(mIndex.data()),
+              mIndex.size()*sizeof(std::uint64_t));
+
+  mFile.seekp(0);
+  mFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  bool failed = mFile.fail();
+  mFile.close();
+
+  if(failed)
+    throw std::runtime_error("Error writing packed event file: " + mFilename);
+}
@@ -0,0 +1,97 @@
+/**
+ * @file   EventPackedITS.hpp
+ * @author Simon Voigt Nesbo
+ * @date   October 16, 2026
+ * @brief  Class for handling events from AliRoot MC simulations for ITS, stored
+ *         together in one packed and indexed file. The file is memory mapped, and
+ *         events are only decoded when they are used.
+ *
+ *         File layout (native byte order, ie. little endian on x86):
+ *           EventPackedFileHeader
+ *           For each event, starting at an 8-byte aligned offset:
+ *             EventPackedEventHeader
+ *             uint32_t chip_id[num_digits]
+ *             uint16_t col[num_digits]
+ *             uint16_t row[num_digits]
+ *             Padding to 8 bytes
+ *           Index: uint64_t event_offset[num_events], at header.index_offset
+ *
+ *         Packed files are created from the binary or XML event files with the
+ *         pack_mc_events tool.
+ */
+
+#ifndef EVENT_PACKED_ITS_H
+#define EVENT_PACKED_ITS_H
+
+#include <QFile>
+#include <QString>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "EventBaseDiscrete.hpp"
+
+static const char EVENT_PACKED_MAGIC[8] = {'A','L','P','E','V','P','K','D'};
+static const std::uint32_t EVENT_PACKED_VERSION = 1;
+
+struct EventPackedFileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t num_events;
+
+  /// File offset of event index
+  std::uint64_t index_offset;
+};
+
+struct EventPackedEventHeader {
+  std::uint32_t num_digits;
+  std::uint32_t reserved;
+};
+
+static_assert(sizeof(EventPackedFileHeader) == 24, "Unexpected EventPackedFileHeader size");
+static_assert(sizeof(EventPackedEventHeader) == 8, "Unexpected EventPackedEventHeader size");
+
+
+class EventPackedITS : public EventBaseDiscrete {
+private:
+  QFile mFile;
+  const uchar* mData = nullptr;
+  qint64 mSize = 0;
+  EventPackedFileHeader mHeader;
+  const std::uint64_t* mIndex = nullptr;
+
+  /// Indexed by global chip id, true for chips that are included in the simulation
+  std::vector<bool> mChipIncluded;
+
+  bool fitsInFile(std::uint64_t offset, std::uint64_t size) const;
+  void readEventFiles();
+  EventDigits* readEvent(int event_index);
+
+public:
+  EventPackedITS(Detector::DetectorConfigBase config,
+                 Detector::t_global_chip_id_to_position_func global_chip_id_to_position_func,
+                 Detector::t_position_to_global_chip_id_func position_to_global_chip_id_func,
+                 const QString& path,
+                 const QString& packed_filename,
+                 bool random_event_order = true,
+                 int random_seed = 0);
+  ~EventPackedITS();
+  int getNumEvents(void) const { return mNumEvents; }
+};
+
+
+///@brief Writes events to a packed event file. The file is not valid until finish() is called.
+class EventPackedITSWriter {
+  std::ofstream mFile;
+  std::vector<std::uint64_t> mIndex;
+  std::uint64_t mPos;
+  std::string mFilename;
+
+public:
+  EventPackedITSWriter(const std::string& filename);
+  void writeEvent(const EventDigits& event);
+  void finish(void);
+};
+
+
+#endif /* EVENT_PACKED_ITS_H */
@@ -0,0 +1,191 @@
+/**
+ * @file   EventStream.cpp
+ * @author Simon Voigt Nesbo
+ * @date   October 16, 2026
+ * @brief  Writer and reader for pregenerated event streams.
+ */
+
+#include "EventStream.hpp"
+#include <cstring>
+#include <stdexcept>
+
+
+///@brief Create event stream file and write the file header
+///@param[in] filename Path and name of event stream file
+///@param[in] flags EVENT_STREAM_FLAG_xx flags describing the event generator setup
+///@param[in] qed_noise_feed_rate_ns Feed rate for untriggered (QED/noise) events
+///@param[in] config Detector configuration the events are generated for
+///@param[in] num_chips Number of chips the events are generated for
+///@throw runtime_error If the file can not be created, or the detector has too many layers
+EventStreamWriter::EventStreamWriter(const std::string& filename, std::uint32_t flags,
+                                     std::uint64_t qed_noise_feed_rate_ns,
+                                     const Detector::DetectorConfigBase& config,
+                                     std::uint32_t num_chips)
+  : mFile(filename, std::ios::out | std::ios::binary | std::ios::trunc)
+{
+  if(!mFile.is_open())
+    throw std::runtime_error("Error creating event stream file: " + filename);
+
+  if(config.num_layers > EVENT_STREAM_MAX_LAYERS)
+    throw std::runtime_error("Too many detector layers for event stream file: " + filename);
+
+  EventStreamFileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, EVENT_STREAM_MAGIC, sizeof(header.magic));
+  header.version = EVENT_STREAM_VERSION;
+  header.flags = flags;
+  header.qed_noise_feed_rate_ns = qed_noise_feed_rate_ns;
+  header.num_chips = num_chips;
+  header.num_layers = config.num_layers;
+
+  for(unsigned int layer = 0; layer < config.num_layers; layer++)
+    header.layer_num_staves[layer] = config.layer[layer].num_staves;
+
+  mFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+
+///@brief Write an event to the event stream file
+///@param[in] type Triggered or untriggered event
+///@param[in] time_ns Simulation time of event
+///@param[in] t_delta_ns Time till next event of the same type
+///@param[in] event_pixel_hit_count Multiplicity reported by the event generator
+///@param[in] hits Pixel hits in event
+///@param[in] pixels_per_cluster Number of consecutive hits in the hits vector that belong to
+///                              the same cluster. Used to assign cluster ids to the hits.
+void EventStreamWriter::writeEvent(EventStreamType type,
+                                   std::uint64_t time_ns,
+                                   std::uint64_t t_delta_ns,
+                                   std::uint32_t event_pixel_hit_count,
+                                   const std::vector<PixelHitPtr>& hits,
+                                   unsigned int pixels_per_cluster)
+{
+  EventStreamEventHeader event_header;
+  std::memset(&event_header, 0, sizeof(event_header));
+  event_header.time_ns = time_ns;
+  event_header.t_delta_ns = t_delta_ns;
+  event_header.num_hits = hits.size();
+  event_header.event_pixel_hit_count = event_pixel_hit_count;
+  event_header.type = type;
+
+  mFile.write(reinterpret_cast<const char*>(&event_header), sizeof(event_header));
+
+  std::vector<EventStreamHit> stream_hits(hits.size());
+
+  for(unsigned int i = 0; i < hits.size(); i++) {
+    stream_hits[i].chip_id = hits[i]->getChipId();
+    stream_hits[i].col = hits[i]->getCol();
+    stream_hits[i].row = hits[i]->getRow();
+    stream_hits[i].cluster_id = i / pixels_per_cluster;
+  }
+
+  mFile.write(reinterpret_cast<const char*>(stream_hits.data()),
+              stream_hits.size()*sizeof(EventStreamHit));
+}
+
+
+///@brief Open and memory map an event stream file
+///@param[in] filename Path and name of event stream file
+///@throw runtime_error If the file can not be opened or mapped, or if it does
+///                     not have a valid header.
+EventStreamReader::EventStreamReader(const std::string& filename)
+  : mFile(QString::fromStdString(filename))
+{
+  if(!mFile.open(QIODevice::ReadOnly))
+    throw std::runtime_error("Error opening event stream file: " + filename);
+
+  mSize = mFile.size();
+
+  if(mSize < (qint64)sizeof(EventStreamFileHeader))
+    throw std::runtime_error("Event stream file too short: " + filename);
+
+  mData = mFile.map(0, mSize);
+
+  if(mData == nullptr)
+    throw std::runtime_error("Error memory mapping event stream file: " + filename);
+
+  std::memcpy(&mHeader, mData, sizeof(mHeader));
+
+  if(std::memcmp(mHeader.magic, EVENT_STREAM_MAGIC, sizeof(mHeader.magic)) != 0)
+    throw std::runtime_error("Not an event stream file: " + filename);
+
+  if(mHeader.version != EVENT_STREAM_VERSION)
+    throw std::runtime_error("Unsupported event stream file version: " + filename);
+
+  mPos[EVENT_STREAM_TRIGGERED] = sizeof(EventStreamFileHeader);
+  mPos[EVENT_STREAM_UNTRIGGERED] = sizeof(EventStreamFileHeader);
+}
+
+
+///@brief Check that the events in the event stream were generated for the same detector
+///       configuration as the one that is simulated. Otherwise the chip ids of the hits
+///       in the event stream would not match the chips in the simulation.
+///@param[in] config Detector configuration of the simulation
+///@param[in] num_chips Number of chips in the simulation (1 for single chip simulations)
+///@throw runtime_error If the detector configurations differ
+void EventStreamReader::checkDetectorConfig(const Detector::DetectorConfigBase& config,
+                                            std::uint32_t num_chips) const
+{
+  bool config_equal = mHeader.num_chips == num_chips && mHeader.num_layers == config.num_layers;
+
+  for(unsigned int layer = 0; config_equal && layer < config.num_layers; layer++)
+    config_equal = mHeader.layer_num_staves[layer] == config.layer[layer].num_staves;
+
+  if(config_equal)
+    return;
+
+  std::string error_msg = "Event stream file was generated for a different detector configuration. ";
+
+  error_msg += "Event stream: " + std::to_string(mHeader.num_chips) + " chips, staves per layer:";
+  for(unsigned int layer = 0; layer < mHeader.num_layers && layer < EVENT_STREAM_MAX_LAYERS; layer++)
+    error_msg += " " + std::to_string(mHeader.layer_num_staves[layer]);
+
+  error_msg += ". Simulation: " + std::to_string(num_chips) + " chips, staves per layer:";
+  for(unsigned int layer = 0; layer < config.num_layers; layer++)
+    error_msg += " " + std::to_string(config.layer[layer].num_staves);
+
+  throw std::runtime_error(error_msg + ".");
+}
+
+
+EventStreamReader::~EventStreamReader()
+{
+  if(mData != nullptr)
+    mFile.unmap(const_cast<uchar*>(mData));
+}
+
+
+///@brief Get the next event of a given type from the event stream
+///@param[in] type Triggered or untriggered event
+///@param[out] event Header for the event
+///@param[out] hits Pointer to the event.num_hits hits of the event, in the mapped file
+///@return True if an event was found, false if the end of the file was reached
+///@throw runtime_error If the file is truncated
+bool EventStreamReader::getNextEvent(EventStreamType type,
+                                     EventStreamEventHeader& event,
+                                     const EventStreamHit*& hits)
+{
+  qint64& pos = mPos[type];
+
+  // Skip events of the other type
+  while(pos + (qint64)sizeof(EventStreamEventHeader) <= mSize) {
+    // The headers are not necessarily 8-byte aligned in the file, copy it out
+    std::memcpy(&event, mData+pos, sizeof(event));
+
+    qint64 hits_pos = pos + sizeof(EventStreamEventHeader);
+    qint64 next_pos = hits_pos + (qint64)event.num_hits*sizeof(EventStreamHit);
+
+    if(next_pos > mSize)
+      throw std::runtime_error("Truncated event in event stream file");
+
+    pos = next_pos;
+
+    if(event.type == type) {
+      // Hits are 4-byte aligned, since the headers are multiples of 4 bytes long
+      hits = reinterpret_cast<const EventStreamHit*>(mData+hits_pos);
+      return true;
+    }
+  }
+
+  return false;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file   EventStream.hpp
+ * @author Simon Voigt Nesbo
+ * @date   October 16, 2026
+ * @brief  File format, writer and reader for pregenerated event streams.
+ *         An event stream file holds the exact sequence of triggered (physics) and
+ *         untriggered (QED/noise) events from an event generator, so that a simulation
+ *         can be rerun with the same hits without generating them again.
+ *
+ *         The file header records the detector configuration the events were
+ *         generated for, and the events can only be replayed with the same configuration.
+ *
+ *         File layout (native byte order, ie. little endian on x86):
+ *           EventStreamFileHeader
+ *           For each event, in the order they were generated:
+ *             EventStreamEventHeader
+ *             EventStreamHit x num_hits
+ */
+
+///@addtogroup event_generation
+///@{
+#ifndef EVENT_STREAM_HPP
+#define EVENT_STREAM_HPP
+
+#include "Alpide/PixelHit.hpp"
+#include "Detector/Common/DetectorConfig.hpp"
+#include <QFile>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static const char EVENT_STREAM_MAGIC[8] = {'A','L','P','E','V','S','T','R'};
+static const std::uint32_t EVENT_STREAM_VERSION = 2;
+
+/// Maximum number of detector layers that can be stored in EventStreamFileHeader
+static const unsigned int EVENT_STREAM_MAX_LAYERS = 8;
+
+/// Flags in EventStreamFileHeader
+static const std::uint32_t EVENT_STREAM_FLAG_QED_NOISE         = 0x1;
+static const std::uint32_t EVENT_STREAM_FLAG_RANDOM_HITS       = 0x2;
+static const std::uint32_t EVENT_STREAM_FLAG_SINGLE_CHIP       = 0x4;
+
+enum EventStreamType : std::uint8_t {
+  EVENT_STREAM_TRIGGERED = 0,
+  EVENT_STREAM_UNTRIGGERED = 1
+};
+
+struct EventStreamFileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t flags;
+
+  /// Feed rate for untriggered (QED/noise) events, 0 if not used
+  std::uint64_t qed_noise_feed_rate_ns;
+
+  /// Number of chips the events were generated for (1 for single chip simulations)
+  std::uint32_t num_chips;
+
+  /// Number of staves in each layer the events were generated for (unused layers are 0)
+  std::uint32_t num_layers;
+  std::uint32_t layer_num_staves[EVENT_STREAM_MAX_LAYERS];
+};
+
+struct EventStreamEventHeader {
+  /// Simulation time when the event occured
+  std::uint64_t time_ns;
+
+  /// Time till next event of the same type
+  std::uint64_t t_delta_ns;
+
+  std::uint32_t num_hits;
+
+  /// Multiplicity reported by the event generator for this event
+  std::uint32_t event_pixel_hit_count;
+
+  std::uint8_t type;
+  std::uint8_t reserved[7];
+};
+
+struct EventStreamHit {
+  std::uint32_t chip_id;
+  std::uint16_t col;
+  std::uint16_t row;
+
+  /// Hits from the same particle hit (cluster) in an event share the same cluster id
+  std::uint32_t cluster_id;
+};
+
+static_assert(sizeof(EventStreamFileHeader) == 64, "Unexpected EventStreamFileHeader size");
+static_assert(sizeof(EventStreamEventHeader) == 32, "Unexpected EventStreamEventHeader size");
+static_assert(sizeof(EventStreamHit) == 12, "Unexpected EventStreamHit size");
+
+
+///@brief Writes events to an event stream file
+class EventStreamWriter {
+  std::ofstream mFile;
+
+public:
+  EventStreamWriter(const std::string& filename, std::uint32_t flags,
+                    std::uint64_t qed_noise_feed_rate_ns,
+                    const Detector::DetectorConfigBase& config,
+                    std::uint32_t num_chips);
+  void writeEvent(EventStreamType type,
+                  std::uint64_t time_ns,
+                  std::uint64_t t_delta_ns,
+                  std::uint32_t event_pixel_hit_count,
+                  const std::vector<PixelHitPtr>& hits,
+                  unsigned int pixels_per_cluster);
+};
+
+
+///@brief Memory maps an event stream file, and gives access to the triggered and
+///       untriggered events in it, in the order they were written.
+class EventStreamReader {
+  QFile mFile;
+  const uchar* mData = nullptr;
+  qint64 mSize = 0;
+  EventStreamFileHeader mHeader;
+
+  /// Position of next event for each event type
+  qint64 mPos[2];
+
+public:
+  EventStreamReader(const std::string& filename);
+  ~EventStreamReader();
+  const EventStreamFileHeader& getHeader(void) const { return mHeader; }
+  void checkDetectorConfig(const Detector::DetectorConfigBase& config,
+                           std::uint32_t num_chips) const;
+  bool getNextEvent(EventStreamType type,
+                    EventStreamEventHeader& event,
+                    const EventStreamHit*& hits);
+};
+
+
+#endif
+///@}
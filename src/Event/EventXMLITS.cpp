@@ -131,6 +131,12 @@ EventXMLITS::EventXMLITS(Detector::DetectorConfigBase config,
 }
 
 
+EventXMLITS::~EventXMLITS()
+{
+  stopPrefetch();
+}
+
+
 ///@brief Find an XML DOM node element in a list of elements, with the requested ID.
 ///       This assumes that all the elements have an id attribute.
 ///@param[in] list XML DOM node element list
@@ -164,6 +170,15 @@ void EventXMLITS::readEventFiles()
 }
 
 
+///@brief Read a monte carlo event from the list of event files
+///@param event_index Index of event file in list of event files
+///@return Pointer to EventDigits object with the event that was read from file
+EventDigits* EventXMLITS::readEvent(int event_index)
+{
+  return readEventFile(mEventPath + QString("/") + mEventFileNames.at(event_index));
+}
+
+
 ///@brief Read a monte carlo event from an XML file
 ///@param event_filename File name and path of .xml file
 ///@return Pointer to EventDigits object with the event that was read from file
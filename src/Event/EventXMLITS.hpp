@@ -21,6 +21,7 @@ class EventXMLITS : public EventBaseDiscrete {
                             QDomElement& chip_element_out);
   void readEventFiles();
   EventDigits* readEventFile(const QString& event_filename);
+  EventDigits* readEvent(int event_index);
 
 public:
   EventXMLITS(Detector::DetectorConfigBase config,
@@ -31,6 +32,7 @@ public:
               bool random_event_order = true,
               int random_seed = 0,
               bool load_all = false);
+  ~EventXMLITS();
 };
 
 
@@ -0,0 +1,339 @@
+/**
+ * @file   Log.cpp
+ * @author Simon Voigt Nesbo
+ * @date   October 16, 2026
+ * @brief  Asynchronous leveled logging. See Log.hpp for details.
+ */
+
+#include "Log.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+
+LogLevel Log::sModuleLevels[LOG_NUM_MODULES] = {LOG_INFO, LOG_INFO, LOG_INFO, LOG_INFO};
+unsigned int LogProgress::sIntervalMs = 1000;
+
+static const char* const LOG_LEVEL_NAMES[] = {"error", "warning", "info", "debug", "trace"};
+static const char* const LOG_MODULE_NAMES[] = {"sim", "event", "ru", "alpide"};
+
+
+namespace {
+
+/// Number of records in the ring buffer, must be a power of two
+const std::uint64_t LOG_RING_BUFFER_SIZE = 4096;
+
+/// Max length of a message, longer messages are truncated
+const std::size_t LOG_RECORD_TEXT_SIZE = 500;
+
+/// Time the writer thread sleeps when the ring buffer is empty
+const std::chrono::milliseconds LOG_WRITER_IDLE_SLEEP(1);
+
+struct LogRecord {
+  ///@brief Sequence number, used to hand the record over between the producers and the
+  ///       writer thread. The record at position pos is free for a producer when
+  ///       seq == pos, and ready for the writer when seq == pos+1.
+  std::atomic<std::uint64_t> seq;
+  std::uint8_t level;
+  std::uint16_t length;
+  char text[LOG_RECORD_TEXT_SIZE];
+};
+
+
+///@brief Bounded multi producer, single consumer ring buffer with a writer thread.
+///       Producers wait (yield) if the buffer is full, messages are never dropped.
+class LogWriter
+{
+  std::unique_ptr<LogRecord[]> mRecords;
+  std::atomic<std::uint64_t> mEnqueuePos;
+  std::uint64_t mDequeuePos = 0;
+
+  ///@brief Position up to which all messages have been written and flushed
+  std::atomic<std::uint64_t> mWrittenPos;
+
+  std::atomic<bool> mStop;
+  std::thread mThread;
+
+  bool pop(LogRecord& record_out);
+  void writerThread(void);
+
+public:
+  LogWriter();
+  ~LogWriter();
+  void push(LogLevel level, const std::string& text);
+  void flush(void);
+};
+
+
+LogWriter::LogWriter()
+  : mRecords(new LogRecord[LOG_RING_BUFFER_SIZE])
+  , mEnqueuePos(0)
+  , mWrittenPos(0)
+  , mStop(false)
+{
+  for(std::uint64_t i = 0; i < LOG_RING_BUFFER_SIZE; i++)
+    mRecords[i].seq.store(i, std::memory_order_relaxed);
+
+  mThread = std::thread(&LogWriter::writerThread, this);
+}
+
+
+///@brief Stop the writer thread after it has written all messages
+LogWriter::~LogWriter()
+{
+  mStop = true;
+  mThread.join();
+}
+
+
+void LogWriter::push(LogLevel level, const std::string& text)
+{
+  std::uint64_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+  LogRecord* record;
+
+  while(true) {
+    record = &mRecords[pos & (LOG_RING_BUFFER_SIZE-1)];
+    std::uint64_t seq = record->seq.load(std::memory_order_acquire);
+    std::int64_t diff = (std::int64_t)seq - (std::int64_t)pos;
+
+    if(diff == 0) {
+      if(mEnqueuePos.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed))
+        break;
+    } else {
+      // Buffer is full (diff < 0), wait for the writer thread.
+      // Or another producer took this position (diff > 0), try the next one.
+      if(diff < 0)
+        std::this_thread::yield();
+      pos = mEnqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+
+  record->level = level;
+  record->length = std::min(text.size(), LOG_RECORD_TEXT_SIZE);
+  std::memcpy(record->text, text.data(), record->length);
+  record->seq.store(pos+1, std::memory_order_release);
+}
+
+
+bool LogWriter::pop(LogRecord& record_out)
+{
+  LogRecord& record = mRecords[mDequeuePos & (LOG_RING_BUFFER_SIZE-1)];
+
+  if(record.seq.load(std::memory_order_acquire) != mDequeuePos+1)
+    return false;
+
+  record_out.level = record.level;
+  record_out.length = record.length;
+  std::memcpy(record_out.text, record.text, record.length);
+
+  record.seq.store(mDequeuePos+LOG_RING_BUFFER_SIZE, std::memory_order_release);
+  mDequeuePos++;
+
+  return true;
+}
+
+
+void LogWriter::writerThread(void)
+{
+  LogRecord record;
+  bool written = false;
+
+  while(true) {
+    // Read the stop flag before emptying the buffer, messages pushed before stop was
+    // set are then always written
+    bool stop = mStop;
+
+    if(pop(record)) {
+      FILE* stream = record.level <= LOG_WARNING ? stderr : stdout;
+      std::fwrite(record.text, 1, record.length, stream);
+      std::fputc('\n', stream);
+      written = true;
+      continue;
+    }
+
+    if(written) {
+      std::fflush(stdout);
+      std::fflush(stderr);
+      written = false;
+    }
+    mWrittenPos = mDequeuePos;
+
+    if(stop)
+      return;
+
+    std::this_thread::sleep_for(LOG_WRITER_IDLE_SLEEP);
+  }
+}
+
+
+///@brief Wait until all messages pushed before this call have been written and flushed
+void LogWriter::flush(void)
+{
+  std::uint64_t pos = mEnqueuePos.load();
+
+  while(mWrittenPos.load() < pos)
+    std::this_thread::yield();
+}
+
+
+std::unique_ptr<LogWriter> sLogWriter;
+
+}
+
+
+const char* Log::getLevelName(LogLevel level)
+{
+  return LOG_LEVEL_NAMES[level];
+}
+
+
+const char* Log::getModuleName(LogModule module)
+{
+  return LOG_MODULE_NAMES[module];
+}
+
+
+///@brief Set the runtime log level for all modules
+void Log::setLevel(LogLevel level)
+{
+  for(unsigned int i = 0; i < LOG_NUM_MODULES; i++)
+    sModuleLevels[i] = level;
+}
+
+
+void Log::setModuleLevel(LogModule module, LogLevel level)
+{
+  sModuleLevels[module] = level;
+}
+
+
+///@brief Parse a log level name
+///@throw runtime_error If the level name is unknown
+static LogLevel parseLogLevel(const std::string& level_str)
+{
+  for(unsigned int i = 0; i <= LOG_TRACE; i++) {
+    if(level_str == LOG_LEVEL_NAMES[i])
+      return LogLevel(i);
+  }
+
+  throw std::runtime_error("Unknown log level: " + level_str);
+}
+
+
+///@brief Set the runtime log levels
+///@param[in] level Level for all modules, eg. "info"
+///@param[in] module_levels Semicolon delimited list of levels for individual modules,
+///                         eg. "ru=debug;event=warning". Can be empty.
+///@throw runtime_error If a level or module name is unknown
+void Log::configure(const std::string& level, const std::string& module_levels)
+{
+  setLevel(parseLogLevel(level));
+
+  std::string levels_str = module_levels;
+
+  while(levels_str.length() > 0) {
+    std::string::size_type delim_pos = levels_str.find(";");
+    std::string module_level_str = levels_str.substr(0, delim_pos);
+    std::string::size_type equal_pos = module_level_str.find("=");
+
+    if(equal_pos == std::string::npos)
+      throw std::runtime_error("Invalid module log level: " + module_level_str);
+
+    std::string module_str = module_level_str.substr(0, equal_pos);
+    unsigned int module = 0;
+
+    while(module < LOG_NUM_MODULES && module_str != LOG_MODULE_NAMES[module])
+      module++;
+
+    if(module == LOG_NUM_MODULES)
+      throw std::runtime_error("Unknown log module: " + module_str);
+
+    setModuleLevel(LogModule(module), parseLogLevel(module_level_str.substr(equal_pos+1)));
+
+    if(delim_pos == std::string::npos)
+      levels_str.erase(0);
+    else
+      levels_str.erase(0, delim_pos+1);
+  }
+}
+
+
+///@brief Start the writer thread. Messages are written asynchronously from now on.
+void Log::start(void)
+{
+  if(!sLogWriter)
+    sLogWriter = std::unique_ptr<LogWriter>(new LogWriter());
+}
+
+
+///@brief Wait until all messages logged so far have been written
+void Log::flush(void)
+{
+  if(sLogWriter)
+    sLogWriter->flush();
+}
+
+
+///@brief Write the remaining messages and stop the writer thread
+void Log::stop(void)
+{
+  sLogWriter.reset();
+}
+
+
+void Log::write(LogLevel level, LogModule module, const std::string& text)
+{
+  (void)module;
+
+  if(sLogWriter) {
+    sLogWriter->push(level, text);
+  } else {
+    FILE* stream = level <= LOG_WARNING ? stderr : stdout;
+    std::fwrite(text.data(), 1, text.size(), stream);
+    std::fputc('\n', stream);
+  }
+}
+
+
+///@brief Constructor for LogProgress
+///@param[in] module Module to log progress messages for
+///@param[in] name Name of the counter in the progress messages, eg. "Physics event number"
+LogProgress::LogProgress(LogModule module, const std::string& name)
+  : mModule(module)
+  , mName(name)
+{
+}
+
+
+///@brief Update the progress counter, and log a progress message if the progress interval
+///       has passed since the last message (or on the first update)
+///@param[in] count Counter value
+///@param[in] time_ns Simulation time
+///@param[in] force Log the message regardless of when the last message was logged
+void LogProgress::update(std::uint64_t count, std::uint64_t time_ns, bool force)
+{
+  if(!Log::enabled(LOG_INFO, mModule))
+    return;
+
+  std::chrono::steady_clock::time_point time_now = std::chrono::steady_clock::now();
+  std::chrono::milliseconds elapsed =
+    std::chrono::duration_cast<std::chrono::milliseconds>(time_now - mLastReportTime);
+
+  if(!force && !mFirstUpdate && elapsed < std::chrono::milliseconds(sIntervalMs))
+    return;
+
+  LogLine line(LOG_INFO, mModule);
+
+  line << "@ " << time_ns << " ns: \t" << mName << " " << count;
+
+  if(!mFirstUpdate && elapsed.count() > 0)
+    line << " (" << (count - mLastReportCount) * 1000.0 / elapsed.count() << " per second)";
+
+  mLastReportTime = time_now;
+  mLastReportCount = count;
+  mFirstUpdate = false;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file   Log.hpp
+ * @author Simon Voigt Nesbo
+ * @date   October 16, 2026
+ * @brief  Asynchronous leveled logging, for messages printed from the SystemC methods
+ *         while the simulation runs.
+ *
+ *         Messages are formatted by the calling thread and put in a lock-free ring buffer,
+ *         which a background writer thread drains to stdout (stderr for warnings and
+ *         errors). The SystemC methods then do not wait for terminal or file I/O, and the
+ *         output is not flushed for every line.
+ *
+ *         Usage:
+ *           LOG(LOG_DEBUG, LOG_MODULE_RU) << "@" << time_now << ": RU " << mId << " triggered.";
+ *
+ *         The stream arguments are only evaluated when the message is enabled. Messages with
+ *         a level above LOG_COMPILE_LEVEL are removed at compile time. At runtime, each
+ *         module has its own level (see Log::configure()). Newlines are added by the logger.
+ *
+ *         Messages are written directly (synchronously) before Log::start() and after
+ *         Log::stop(). While the writer thread runs, call Log::flush() before printing
+ *         directly to std::cout, so that the output stays in order.
+ */
+
+
+///@defgroup logging Logging
+///@{
+#ifndef LOG_HPP
+#define LOG_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+enum LogLevel {
+  LOG_ERROR = 0,
+  LOG_WARNING = 1,
+  LOG_INFO = 2,
+  LOG_DEBUG = 3,
+  LOG_TRACE = 4
+};
+
+enum LogModule {
+  LOG_MODULE_SIM = 0,    ///< Simulation control and stimuli
+  LOG_MODULE_EVENT = 1,  ///< Event generators
+  LOG_MODULE_RU = 2,     ///< Readout units
+  LOG_MODULE_ALPIDE = 3, ///< Alpide chips
+  LOG_NUM_MODULES = 4
+};
+
+/// Messages with a level above this are compiled out. Set with the LOG_COMPILE_LEVEL
+/// CMake variable.
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_DEBUG
+#endif
+
+
+class Log
+{
+  static LogLevel sModuleLevels[LOG_NUM_MODULES];
+
+public:
+  static const char* getLevelName(LogLevel level);
+  static const char* getModuleName(LogModule module);
+
+  ///@brief Check if messages with a level are enabled for a module at runtime
+  static inline bool enabled(LogLevel level, LogModule module) {
+    return level <= sModuleLevels[module];
+  }
+
+  static void setLevel(LogLevel level);
+  static void setModuleLevel(LogModule module, LogLevel level);
+  static void configure(const std::string& level, const std::string& module_levels);
+  static void start(void);
+  static void flush(void);
+  static void stop(void);
+  static void write(LogLevel level, LogModule module, const std::string& text);
+};
+
+
+///@brief One log message. The message is formatted with the << operator, and passed to the
+///       logger when the LogLine object is destroyed at the end of the LOG() statement.
+class LogLine
+{
+  LogLevel mLevel;
+  LogModule mModule;
+  std::ostringstream mStream;
+
+public:
+  LogLine(LogLevel level, LogModule module)
+    : mLevel(level)
+    , mModule(module)
+  {
+  }
+
+  ~LogLine() {
+    Log::write(mLevel, mModule, mStream.str());
+  }
+
+  template<class T>
+  LogLine& operator<<(const T& value) {
+    mStream << value;
+    return *this;
+  }
+};
+
+
+#define LOG(level, module)                                               \
+  if((level) > LOG_COMPILE_LEVEL || !Log::enabled((level), (module))) {} \
+  else LogLine((level), (module))
+
+
+///@brief Rate limited progress messages, for counters that are updated for every event.
+///       A message is logged at LOG_INFO level at most once per progress interval
+///       (wall clock time), with the rate the counter increased since the last message.
+class LogProgress
+{
+  static unsigned int sIntervalMs;
+
+  LogModule mModule;
+  std::string mName;
+  std::chrono::steady_clock::time_point mLastReportTime;
+  std::uint64_t mLastReportCount = 0;
+  bool mFirstUpdate = true;
+
+public:
+  LogProgress(LogModule module, const std::string& name);
+  void update(std::uint64_t count, std::uint64_t time_ns, bool force = false);
+
+  ///@brief Set the minimum time between progress messages. 0 logs every update.
+  static void setInterval(unsigned int interval_ms) {sIntervalMs = interval_ms;}
+};
+
+
+#endif
+///@}
@@ -0,0 +1,223 @@
+/**
+ * @file   ProcessProfiler.cpp
+ * @author Simon Voigt Nesbo
+ * @date   October 16, 2026
+ * @brief  Optional profiling of the SystemC methods. See ProcessProfiler.hpp for details.
+ */
+
+#include "ProcessProfiler.hpp"
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <vector>
+
+
+uint64_t ProcessProfiler::sStartCycles = 0;
+uint64_t ProcessProfiler::sStopCycles = 0;
+std::chrono::steady_clock::time_point ProcessProfiler::sStartTime;
+std::chrono::steady_clock::time_point ProcessProfiler::sStopTime;
+
+
+namespace {
+
+/// Max number of modules listed per hierarchy level in the report
+const unsigned int PROFILE_REPORT_MAX_MODULES = 10;
+
+/// Profile entries for all processes. A deque is used so that the pointers to the
+/// entries stay valid when new entries are added.
+std::deque<ProcessProfileEntry> sEntries;
+
+struct ProfileSum {
+  std::string name;
+  unsigned int processes = 0;
+  uint64_t calls = 0;
+  uint64_t cycles = 0;
+
+  void add(const ProcessProfileEntry& entry) {
+    processes++;
+    calls += entry.calls;
+    cycles += entry.cycles;
+  }
+};
+
+
+///@brief Sort profile sums by time, highest first
+std::vector<ProfileSum> sortByTime(const std::map<std::string, ProfileSum>& sums)
+{
+  std::vector<ProfileSum> sorted;
+
+  for(auto it = sums.begin(); it != sums.end(); it++)
+    sorted.push_back(it->second);
+
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const ProfileSum& a, const ProfileSum& b) {return a.cycles > b.cycles;});
+
+  return sorted;
+}
+
+
+void writeProfileSums(std::ostream& out, const std::vector<ProfileSum>& sums,
+                      unsigned int max_rows, double ns_per_cycle, double total_ns)
+{
+  out << std::left << std::setw(60) << "Name";
+  out << std::right << std::setw(10) << "Processes";
+  out << std::setw(16) << "Calls";
+  out << std::setw(14) << "Time (s)";
+  out << std::setw(10) << "% total";
+  out << std::setw(12) << "ns/call" << std::endl;
+
+  for(unsigned int i = 0; i < sums.size() && i < max_rows; i++) {
+    double time_ns = sums[i].cycles * ns_per_cycle;
+
+    out << std::left << std::setw(60) << sums[i].name;
+    out << std::right << std::setw(10) << sums[i].processes;
+    out << std::setw(16) << sums[i].calls;
+    out << std::setw(14) << std::fixed << std::setprecision(3) << time_ns / 1.0E9;
+    out << std::setw(10) << std::setprecision(2) << 100.0 * time_ns / total_ns;
+    out << std::setw(12) << std::setprecision(1);
+    out << (sums[i].calls > 0 ? time_ns / sums[i].calls : 0.0) << std::endl;
+  }
+
+  if(sums.size() > max_rows)
+    out << "(" << sums.size() - max_rows << " more)" << std::endl;
+}
+
+}
+
+
+///@brief Create a profile entry for a new instance of a process type
+ProcessProfileEntry* ProcessProfileType::newEntry(const sc_core::sc_process_b* process)
+{
+  std::string process_name = process != nullptr ? process->name() : "";
+  ProcessProfileEntry* entry = ProcessProfiler::addEntry(mName, process_name);
+
+  mEntries[process] = entry;
+
+  return entry;
+}
+
+
+ProcessProfileEntry* ProcessProfiler::addEntry(const std::string& type_name,
+                                               const std::string& process_name)
+{
+  sEntries.emplace_back();
+  sEntries.back().type_name = type_name;
+  sEntries.back().process_name = process_name;
+
+  return &sEntries.back();
+}
+
+
+///@brief Start measuring the total time. Call right before sc_start().
+void ProcessProfiler::start(void)
+{
+  sStartTime = std::chrono::steady_clock::now();
+  sStartCycles = readCycleCounter();
+}
+
+
+///@brief Stop measuring the total time. Call right after sc_start() returns.
+void ProcessProfiler::stop(void)
+{
+  sStopTime = std::chrono::steady_clock::now();
+  sStopCycles = readCycleCounter();
+}
+
+
+///@brief Write the profile report, process_profile.txt, with the time per process type and
+///       per hierarchy level, and the raw profile data for each process to
+///       process_profile.csv.
+///@param[in] output_path Path to simulation output directory
+void ProcessProfiler::writeReport(const std::string& output_path)
+{
+  double total_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(sStopTime -
+                                                                         sStartTime).count();
+
+  // The cycle counter is calibrated against steady_clock over the whole simulation
+  double ns_per_cycle = sStopCycles > sStartCycles ? total_ns / (sStopCycles - sStartCycles) : 0;
+
+  std::map<std::string, ProfileSum> type_sums;
+  std::vector<std::map<std::string, ProfileSum>> level_sums;
+  uint64_t profiled_cycles = 0;
+
+  for(auto it = sEntries.begin(); it != sEntries.end(); it++) {
+    type_sums[it->type_name].name = it->type_name;
+    type_sums[it->type_name].add(*it);
+    profiled_cycles += it->cycles;
+
+    // Sum up for each level in the module hierarchy of the process,
+    // ie. "stimuli", "stimuli.ITS", "stimuli.ITS.Stave_0", and so on
+    std::string::size_type pos = 0;
+    unsigned int level = 0;
+
+    while((pos = it->process_name.find('.', pos)) != std::string::npos) {
+      std::string module_name = it->process_name.substr(0, pos);
+
+      if(level_sums.size() <= level)
+        level_sums.resize(level+1);
+
+      level_sums[level][module_name].name = module_name;
+      level_sums[level][module_name].add(*it);
+
+      level++;
+      pos++;
+    }
+  }
+
+  double profiled_ns = profiled_cycles * ns_per_cycle;
+
+  std::string report_filename = output_path + std::string("/process_profile.txt");
+  std::ofstream report_file(report_filename);
+
+  if(!report_file.is_open()) {
+    std::cerr << "Error opening process profile file: " << report_filename << std::endl;
+    return;
+  }
+
+  std::cout << "Writing process profile to file." << std::endl;
+
+  report_file << std::fixed << std::setprecision(3);
+  report_file << "Time in sc_start():                " << total_ns / 1.0E9 << " s" << std::endl;
+  report_file << "Time in profiled processes:        " << profiled_ns / 1.0E9 << " s";
+  report_file << " (" << std::setprecision(2) << 100.0 * profiled_ns / total_ns << " %)";
+  report_file << std::endl;
+  report_file << "Time in SystemC kernel and other:  " << std::setprecision(3);
+  report_file << (total_ns - profiled_ns) / 1.0E9 << " s";
+  report_file << " (" << std::setprecision(2) << 100.0 * (total_ns-profiled_ns) / total_ns;
+  report_file << " %)" << std::endl;
+  report_file << "Cycle counter:                     " << std::setprecision(4);
+  report_file << ns_per_cycle << " ns per cycle" << std::endl;
+
+  report_file << std::endl << "Per process type:" << std::endl;
+  writeProfileSums(report_file, sortByTime(type_sums), type_sums.size(),
+                   ns_per_cycle, total_ns);
+
+  for(unsigned int level = 0; level < level_sums.size(); level++) {
+    report_file << std::endl << "Per module, hierarchy level " << level;
+    report_file << " (" << level_sums[level].size() << " modules):" << std::endl;
+    writeProfileSums(report_file, sortByTime(level_sums[level]), PROFILE_REPORT_MAX_MODULES,
+                     ns_per_cycle, total_ns);
+  }
+
+
+  std::string csv_filename = output_path + std::string("/process_profile.csv");
+  std::ofstream csv_file(csv_filename);
+
+  if(!csv_file.is_open()) {
+    std::cerr << "Error opening process profile CSV file: " << csv_filename << std::endl;
+    return;
+  }
+
+  csv_file << "Process type; Process name; Calls; Cycles; Time (ns)" << std::endl;
+
+  for(auto it = sEntries.begin(); it != sEntries.end(); it++) {
+    csv_file << it->type_name << ";";
+    csv_file << it->process_name << ";";
+    csv_file << it->calls << ";";
+    csv_file << it->cycles << ";";
+    csv_file << (uint64_t)(it->cycles * ns_per_cycle) << std::endl;
+  }
+}
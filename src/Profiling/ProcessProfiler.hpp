@@ -0,0 +1,146 @@
+/**
+ * @file   ProcessProfiler.hpp
+ * @author Simon Voigt Nesbo
+ * @date   October 16, 2026
+ * @brief  Optional profiling of the SystemC methods. Counts the invocations and the time
+ *         spent in each SystemC method process, using the CPU's time stamp counter.
+ *
+ *         The profiling is compiled in with the PROCESS_PROFILING CMake option. Without it,
+ *         the PROFILE_PROCESS() macro expands to nothing and there is no overhead.
+ *
+ *         Usage, as the first statement in a method registered with SC_METHOD:
+ *           PROFILE_PROCESS("Alpide::triggerMethod");
+ *
+ *         The string is the process type, which groups all the instances of the method.
+ *         Each instance is identified by the SystemC process that is running when the
+ *         method is called, and the module hierarchy in the process name is used to sum up
+ *         the time per hierarchy level (eg. layer, stave and chip for ITS).
+ *
+ *         The time in the SystemC kernel (scheduling, signal updates, uninstrumented
+ *         processes) is the time spent in sc_start() minus the time in the profiled
+ *         methods. The profiling is only done in the SystemC thread, and is not thread safe.
+ */
+
+
+///@defgroup profiling Profiling
+///@{
+#ifndef PROCESS_PROFILER_HPP
+#define PROCESS_PROFILER_HPP
+
+// Ignore warnings about use of auto_ptr and unused parameters in SystemC library
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#include <systemc.h>
+#pragma GCC diagnostic pop
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+///@brief Invocation count and time for one instance of a profiled process
+struct ProcessProfileEntry {
+  std::string type_name;
+  std::string process_name;
+  uint64_t calls = 0;
+  uint64_t cycles = 0;
+};
+
+
+///@brief A profiled process type, ie. a method of a module class. Keeps track of the
+///       profile entries for the instances (processes) of the method.
+class ProcessProfileType
+{
+  std::string mName;
+  std::unordered_map<const sc_core::sc_process_b*, ProcessProfileEntry*> mEntries;
+
+  ProcessProfileEntry* newEntry(const sc_core::sc_process_b* process);
+
+public:
+  ProcessProfileType(const char* name) : mName(name) {}
+
+  ///@brief Get the profile entry for the currently running process
+  inline ProcessProfileEntry* getEntry(void) {
+    const sc_core::sc_process_b* process = sc_core::sc_get_current_process_b();
+    auto it = mEntries.find(process);
+
+    if(it != mEntries.end())
+      return it->second;
+    else
+      return newEntry(process);
+  }
+};
+
+
+class ProcessProfiler
+{
+  static uint64_t sStartCycles;
+  static uint64_t sStopCycles;
+  static std::chrono::steady_clock::time_point sStartTime;
+  static std::chrono::steady_clock::time_point sStopTime;
+
+public:
+  ///@brief Read the cycle counter. Uses the time stamp counter on x86, which is counting
+  ///       at a constant rate on all recent CPUs, and steady_clock on other architectures.
+  static inline uint64_t readCycleCounter(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+  }
+
+  ///@brief True if the profiling is compiled in
+  static constexpr bool isEnabled(void) {
+#ifdef PROCESS_PROFILING
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  static ProcessProfileEntry* addEntry(const std::string& type_name,
+                                       const std::string& process_name);
+  static void start(void);
+  static void stop(void);
+  static void writeReport(const std::string& output_path);
+};
+
+
+///@brief Adds the time from construction to destruction to a profile entry
+class ProcessProfileScope
+{
+  ProcessProfileEntry* mEntry;
+  uint64_t mStartCycles;
+
+public:
+  ProcessProfileScope(ProcessProfileType& type)
+    : mEntry(type.getEntry())
+    , mStartCycles(ProcessProfiler::readCycleCounter())
+  {
+  }
+
+  ~ProcessProfileScope() {
+    mEntry->cycles += ProcessProfiler::readCycleCounter() - mStartCycles;
+    mEntry->calls++;
+  }
+};
+
+
+#ifdef PROCESS_PROFILING
+#define PROFILE_PROCESS(type_name)                               \
+  static ProcessProfileType process_profile_type_(type_name);    \
+  ProcessProfileScope process_profile_scope_(process_profile_type_)
+#else
+#define PROFILE_PROCESS(type_name)
+#endif
+
+
+#endif
+///@}
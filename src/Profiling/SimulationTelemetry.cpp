@@ -0,0 +1,128 @@
+/**
+ * @file   SimulationTelemetry.cpp
+ * @author Simon Voigt Nesbo
+ * @date   October 16, 2026
+ * @brief  Periodic sampling of the simulation throughput and memory use.
+ *         See SimulationTelemetry.hpp for details.
+ */
+
+#include "SimulationTelemetry.hpp"
+#include "ProcessProfiler.hpp"
+#include "Alpide/Alpide.hpp"
+#include "Alpide/PixelHit.hpp"
+#include <stdexcept>
+#include <unistd.h>
+
+
+SC_HAS_PROCESS(SimulationTelemetry);
+///@brief Constructor for SimulationTelemetry. Creates telemetry.csv in the output directory.
+///@param[in] name SystemC module name
+///@param[in] output_path Path to simulation output directory
+///@param[in] interval_ns Simulated time between samples
+///@param[in] chips Chips to sum up the MEB occupancy for
+///@param[in] event_count_func Function that returns the number of events simulated so far
+///@throw runtime_error If interval_ns is zero, or the file can not be created
+SimulationTelemetry::SimulationTelemetry(sc_core::sc_module_name name,
+                                         const std::string& output_path,
+                                         uint64_t interval_ns,
+                                         const std::vector<std::shared_ptr<Alpide>>& chips,
+                                         std::function<uint64_t(void)> event_count_func)
+  : sc_core::sc_module(name)
+  , mIntervalNs(interval_ns)
+  , mChips(chips)
+  , mEventCountFunc(event_count_func)
+{
+  if(mIntervalNs == 0)
+    throw std::runtime_error("Telemetry interval can not be zero.");
+
+  std::string filename = output_path + std::string("/telemetry.csv");
+  mFile.open(filename);
+
+  if(!mFile.is_open())
+    throw std::runtime_error("Error creating telemetry file: " + filename);
+
+  mFile << "Time (ns); Wall time (s); RSS (kB); PixelHits in use; MEBs in use; ";
+  mFile << "Pixel hits in MEBs; Events; Events per second; Simulated ns per second";
+  mFile << std::endl;
+
+  // Not using dont_initialize(), the first sample is taken at time zero
+  SC_METHOD(sampleMethod);
+}
+
+
+void SimulationTelemetry::sampleMethod(void)
+{
+  PROFILE_PROCESS("SimulationTelemetry::sampleMethod");
+
+  writeSample();
+
+  next_trigger(mIntervalNs, SC_NS);
+}
+
+
+///@brief Write a sample with the current state of the simulation to the telemetry file.
+///       Called periodically by sampleMethod(), and by the stimuli class at the end of
+///       the simulation. The first sample sets the start of the wall time.
+void SimulationTelemetry::writeSample(void)
+{
+  uint64_t time_now = sc_time_stamp().value();
+  std::chrono::steady_clock::time_point wall_time_now = std::chrono::steady_clock::now();
+
+  if(mFirstSample) {
+    mStartTime = wall_time_now;
+    mLastSampleTime = wall_time_now;
+    mFirstSample = false;
+  } else if(time_now == mLastSampleTimeNs) {
+    // Already sampled at this time
+    return;
+  }
+
+  uint64_t mebs_in_use = 0;
+  uint64_t meb_pixel_hits = 0;
+
+  for(auto it = mChips.begin(); it != mChips.end(); it++) {
+    mebs_in_use += (*it)->getNumEvents();
+    meb_pixel_hits += (*it)->getHitTotalAllEvents();
+  }
+
+  uint64_t event_count = mEventCountFunc();
+
+  double wall_time = std::chrono::duration<double>(wall_time_now - mStartTime).count();
+  double wall_time_diff = std::chrono::duration<double>(wall_time_now - mLastSampleTime).count();
+  double event_rate = 0;
+  double sim_time_rate = 0;
+
+  if(wall_time_diff > 0) {
+    event_rate = (event_count - mLastSampleEventCount) / wall_time_diff;
+    sim_time_rate = (time_now - mLastSampleTimeNs) / wall_time_diff;
+  }
+
+  mFile << time_now << ";";
+  mFile << wall_time << ";";
+  mFile << getResidentMemoryKb() << ";";
+  mFile << PixelHitPool::getInstance().getSlotsInUse() << ";";
+  mFile << mebs_in_use << ";";
+  mFile << meb_pixel_hits << ";";
+  mFile << event_count << ";";
+  mFile << event_rate << ";";
+  mFile << sim_time_rate << std::endl;
+
+  mLastSampleTime = wall_time_now;
+  mLastSampleTimeNs = time_now;
+  mLastSampleEventCount = event_count;
+}
+
+
+///@brief Get the resident memory (RSS) of the simulation process
+///@return RSS in kilobytes, or 0 if it is not available (only supported on Linux)
+uint64_t SimulationTelemetry::getResidentMemoryKb(void)
+{
+  std::ifstream statm_file("/proc/self/statm");
+  uint64_t size_pages = 0;
+  uint64_t resident_pages = 0;
+
+  if(!(statm_file >> size_pages >> resident_pages))
+    return 0;
+
+  return resident_pages * (sysconf(_SC_PAGESIZE) / 1024);
+}
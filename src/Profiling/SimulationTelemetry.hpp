@@ -0,0 +1,74 @@
+/**
+ * @file   SimulationTelemetry.hpp
+ * @author Simon Voigt Nesbo
+ * @date   October 16, 2026
+ * @brief  Periodic sampling of the simulation throughput and memory use, written as a time
+ *         series to telemetry.csv in the simulation output directory.
+ *
+ *         A sample is taken at a fixed interval of simulated time, so that the samples from
+ *         two builds running the same configuration are taken at the same points in the
+ *         simulation, and the wall time between them can be compared directly. Each sample
+ *         has the simulated time, the wall time since the simulation started, the resident
+ *         memory (RSS), the number of PixelHit objects in use, the MEBs in use and pixel hits
+ *         in the MEBs summed over all chips, the event count, and the rates since the
+ *         previous sample. A growing number of PixelHits or MEB hits over a run indicates
+ *         a hit backlog.
+ */
+
+
+///@addtogroup profiling
+///@{
+#ifndef SIMULATION_TELEMETRY_HPP
+#define SIMULATION_TELEMETRY_HPP
+
+// Ignore warnings about use of auto_ptr and unused parameters in SystemC library
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#include <systemc.h>
+#pragma GCC diagnostic pop
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Alpide;
+
+
+class SimulationTelemetry : public sc_core::sc_module
+{
+  uint64_t mIntervalNs;
+
+  std::vector<std::shared_ptr<Alpide>> mChips;
+
+  ///@brief Function that returns the number of events simulated so far
+  std::function<uint64_t(void)> mEventCountFunc;
+
+  std::ofstream mFile;
+
+  std::chrono::steady_clock::time_point mStartTime;
+  std::chrono::steady_clock::time_point mLastSampleTime;
+  uint64_t mLastSampleTimeNs = 0;
+  uint64_t mLastSampleEventCount = 0;
+  bool mFirstSample = true;
+
+  void sampleMethod(void);
+
+public:
+  SimulationTelemetry(sc_core::sc_module_name name,
+                      const std::string& output_path,
+                      uint64_t interval_ns,
+                      const std::vector<std::shared_ptr<Alpide>>& chips,
+                      std::function<uint64_t(void)> event_count_func);
+  void writeSample(void);
+
+  static uint64_t getResidentMemoryKb(void);
+};
+
+
+#endif
+///@}
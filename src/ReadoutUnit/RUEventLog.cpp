@@ -0,0 +1,304 @@
+/**
+ * @file   RUEventLog.cpp
+ * @author Simon Voigt Nesbo
+ * @date   October 16, 2026
+ * @brief  Writer and reader for the event logs of the readout unit.
+ */
+
+#include "RUEventLog.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+
+///@brief Create event log file and write the file header
+///@param[in] filename Path and name of event log file
+///@param[in] log_type Type of log
+///@param[in] num_links Number of links in log. For the trigger actions log this is the number
+///                     of control links, otherwise it is the number of data links.
+///@param[in] record_size Size of each record in bytes
+///@param[in] chunk_records Max number of records buffered per link before a chunk is written
+///@throw runtime_error If the file can not be created
+RUEventLogWriter::RUEventLogWriter(const std::string& filename,
+                                   RUEventLogType log_type,
+                                   std::uint32_t num_links,
+                                   std::uint32_t record_size,
+                                   std::uint32_t chunk_records)
+  : mFile(filename, std::ios::out | std::ios::binary | std::ios::trunc)
+  , mFilename(filename)
+  , mRecordSize(record_size)
+  , mChunkRecords(chunk_records)
+  , mPerLink(ruEventLogPerLink(log_type))
+{
+  if(!mFile.is_open())
+    throw std::runtime_error("Error creating event log file: " + filename);
+
+  mBuffers.resize(mPerLink ? num_links : 1);
+
+  for(auto it = mBuffers.begin(); it != mBuffers.end(); it++)
+    it->reserve(mChunkRecords*mRecordSize);
+
+  RUEventLogFileHeader header;
+  std::memcpy(header.magic, RU_EVENT_LOG_MAGIC, sizeof(header.magic));
+  header.version = RU_EVENT_LOG_VERSION;
+  header.log_type = log_type;
+  header.num_links = num_links;
+  header.record_size = record_size;
+
+  mFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+
+///@brief Write remaining buffered records. Errors are ignored here,
+///       call flush() first to check for them.
+RUEventLogWriter::~RUEventLogWriter()
+{
+  try {
+    flush();
+  }
+  catch(std::exception&) {
+  }
+}
+
+
+///@brief Add a record to the log. A chunk is written to file when the link's buffer is full.
+///@param[in] link_id Link that the record belongs to. Ignored for logs that are not per link.
+///@param[in] record Pointer to record data, must be record_size bytes long
+void RUEventLogWriter::addRecord(std::uint32_t link_id, const void* record)
+{
+  std::uint32_t buffer_index = mPerLink ? link_id : 0;
+  std::vector<char>& buffer = mBuffers.at(buffer_index);
+  const char* record_data = reinterpret_cast<const char*>(record);
+
+  buffer.insert(buffer.end(), record_data, record_data+mRecordSize);
+
+  if(buffer.size() >= mChunkRecords*mRecordSize)
+    writeChunk(buffer_index);
+}
+
+
+///@brief Write the buffered records for a link as a chunk, and flush the file so that the
+///       chunk is on disk even if the simulation is aborted later
+///@param[in] buffer_index Index of buffer (link) to write
+///@throw runtime_error If writing to the file failed
+void RUEventLogWriter::writeChunk(std::uint32_t buffer_index)
+{
+  std::vector<char>& buffer = mBuffers[buffer_index];
+
+  if(buffer.empty())
+    return;
+
+  RUEventLogChunkHeader chunk_header;
+  chunk_header.chunk_magic = RU_EVENT_LOG_CHUNK_MAGIC;
+  chunk_header.link_id = mPerLink ? buffer_index : RU_EVENT_LOG_ALL_LINKS;
+  chunk_header.num_records = buffer.size() / mRecordSize;
+  chunk_header.reserved = 0;
+
+  mFile.write(reinterpret_cast<const char*>(&chunk_header), sizeof(chunk_header));
+  mFile.write(buffer.data(), buffer.size());
+  mFile.flush();
+
+  buffer.clear();
+
+  if(mFile.fail())
+    throw std::runtime_error("Error writing event log file: " + mFilename);
+}
+
+
+///@brief Write all buffered records to file
+void RUEventLogWriter::flush(void)
+{
+  for(std::uint32_t i = 0; i < mBuffers.size(); i++)
+    writeChunk(i);
+}
+
+
+///@brief Constructor for the trigger actions run-length encoder
+///@param[in] num_ctrl_links Number of control links (trigger actions per trigger)
+///@param[in] max_flush_triggers Max number of triggers between each time the open run is
+///                              written and the log is flushed to file
+RUTriggerActionRunEncoder::RUTriggerActionRunEncoder(std::uint32_t num_ctrl_links,
+                                                     std::uint32_t max_flush_triggers)
+  : mRun(sizeof(RUTriggerActionRunHeader) + num_ctrl_links)
+  , mMaxFlushTriggers(max_flush_triggers)
+{
+}
+
+
+///@brief Add the actions for the next trigger. The trigger is added to the open run if it
+///       has the same actions, otherwise the open run is written and a new run is started.
+///@param[in] trig_actions Trigger action for each control link
+///@param[in] log Trigger actions log, or nullptr to discard the runs
+void RUTriggerActionRunEncoder::addTrigger(const std::uint8_t* trig_actions,
+                                           RUEventLogWriter* log)
+{
+  std::uint8_t* run_actions = mRun.data() + sizeof(RUTriggerActionRunHeader);
+  std::uint32_t num_ctrl_links = mRun.size() - sizeof(RUTriggerActionRunHeader);
+
+  if(mRunLength > 0 && std::equal(trig_actions, trig_actions+num_ctrl_links, run_actions)) {
+    mRunLength++;
+  } else {
+    writeRun(log);
+    std::copy(trig_actions, trig_actions+num_ctrl_links, run_actions);
+    mRunLength = 1;
+  }
+
+  // The run is split here if it is still open. The runs are merged again when the log is
+  // read, and since mTriggersSinceFlush <= mMaxFlushTriggers the run length can not overflow.
+  if(++mTriggersSinceFlush >= mMaxFlushTriggers) {
+    writeRun(log);
+
+    if(log != nullptr)
+      log->flush();
+
+    mTriggersSinceFlush = 0;
+  }
+}
+
+
+///@brief Write the open run to the log, and start a new run with the next trigger
+///@param[in] log Trigger actions log, or nullptr to discard the run
+void RUTriggerActionRunEncoder::writeRun(RUEventLogWriter* log)
+{
+  if(mRunLength == 0)
+    return;
+
+  if(log != nullptr) {
+    RUTriggerActionRunHeader run_header;
+    run_header.num_triggers = mRunLength;
+    std::memcpy(mRun.data(), &run_header, sizeof(run_header));
+
+    log->addRecord(RU_EVENT_LOG_ALL_LINKS, mRun.data());
+  }
+
+  mRunLength = 0;
+}
+
+
+///@brief Read the file header of an event log file
+///@param[in] filename Path and name of event log file
+///@param[out] header File header
+///@return True if the file has a valid event log header, false if the file could not be
+///        read or is not an event log file (e.g. a trigger actions file in the format used
+///        before the event logs were introduced)
+bool readRUEventLogFileHeader(const std::string& filename, RUEventLogFileHeader& header)
+{
+  std::ifstream file(filename, std::ios::in | std::ios::binary);
+
+  if(!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    return false;
+
+  return std::memcmp(header.magic, RU_EVENT_LOG_MAGIC, sizeof(header.magic)) == 0;
+}
+
+
+///@brief Open and memory map an event log file, and index the chunks in the file.
+///       An incomplete chunk at the end of the file is ignored, and getTruncated()
+///       will return true.
+///@param[in] filename Path and name of event log file
+///@param[in] log_type Expected type of log
+///@throw runtime_error If the file can not be opened or mapped, is not an event log of
+///                     the expected type, or has a corrupt chunk
+RUEventLogReader::RUEventLogReader(const std::string& filename, RUEventLogType log_type)
+  : mFile(QString::fromStdString(filename))
+{
+  if(!mFile.open(QIODevice::ReadOnly))
+    throw std::runtime_error("Error opening event log file: " + filename);
+
+  std::uint64_t size = mFile.size();
+
+  if(size < sizeof(mHeader))
+    throw std::runtime_error("Event log file too short: " + filename);
+
+  mData = mFile.map(0, size);
+
+  if(mData == nullptr)
+    throw std::runtime_error("Error memory mapping event log file: " + filename);
+
+  std::memcpy(&mHeader, mData, sizeof(mHeader));
+
+  if(std::memcmp(mHeader.magic, RU_EVENT_LOG_MAGIC, sizeof(mHeader.magic)) != 0)
+    throw std::runtime_error("Not an event log file: " + filename);
+
+  if(mHeader.version != RU_EVENT_LOG_VERSION)
+    throw std::runtime_error("Unsupported event log file version: " + filename);
+
+  if(mHeader.log_type != log_type || mHeader.record_size == 0)
+    throw std::runtime_error("Unexpected event log type in file: " + filename);
+
+  bool per_link = ruEventLogPerLink(log_type);
+
+  mChunks.resize(per_link ? mHeader.num_links : 1);
+  mNumRecords.resize(mChunks.size(), 0);
+
+  std::uint64_t pos = sizeof(mHeader);
+  RUEventLogChunkHeader chunk_header;
+
+  while(pos + sizeof(chunk_header) <= size) {
+    std::memcpy(&chunk_header, mData+pos, sizeof(chunk_header));
+    pos += sizeof(chunk_header);
+
+    if(chunk_header.chunk_magic != RU_EVENT_LOG_CHUNK_MAGIC)
+      throw std::runtime_error("Corrupt chunk in event log file: " + filename);
+
+    std::uint32_t link_id = chunk_header.link_id;
+
+    if(per_link == false && link_id == RU_EVENT_LOG_ALL_LINKS)
+      link_id = 0;
+    else if(per_link == false || link_id >= mHeader.num_links)
+      throw std::runtime_error("Invalid link ID in event log file: " + filename);
+
+    std::uint64_t chunk_size = (std::uint64_t)chunk_header.num_records*mHeader.record_size;
+
+    if(pos + chunk_size > size) {
+      mTruncated = true;
+      return;
+    }
+
+    if(chunk_header.num_records > 0) {
+      Chunk chunk;
+      chunk.data = reinterpret_cast<const char*>(mData+pos);
+      chunk.first_record = mNumRecords[link_id];
+      chunk.num_records = chunk_header.num_records;
+
+      mChunks[link_id].push_back(chunk);
+      mNumRecords[link_id] += chunk_header.num_records;
+    }
+
+    pos += chunk_size;
+  }
+
+  // Partial chunk header at the end of the file
+  if(pos != size)
+    mTruncated = true;
+}
+
+
+RUEventLogReader::~RUEventLogReader()
+{
+  if(mData != nullptr)
+    mFile.unmap(const_cast<uchar*>(mData));
+}
+
+
+///@brief Get pointer to a record in the mapped file. The record is not necessarily
+///       aligned, so use memcpy to read it.
+///@param[in] link_id Link ID. Use link_id = 0 for logs that are not per link.
+///@param[in] record_num Record number for the link
+///@throw out_of_range If link_id or record_num is out of range
+const char* RUEventLogReader::getRecord(std::uint32_t link_id, std::uint64_t record_num) const
+{
+  const std::vector<Chunk>& chunks = mChunks.at(link_id);
+
+  if(record_num >= mNumRecords[link_id])
+    throw std::out_of_range("Event log record number out of range");
+
+  // Find the last chunk that starts at or before record_num
+  auto it = std::upper_bound(chunks.begin(), chunks.end(), record_num,
+                             [](std::uint64_t num, const Chunk& chunk) {
+                               return num < chunk.first_record;
+                             });
+  --it;
+
+  return it->data + (record_num - it->first_record)*mHeader.record_size;
+}
@@ -0,0 +1,202 @@
+/**
+ * @file   RUEventLog.hpp
+ * @author Simon Voigt Nesbo
+ * @date   October 16, 2026
+ * @brief  File format, writer and reader for the event logs of the readout unit
+ *         (trigger actions, busy events, and busy violation/flush/readout abort/fatal
+ *         events). The logs are streamed to file in chunks while the simulation runs,
+ *         so the readout unit only has to buffer up to one chunk per data link in memory.
+ *
+ *         File layout (native byte order, ie. little endian on x86):
+ *           RUEventLogFileHeader
+ *           Chunks, until end of file:
+ *             RUEventLogChunkHeader
+ *             num_records records of record_size bytes
+ *
+ *         Records in a chunk belong to the data link given by link_id in the chunk header.
+ *         Chunks for different links are interleaved in the file, but the records for a
+ *         given link are always in the order they were logged. For the trigger actions
+ *         log, each record holds the actions for all control links for one trigger, and
+ *         link_id is RU_EVENT_LOG_ALL_LINKS. The records are in trigger ID order, starting
+ *         at trigger ID 0. The readout unit writes the trigger actions run-length encoded
+ *         (RU_LOG_TRIGGER_ACTIONS_RLE), where each record covers a run of consecutive
+ *         triggers with the same actions.
+ *
+ *         The file is valid up to the last complete chunk, if a simulation is aborted the
+ *         events that were written before that can still be read.
+ *
+ *         This file is also used by the analysis code, so it should not depend on SystemC.
+ *         Records in the file are not aligned, use memcpy to access them.
+ */
+
+#ifndef RU_EVENT_LOG_HPP
+#define RU_EVENT_LOG_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <QFile>
+
+static const char RU_EVENT_LOG_MAGIC[8] = {'A','L','P','R','U','L','O','G'};
+static const std::uint32_t RU_EVENT_LOG_VERSION = 1;
+static const std::uint32_t RU_EVENT_LOG_CHUNK_MAGIC = 0x4B4E4843; // "CHNK"
+
+/// Link ID used for chunks in logs where each record covers all links
+static const std::uint32_t RU_EVENT_LOG_ALL_LINKS = 0xFFFFFFFF;
+
+/// Number of records buffered for a link before a chunk is written to file
+static const std::uint32_t RU_EVENT_LOG_CHUNK_RECORDS = 4096;
+
+enum RUEventLogType : std::uint32_t {
+  RU_LOG_TRIGGER_ACTIONS = 0,
+  RU_LOG_BUSY_EVENTS = 1,
+  RU_LOG_BUSYV_EVENTS = 2,
+  RU_LOG_FLUSH_EVENTS = 3,
+  RU_LOG_RO_ABORT_EVENTS = 4,
+  RU_LOG_FATAL_EVENTS = 5,
+  RU_LOG_TRIGGER_ACTIONS_RLE = 6,
+  RU_LOG_NUM_TYPES = 7
+};
+
+struct RUEventLogFileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t log_type;
+
+  /// Number of control links for trigger actions log, number of data links for the others
+  std::uint32_t num_links;
+  std::uint32_t record_size;
+};
+
+struct RUEventLogChunkHeader {
+  std::uint32_t chunk_magic;
+  std::uint32_t link_id;
+  std::uint32_t num_records;
+  std::uint32_t reserved;
+};
+
+/// Record in run-length encoded trigger actions log, for a run of consecutive triggers
+/// that had the same actions on all control links. The header is followed by one
+/// uint8_t action per control link, so the record size is 4 + number of control links.
+struct RUTriggerActionRunHeader {
+  std::uint32_t num_triggers;
+};
+
+/// Record in busy events log
+struct RUBusyEventRecord {
+  std::uint64_t busy_on_time_ns;
+  std::uint64_t busy_off_time_ns;
+  std::uint64_t busy_on_trigger_id;
+  std::uint64_t busy_off_trigger_id;
+};
+
+/// Record in busy violation, flushed incomplete, readout abort and fatal event logs
+struct RUTriggerEventRecord {
+  std::uint64_t trigger_id;
+  std::uint32_t chip_id;
+  std::uint32_t reserved;
+};
+
+static_assert(sizeof(RUEventLogFileHeader) == 24, "Unexpected RUEventLogFileHeader size");
+static_assert(sizeof(RUEventLogChunkHeader) == 16, "Unexpected RUEventLogChunkHeader size");
+static_assert(sizeof(RUTriggerActionRunHeader) == 4, "Unexpected RUTriggerActionRunHeader size");
+static_assert(sizeof(RUBusyEventRecord) == 32, "Unexpected RUBusyEventRecord size");
+static_assert(sizeof(RUTriggerEventRecord) == 16, "Unexpected RUTriggerEventRecord size");
+
+
+///@brief Returns true for logs that have separate records for each link, false for logs
+///       where one record covers all links (trigger actions)
+inline bool ruEventLogPerLink(RUEventLogType log_type)
+{
+  return log_type != RU_LOG_TRIGGER_ACTIONS && log_type != RU_LOG_TRIGGER_ACTIONS_RLE;
+}
+
+
+bool readRUEventLogFileHeader(const std::string& filename, RUEventLogFileHeader& header);
+
+
+///@brief Buffers records for an event log, and writes them to file one chunk at a time
+class RUEventLogWriter {
+  std::ofstream mFile;
+  std::string mFilename;
+  std::uint32_t mRecordSize;
+  std::uint32_t mChunkRecords;
+
+  /// Buffered records, one buffer per link (or just one for logs that are not per link)
+  std::vector<std::vector<char>> mBuffers;
+  bool mPerLink;
+
+  void writeChunk(std::uint32_t buffer_index);
+
+public:
+  RUEventLogWriter(const std::string& filename,
+                   RUEventLogType log_type,
+                   std::uint32_t num_links,
+                   std::uint32_t record_size,
+                   std::uint32_t chunk_records = RU_EVENT_LOG_CHUNK_RECORDS);
+  ~RUEventLogWriter();
+  void addRecord(std::uint32_t link_id, const void* record);
+  void flush(void);
+};
+
+
+///@brief Run-length encoder for the trigger actions log (RU_LOG_TRIGGER_ACTIONS_RLE).
+///       Consecutive triggers with the same actions on all control links are written as one
+///       RUTriggerActionRunHeader record. The open run is written, and the log flushed to
+///       file, every max_flush_triggers triggers, so that the log on disk does not fall
+///       behind the simulation when the trigger actions do not change for a long time.
+class RUTriggerActionRunEncoder {
+  /// Current run as a log record (RUTriggerActionRunHeader + one action per control link)
+  std::vector<std::uint8_t> mRun;
+  std::uint32_t mRunLength = 0;
+  std::uint32_t mMaxFlushTriggers;
+  std::uint32_t mTriggersSinceFlush = 0;
+
+public:
+  RUTriggerActionRunEncoder(std::uint32_t num_ctrl_links,
+                            std::uint32_t max_flush_triggers = RU_EVENT_LOG_CHUNK_RECORDS);
+  std::uint32_t getRecordSize(void) const { return mRun.size(); }
+  void addTrigger(const std::uint8_t* trig_actions, RUEventLogWriter* log);
+  void writeRun(RUEventLogWriter* log);
+};
+
+
+///@brief Reads an event log file. The file is memory mapped, and the records are accessed
+///       directly in the mapped file through an index of the chunks for each link.
+class RUEventLogReader {
+  /// Chunk in mapped file, with the number of records for the link before this chunk
+  struct Chunk {
+    const char* data;
+    std::uint64_t first_record;
+    std::uint32_t num_records;
+  };
+
+  QFile mFile;
+  const uchar* mData = nullptr;
+  RUEventLogFileHeader mHeader;
+
+  /// Chunks for each link (or just one entry for logs that are not per link)
+  std::vector<std::vector<Chunk>> mChunks;
+  std::vector<std::uint64_t> mNumRecords;
+  bool mTruncated = false;
+
+public:
+  RUEventLogReader(const std::string& filename, RUEventLogType log_type);
+  ~RUEventLogReader();
+  std::uint32_t getNumLinks(void) const { return mHeader.num_links; }
+  std::uint32_t getRecordSize(void) const { return mHeader.record_size; }
+
+  ///@brief True if the file ended with an incomplete chunk, which was ignored
+  bool getTruncated(void) const { return mTruncated; }
+
+  ///@brief Get number of records for a link. Use link_id = 0 for logs that are not per link.
+  std::uint64_t getNumRecords(std::uint32_t link_id) const {
+    return mNumRecords.at(link_id);
+  }
+
+  const char* getRecord(std::uint32_t link_id, std::uint64_t record_num) const;
+};
+
+
+#endif
@@ -12,6 +12,8 @@
 
 #include "ReadoutUnit.hpp"
 #include <misc/vcd_trace.hpp>
+#include <Log/Log.hpp>
+#include <Profiling/ProcessProfiler.hpp>
 
 
 SC_HAS_PROCESS(ReadoutUnit);
@@ -55,7 +57,8 @@ ReadoutUnit::ReadoutUnit(sc_core::sc_module_name name,
   , mTriggerFilterTimeNs(trigger_filter_time)
   , mTriggerFilterEnabled(trigger_filter_enable)
   , mTriggersSentCount(n_ctrl_links)
-  , mTriggerActionMaps(n_ctrl_links)
+  , mTriggerActions(n_ctrl_links)
+  , mTriggerActionRunEncoder(n_ctrl_links)
   , mAlpideLinkBusySignals(n_data_links)
 {
   // This prevents the first trigger from being filtered
@@ -138,7 +141,8 @@ ReadoutUnit::ReadoutUnit(sc_core::sc_module_name name,
   , mTriggerFilterTimeNs(trigger_filter_time)
   , mTriggerFilterEnabled(trigger_filter_enable)
   , mTriggersSentCount(n_ctrl_links)
-  , mTriggerActionMaps(n_ctrl_links)
+  , mTriggerActions(n_ctrl_links)
+  , mTriggerActionRunEncoder(n_ctrl_links)
   , mAlpideLinkBusySignals(n_data_links)
 {
   // This prevents the first trigger from being filtered
@@ -189,6 +193,163 @@ void ReadoutUnit::end_of_elaboration(void)
 }
 
 
+///@brief Write the remaining events in the data link parsers to the event logs,
+///       and flush the logs.
+void ReadoutUnit::end_of_simulation(void)
+{
+  if(mEventLogs.empty())
+    return;
+
+  mTriggerActionRunEncoder.writeRun(mEventLogs[RU_LOG_TRIGGER_ACTIONS_RLE].get());
+  logDataLinkEvents(true);
+
+  try {
+    for(auto it = mEventLogs.begin(); it != mEventLogs.end(); it++) {
+      if(*it)
+        (*it)->flush();
+    }
+  }
+  catch(std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+  }
+
+  mEventLogs.clear();
+}
+
+
+///@brief Open files for the event logs of this RU. The events are streamed to the files
+///       in chunks while the simulation runs. If this function is not called, the events
+///       are discarded. All the files have the same format, see RUEventLog.hpp.
+///       Files are created for:
+///       - Trigger actions (_trigger_actions.dat), run-length encoded. One record per run of
+///         consecutive triggers with identical actions, with one uint8_t per control link:
+///         TRIGGER_SENT, TRIGGER_NOT_SENT_BUSY or TRIGGER_FILTERED
+///       - Busy events (_busy_events.dat), with RUBusyEventRecord records per data link
+///       - Busy violation (_busyv_events.dat), flushed incomplete (_flush_events.dat),
+///         readout abort (_ro_abort_events.dat) and fatal (_fatal_events.dat) events,
+///         with RUTriggerEventRecord records per data link
+///@param[in] output_path Path and filename prefix for the event log files
+///@throw runtime_error If one of the files can not be created
+void ReadoutUnit::openEventLogs(const std::string output_path)
+{
+  const std::vector<std::pair<RUEventLogType, const char*>> log_files =
+    {{RU_LOG_TRIGGER_ACTIONS_RLE, "_trigger_actions.dat"},
+     {RU_LOG_BUSY_EVENTS, "_busy_events.dat"},
+     {RU_LOG_BUSYV_EVENTS, "_busyv_events.dat"},
+     {RU_LOG_FLUSH_EVENTS, "_flush_events.dat"},
+     {RU_LOG_RO_ABORT_EVENTS, "_ro_abort_events.dat"},
+     {RU_LOG_FATAL_EVENTS, "_fatal_events.dat"}};
+
+  mEventLogs.clear();
+  mEventLogs.resize(RU_LOG_NUM_TYPES);
+
+  for(auto it = log_files.begin(); it != log_files.end(); it++) {
+    RUEventLogType log_type = it->first;
+    uint32_t num_links = s_alpide_data_input.size();
+    uint32_t record_size = sizeof(RUTriggerEventRecord);
+
+    if(log_type == RU_LOG_TRIGGER_ACTIONS_RLE) {
+      num_links = s_alpide_control_output.size();
+      record_size = mTriggerActionRunEncoder.getRecordSize();
+    } else if(log_type == RU_LOG_BUSY_EVENTS) {
+      record_size = sizeof(RUBusyEventRecord);
+    }
+
+    mEventLogs[log_type].reset(new RUEventLogWriter(output_path + it->second,
+                                                    log_type,
+                                                    num_links,
+                                                    record_size));
+  }
+}
+
+
+///@brief Log the actions for the current trigger. Consecutive triggers with the same
+///       actions on all control links are written as one run in the trigger actions log,
+///       see RUTriggerActionRunEncoder.
+void ReadoutUnit::logTriggerActions(void)
+{
+  RUEventLogWriter* log = nullptr;
+
+  if(!mEventLogs.empty())
+    log = mEventLogs[RU_LOG_TRIGGER_ACTIONS_RLE].get();
+
+  mTriggerActionRunEncoder.addTrigger(mTriggerActions.data(), log);
+}
+
+
+///@brief Move busy violation/flush/readout abort/fatal events from a data link parser
+///       to an event log (or discard them if the logs are not open)
+///@param[in] log_type Type of event log
+///@param[in] link_id Data link ID
+///@param[in,out] trigger_events Map with trigger IDs per chip from the data link parser.
+///                              The map is cleared.
+void ReadoutUnit::logTriggerEvents(RUEventLogType log_type,
+                                   unsigned int link_id,
+                                   std::map<unsigned int, std::vector<uint64_t>>& trigger_events)
+{
+  if(trigger_events.empty())
+    return;
+
+  if(!mEventLogs.empty()) {
+    RUTriggerEventRecord record;
+    record.reserved = 0;
+
+    for(auto chip_it = trigger_events.begin(); chip_it != trigger_events.end(); chip_it++) {
+      record.chip_id = chip_it->first;
+
+      for(auto trig_it = chip_it->second.begin(); trig_it != chip_it->second.end(); trig_it++) {
+        record.trigger_id = *trig_it;
+        mEventLogs[log_type]->addRecord(link_id, &record);
+      }
+    }
+  }
+
+  trigger_events.clear();
+}
+
+
+///@brief Move the events recorded by the data link parsers to the event logs,
+///       so that the parsers don't accumulate them for the whole simulation.
+///@param[in] final_flush The last busy event of each link is normally kept in the parser,
+///                       since it is updated when BUSY_OFF is received. Set to true to
+///                       log it anyway at the end of the simulation.
+void ReadoutUnit::logDataLinkEvents(bool final_flush)
+{
+  for(unsigned int link_id = 0; link_id < mDataLinkParsers.size(); link_id++) {
+    std::vector<BusyEvent>& busy_events = mDataLinkParsers[link_id]->getBusyEvents();
+    std::size_t num_busy_events = busy_events.size();
+
+    if(!final_flush && num_busy_events > 0)
+      num_busy_events--;
+
+    if(num_busy_events > 0) {
+      if(!mEventLogs.empty()) {
+        RUBusyEventRecord record;
+
+        for(std::size_t i = 0; i < num_busy_events; i++) {
+          record.busy_on_time_ns = busy_events[i].mBusyOnTime;
+          record.busy_off_time_ns = busy_events[i].mBusyOffTime;
+          record.busy_on_trigger_id = busy_events[i].mBusyOnTriggerId;
+          record.busy_off_trigger_id = busy_events[i].mBusyOffTriggerId;
+          mEventLogs[RU_LOG_BUSY_EVENTS]->addRecord(link_id, &record);
+        }
+      }
+
+      busy_events.erase(busy_events.begin(), busy_events.begin()+num_busy_events);
+    }
+
+    logTriggerEvents(RU_LOG_BUSYV_EVENTS, link_id,
+                     mDataLinkParsers[link_id]->getBusyViolationTriggers());
+    logTriggerEvents(RU_LOG_FLUSH_EVENTS, link_id,
+                     mDataLinkParsers[link_id]->getFlushedIncomplTriggers());
+    logTriggerEvents(RU_LOG_RO_ABORT_EVENTS, link_id,
+                     mDataLinkParsers[link_id]->getReadoutAbortTriggers());
+    logTriggerEvents(RU_LOG_FATAL_EVENTS, link_id,
+                     mDataLinkParsers[link_id]->getFatalTriggers());
+  }
+}
+
+
 ///@brief Dummy callback function for the Alpide data socket. Not used here.
 void ReadoutUnit::alpideDataSocketInput(const DataPayload &pl)
 {
@@ -231,21 +392,24 @@ void ReadoutUnit::sendTrigger(void)
   for(unsigned int i = 0; i < s_alpide_control_output.size(); i++) {
     if(mTriggerFilterEnabled && filter_trigger) {
       // Filter triggers that come too close in time
-      mTriggerActionMaps[i][mTriggerIdCount] = TRIGGER_FILTERED;
+      mTriggerActions[i] = TRIGGER_FILTERED;
       mTriggersFilteredCount++;
     } else if(true) { ///@todo else if(link_busy[i] == false) {
       // If we are not busy, send trigger
       s_alpide_control_output[i]->transport(trigger_word);
       mTriggersSentCount[i]++;
-      mTriggerActionMaps[i][mTriggerIdCount] = TRIGGER_SENT;
+      mTriggerActions[i] = TRIGGER_SENT;
       mPreviousTriggerId = mTriggerIdCount;
       mLastTriggerTime = time_now;
     } else {
-      mTriggerActionMaps[i][mTriggerIdCount] = TRIGGER_NOT_SENT_BUSY;
+      mTriggerActions[i] = TRIGGER_NOT_SENT_BUSY;
       mLastTriggerTime = time_now;
     }
   }
 
+  logTriggerActions();
+  logDataLinkEvents(false);
+
   mTriggerIdCount++;
 }
 
@@ -253,11 +417,10 @@ void ReadoutUnit::sendTrigger(void)
 ///@brief Process trigger input events.
 void ReadoutUnit::triggerInputMethod(void)
 {
-  uint64_t time_now = sc_time_stamp().value();
+  PROFILE_PROCESS("ReadoutUnit::triggerInputMethod");
 
-  std::cout << "@" << time_now;
-  std::cout << ": RU " << mLayerId << ":" << mStaveId << " triggered.";
-  std::cout << std::endl;
+  LOG(LOG_DEBUG, LOG_MODULE_RU) << "@" << sc_time_stamp().value()
+                                << ": RU " << mLayerId << ":" << mStaveId << " triggered.";
 
   sendTrigger();
 }
@@ -268,6 +431,8 @@ void ReadoutUnit::triggerInputMethod(void)
 ///       local busy status.
 void ReadoutUnit::evaluateBusyStatusMethod(void)
 {
+  PROFILE_PROCESS("ReadoutUnit::evaluateBusyStatusMethod");
+
   unsigned int busy_link_count = 0;
 
   for(unsigned int i = 0; i < mAlpideLinkBusySignals.size(); i++) {
@@ -305,6 +470,8 @@ void ReadoutUnit::evaluateBusyStatusMethod(void)
 ///       the chain, unless they originated from this readout unit.
 void ReadoutUnit::busyChainMethod(void)
 {
+  PROFILE_PROCESS("ReadoutUnit::busyChainMethod");
+
   ///@todo Pass on busy event here, unless the busy event originated from this readout unit.
   ///@todo How can I implement a payload with these events? Maybe Matthias' structure is suitable for this?
 
@@ -312,11 +479,10 @@ void ReadoutUnit::busyChainMethod(void)
 
   if(s_busy_in->nb_read(busy_word)) {
 
-    uint64_t time_now = sc_time_stamp().value();
-    std::cout << "@" << time_now << ": RU " << mLayerId << ":" << mStaveId << " Got busy word." << std::endl;
-    std::cout << "Origin ID: " << busy_word.mOriginAddress << std::endl;
-    std::cout << "Timestamp : " << busy_word.mTimeStamp << std::endl;
-    std::cout << "Busy word type: " << busy_word.getString();
+    LOG(LOG_DEBUG, LOG_MODULE_RU) << "@" << sc_time_stamp().value() << ": RU " << mLayerId << ":"
+                                  << mStaveId << " Got busy word. Origin ID: "
+                                  << busy_word.mOriginAddress << ", timestamp: "
+                                  << busy_word.mTimeStamp << ", type: " << busy_word.getString();
 
     // Ignore (and discard) busy words that originated from this readout unit
     // (ie. it has made the roundtrip through the busy chain)
@@ -338,7 +504,7 @@ void ReadoutUnit::busyChainMethod(void)
       // }
 
       // Pass the busy word down the daisy chain link
-      std::cout << "Passing on busy word down the chain.." << std::endl;
+      LOG(LOG_DEBUG, LOG_MODULE_RU) << "Passing on busy word down the chain..";
       s_busy_fifo_out.nb_write(busy_word);
     }
   }
@@ -388,20 +554,22 @@ void ReadoutUnit::writeSimulationStats(const std::string output_path) const
 
   // Assuming that each link parser has the recorded the same number of intervals, which should
   // hold true since they starts and stop at the same time, and use the same interval length
-  for(auto interval_it = mDataLinkParsers[0]->getDataIntervalByteCounts().begin();
-      interval_it != mDataLinkParsers[0]->getDataIntervalByteCounts().end();
-      interval_it++)
+  for(uint64_t interval_num = 0;
+      interval_num < mDataLinkParsers[0]->getNumDataIntervals();
+      interval_num++)
   {
+    if(!mDataLinkParsers[0]->getDataIntervalRecorded(interval_num))
+      continue;
+
     data_rate_csv_file << std::endl;
 
-    uint64_t interval_num = interval_it->first;
     uint64_t data_bytes_total = 0;
 
     data_rate_csv_file << interval_num*data_rate_interval_ns << ";";
 
     // Calculate total data rate (for readout unit)
     for(unsigned int i = 0; i < mDataLinkParsers.size(); i++) {
-      data_bytes_total += mDataLinkParsers[i]->getDataIntervalByteCounts()[interval_num];
+      data_bytes_total += mDataLinkParsers[i]->getDataIntervalByteCount(interval_num);
     }
 
     // Convert number of bytes in interval to Mbps
@@ -410,7 +578,7 @@ void ReadoutUnit::writeSimulationStats(const std::string output_path) const
 
     // Output data rate for each link
     for(unsigned int i = 0; i < mDataLinkParsers.size(); i++) {
-      uint64_t data_bytes_link = mDataLinkParsers[i]->getDataIntervalByteCounts()[interval_num];
+      uint64_t data_bytes_link = mDataLinkParsers[i]->getDataIntervalByteCount(interval_num);
 
       // Convert number of bytes in interval to Mbps
       double data_rate_link_mbps = 8*(data_bytes_link*(1E9/data_rate_interval_ns))/(1E6);
@@ -464,7 +632,7 @@ void ReadoutUnit::writeSimulationStats(const std::string output_path) const
   prot_stats_csv_file << std::endl;
 
   for(unsigned int i = 0; i < mDataLinkParsers.size(); i++) {
-    auto stats = mDataLinkParsers[i]->getProtocolStats();
+    const auto& stats = mDataLinkParsers[i]->getProtocolStats();
 
     // Calculate total number of bytes used by data words,
     // and counts of each type of data word
@@ -556,366 +724,6 @@ void ReadoutUnit::writeSimulationStats(const std::string output_path) const
 
 
   // -----------------------------------------------------
-  // Write binary data file with trigger actions
-  // -----------------------------------------------------
-  // File format:
-  //
-  //   Header:
-  //   uint64_t: number of triggers
-  //   uint8_t:  number of control links
-  //
-  //   For each trigger ID:
-  //     Control link 0:
-  //       uint8_t: link action
-  //     Control link 1:
-  //       uint8_t: link action
-  //     ...
-  //     Control link n-1:
-  //       uint8_t: link action
-
-  std::string trig_actions_filename = output_path + std::string("_trigger_actions.dat");
-  ofstream trig_actions_file(trig_actions_filename, std::ios_base::out | std::ios_base::binary);
-
-  if(!trig_actions_file.is_open()) {
-    std::cerr << "Error opening trigger actions file: " << trig_actions_filename << std::endl;
-    return;
-  } else {
-    std::cout << "Writing trigger actions to file:\n\"";
-    std::cout << trig_actions_filename << "\"" << std::endl;
-  }
-
-
-  // Write number of triggers and number of control links to file header
-  uint64_t num_triggers = mTriggerIdCount;
-  uint8_t num_ctrl_links = s_alpide_control_output.size();
-  trig_actions_file.write((char*)&num_triggers, sizeof(uint64_t));
-  trig_actions_file.write((char*)&num_ctrl_links, sizeof(uint8_t));
-
-  // Write action for each link, for each trigger
-  for(uint64_t trigger_id = 0; trigger_id < mTriggerIdCount; trigger_id++) {
-    for(uint64_t link_id = 0; link_id < mTriggerActionMaps.size(); link_id++) {
-      uint8_t link_action = mTriggerActionMaps[link_id].at(trigger_id);
-      trig_actions_file.write((char*)&link_action, sizeof(uint8_t));
-    }
-  }
-  trig_actions_file.close();
-
-
-  // -----------------------------------------------------
-  // Write binary data file with busy events
-  // -----------------------------------------------------
-  // File format:
-  //
-  //   Header:
-  //   uint8_t:  number of data links
-  //
-  //   For each data link:
-  //       Header:
-  //          uint64_t: Number of "busy events"
-  //       Data (for each busy event)
-  //          uint64_t: time of BUSY_ON
-  //          uint64_t: time of BUSY_OFF
-  //          uint64_t: trigger ID when BUSY_ON occured
-  //          uint64_t: trigger ID when BUSY_OFF occured
-
-  std::string busy_events_filename = output_path + std::string("_busy_events.dat");
-  ofstream busy_events_file(busy_events_filename, std::ios_base::out | std::ios_base::binary);
-
-  if(!busy_events_file.is_open()) {
-    std::cerr << "Error opening busy events file: " << busy_events_filename << std::endl;
-    return;
-  } else {
-    std::cout << "Writing busy events to file:\n\"";
-    std::cout << busy_events_filename << "\"" << std::endl;
-  }
-
-
-  // Write number of data links to file header
-  uint8_t num_data_links = s_alpide_data_input.size();
-  busy_events_file.write((char*)&num_data_links, sizeof(uint8_t));
-
-  // Write busy events for each link
-  for(uint64_t link_id = 0; link_id < mDataLinkParsers.size(); link_id++) {
-    std::vector<BusyEvent> busy_events = mDataLinkParsers[link_id]->getBusyEvents();
-    uint64_t num_busy_events = busy_events.size();
-    busy_events_file.write((char*)&num_busy_events, sizeof(uint64_t));
-
-    for(auto busy_event_it = busy_events.begin();
-        busy_event_it != busy_events.end();
-        busy_event_it++)
-    {
-      busy_events_file.write((char*)&(busy_event_it->mBusyOnTime), sizeof(uint64_t));
-      busy_events_file.write((char*)&(busy_event_it->mBusyOffTime), sizeof(uint64_t));
-      busy_events_file.write((char*)&(busy_event_it->mBusyOnTriggerId), sizeof(uint64_t));
-      busy_events_file.write((char*)&(busy_event_it->mBusyOffTriggerId), sizeof(uint64_t));
-    }
-  }
-  busy_events_file.close();
-
-
-  // -----------------------------------------------------
-  // Write binary data file with busy violation events
-  // -----------------------------------------------------
-  // File format:
-  //
-  //   Header:
-  //   uint8_t:  number of data links
-  //
-  //   For each data link:
-  //       uint8_t: Number of chips with data for this link
-  //
-  //       For each chip in data link which has data:
-  //          Header:
-  //             uint8_t:  Chip ID
-  //             uint64_t: Number of "busy violation events"
-  //          Data (for each busy violation event)
-  //             uint64_t: trigger ID for busy violation
-
-  std::string busyv_events_filename = output_path + std::string("_busyv_events.dat");
-  ofstream busyv_events_file(busyv_events_filename, std::ios_base::out | std::ios_base::binary);
-
-  if(!busyv_events_file.is_open()) {
-    std::cerr << "Error opening busy violation events file: " << busyv_events_filename << std::endl;
-    return;
-  } else {
-    std::cout << "Writing busy violation events to file:\n\"";
-    std::cout << busyv_events_filename << "\"" << std::endl;
-  }
-
-
-  // Write number of data links to file header
-  busyv_events_file.write((char*)&num_data_links, sizeof(uint8_t));
-
-  // Write busy events for each link
-  for(uint64_t link_id = 0; link_id < mDataLinkParsers.size(); link_id++) {
-    std::map<unsigned int, std::vector<uint64_t>> busyv_events =
-      mDataLinkParsers[link_id]->getBusyViolationTriggers();
-
-    // Write number of chips that had busyv events for this link
-    uint8_t num_chips_with_data = busyv_events.size();
-    busyv_events_file.write((char*)&num_chips_with_data, sizeof(uint8_t));
-
-    // Write busyv events per chip in this link
-    for(auto busyv_chip_it = busyv_events.begin();
-        busyv_chip_it != busyv_events.end();
-        busyv_chip_it++)
-    {
-      uint8_t chip_id = busyv_chip_it->first;
-      busyv_events_file.write((char*)&chip_id, sizeof(uint8_t));
-
-      uint64_t num_busyv_events = busyv_chip_it->second.size();
-      busyv_events_file.write((char*)&num_busyv_events, sizeof(uint64_t));
-
-      for(auto busyv_event_it = busyv_chip_it->second.begin();
-          busyv_event_it != busyv_chip_it->second.end();
-          busyv_event_it++)
-      {
-        uint64_t busyv_trigger_id = *busyv_event_it;
-        busyv_events_file.write((char*)&busyv_trigger_id, sizeof(uint64_t));
-      }
-    }
-  }
-  busyv_events_file.close();
-
-
-  // ------------------------------------------------------
-  // Write binary data file with flushed incomplete events
-  // ------------------------------------------------------
-  // File format (same as for busyv basically):
-  //
-  //   Header:
-  //   uint8_t:  number of data links
-  //
-  //   For each data link:
-  //       uint8_t: Number of chips with data for this link
-  //
-  //       For each chip in data link which has data:
-  //          Header:
-  //             uint8_t:  Chip ID
-  //             uint64_t: Number of "flushed incomplete events"
-  //          Data (for each flushed incomplete event)
-  //             uint64_t: trigger ID for flushed incomplete
-
-  std::string flush_events_filename = output_path + std::string("_flush_events.dat");
-  ofstream flush_events_file(flush_events_filename, std::ios_base::out | std::ios_base::binary);
-
-  if(!flush_events_file.is_open()) {
-    std::cerr << "Error opening flushed incomplete events file: ";
-    std::cerr << flush_events_filename << std::endl;
-    return;
-  } else {
-    std::cout << "Writing flushed incomplete events to file:\n\"";
-    std::cout << flush_events_filename << "\"" << std::endl;
-  }
-
-
-  // Write number of data links to file header
-  flush_events_file.write((char*)&num_data_links, sizeof(uint8_t));
-
-  // Write flushed incomplete events for each link
-  for(uint64_t link_id = 0; link_id < mDataLinkParsers.size(); link_id++) {
-    std::map<unsigned int, std::vector<uint64_t>> flush_events
-      = mDataLinkParsers[link_id]->getFlushedIncomplTriggers();
-
-    // Write number of chips that had flush events for this link
-    uint8_t num_chips_with_data = flush_events.size();
-    flush_events_file.write((char*)&num_chips_with_data, sizeof(uint8_t));
-
-    // Write flush events per chip in this link
-    for(auto flush_chip_it = flush_events.begin();
-        flush_chip_it != flush_events.end();
-        flush_chip_it++)
-    {
-      uint8_t chip_id = flush_chip_it->first;
-      flush_events_file.write((char*)&chip_id, sizeof(uint8_t));
-
-      uint64_t num_flush_events = flush_chip_it->second.size();
-      flush_events_file.write((char*)&num_flush_events, sizeof(uint64_t));
-
-      for(auto flush_event_it = flush_chip_it->second.begin();
-          flush_event_it != flush_chip_it->second.end();
-          flush_event_it++)
-      {
-        uint64_t flush_trigger_id = *flush_event_it;
-        flush_events_file.write((char*)&flush_trigger_id, sizeof(uint64_t));
-      }
-    }
-  }
-  flush_events_file.close();
-
-
-  // ---------------------------------------------------------------
-  // Write binary data file with readout abort (data overrun) events
-  // ---------------------------------------------------------------
-  // File format (same as for busyv basically):
-  //
-  //   Header:
-  //   uint8_t:  number of data links
-  //
-  //   For each data link:
-  //       uint8_t: Number of chips with data for this link
-  //
-  //       For each chip in data link which has data:
-  //          Header:
-  //             uint8_t:  Chip ID
-  //             uint64_t: Number of "readout abort events"
-  //          Data (for each trigger chip was in readout abort)
-  //             uint64_t: trigger ID for readout abort event
-
-  std::string ro_abort_event_filename = output_path + std::string("_ro_abort_events.dat");
-  ofstream ro_abort_event_file(ro_abort_event_filename, std::ios_base::out | std::ios_base::binary);
-
-  if(!ro_abort_event_file.is_open()) {
-    std::cerr << "Error opening readout abort events file: ";
-    std::cerr << ro_abort_event_filename << std::endl;
-    return;
-  } else {
-    std::cout << "Writing readout abort events to file:\n\"";
-    std::cout << ro_abort_event_filename << "\"" << std::endl;
-  }
-
-
-  // Write number of data links to file header
-  ro_abort_event_file.write((char*)&num_data_links, sizeof(uint8_t));
-
-  // Write readout abort events for each link
-  for(uint64_t link_id = 0; link_id < mDataLinkParsers.size(); link_id++) {
-    std::map<unsigned int, std::vector<uint64_t>> ro_abort_event
-      = mDataLinkParsers[link_id]->getReadoutAbortTriggers();
-
-    // Write number of chips that had readout abort events for this link
-    uint8_t num_chips_with_data = ro_abort_event.size();
-    ro_abort_event_file.write((char*)&num_chips_with_data, sizeof(uint8_t));
-
-    // Write readout abort events per chip in this link
-    for(auto readout_abort_chip_it = ro_abort_event.begin();
-        readout_abort_chip_it != ro_abort_event.end();
-        readout_abort_chip_it++)
-    {
-      uint8_t chip_id = readout_abort_chip_it->first;
-      ro_abort_event_file.write((char*)&chip_id, sizeof(uint8_t));
-
-      uint64_t num_ro_abort_event = readout_abort_chip_it->second.size();
-      ro_abort_event_file.write((char*)&num_ro_abort_event, sizeof(uint64_t));
-
-      for(auto readout_abort_it = readout_abort_chip_it->second.begin();
-          readout_abort_it != readout_abort_chip_it->second.end();
-          readout_abort_it++)
-      {
-        uint64_t ro_abort_trigger_id = *readout_abort_it;
-        ro_abort_event_file.write((char*)&ro_abort_trigger_id, sizeof(uint64_t));
-      }
-    }
-  }
-  ro_abort_event_file.close();
-
-
-  // ------------------------------------------------------
-  // Write binary data file with fatal events
-  // ------------------------------------------------------
-  // File format (same as for busyv basically):
-  //
-  //   Header:
-  //   uint8_t:  number of data links
-  //
-  //   For each data link:
-  //       uint8_t: Number of chips with data for this link
-  //
-  //       For each chip in data link which has data:
-  //          Header:
-  //             uint8_t:  Chip ID
-  //             uint64_t: Number of "fatal events"
-  //          Data (for each trigger chip was in fatal mode)
-  //             uint64_t: trigger ID for fatal event
-
-  std::string fatal_event_filename = output_path + std::string("_fatal_events.dat");
-  ofstream fatal_event_file(fatal_event_filename, std::ios_base::out | std::ios_base::binary);
-
-  if(!fatal_event_file.is_open()) {
-    std::cerr << "Error opening fatal events events file: ";
-    std::cerr << fatal_event_filename << std::endl;
-    return;
-  } else {
-    std::cout << "Writing readout fatal events to file:\n\"";
-    std::cout << fatal_event_filename << "\"" << std::endl;
-  }
-
-
-  // Write number of data links to file header
-  fatal_event_file.write((char*)&num_data_links, sizeof(uint8_t));
-
-  // Write fatal events for each link
-  for(uint64_t link_id = 0; link_id < mDataLinkParsers.size(); link_id++) {
-    std::map<unsigned int, std::vector<uint64_t>> fatal_event
-      = mDataLinkParsers[link_id]->getFatalTriggers();
-
-    // Write number of chips that had fatal events for this link
-    uint8_t num_chips_with_data = fatal_event.size();
-    fatal_event_file.write((char*)&num_chips_with_data, sizeof(uint8_t));
-
-    // Write fatal events per chip in this link
-    for(auto fatal_chip_it = fatal_event.begin();
-        fatal_chip_it != fatal_event.end();
-        fatal_chip_it++)
-    {
-      uint8_t chip_id = fatal_chip_it->first;
-      fatal_event_file.write((char*)&chip_id, sizeof(uint8_t));
-
-      uint64_t num_fatal_event = fatal_chip_it->second.size();
-      fatal_event_file.write((char*)&num_fatal_event, sizeof(uint64_t));
-
-      for(auto fatal_it = fatal_chip_it->second.begin();
-          fatal_it != fatal_chip_it->second.end();
-          fatal_it++)
-      {
-        uint64_t fatal_trigger_id = *fatal_it;
-        fatal_event_file.write((char*)&fatal_trigger_id, sizeof(uint64_t));
-      }
-    }
-  }
-  fatal_event_file.close();
-
-
   // Write file with trigger summary
   // -----------------------------------------------------
   csv_filename = output_path + std::string("_Trigger_summary.csv");
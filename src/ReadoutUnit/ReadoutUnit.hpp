@@ -23,6 +23,7 @@
 #include <memory>
 
 #include "BusyLinkWord.hpp"
+#include "RUEventLog.hpp"
 #include <Alpide/AlpideInterface.hpp>
 #include "../AlpideDataParser/AlpideDataParser.hpp"
 
@@ -74,12 +75,18 @@ private:
   // Should be same size as s_alpide_control_output.
   std::vector<uint64_t> mTriggersSentCount;
 
-  // Map holds the trigger action taken per event ID per control link
-  // One map per control link in the vector
+  // Trigger action taken for the current trigger, one entry per control link.
   // Valid values for the uint8_t:
   // TRIGGER_SENT, TRIGGER_NOT_SENT_BUSY, TRIGGER_FILTERED.
-  std::vector<std::map<uint64_t, uint8_t>> mTriggerActionMaps;
+  std::vector<uint8_t> mTriggerActions;
 
+  // Run-length encodes mTriggerActions for the trigger actions log
+  RUTriggerActionRunEncoder mTriggerActionRunEncoder;
+
+  // Event logs (trigger actions, busy events etc.), indexed by RUEventLogType,
+  // with null pointers for unused log types.
+  // Empty if openEventLogs() has not been called, and the events are then discarded.
+  std::vector<std::unique_ptr<RUEventLogWriter>> mEventLogs;
 
   std::vector<std::shared_ptr<AlpideDataParser>> mDataLinkParsers;
   std::vector<sc_export<sc_signal<bool>>> mAlpideLinkBusySignals;
@@ -90,6 +97,11 @@ private:
   void evaluateBusyStatusMethod(void);
   void triggerInputMethod(void);
   void busyChainMethod(void);
+  void logTriggerActions(void);
+  void logTriggerEvents(RUEventLogType log_type,
+                        unsigned int link_id,
+                        std::map<unsigned int, std::vector<uint64_t>>& trigger_events);
+  void logDataLinkEvents(bool final_flush);
 //  void processInputData(void);
 
 public:
@@ -112,6 +124,8 @@ public:
               bool trigger_filter_enable,
               unsigned int data_rate_interval_ns);
   void end_of_elaboration();
+  void end_of_simulation();
+  void openEventLogs(const std::string output_path);
   unsigned int numCtrlLinks(void) const { return s_alpide_control_output.size(); }
   unsigned int numDataLinks(void) const { return s_alpide_data_input.size(); }
   void addTraces(sc_trace_file *wf, std::string name_prefix) const;
@@ -64,6 +64,7 @@ void setDefaultSimSettings(QSettings *readoutSimSettings) {
   defaultSettings["data_output/write_vcd_clock"] = DEFAULT_DATA_OUTPUT_WRITE_VCD_CLOCK;
   defaultSettings["data_output/write_event_csv"] = DEFAULT_DATA_OUTPUT_WRITE_EVENT_CSV;
   defaultSettings["data_output/data_rate_interval_ns"] = DEFAULT_DATA_OUTPUT_DATA_RATE_INTERVAL_NS;
+  defaultSettings["data_output/telemetry_interval_ns"] = DEFAULT_DATA_OUTPUT_TELEMETRY_INTERVAL_NS;
 
   defaultSettings["simulation/type"] = DEFAULT_SIMULATION_TYPE;
   defaultSettings["simulation/single_chip"] = DEFAULT_SIMULATION_SINGLE_CHIP;
@@ -71,6 +72,12 @@ void setDefaultSimSettings(QSettings *readoutSimSettings) {
   defaultSettings["simulation/system_continuous_mode"] = DEFAULT_SIMULATION_SYSTEM_CONTINUOUS_MODE;
   defaultSettings["simulation/system_continuous_period_ns"] = DEFAULT_SIMULATION_SYSTEM_CONTINUOUS_PERIOD_NS;
   defaultSettings["simulation/random_seed"] = DEFAULT_SIMULATION_RANDOM_SEED;
+  defaultSettings["simulation/shard_count"] = DEFAULT_SIMULATION_SHARD_COUNT;
+  defaultSettings["simulation/shard_index"] = DEFAULT_SIMULATION_SHARD_INDEX;
+  defaultSettings["simulation/threads"] = DEFAULT_SIMULATION_THREADS;
+  defaultSettings["simulation/log_level"] = DEFAULT_SIMULATION_LOG_LEVEL;
+  defaultSettings["simulation/log_module_levels"] = DEFAULT_SIMULATION_LOG_MODULE_LEVELS;
+  defaultSettings["simulation/log_progress_interval_ms"] = DEFAULT_SIMULATION_LOG_PROGRESS_INTERVAL_MS;
 
   defaultSettings["alpide/data_long_enable"] = DEFAULT_ALPIDE_DATA_LONG_ENABLE;
   defaultSettings["alpide/dtu_delay"] = DEFAULT_ALPIDE_DTU_DELAY;
@@ -80,6 +87,12 @@ void setDefaultSimSettings(QSettings *readoutSimSettings) {
   defaultSettings["alpide/strobe_extension_enable"] = DEFAULT_ALPIDE_STROBE_EXTENSION_ENABLE;
   defaultSettings["alpide/minimum_busy_cycles"] = DEFAULT_ALPIDE_MINIMUM_BUSY_CYCLES;
   defaultSettings["alpide/chip_continuous_mode"] = DEFAULT_ALPIDE_CHIP_CONTINUOUS_MODE;
+  defaultSettings["alpide/clock_skipping_enable"] = DEFAULT_ALPIDE_CLOCK_SKIPPING_ENABLE;
+  defaultSettings["alpide/frame_model_layers"] = DEFAULT_ALPIDE_FRAME_MODEL_LAYERS;
+  defaultSettings["alpide/frame_model_validation"] = DEFAULT_ALPIDE_FRAME_MODEL_VALIDATION;
+  defaultSettings["alpide/hybrid_model_layers"] = DEFAULT_ALPIDE_HYBRID_MODEL_LAYERS;
+  defaultSettings["alpide/hybrid_meb_threshold"] = DEFAULT_ALPIDE_HYBRID_MEB_THRESHOLD;
+  defaultSettings["alpide/hybrid_frame_fifo_threshold"] = DEFAULT_ALPIDE_HYBRID_FRAME_FIFO_THRESHOLD;
 
   defaultSettings["its/layer0_num_staves"] = DEFAULT_ITS_LAYER0_NUM_STAVES;
   defaultSettings["its/layer1_num_staves"] = DEFAULT_ITS_LAYER1_NUM_STAVES;
@@ -121,6 +134,7 @@ void setDefaultSimSettings(QSettings *readoutSimSettings) {
   defaultSettings["event/random_cluster_size_mean"] = DEFAULT_EVENT_RANDOM_CLUSTER_SIZE_MEAN;
   defaultSettings["event/random_cluster_size_stddev"] = DEFAULT_EVENT_RANDOM_CLUSTER_SIZE_STDDEV;
   defaultSettings["event/monte_carlo_file_type"] = DEFAULT_EVENT_MONTE_CARLO_FILE_TYPE;
+  defaultSettings["event/monte_carlo_prefetch_depth"] = DEFAULT_EVENT_MONTE_CARLO_PREFETCH_DEPTH;
   defaultSettings["event/qed_noise_path"] = DEFAULT_EVENT_QED_NOISE_PATH;
   defaultSettings["event/qed_noise_input"] = DEFAULT_EVENT_QED_NOISE_INPUT;
   defaultSettings["event/qed_noise_feed_rate_ns"] = DEFAULT_EVENT_QED_NOISE_FEED_RATE_NS;
@@ -132,6 +146,8 @@ void setDefaultSimSettings(QSettings *readoutSimSettings) {
   defaultSettings["event/strobe_inactive_length_ns"] = DEFAULT_EVENT_STROBE_INACTIVE_LENGTH_NS;
   ///@todo Rename to average_trigger_rate_ns?
   defaultSettings["event/average_event_rate_ns"] = DEFAULT_EVENT_AVERAGE_EVENT_RATE_NS;
+  defaultSettings["event/event_stream_mode"] = DEFAULT_EVENT_EVENT_STREAM_MODE;
+  defaultSettings["event/event_stream_file"] = DEFAULT_EVENT_EVENT_STREAM_FILE;
 
   QStringList simSettingsKeys = readoutSimSettings->allKeys();
 
@@ -24,6 +24,7 @@
 #define DEFAULT_DATA_OUTPUT_WRITE_VCD_CLOCK "false"
 #define DEFAULT_DATA_OUTPUT_WRITE_EVENT_CSV "true"
 #define DEFAULT_DATA_OUTPUT_DATA_RATE_INTERVAL_NS "10000"
+#define DEFAULT_DATA_OUTPUT_TELEMETRY_INTERVAL_NS "1000000"
 
 #define DEFAULT_SIMULATION_TYPE "its"
 #define DEFAULT_SIMULATION_SINGLE_CHIP "true"
@@ -31,6 +32,12 @@
 #define DEFAULT_SIMULATION_SYSTEM_CONTINUOUS_MODE "false"
 #define DEFAULT_SIMULATION_SYSTEM_CONTINUOUS_PERIOD_NS "5000"
 #define DEFAULT_SIMULATION_RANDOM_SEED "0"
+#define DEFAULT_SIMULATION_SHARD_COUNT "1"
+#define DEFAULT_SIMULATION_SHARD_INDEX "0"
+#define DEFAULT_SIMULATION_THREADS "0"
+#define DEFAULT_SIMULATION_LOG_LEVEL "info"
+#define DEFAULT_SIMULATION_LOG_MODULE_LEVELS ""
+#define DEFAULT_SIMULATION_LOG_PROGRESS_INTERVAL_MS "1000"
 
 #define DEFAULT_ALPIDE_DATA_LONG_ENABLE "true"
 #define DEFAULT_ALPIDE_DTU_DELAY "10"
@@ -40,6 +47,12 @@
 #define DEFAULT_ALPIDE_STROBE_EXTENSION_ENABLE "false"
 #define DEFAULT_ALPIDE_MINIMUM_BUSY_CYCLES "8"
 #define DEFAULT_ALPIDE_CHIP_CONTINUOUS_MODE "false"
+#define DEFAULT_ALPIDE_CLOCK_SKIPPING_ENABLE "false"
+#define DEFAULT_ALPIDE_FRAME_MODEL_LAYERS ""
+#define DEFAULT_ALPIDE_FRAME_MODEL_VALIDATION "false"
+#define DEFAULT_ALPIDE_HYBRID_MODEL_LAYERS ""
+#define DEFAULT_ALPIDE_HYBRID_MEB_THRESHOLD "2"
+#define DEFAULT_ALPIDE_HYBRID_FRAME_FIFO_THRESHOLD "4"
 
 #define DEFAULT_ITS_LAYER0_NUM_STAVES "12"
 #define DEFAULT_ITS_LAYER1_NUM_STAVES "16"
@@ -81,6 +94,7 @@
 #define DEFAULT_EVENT_RANDOM_CLUSTER_SIZE_MEAN "4"
 #define DEFAULT_EVENT_RANDOM_CLUSTER_SIZE_STDDEV "2"
 #define DEFAULT_EVENT_MONTE_CARLO_FILE_TYPE "xml"
+#define DEFAULT_EVENT_MONTE_CARLO_PREFETCH_DEPTH "8"
 #define DEFAULT_EVENT_QED_NOISE_PATH "config/monte_carlo_events/QED"
 #define DEFAULT_EVENT_QED_NOISE_INPUT "false"
 #define DEFAULT_EVENT_QED_NOISE_FEED_RATE_NS "250"
@@ -91,6 +105,8 @@
 #define DEFAULT_EVENT_STROBE_ACTIVE_LENGTH_NS "100"
 #define DEFAULT_EVENT_STROBE_INACTIVE_LENGTH_NS "100"
 #define DEFAULT_EVENT_AVERAGE_EVENT_RATE_NS "2500"
+#define DEFAULT_EVENT_EVENT_STREAM_MODE "off"
+#define DEFAULT_EVENT_EVENT_STREAM_FILE "event_stream.dat"
 
 QSettings *getSimSettings(const char *fileName = "config/settings.txt");
 void setDefaultSimSettings(QSettings *readoutSimSettings);
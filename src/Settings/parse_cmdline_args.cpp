@@ -67,6 +67,20 @@ QSettings* parseCommandLine(QCommandLineParser &parser,
                                             "Use 0 to generate high-entropy random value for seed",
                                             "seed");
 
+  const QCommandLineOption shardIndexOption({"shard", "shard_index"},
+                                            "Index of detector shard to simulate (ITS only).",
+                                            "index");
+
+  const QCommandLineOption shardCountOption({"shards", "shard_count"},
+                                            "Number of shards the detector is split into (ITS only). "
+                                            "Each shard is simulated by a separate process.",
+                                            "count");
+
+  const QCommandLineOption threadsOption({"t", "threads"},
+                                         "Number of threads for parallel evaluation of the chips. "
+                                         "0 and 1 both use the SystemC thread only.",
+                                         "threads");
+
   const QCommandLineOption layer0HitDensityOption({"l0", "layer0_hit_density"},
                                                   "Hit density [cm^-2] in layer 0 (or single chip mode).",
                                                   "density");
@@ -118,6 +132,16 @@ QSettings* parseCommandLine(QCommandLineParser &parser,
                                                       "Strobe inactive time (in nanoseconds).",
                                                       "inactive time");
 
+  const QCommandLineOption pregenerateOption({"pregenerate", "pregenerate_events"},
+                                             "Only generate events, and write them to an event "
+                                             "stream file. The detector is not simulated.",
+                                             "event_stream_file");
+
+  const QCommandLineOption replayOption({"replay", "replay_events"},
+                                        "Read events from an event stream file created with "
+                                        "--pregenerate, instead of generating them.",
+                                        "event_stream_file");
+
   const QCommandLineOption verboseOption({"V", "verbose"}, "Enable verbose output.");
 
   const QCommandLineOption outputDirPrefixOption({"o", "output_dir_prefix"},
@@ -138,6 +162,9 @@ QSettings* parseCommandLine(QCommandLineParser &parser,
   parser.addOption(systemModeOption);
   parser.addOption(chipModeOption);
   parser.addOption(randomSeedOption);
+  parser.addOption(shardIndexOption);
+  parser.addOption(shardCountOption);
+  parser.addOption(threadsOption);
   parser.addOption(layer0HitDensityOption);
   parser.addOption(layer1HitDensityOption);
   parser.addOption(layer2HitDensityOption);
@@ -151,6 +178,8 @@ QSettings* parseCommandLine(QCommandLineParser &parser,
   parser.addOption(triggerFilterOption);
   parser.addOption(strobeActiveLengthOption);
   parser.addOption(strobeInactiveLengthOption);
+  parser.addOption(pregenerateOption);
+  parser.addOption(replayOption);
   parser.addOption(verboseOption);
   parser.addOption(outputDirPrefixOption);
 
@@ -248,6 +277,39 @@ QSettings* parseCommandLine(QCommandLineParser &parser,
       }
     }
 
+    if(parser.isSet(shardIndexOption)) {
+      parser.value(shardIndexOption).toUInt(&conversion_ok, 10);
+
+      if(conversion_ok == false) {
+        std::cout << "Error parsing shard index." << std::endl;
+        start_program = false;
+      } else {
+        settings->setValue("simulation/shard_index", parser.value(shardIndexOption));
+      }
+    }
+
+    if(parser.isSet(shardCountOption)) {
+      unsigned int shard_count = parser.value(shardCountOption).toUInt(&conversion_ok, 10);
+
+      if(conversion_ok == false || shard_count == 0) {
+        std::cout << "Error parsing shard count." << std::endl;
+        start_program = false;
+      } else {
+        settings->setValue("simulation/shard_count", parser.value(shardCountOption));
+      }
+    }
+
+    if(parser.isSet(threadsOption)) {
+      parser.value(threadsOption).toUInt(&conversion_ok, 10);
+
+      if(conversion_ok == false) {
+        std::cout << "Error parsing number of threads." << std::endl;
+        start_program = false;
+      } else {
+        settings->setValue("simulation/threads", parser.value(threadsOption));
+      }
+    }
+
     if(parser.isSet(layer0HitDensityOption)) {
       parser.value(layer0HitDensityOption).toDouble(&conversion_ok);
 
@@ -389,6 +451,17 @@ QSettings* parseCommandLine(QCommandLineParser &parser,
     else
       settings->setValue("verbose", "false");
 
+    if(parser.isSet(pregenerateOption) && parser.isSet(replayOption)) {
+      std::cout << "Error: Can not pregenerate and replay events at the same time." << std::endl;
+      start_program = false;
+    } else if(parser.isSet(pregenerateOption)) {
+      settings->setValue("event/event_stream_mode", "pregenerate");
+      settings->setValue("event/event_stream_file", parser.value(pregenerateOption));
+    } else if(parser.isSet(replayOption)) {
+      settings->setValue("event/event_stream_mode", "replay");
+      settings->setValue("event/event_stream_file", parser.value(replayOption));
+    }
+
     if(parser.isSet(outputDirPrefixOption)) {
       if(parser.value(outputDirPrefixOption).length() == 0) {
         std::cout << "Error parsing output directory prefix." << std::endl;
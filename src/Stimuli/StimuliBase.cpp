@@ -8,6 +8,29 @@
 #include "StimuliBase.hpp"
 #include <iostream>
 
+
+///@brief Parse a semicolon delimited list of layers, eg. "3;4;5;6"
+///@param[in] layers_str String with list of layers
+///@return Vector with the layer numbers
+static std::vector<unsigned int> parseLayerList(std::string layers_str)
+{
+  std::vector<unsigned int> layers;
+
+  while(layers_str.length() > 0) {
+    std::string::size_type delim_pos = layers_str.find(";");
+    std::string layer_str = layers_str.substr(0, delim_pos);
+
+    layers.push_back(std::stoi(layer_str));
+
+    if(delim_pos == std::string::npos)
+      layers_str.erase(0);
+    else
+      layers_str.erase(0, delim_pos+1);
+  }
+
+  return layers;
+}
+
 ///@brief Constructor for stimuli base class.
 ///@param[in] settings QSettings object with simulation settings.
 ///@param[in] output_path Path to store output files generated by the StimuliBase class
@@ -15,6 +38,7 @@ StimuliBase::StimuliBase(sc_core::sc_module_name name,
                          QSettings* settings,
                          std::string output_path)
   : sc_core::sc_module(name)
+  , mEventProgress(LOG_MODULE_SIM, "Physics event number")
 {
   mOutputPath = output_path;
 
@@ -29,6 +53,8 @@ StimuliBase::StimuliBase(sc_core::sc_module_name name,
   mTriggerFilterTimeNs = settings->value("event/trigger_filter_time_ns").toUInt();
   mTriggerFilterEnabled = settings->value("event/trigger_filter_enable").toBool();
   mDataRateIntervalNs = settings->value("data_output/data_rate_interval_ns").toUInt();
+  mNumThreads = settings->value("simulation/threads").toUInt();
+  mTelemetryIntervalNs = settings->value("data_output/telemetry_interval_ns").toULongLong();
 
   mChipCfg.dtu_delay_cycles = settings->value("alpide/dtu_delay").toUInt();
   mChipCfg.strobe_length_ns = mStrobeActiveNs;
@@ -37,6 +63,18 @@ StimuliBase::StimuliBase(sc_core::sc_module_name name,
   mChipCfg.data_long_en = settings->value("alpide/data_long_enable").toBool();
   mChipCfg.chip_continuous_mode = settings->value("alpide/chip_continuous_mode").toBool();
   mChipCfg.matrix_readout_speed = settings->value("alpide/matrix_readout_speed_fast").toBool();
+  mChipCfg.clock_skipping = settings->value("alpide/clock_skipping_enable").toBool();
+  mChipCfg.frame_model_validation = settings->value("alpide/frame_model_validation").toBool();
+
+  mChipCfg.hybrid_meb_threshold = settings->value("alpide/hybrid_meb_threshold").toUInt();
+  mChipCfg.hybrid_frame_fifo_threshold = settings->value("alpide/hybrid_frame_fifo_threshold").toUInt();
+
+  // The frame level and hybrid models are selected per layer, see setFrameModelLayers()
+  mChipCfg.frame_model = false;
+  mChipCfg.hybrid_model = false;
+
+  mFrameModelLayers = parseLayerList(settings->value("alpide/frame_model_layers").toString().toStdString());
+  mHybridModelLayers = parseLayerList(settings->value("alpide/hybrid_model_layers").toString().toStdString());
 
   if((mStrobeActiveNs+mStrobeInactiveNs) > mSystemContinuousPeriodNs) {
     std::string error_msg = "Alpide strobe active + inactive time > system continuous period.";
@@ -51,6 +89,7 @@ StimuliBase::StimuliBase(sc_core::sc_module_name name,
   std::cout << "Single chip simulation: " << (mSingleChipSimulation ? "true" : "false") << std::endl;
   std::cout << "System continuous mode: " << (mSystemContinuousMode ? "continuous" : "triggered") << std::endl;
   std::cout << "System continuous period: " << mSystemContinuousPeriodNs << std::endl;
+  std::cout << "Threads: " << mNumThreads << std::endl;
   std::cout << "Chip continuous mode: " << (mChipCfg.chip_continuous_mode ? "continuous" : "triggered") << std::endl;
   std::cout << "Strobe active time (ns): " << mStrobeActiveNs << std::endl;
   std::cout << "Strobe inactive time (ns): " << mStrobeInactiveNs << std::endl;
@@ -62,11 +101,84 @@ StimuliBase::StimuliBase(sc_core::sc_module_name name,
   std::cout << "Matrix readout speed fast: " << (mChipCfg.matrix_readout_speed ? "true" : "false") << std::endl;
   std::cout << "Strobe extension enabled: " << (mChipCfg.strobe_extension ? "true" : "false") << std::endl;
   std::cout << "Minimum busy cycles: " << mChipCfg.min_busy_cycles << std::endl;
+  std::cout << "Clock skipping enabled: " << (mChipCfg.clock_skipping ? "true" : "false") << std::endl;
+  std::cout << "Frame model layers: ";
+  for(auto it = mFrameModelLayers.begin(); it != mFrameModelLayers.end(); it++)
+    std::cout << (it == mFrameModelLayers.begin() ? "" : ";") << *it;
+  std::cout << std::endl;
+  std::cout << "Frame model validation: " << (mChipCfg.frame_model_validation ? "true" : "false") << std::endl;
+  std::cout << "Hybrid model layers: ";
+  for(auto it = mHybridModelLayers.begin(); it != mHybridModelLayers.end(); it++)
+    std::cout << (it == mHybridModelLayers.begin() ? "" : ";") << *it;
+  std::cout << std::endl;
+  std::cout << "Hybrid model MEB threshold: " << mChipCfg.hybrid_meb_threshold << std::endl;
+  std::cout << "Hybrid model frame FIFO threshold: " << mChipCfg.hybrid_frame_fifo_threshold << std::endl;
   std::cout << "Data rate interval (ns): " << mDataRateIntervalNs << std::endl;
+  std::cout << "Telemetry interval (ns): " << mTelemetryIntervalNs << std::endl;
 
 
   if(mDataRateIntervalNs == 0) {
     std::string error_msg = "Data rate interval can not be zero.";
     throw std::runtime_error(error_msg);
   }
+
+  // Also created for threads=0, where it does not start any worker threads. The chips
+  // then latch their hits on the falling clock edge like they do with parallel evaluation,
+  // and the output is the same for any number of threads.
+  mParallelEvaluator = std::unique_ptr<ParallelChipEvaluator>(
+    new ParallelChipEvaluator("parallel_chip_evaluator", mNumThreads));
+  mParallelEvaluator->s_system_clk_in(clock);
+}
+
+
+///@brief Select the frame level Alpide model for the layers in mFrameModelLayers, and the
+///       hybrid model for the layers in mHybridModelLayers
+///@param[in,out] config Detector configuration
+///@throw runtime_error If a layer is not in the detector configuration
+void StimuliBase::setFrameModelLayers(Detector::DetectorConfigBase& config) const
+{
+  for(auto it = mFrameModelLayers.begin(); it != mFrameModelLayers.end(); it++) {
+    if(*it >= config.layer.size()) {
+      std::string error_msg = "Frame model layer " + std::to_string(*it) + " does not exist.";
+      throw std::runtime_error(error_msg);
+    }
+
+    config.layer[*it].frame_model = true;
+  }
+
+  for(auto it = mHybridModelLayers.begin(); it != mHybridModelLayers.end(); it++) {
+    if(*it >= config.layer.size()) {
+      std::string error_msg = "Hybrid model layer " + std::to_string(*it) + " does not exist.";
+      throw std::runtime_error(error_msg);
+    }
+
+    config.layer[*it].hybrid_model = true;
+  }
+}
+
+
+///@brief Create the telemetry sampler, unless telemetry is disabled (interval is zero).
+///       Called by the derived classes when the chips have been created.
+///@param[in] chips All the chips in the simulation
+///@param[in] event_count_func Function that returns the number of events simulated so far
+void StimuliBase::createTelemetry(const std::vector<std::shared_ptr<Alpide>>& chips,
+                                  std::function<uint64_t(void)> event_count_func)
+{
+  if(mTelemetryIntervalNs > 0) {
+    mTelemetry = std::unique_ptr<SimulationTelemetry>(
+      new SimulationTelemetry("telemetry", mOutputPath, mTelemetryIntervalNs,
+                              chips, event_count_func));
+  }
+}
+
+
+///@brief Called by SystemC when the simulation has been stopped, after the last delta cycle
+///       has completed. Data words that are still queued in the chips are released first,
+///       so that their pixels are counted as not read out in the readout stats.
+void StimuliBase::end_of_simulation(void)
+{
+  for(auto it = mChips.begin(); it != mChips.end(); it++)
+    (*it)->releaseQueuedPixelRefs();
+
+  writeSimulationStats();
 }
@@ -19,7 +19,15 @@
 #pragma GCC diagnostic pop
 
 #include <QSettings>
+#include "Alpide/Alpide.hpp"
 #include "Alpide/AlpideConfig.hpp"
+#include "Alpide/ParallelChipEvaluator.hpp"
+#include "Detector/Common/DetectorConfig.hpp"
+#include "Log/Log.hpp"
+#include "Profiling/SimulationTelemetry.hpp"
+#include <functional>
+#include <memory>
+#include <vector>
 
 class StimuliBase : public sc_core::sc_module
 {
@@ -45,9 +53,39 @@ protected:
 
   AlpideConfig mChipCfg;
 
+  ///@brief Number of threads for parallel evaluation of the chips. 0 and 1 both mean
+  ///       that the chips are evaluated by the SystemC thread only.
+  unsigned int mNumThreads;
+
+  ///@brief Created before the detector, so that the chips can find it
+  std::unique_ptr<ParallelChipEvaluator> mParallelEvaluator;
+
+  ///@brief Rate limited progress messages for the event count
+  LogProgress mEventProgress;
+
+  ///@brief Simulated time between telemetry samples, 0 if telemetry is disabled
+  uint64_t mTelemetryIntervalNs;
+
+  std::unique_ptr<SimulationTelemetry> mTelemetry;
+
+  ///@brief All the chips in the simulation
+  std::vector<std::shared_ptr<Alpide>> mChips;
+
+  ///@brief Layers where the chips use the frame level Alpide model
+  std::vector<unsigned int> mFrameModelLayers;
+
+  ///@brief Layers where the chips use the hybrid frame level/cycle accurate Alpide model
+  std::vector<unsigned int> mHybridModelLayers;
+
+  void setFrameModelLayers(Detector::DetectorConfigBase& config) const;
+  void createTelemetry(const std::vector<std::shared_ptr<Alpide>>& chips,
+                       std::function<uint64_t(void)> event_count_func);
+  virtual void writeSimulationStats(void) const = 0;
+
 public:
   StimuliBase(sc_core::sc_module_name name, QSettings* settings, std::string output_path);
   virtual void addTraces(sc_trace_file *wf) const = 0;
+  void end_of_simulation(void);
 };
 
 
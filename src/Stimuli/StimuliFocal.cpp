@@ -7,6 +7,7 @@
 
 #include "StimuliFocal.hpp"
 #include "Detector/Common/DetectorSimulationStats.hpp"
+#include "Profiling/ProcessProfiler.hpp"
 
 // Ignore warnings about use of auto_ptr and unused parameters in SystemC library
 #pragma GCC diagnostic push
@@ -42,6 +43,7 @@ StimuliFocal::StimuliFocal(sc_core::sc_module_name name, QSettings* settings, st
   // Initialize detector configuration for Focal.
   Focal::FocalDetectorConfig config(staves_per_quadrant);
   config.chip_cfg = mChipCfg;
+  setFrameModelLayers(config);
 
   // Focal uses same event generator as ITS
   mEventGen = std::move(std::unique_ptr<EventGenITS>(new EventGenITS("event_gen",
@@ -56,6 +58,11 @@ StimuliFocal::StimuliFocal(sc_core::sc_module_name name, QSettings* settings, st
                                                                                     mDataRateIntervalNs)));
   mFocal->s_system_clk_in(clock);
   mFocal->s_detector_busy_out(s_focal_busy);
+  mFocal->openEventLogs(mOutputPath);
+
+  mChips = mFocal->getChips();
+
+  createTelemetry(mChips, [this]{return mEventGen->getTriggeredEventCount();});
 
   s_physics_event = false;
 
@@ -82,32 +89,38 @@ StimuliFocal::StimuliFocal(sc_core::sc_module_name name, QSettings* settings, st
 ///@brief Main control of simulation stimuli
 void StimuliFocal::stimuliMainMethod(void)
 {
+  PROFILE_PROCESS("StimuliFocal::stimuliMainMethod");
+
   if(simulation_done == true || g_terminate_program == true) {
     int64_t time_now = sc_time_stamp().value();
-    std::cout << "@ " << time_now << " ns: \tSimulation done" << std::endl;
+    mEventProgress.update(mEventGen->getTriggeredEventCount(), time_now, true);
+    LOG(LOG_INFO, LOG_MODULE_SIM) << "@ " << time_now << " ns: \tSimulation done";
+
+    // The stats below are printed directly to stdout
+    Log::flush();
+
+    if(mTelemetry)
+      mTelemetry->writeSample();
 
     sc_core::sc_stop();
 
+    // The simulation stats are written by end_of_simulation()
     writeStimuliInfo();
-    mFocal->writeSimulationStats(mOutputPath);
-    mEventGen->writeSimulationStats(mOutputPath);
   }
   // We want to stop at n_events, not n_events-1.
   else if(mEventGen->getTriggeredEventCount() <= mNumEvents) {
-    //if((mEventGen->getPhysicsEventCount() % 100) == 0) {
     int64_t time_now = sc_time_stamp().value();
-    std::cout << "@ " << time_now << " ns: \tPhysics event number ";
-    std::cout << mEventGen->getTriggeredEventCount() << std::endl;
-    //}
+    mEventProgress.update(mEventGen->getTriggeredEventCount(), time_now);
 
-    std::cout << "Feeding " << mEventGen->getTriggeredEvent().size() << " pixels to Focal detector." << std::endl;
+    LOG(LOG_DEBUG, LOG_MODULE_SIM) << "Feeding " << mEventGen->getTriggeredEvent().size()
+                                   << " pixels to Focal detector.";
     // Get hits for this event, and "feed" them to the Focal detector
     auto event_hits = mEventGen->getTriggeredEvent();
 
     for(auto it = event_hits.begin(); it != event_hits.end(); it++)
       mFocal->pixelInput(*it);
 
-    std::cout << "Creating event for next trigger.." << std::endl;
+    LOG(LOG_DEBUG, LOG_MODULE_SIM) << "Creating event for next trigger..";
 
     if(mSystemContinuousMode == false) {
       // Create an event for the next trigger, delayed by the
@@ -132,6 +145,8 @@ void StimuliFocal::stimuliMainMethod(void)
 ///       not associated with a trigger to the ALPIDE chips.
 void StimuliFocal::stimuliQedNoiseEventMethod(void)
 {
+    PROFILE_PROCESS("StimuliFocal::stimuliQedNoiseEventMethod");
+
     // Get hits for this event, and "feed" them to the ITS detector
     auto event_hits = mEventGen->getUntriggeredEvent();
 
@@ -157,6 +172,8 @@ void StimuliFocal::stimuliQedNoiseEventMethod(void)
 ///       in the chip.
 void StimuliFocal::continuousTriggerMethod(void)
 {
+  PROFILE_PROCESS("StimuliFocal::continuousTriggerMethod");
+
   if(mSingleChipSimulation)
     mReadoutUnit->E_trigger_in.notify(mTriggerDelayNs, SC_NS);
   else
@@ -171,6 +188,8 @@ void StimuliFocal::continuousTriggerMethod(void)
 ///       so that we can have a signal for this that we can add to the trace file.
 void StimuliFocal::physicsEventSignalMethod(void)
 {
+  PROFILE_PROCESS("StimuliFocal::physicsEventSignalMethod");
+
   if(s_physics_event.read() == true) {
     s_physics_event.write(false);
     next_trigger(mEventGen->E_triggered_event);
@@ -197,6 +216,14 @@ void StimuliFocal::addTraces(sc_trace_file *wf) const
 }
 
 
+///@brief Write the simulation stats for the detector and the event generator
+void StimuliFocal::writeSimulationStats(void) const
+{
+  mFocal->writeSimulationStats(mOutputPath);
+  mEventGen->writeSimulationStats(mOutputPath);
+}
+
+
 void StimuliFocal::writeStimuliInfo(void) const
 {
   std::string info_filename = mOutputPath + std::string("/simulation_info.txt");
@@ -45,6 +45,7 @@ private:
   void continuousTriggerMethod(void);
   void physicsEventSignalMethod(void);
   void writeStimuliInfo(void) const;
+  void writeSimulationStats(void) const;
 public:
   StimuliFocal(sc_core::sc_module_name name, QSettings* settings, std::string output_path);
   void addTraces(sc_trace_file *wf) const;
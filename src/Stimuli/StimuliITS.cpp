@@ -7,6 +7,7 @@
 
 #include "StimuliITS.hpp"
 #include "Detector/Common/DetectorSimulationStats.hpp"
+#include "Profiling/ProcessProfiler.hpp"
 
 // Ignore warnings about use of auto_ptr and unused parameters in SystemC library
 #pragma GCC diagnostic push
@@ -83,13 +84,39 @@ StimuliITS::StimuliITS(sc_core::sc_module_name name, QSettings* settings, std::s
   config.layer[5].num_staves = settings->value("its/layer5_num_staves").toUInt();
   config.layer[6].num_staves = settings->value("its/layer6_num_staves").toUInt();
   config.chip_cfg = mChipCfg;
+  setFrameModelLayers(config);
+
+  // The event generator always generates hits for all the staves in the configuration,
+  // also when only a shard of the detector is simulated. With a fixed random seed, all
+  // the shards then see exactly the same events and triggers.
+  config.shard_count = settings->value("simulation/shard_count").toUInt();
+  config.shard_index = settings->value("simulation/shard_index").toUInt();
+
+  std::cout << "Shard index: " << config.shard_index << std::endl;
+  std::cout << "Shard count: " << config.shard_count << std::endl;
+
+  if(config.shard_count > 1) {
+    if(mSingleChipSimulation) {
+      std::string error_msg = "Sharding is not supported for single chip simulations.";
+      throw std::runtime_error(error_msg);
+    }
+    if(settings->value("simulation/random_seed").toInt() == 0) {
+      std::string error_msg = "Sharded simulations require a fixed (nonzero) random seed.";
+      throw std::runtime_error(error_msg);
+    }
+  }
 
   mEventGen = std::move(std::unique_ptr<EventGenITS>(new EventGenITS("event_gen",
                                                                      config,
                                                                      settings,
                                                                      mOutputPath)));
 
-  if(mSingleChipSimulation) {
+  mPregenerateEvents = settings->value("event/event_stream_mode").toString() == "pregenerate";
+
+  if(mPregenerateEvents) {
+    std::cout << "Pregenerating events only, detector is not simulated." << std::endl;
+  }
+  else if(mSingleChipSimulation) {
     mAlpide = std::move(std::unique_ptr<ITS::SingleChip>(new ITS::SingleChip("SingleChip",
                                                                              0,
                                                                              mChipCfg)));
@@ -120,11 +147,22 @@ StimuliITS::StimuliITS(sc_core::sc_module_name name, QSettings* settings, std::s
                                                                             mDataRateIntervalNs)));
     mITS->s_system_clk_in(clock);
     mITS->s_detector_busy_out(s_its_busy);
+
+    // Hits are never read out when pregenerating events, so there are no events to log
+    if(mPregenerateEvents == false)
+      mITS->openEventLogs(mOutputPath);
   }
 
+  if(mAlpide)
+    mChips = mAlpide->getChips();
+  else if(mITS)
+    mChips = mITS->getChips();
+
+  createTelemetry(mChips, [this]{return mEventGen->getTriggeredEventCount();});
+
   s_physics_event = false;
 
-  if(mSystemContinuousMode == true) {
+  if(mSystemContinuousMode == true && mPregenerateEvents == false) {
     SC_METHOD(continuousTriggerMethod);
   }
 
@@ -147,46 +185,42 @@ StimuliITS::StimuliITS(sc_core::sc_module_name name, QSettings* settings, std::s
 ///@brief Main control of simulation stimuli
 void StimuliITS::stimuliMainMethod(void)
 {
+  PROFILE_PROCESS("StimuliITS::stimuliMainMethod");
+
   if(simulation_done == true || g_terminate_program == true) {
     int64_t time_now = sc_time_stamp().value();
-    std::cout << "@ " << time_now << " ns: \tSimulation done" << std::endl;
-
-    sc_core::sc_stop();
+    mEventProgress.update(mEventGen->getTriggeredEventCount(), time_now, true);
+    LOG(LOG_INFO, LOG_MODULE_SIM) << "@ " << time_now << " ns: \tSimulation done";
 
-    writeStimuliInfo();
+    // The stats below are printed directly to stdout
+    Log::flush();
 
-    if(mSingleChipSimulation) {
-      std::map<unsigned int, std::shared_ptr<Alpide>> chip_map;
+    if(mTelemetry)
+      mTelemetry->writeSample();
 
-      // The writeAlpideStatsToFile function expects a map of chip ids vs chip objects
-      chip_map[mAlpide->getChips()[0]->getGlobalChipId()] = mAlpide->getChips()[0];
-
-      Detector::writeAlpideStatsToFile(mOutputPath,
-                                       chip_map,
-                                       &ITS::ITS_global_chip_id_to_position);
-    } else {
-      mITS->writeSimulationStats(mOutputPath);
-    }
+    sc_core::sc_stop();
 
-    mEventGen->writeSimulationStats(mOutputPath);
+    // The simulation stats are written by end_of_simulation()
+    writeStimuliInfo();
   }
   // We want to stop at n_events, not n_events-1.
   else if(mEventGen->getTriggeredEventCount() <= mNumEvents) {
-    //if((mEventGen->getPhysicsEventCount() % 100) == 0) {
     int64_t time_now = sc_time_stamp().value();
-    std::cout << "@ " << time_now << " ns: \tPhysics event number ";
-    std::cout << mEventGen->getTriggeredEventCount() << std::endl;
-    //}
+    mEventProgress.update(mEventGen->getTriggeredEventCount(), time_now);
 
-    std::cout << "Feeding " << mEventGen->getTriggeredEvent().size() << " pixels to ITS detector." << std::endl;
+    LOG(LOG_DEBUG, LOG_MODULE_SIM) << "Feeding " << mEventGen->getTriggeredEvent().size()
+                                   << " pixels to ITS detector.";
     // Get hits for this event, and "feed" them to the ITS detector
     auto event_hits = mEventGen->getTriggeredEvent();
 
-    if(mSingleChipSimulation) {
+    if(mPregenerateEvents) {
+      // Event was written to event stream file by the event generator
+    }
+    else if(mSingleChipSimulation) {
       for(auto it = event_hits.begin(); it != event_hits.end(); it++)
         mAlpide->pixelInput(*it);
 
-      std::cout << "Creating event for next trigger.." << std::endl;
+      LOG(LOG_DEBUG, LOG_MODULE_SIM) << "Creating event for next trigger..";
 
       if(mSystemContinuousMode == false) {
         // Create an event for the next trigger, delayed by the
@@ -198,7 +232,7 @@ void StimuliITS::stimuliMainMethod(void)
       for(auto it = event_hits.begin(); it != event_hits.end(); it++)
         mITS->pixelInput(*it);
 
-      std::cout << "Creating event for next trigger.." << std::endl;
+      LOG(LOG_DEBUG, LOG_MODULE_SIM) << "Creating event for next trigger..";
 
       if(mSystemContinuousMode == false) {
       // Create an event for the next trigger, delayed by the
@@ -224,10 +258,15 @@ void StimuliITS::stimuliMainMethod(void)
 ///       not associated with a trigger to the ALPIDE chips.
 void StimuliITS::stimuliQedNoiseEventMethod(void)
 {
+    PROFILE_PROCESS("StimuliITS::stimuliQedNoiseEventMethod");
+
     // Get hits for this event, and "feed" them to the ITS detector
     auto event_hits = mEventGen->getUntriggeredEvent();
 
-    if(mSingleChipSimulation) {
+    if(mPregenerateEvents) {
+      return;
+    }
+    else if(mSingleChipSimulation) {
       for(auto it = event_hits.begin(); it != event_hits.end(); it++)
         mAlpide->pixelInput(*it);
     }
@@ -249,6 +288,8 @@ void StimuliITS::stimuliQedNoiseEventMethod(void)
 ///       in the chip.
 void StimuliITS::continuousTriggerMethod(void)
 {
+  PROFILE_PROCESS("StimuliITS::continuousTriggerMethod");
+
   if(mSingleChipSimulation)
     mReadoutUnit->E_trigger_in.notify(mTriggerDelayNs, SC_NS);
   else
@@ -263,6 +304,8 @@ void StimuliITS::continuousTriggerMethod(void)
 ///       so that we can have a signal for this that we can add to the trace file.
 void StimuliITS::physicsEventSignalMethod(void)
 {
+  PROFILE_PROCESS("StimuliITS::physicsEventSignalMethod");
+
   if(s_physics_event.read() == true) {
     s_physics_event.write(false);
     next_trigger(mEventGen->E_triggered_event);
@@ -280,7 +323,10 @@ void StimuliITS::addTraces(sc_trace_file *wf) const
   sc_trace(wf, s_physics_event, "PHYSICS_EVENT");
   sc_trace(wf, s_its_busy, "its_busy");
 
-  if(mSingleChipSimulation) {
+  if(mPregenerateEvents) {
+    return;
+  }
+  else if(mSingleChipSimulation) {
     sc_trace(wf, s_alpide_data_line, "alpide_data_line");
     mAlpide->addTraces(wf, "");
   } else {
@@ -289,6 +335,30 @@ void StimuliITS::addTraces(sc_trace_file *wf) const
 }
 
 
+///@brief Write the simulation stats for the detector/chip and the event generator
+void StimuliITS::writeSimulationStats(void) const
+{
+  // Hits are never read out when pregenerating events, so there are no stats to write
+  if(mPregenerateEvents)
+    return;
+
+  if(mSingleChipSimulation) {
+    std::map<unsigned int, std::shared_ptr<Alpide>> chip_map;
+
+    // The writeAlpideStatsToFile function expects a map of chip ids vs chip objects
+    chip_map[mAlpide->getChips()[0]->getGlobalChipId()] = mAlpide->getChips()[0];
+
+    Detector::writeAlpideStatsToFile(mOutputPath,
+                                     chip_map,
+                                     &ITS::ITS_global_chip_id_to_position);
+  } else {
+    mITS->writeSimulationStats(mOutputPath);
+  }
+
+  mEventGen->writeSimulationStats(mOutputPath);
+}
+
+
 void StimuliITS::writeStimuliInfo(void) const
 {
   std::string info_filename = mOutputPath + std::string("/simulation_info.txt");
@@ -32,6 +32,10 @@ private:
 private:
   std::unique_ptr<EventGenITS> mEventGen;
 
+  // Only generate events and write them to an event stream file,
+  // the detector is not simulated in this mode
+  bool mPregenerateEvents;
+
   // mITS is only used for detector simulation
   std::unique_ptr<ITS::ITSDetector> mITS;
 
@@ -45,6 +49,7 @@ private:
   void continuousTriggerMethod(void);
   void physicsEventSignalMethod(void);
   void writeStimuliInfo(void) const;
+  void writeSimulationStats(void) const;
 public:
   StimuliITS(sc_core::sc_module_name name, QSettings* settings, std::string output_path);
   void addTraces(sc_trace_file *wf) const;
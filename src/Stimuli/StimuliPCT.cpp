@@ -7,6 +7,7 @@
 
 #include "StimuliPCT.hpp"
 #include "Detector/Common/DetectorSimulationStats.hpp"
+#include "Profiling/ProcessProfiler.hpp"
 
 // Ignore warnings about use of auto_ptr and unused parameters in SystemC library
 #pragma GCC diagnostic push
@@ -32,6 +33,8 @@ SC_HAS_PROCESS(StimuliPCT);
 StimuliPCT::StimuliPCT(sc_core::sc_module_name name, QSettings* settings, std::string output_path)
   : StimuliBase(name, settings, output_path)
 {
+  mEventProgress = LogProgress(LOG_MODULE_SIM, "Event frame number");
+
   std::cout << "Layers: ";
   std::cout << settings->value("pct/layers").toString().toStdString() << std::endl;
 
@@ -111,6 +114,7 @@ StimuliPCT::StimuliPCT(sc_core::sc_module_name name, QSettings* settings, std::s
   }
 
   config.chip_cfg = mChipCfg;
+  setFrameModelLayers(config);
 
   mEventGen = std::move(std::unique_ptr<EventGenPCT>(new EventGenPCT("event_gen",
                                                                      settings,
@@ -147,8 +151,13 @@ StimuliPCT::StimuliPCT(sc_core::sc_module_name name, QSettings* settings, std::s
                                                                             mDataRateIntervalNs)));
     mPCT->s_system_clk_in(clock);
     mPCT->s_detector_busy_out(s_pct_busy);
+    mPCT->openEventLogs(mOutputPath);
   }
 
+  mChips = mSingleChipSimulation ? mAlpide->getChips() : mPCT->getChips();
+
+  createTelemetry(mChips, [this]{return mEventGen->getUntriggeredEventCount();});
+
   SC_METHOD(triggerMethod);
 
   SC_METHOD(stimuliMethod);
@@ -160,58 +169,52 @@ StimuliPCT::StimuliPCT(sc_core::sc_module_name name, QSettings* settings, std::s
 ///@brief Main control of simulation stimuli
 void StimuliPCT::stimuliMethod(void)
 {
+  PROFILE_PROCESS("StimuliPCT::stimuliMethod");
+
   if(simulation_done == true) {
     uint64_t time_now = sc_time_stamp().value();
-    std::cout << "@ " << time_now << " ns: \tSimulation done" << std::endl;
-
-    sc_core::sc_stop();
+    mEventProgress.update(mEventGen->getUntriggeredEventCount(), time_now, true);
+    LOG(LOG_INFO, LOG_MODULE_SIM) << "@ " << time_now << " ns: \tSimulation done";
 
-    writeStimuliInfo();
-
-    if(mSingleChipSimulation) {
-      std::map<unsigned int, std::shared_ptr<Alpide>> chip_map;
+    // The stats below are printed directly to stdout
+    Log::flush();
 
-      // The writeAlpideStatsToFile function expects a map of chip ids vs chip objects
-      chip_map[mAlpide->getChips()[0]->getGlobalChipId()] = mAlpide->getChips()[0];
+    if(mTelemetry)
+      mTelemetry->writeSample();
 
-      Detector::writeAlpideStatsToFile(mOutputPath,
-                                       chip_map,
-                                       &PCT::PCT_global_chip_id_to_position);
-    } else {
-      mPCT->writeSimulationStats(mOutputPath);
-    }
+    sc_core::sc_stop();
 
-    mEventGen->writeSimulationStats(mOutputPath);
+    // The simulation stats are written by end_of_simulation()
+    writeStimuliInfo();
   }
   else {
     uint64_t time_now = sc_time_stamp().value();
-    std::cout << "@ " << time_now << " ns: \tEvent frame number ";
-    std::cout << mEventGen->getUntriggeredEventCount() << std::endl;
+    mEventProgress.update(mEventGen->getUntriggeredEventCount(), time_now);
 
     // Only print beam coords when we are generating random hits and
     // control the beam coords ourselves
     if(mRandomHitGen) {
-      std::cout << "\tBeam coords (mm): (";
-      std::cout << mEventGen->getBeamCenterCoordX() << ",";
-      std::cout << mEventGen->getBeamCenterCoordY() << ")" << std::endl;
+      LOG(LOG_DEBUG, LOG_MODULE_SIM) << "\tBeam coords (mm): ("
+                                     << mEventGen->getBeamCenterCoordX() << ","
+                                     << mEventGen->getBeamCenterCoordY() << ")";
     }
 
     // Get hits for this event, and "feed" them to the PCT detector
     auto event_hits = mEventGen->getUntriggeredEvent();
 
     if(mSingleChipSimulation) {
-      std::cout << "Feeding " << event_hits.size() << " pixels to Alpide chip." << std::endl;
+      LOG(LOG_DEBUG, LOG_MODULE_SIM) << "Feeding " << event_hits.size() << " pixels to Alpide chip.";
 
       for(auto it = event_hits.begin(); it != event_hits.end(); it++)
         mAlpide->pixelInput(*it);
     }
     else {
-      std::cout << "Feeding " << event_hits.size() << " pixels to PCT detector." << std::endl;
+      LOG(LOG_DEBUG, LOG_MODULE_SIM) << "Feeding " << event_hits.size() << " pixels to PCT detector.";
 
       for(auto it = event_hits.begin(); it != event_hits.end(); it++)
         mPCT->pixelInput(*it);
 
-      std::cout << "Creating event for next trigger.." << std::endl;
+      LOG(LOG_DEBUG, LOG_MODULE_SIM) << "Creating event for next trigger..";
     }
 
     if(mEventGen->getBeamEndCoordsReached() == true || g_terminate_program == true) {
@@ -231,6 +234,8 @@ void StimuliPCT::stimuliMethod(void)
 ///@brief SystemC method for generating triggers
 void StimuliPCT::triggerMethod(void)
 {
+  PROFILE_PROCESS("StimuliPCT::triggerMethod");
+
   if(mSingleChipSimulation)
     mReadoutUnit->E_trigger_in.notify(mTriggerDelayNs, SC_NS);
   else
@@ -256,6 +261,26 @@ void StimuliPCT::addTraces(sc_trace_file *wf) const
 }
 
 
+///@brief Write the simulation stats for the detector/chip and the event generator
+void StimuliPCT::writeSimulationStats(void) const
+{
+  if(mSingleChipSimulation) {
+    std::map<unsigned int, std::shared_ptr<Alpide>> chip_map;
+
+    // The writeAlpideStatsToFile function expects a map of chip ids vs chip objects
+    chip_map[mAlpide->getChips()[0]->getGlobalChipId()] = mAlpide->getChips()[0];
+
+    Detector::writeAlpideStatsToFile(mOutputPath,
+                                     chip_map,
+                                     &PCT::PCT_global_chip_id_to_position);
+  } else {
+    mPCT->writeSimulationStats(mOutputPath);
+  }
+
+  mEventGen->writeSimulationStats(mOutputPath);
+}
+
+
 void StimuliPCT::writeStimuliInfo(void) const
 {
   std::string info_filename = mOutputPath + std::string("/simulation_info.txt");
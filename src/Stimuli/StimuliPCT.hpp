@@ -44,6 +44,7 @@ private:
   void stimuliMethod(void);
   void triggerMethod(void);
   void writeStimuliInfo(void) const;
+  void writeSimulationStats(void) const;
 
 public:
   StimuliPCT(sc_core::sc_module_name name, QSettings* settings, std::string output_path);
@@ -0,0 +1,585 @@
+/**
+ * @file   alpide_benchmark.cpp
+ * @author Simon Voigt Nesbo
+ * @date   October 16, 2026
+ * @brief  Microbenchmarks for the pixel data structures, the cluster generation, the
+ *         Alpide data parser and the ITS binary event reader.
+ *
+ *         Each benchmark is run for a range of occupancies (pixel hits per chip per event),
+ *         from pp to central Pb-Pb with pileup. The hits are generated from a fixed seed,
+ *         so the input is the same for every run and every build. A benchmark is repeated
+ *         until it has run for at least the minimum time, and the time per iteration and
+ *         per pixel hit is reported.
+ *
+ *         Usage: alpide_benchmark [--json <file>] [--min-time-ms <ms>] [--filter <substring>]
+ *
+ *         --json:        Write the results to a JSON file, for comparing builds.
+ *         --min-time-ms: Minimum run time for each benchmark and occupancy (default 200 ms).
+ *         --filter:      Only run the benchmarks with names that contain the substring.
+ */
+
+#include "Alpide/AlpideDataWord.hpp"
+#include "Alpide/AlpideFrameModel.hpp"
+#include "Alpide/PixelDoubleColumn.hpp"
+#include "Alpide/PixelFrontEnd.hpp"
+#include "Alpide/PixelMatrix.hpp"
+#include "AlpideDataParser/AlpideDataParser.hpp"
+#include "Detector/ITS/ITSDetectorConfig.hpp"
+#include "Event/EventBinaryITS.hpp"
+#include "Event/EventBinaryITSFormat.hpp"
+#include "Event/EventGenBase.hpp"
+#include "Settings/Settings.hpp"
+#include "version.hpp"
+
+// Ignore warnings about use of auto_ptr and unused parameters in SystemC library
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#include <systemc.h>
+#pragma GCC diagnostic pop
+
+#include <QSettings>
+#include <QTemporaryDir>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace {
+
+///@brief Occupancy level for the benchmarks
+struct Occupancy {
+  const char* name;
+
+  ///@brief Pixel hits per chip per event
+  unsigned int hits_per_chip;
+};
+
+///@brief Approximate number of pixel hits per chip per event (or strobe) in ITS layer 0,
+///       for the collision systems the simulation is used for. The hits are in clusters
+///       of 4 pixels, which is close to the average cluster size in the ALPIDE.
+const Occupancy OCCUPANCIES[] = {
+  {"pp", 4},
+  {"pPb", 20},
+  {"PbPb_minbias", 150},
+  {"PbPb_central", 600},
+  {"PbPb_central_pileup", 2000}
+};
+
+/// Seed for the pixel hit coordinates, fixed so that all runs use the same input
+const unsigned int BENCHMARK_SEED = 1234;
+
+/// Number of different events used as input, to avoid benchmarking one event only
+const unsigned int BENCHMARK_NUM_EVENTS = 8;
+
+/// Time between events in the benchmarks that need a simulation time
+const uint64_t BENCHMARK_EVENT_SPACING_NS = 1000;
+
+/// Number of staves and chips per stave in ITS layer 0, used for the binary event file
+const unsigned int BENCHMARK_LAYER0_STAVES = 12;
+const unsigned int BENCHMARK_LAYER0_CHIPS_PER_STAVE = 9;
+
+struct BenchmarkResult {
+  std::string name;
+  std::string occupancy;
+  unsigned int hits_per_iteration;
+  uint64_t iterations;
+  double ns_per_iteration;
+};
+
+std::chrono::milliseconds sMinTime(200);
+std::string sFilter;
+
+/// Sum of values from the benchmarks, printed at the end so that the compiler
+/// can not optimize away the work that is benchmarked
+uint64_t sChecksum = 0;
+
+typedef std::vector<std::pair<unsigned int, unsigned int>> HitList;
+
+
+///@brief Generate pixel hit coordinates for the events, in clusters of 2x2 pixels at
+///       random positions in the matrix. A cluster may be cut short at the end of the event.
+///@param[in] hits_per_chip Number of pixel hits per event
+///@return Vector with one list of (col, row) coordinates per event
+std::vector<HitList> generateEvents(unsigned int hits_per_chip)
+{
+  boost::random::mt19937 rand_gen(BENCHMARK_SEED);
+  boost::random::uniform_int_distribution<unsigned int> col_dist(0, N_PIXEL_COLS-2);
+  boost::random::uniform_int_distribution<unsigned int> row_dist(0, N_PIXEL_ROWS-2);
+  std::vector<HitList> events(BENCHMARK_NUM_EVENTS);
+
+  for(auto it = events.begin(); it != events.end(); it++) {
+    while(it->size() < hits_per_chip) {
+      unsigned int col = col_dist(rand_gen);
+      unsigned int row = row_dist(rand_gen);
+
+      for(unsigned int i = 0; i < 4 && it->size() < hits_per_chip; i++)
+        it->emplace_back(col + (i&1), row + (i>>1));
+    }
+  }
+
+  return events;
+}
+
+
+///@brief Run a benchmark until it has run for at least the minimum time
+///@param[in] name Name of benchmark
+///@param[in] occupancy Occupancy level the benchmark is run for
+///@param[in] hits_per_iteration Number of pixel hits processed per call to func
+///@param[in] func Function that runs one iteration of the benchmark
+///@param[out] results The result is added to this vector
+void runBenchmark(const std::string& name,
+                  const Occupancy& occupancy,
+                  unsigned int hits_per_iteration,
+                  const std::function<void(void)>& func,
+                  std::vector<BenchmarkResult>& results)
+{
+  // Warm up caches and memory pools
+  func();
+
+  uint64_t iterations = 0;
+  std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::duration elapsed;
+
+  do {
+    func();
+    iterations++;
+    elapsed = std::chrono::steady_clock::now() - start_time;
+  } while(elapsed < sMinTime);
+
+  double elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  BenchmarkResult result = {name, occupancy.name, hits_per_iteration, iterations,
+                            elapsed_ns / iterations};
+
+  std::cout << std::left << std::setw(45) << name;
+  std::cout << std::setw(22) << occupancy.name;
+  std::cout << std::right << std::setw(12) << iterations;
+  std::cout << std::setw(16) << std::fixed << std::setprecision(1) << result.ns_per_iteration;
+  std::cout << std::setw(12) << std::setprecision(2);
+  std::cout << result.ns_per_iteration / std::max(hits_per_iteration, 1U) << std::endl;
+
+  results.push_back(result);
+}
+
+
+bool benchmarkEnabled(const std::string& name)
+{
+  return sFilter.empty() || name.find(sFilter) != std::string::npos;
+}
+
+
+///@brief Set the hits of an event in the double columns, and read them all out again
+void benchmarkDoubleColumn(const Occupancy& occupancy, std::vector<BenchmarkResult>& results)
+{
+  std::vector<HitList> events = generateEvents(occupancy.hits_per_chip);
+  std::vector<PixelDoubleColumn> dcols(N_PIXEL_COLS/2);
+  unsigned int event_num = 0;
+
+  for(unsigned int i = 0; i < dcols.size(); i++)
+    dcols[i].setDoubleColumnNum(i);
+
+  runBenchmark("PixelDoubleColumn::setPixel/readPixel", occupancy, occupancy.hits_per_chip,
+               [&]() {
+                 const HitList& hits = events[event_num++ % events.size()];
+
+                 for(auto it = hits.begin(); it != hits.end(); it++)
+                   dcols[it->first/2].setPixel(it->first&1, it->second);
+
+                 for(auto it = dcols.begin(); it != dcols.end(); it++) {
+                   while(it->pixelHitsRemaining() > 0)
+                     sChecksum += it->readPixel()->getRow();
+                 }
+               },
+               results);
+}
+
+
+///@brief Create an event in the matrix, set the hits, read out all the regions,
+///       and delete the event
+void benchmarkPixelMatrix(const Occupancy& occupancy, std::vector<BenchmarkResult>& results)
+{
+  std::vector<HitList> events = generateEvents(occupancy.hits_per_chip);
+  PixelMatrix matrix;
+  uint64_t time_now = 0;
+
+  runBenchmark("PixelMatrix::newEvent/readPixelRegion", occupancy, occupancy.hits_per_chip,
+               [&]() {
+                 const HitList& hits = events[(time_now/BENCHMARK_EVENT_SPACING_NS) %
+                                              events.size()];
+
+                 matrix.newEvent(time_now);
+
+                 for(auto it = hits.begin(); it != hits.end(); it++)
+                   matrix.setPixel(it->first, it->second);
+
+                 for(int region = 0; region < N_REGIONS; region++) {
+                   while(!matrix.regionEmpty(region))
+                     sChecksum += matrix.readPixelRegion(region, time_now)->getCol();
+                 }
+
+                 matrix.deleteEvent(time_now);
+                 time_now += BENCHMARK_EVENT_SPACING_NS;
+               },
+               results);
+}
+
+
+///@brief Gives access to the (protected) latching of hits into the matrix in PixelFrontEnd
+class BenchmarkFrontEnd : public PixelFrontEnd, public PixelMatrix
+{
+public:
+  void latchEventFrame(uint64_t event_start, uint64_t event_end) {
+    feedHitsToPixelMatrix(*this, event_start, event_end);
+  }
+};
+
+
+///@brief Latch the hits that are active in an event frame into the matrix, and delete the event.
+///       The front end holds the hits for all the events, with one event per strobe, so
+///       the frame is found among the hits of the other events like in the Alpide.
+void benchmarkPixelFrontEnd(const Occupancy& occupancy, std::vector<BenchmarkResult>& results)
+{
+  std::vector<HitList> events = generateEvents(occupancy.hits_per_chip);
+  BenchmarkFrontEnd front_end;
+  unsigned int event_num = 0;
+  uint64_t time_now = 0;
+
+  for(unsigned int i = 0; i < events.size(); i++) {
+    for(auto it = events[i].begin(); it != events[i].end(); it++) {
+      PixelHitPtr pixel = makePixelHit(it->first, it->second, 0);
+      pixel->setActiveTimeStart(i*BENCHMARK_EVENT_SPACING_NS);
+      pixel->setActiveTimeEnd(i*BENCHMARK_EVENT_SPACING_NS + BENCHMARK_EVENT_SPACING_NS/2);
+      front_end.pixelFrontEndInput(pixel);
+    }
+  }
+
+  runBenchmark("PixelFrontEnd::feedHitsToPixelMatrix", occupancy, occupancy.hits_per_chip,
+               [&]() {
+                 uint64_t event_start = (event_num++ % events.size()) *
+                   BENCHMARK_EVENT_SPACING_NS + 10;
+
+                 front_end.newEvent(time_now);
+                 front_end.latchEventFrame(event_start, event_start + 100);
+                 sChecksum += front_end.getHitsRemainingInOldestEvent();
+                 front_end.deleteEvent(time_now);
+                 time_now += BENCHMARK_EVENT_SPACING_NS;
+               },
+               results);
+}
+
+
+///@brief EventGenBase with the event generation left out, for benchmarking createCluster()
+class BenchmarkEventGen : public EventGenBase
+{
+  std::vector<PixelHitPtr> mNoHits;
+
+public:
+  BenchmarkEventGen(sc_core::sc_module_name name, const QSettings* settings)
+    : EventGenBase(name, settings, "") {}
+  const std::vector<PixelHitPtr>& getTriggeredEvent(void) const {return mNoHits;}
+  const std::vector<PixelHitPtr>& getUntriggeredEvent(void) const {return mNoHits;}
+  void stopEventGeneration(void) {mStopEventGeneration = true;}
+};
+
+
+///@brief Create random clusters around base pixels until the clusters have as many pixel
+///       hits as there are in an event at this occupancy. Uses the default cluster size
+///       distribution of the simulation.
+void benchmarkCreateCluster(const Occupancy& occupancy, EventGenBase& event_gen,
+                            std::vector<BenchmarkResult>& results)
+{
+  std::vector<HitList> events = generateEvents(occupancy.hits_per_chip);
+  unsigned int event_num = 0;
+
+  runBenchmark("EventGenBase::createCluster", occupancy, occupancy.hits_per_chip,
+               [&]() {
+                 const HitList& hits = events[event_num++ % events.size()];
+                 unsigned int event_hits = 0;
+
+                 // Use every fourth hit (the first hit of each 2x2 cluster) as base pixel
+                 for(unsigned int i = 0; event_hits < hits.size(); i = (i+4) % hits.size()) {
+                   PixelHit pixel(hits[i].first, hits[i].second, 0);
+                   std::vector<PixelHitPtr> cluster = event_gen.createCluster(pixel, 0, 0, 1000);
+                   event_hits += cluster.size();
+                 }
+
+                 sChecksum += event_hits;
+               },
+               results);
+}
+
+
+///@brief Create the data words for an event with the frame level Alpide model,
+///       with chip header and trailer
+std::vector<AlpideDataWord> createEventDataWords(const HitList& hits, uint64_t trig_id)
+{
+  AlpideFrameModel frame_model(true, true);
+  PixelMatrix matrix;
+  std::deque<FrameModelWord> frame_words;
+  std::vector<AlpideDataWord> data_words;
+
+  matrix.newEvent(0);
+
+  for(auto it = hits.begin(); it != hits.end(); it++)
+    matrix.setPixel(it->first, it->second);
+
+  frame_model.readoutFrame(matrix, 0, 0, frame_words);
+
+  data_words.push_back(AlpideChipHeader(0, 0, trig_id));
+
+  for(auto it = frame_words.begin(); it != frame_words.end(); it++)
+    data_words.push_back(it->data_word);
+
+  data_words.push_back(AlpideChipTrailer(0));
+
+  return data_words;
+}
+
+
+///@brief Parse the data words of an event, 24-bit words at a time (as from an inner barrel
+///       chip) or a byte at a time (as from an outer barrel chip), and pop the event
+void benchmarkDataParser(const Occupancy& occupancy, bool byte_input,
+                         std::vector<BenchmarkResult>& results)
+{
+  std::vector<HitList> events = generateEvents(occupancy.hits_per_chip);
+  std::vector<std::vector<AlpideDataWord>> events_data_words;
+  unsigned int event_num = 0;
+
+  for(unsigned int i = 0; i < events.size(); i++)
+    events_data_words.push_back(createEventDataWords(events[i], i));
+
+  // Long data rate interval, so that the data rate counters don't grow during the benchmark
+  AlpideEventBuilder event_builder(1000000000, true, false);
+
+  std::string name = byte_input ? "AlpideEventBuilder::inputDataByte" :
+                                  "AlpideEventBuilder::inputDataWord";
+
+  runBenchmark(name, occupancy, occupancy.hits_per_chip,
+               [&]() {
+                 unsigned int event_index = event_num++ % events.size();
+                 const std::vector<AlpideDataWord>& data_words = events_data_words[event_index];
+
+                 for(auto it = data_words.begin(); it != data_words.end(); it++) {
+                   if(byte_input) {
+                     // Most significant byte first, like the outer barrel data
+                     for(unsigned int i = 0; i < it->size; i++)
+                       event_builder.inputDataByte(it->data[2-i], event_index, 0);
+                   } else {
+                     uint32_t data = it->data[2] << 16 | it->data[1] << 8 | it->data[0];
+                     event_builder.inputDataWord(data, 3, event_index, 0);
+                   }
+                 }
+
+                 sChecksum += event_builder.getNumEvents();
+                 event_builder.popEvent();
+               },
+               results);
+}
+
+
+void writeUint16(std::ofstream& file, std::uint16_t value)
+{
+  file.write((const char*) &value, sizeof(value));
+}
+
+
+///@brief Write an event in the ITS binary event format with hits in all the chips of layer 0
+void writeBinaryEventFile(const std::string& filename, const HitList& hits)
+{
+  std::ofstream file(filename, std::ios_base::out | std::ios_base::binary);
+
+  if(!file.is_open())
+    throw std::runtime_error("Error creating benchmark event file: " + filename);
+
+  file.put(DETECTOR_START);
+  file.put(LAYER_START);
+  file.put(0);
+
+  for(unsigned int stave = 0; stave < BENCHMARK_LAYER0_STAVES; stave++) {
+    file.put(STAVE_START);
+    file.put(stave);
+    file.put(MODULE_START);
+    file.put(0);
+
+    for(unsigned int chip = 0; chip < BENCHMARK_LAYER0_CHIPS_PER_STAVE; chip++) {
+      file.put(CHIP_START);
+      file.put(chip);
+
+      for(auto it = hits.begin(); it != hits.end(); it++) {
+        file.put(DIGIT);
+        writeUint16(file, it->first);
+        writeUint16(file, it->second);
+      }
+
+      file.put(CHIP_END);
+    }
+
+    file.put(MODULE_END);
+    file.put(STAVE_END);
+  }
+
+  file.put(LAYER_END);
+  file.put(DETECTOR_END);
+}
+
+
+///@brief Read an ITS binary event file with all of layer 0 at this occupancy.
+///       The file is read with EventBaseDiscrete::readEvent(), which reads the file each
+///       time. EventBinaryITS::readEventFile() is private.
+void benchmarkEventBinaryITS(const Occupancy& occupancy, const QString& path,
+                             std::vector<BenchmarkResult>& results)
+{
+  std::vector<HitList> events = generateEvents(occupancy.hits_per_chip);
+  QString filename = QString("event_") + occupancy.name + QString(".dat");
+
+  writeBinaryEventFile((path + "/" + filename).toStdString(), events[0]);
+
+  ITS::ITSDetectorConfig config;
+
+  for(unsigned int layer = 1; layer < ITS::N_LAYERS; layer++)
+    config.layer[layer].num_staves = 0;
+
+  EventBinaryITS event_reader(config,
+                              &ITS::ITS_global_chip_id_to_position,
+                              &ITS::ITS_position_to_global_chip_id,
+                              path,
+                              QStringList(filename),
+                              false,
+                              BENCHMARK_SEED,
+                              false);
+
+  EventBaseDiscrete& event_base = event_reader;
+  unsigned int layer_hits = occupancy.hits_per_chip *
+    BENCHMARK_LAYER0_STAVES * BENCHMARK_LAYER0_CHIPS_PER_STAVE;
+
+  runBenchmark("EventBinaryITS::readEventFile", occupancy, layer_hits,
+               [&]() {
+                 EventDigits* event = event_base.readEvent(0);
+                 sChecksum += event->size();
+                 delete event;
+               },
+               results);
+}
+
+
+void writeJson(const std::string& filename, const std::vector<BenchmarkResult>& results)
+{
+  std::ofstream file(filename);
+
+  if(!file.is_open())
+    throw std::runtime_error("Error creating benchmark results file: " + filename);
+
+  file << "{" << std::endl;
+  file << "  \"version\": \"" << VERSION_MAJOR << "." << VERSION_MINOR << "\"," << std::endl;
+#ifdef PIXEL_DOUBLE_COLUMN_BITMAP
+  file << "  \"pixel_double_column_bitmap\": true," << std::endl;
+#else
+  file << "  \"pixel_double_column_bitmap\": false," << std::endl;
+#endif
+  file << "  \"min_time_ms\": " << sMinTime.count() << "," << std::endl;
+  file << "  \"benchmarks\": [" << std::endl;
+
+  file << std::fixed;
+
+  for(auto it = results.begin(); it != results.end(); it++) {
+    file << "    {\"name\": \"" << it->name << "\", ";
+    file << "\"occupancy\": \"" << it->occupancy << "\", ";
+    file << "\"hits_per_iteration\": " << it->hits_per_iteration << ", ";
+    file << "\"iterations\": " << it->iterations << ", ";
+    file << "\"ns_per_iteration\": " << std::setprecision(1) << it->ns_per_iteration << ", ";
+    file << "\"ns_per_hit\": " << std::setprecision(3);
+    file << it->ns_per_iteration / std::max(it->hits_per_iteration, 1U) << "}";
+    file << (it+1 != results.end() ? "," : "") << std::endl;
+  }
+
+  file << "  ]" << std::endl;
+  file << "}" << std::endl;
+}
+
+}
+
+
+int sc_main(int argc, char** argv)
+{
+  std::string json_filename;
+
+  for(int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+
+    if(arg == "--json" && i+1 < argc) {
+      json_filename = argv[++i];
+    } else if(arg == "--min-time-ms" && i+1 < argc) {
+      sMinTime = std::chrono::milliseconds(std::atoi(argv[++i]));
+    } else if(arg == "--filter" && i+1 < argc) {
+      sFilter = argv[++i];
+    } else {
+      std::cerr << "Usage: " << argv[0];
+      std::cerr << " [--json <file>] [--min-time-ms <ms>] [--filter <substring>]" << std::endl;
+      return -1;
+    }
+  }
+
+  QTemporaryDir tmp_dir;
+
+  if(!tmp_dir.isValid()) {
+    std::cerr << "Error creating temporary directory for benchmark files." << std::endl;
+    return -1;
+  }
+
+  std::vector<BenchmarkResult> results;
+
+  std::cout << std::left << std::setw(45) << "Benchmark";
+  std::cout << std::setw(22) << "Occupancy";
+  std::cout << std::right << std::setw(12) << "Iterations";
+  std::cout << std::setw(16) << "ns/iteration";
+  std::cout << std::setw(12) << "ns/hit" << std::endl;
+
+  {
+    // Settings for the cluster generation only, saved in the temporary directory
+    QSettings settings(tmp_dir.path() + "/settings.txt", QSettings::IniFormat);
+    settings.setValue("event/random_cluster_generation", true);
+    settings.setValue("event/random_cluster_size_mean", DEFAULT_EVENT_RANDOM_CLUSTER_SIZE_MEAN);
+    settings.setValue("event/random_cluster_size_stddev",
+                      DEFAULT_EVENT_RANDOM_CLUSTER_SIZE_STDDEV);
+    settings.setValue("simulation/random_seed", BENCHMARK_SEED);
+
+    BenchmarkEventGen event_gen("event_gen", &settings);
+
+    for(const Occupancy& occupancy : OCCUPANCIES) {
+      if(benchmarkEnabled("PixelDoubleColumn::setPixel/readPixel"))
+        benchmarkDoubleColumn(occupancy, results);
+      if(benchmarkEnabled("PixelMatrix::newEvent/readPixelRegion"))
+        benchmarkPixelMatrix(occupancy, results);
+      if(benchmarkEnabled("PixelFrontEnd::feedHitsToPixelMatrix"))
+        benchmarkPixelFrontEnd(occupancy, results);
+      if(benchmarkEnabled("EventGenBase::createCluster"))
+        benchmarkCreateCluster(occupancy, event_gen, results);
+      if(benchmarkEnabled("AlpideEventBuilder::inputDataWord"))
+        benchmarkDataParser(occupancy, false, results);
+      if(benchmarkEnabled("AlpideEventBuilder::inputDataByte"))
+        benchmarkDataParser(occupancy, true, results);
+      if(benchmarkEnabled("EventBinaryITS::readEventFile"))
+        benchmarkEventBinaryITS(occupancy, tmp_dir.path(), results);
+    }
+  }
+
+  std::cout << "Checksum: " << sChecksum << std::endl;
+
+  if(!json_filename.empty()) {
+    writeJson(json_filename, results);
+    std::cout << "Benchmark results written to " << json_filename << std::endl;
+  }
+
+  return 0;
+}
@@ -26,6 +26,8 @@
 #include "TSystem.h"
 #endif
 
+#include "Log/Log.hpp"
+#include "Profiling/ProcessProfiler.hpp"
 #include "Settings/Settings.hpp"
 #include "Settings/parse_cmdline_args.hpp"
 #include "Stimuli/StimuliITS.hpp"
@@ -79,6 +81,10 @@ int sc_main(int argc, char** argv)
       return 0;
   }
 
+  Log::configure(simulation_settings->value("simulation/log_level").toString().toStdString(),
+                 simulation_settings->value("simulation/log_module_levels").toString().toStdString());
+  LogProgress::setInterval(simulation_settings->value("simulation/log_progress_interval_ms").toUInt());
+
   // Create output data directory
   std::string output_dir_str;
   if(create_output_dir(simulation_settings, output_dir_str) == false)
@@ -126,10 +132,19 @@ int sc_main(int argc, char** argv)
 
   std::cout << "Starting simulation.." << std::endl;
 
+  // Messages from the SystemC methods are written by the log writer thread
+  // while the simulation runs
+  Log::start();
+  ProcessProfiler::start();
   sc_core::sc_start();
+  ProcessProfiler::stop();
+  Log::stop();
 
   std::cout << "Ending simulation.." << std::endl;
 
+  if(ProcessProfiler::isEnabled())
+    ProcessProfiler::writeReport(output_dir_str);
+
   if(wf != NULL) {
     sc_close_vcd_trace_file(wf);
   }
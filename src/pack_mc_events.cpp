@@ -0,0 +1,90 @@
+/**
+ * @file   pack_mc_events.cpp
+ * @author Simon Voigt Nesbo
+ * @date   October 16, 2026
+ * @brief  Converts a directory of ITS MC event files (binary or XML, one event per file)
+ *         to a single packed event file, which can be used with monte_carlo_file_type=packed.
+ *
+ *         Usage: pack_mc_events <binary|xml> <input_dir> <output_file>
+ */
+
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <QDir>
+#include <QStringList>
+#include "Detector/ITS/ITSDetectorConfig.hpp"
+#include "Event/EventBinaryITS.hpp"
+#include "Event/EventXMLITS.hpp"
+#include "Event/EventPackedITS.hpp"
+
+
+int main(int argc, char** argv)
+{
+  if(argc != 4) {
+    std::cerr << "Usage: " << argv[0] << " <binary|xml> <input_dir> <output_file>" << std::endl;
+    return -1;
+  }
+
+  QString file_type(argv[1]);
+  QString input_dir_str(argv[2]);
+  std::string output_file(argv[3]);
+  QDir input_dir(input_dir_str);
+  QStringList name_filters;
+
+  if(file_type == "binary")
+    name_filters << "*.dat";
+  else if(file_type == "xml")
+    name_filters << "*.xml";
+  else {
+    std::cerr << "Error: Unknown MC event format \"" << argv[1] << "\"" << std::endl;
+    return -1;
+  }
+
+  QStringList event_files = input_dir.entryList(name_filters);
+
+  if(event_files.isEmpty()) {
+    std::cerr << "Error: No " << name_filters.first().toStdString();
+    std::cerr << " files found in " << argv[2] << std::endl;
+    return -1;
+  }
+
+  // Default config includes the full detector, the simulation filters out
+  // chips that are not used when the packed file is read
+  ITS::ITSDetectorConfig config;
+
+  std::unique_ptr<EventBaseDiscrete> events;
+
+  if(file_type == "binary")
+    events.reset(new EventBinaryITS(config,
+                                    &ITS::ITS_global_chip_id_to_position,
+                                    &ITS::ITS_position_to_global_chip_id,
+                                    input_dir_str,
+                                    event_files,
+                                    false));
+  else
+    events.reset(new EventXMLITS(config,
+                                 &ITS::ITS_global_chip_id_to_position,
+                                 &ITS::ITS_position_to_global_chip_id,
+                                 input_dir_str,
+                                 event_files,
+                                 false));
+
+  try {
+    EventPackedITSWriter writer(output_file);
+
+    // Events are read in sequential order, one file at a time
+    for(int i = 0; i < event_files.size(); i++)
+      writer.writeEvent(*events->getNextEvent());
+
+    writer.finish();
+  }
+  catch(std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return -1;
+  }
+
+  std::cout << "Packed " << event_files.size() << " events into " << output_file << std::endl;
+
+  return 0;
+}
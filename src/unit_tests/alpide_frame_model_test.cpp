@@ -0,0 +1,314 @@
+#include "Alpide/Alpide.hpp"
+#include "Alpide/AlpideFrameModel.hpp"
+#include "AlpideDataParser/AlpideDataParser.hpp"
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <set>
+
+// SystemC expects to be in charge of main, so let sc_main() run the boost tests
+#define BOOST_TEST_MODULE AlpideFrameModelTest
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/included/unit_test.hpp>
+
+
+// Clock cycle the frame readout starts in all the tests
+static const uint64_t START_CYCLE = 1000;
+
+
+///@brief Check the type and ready cycle of a data word from the frame model, and the
+///       priority encoder and address for DATA SHORT/LONG words (or region for REGION HEADER)
+static void checkWord(const FrameModelWord& word, AlpideDataType data_type,
+                      unsigned int id, unsigned int addr, uint64_t ready_cycle)
+{
+  BOOST_CHECK_EQUAL(word.data_word.data_type, data_type);
+  BOOST_CHECK_EQUAL(word.ready_cycle, START_CYCLE + ready_cycle);
+
+  if(data_type == ALPIDE_REGION_HEADER) {
+    BOOST_CHECK_EQUAL(word.data_word.data[2] & 0x1F, id);
+  } else {
+    BOOST_CHECK_EQUAL((word.data_word.data[2] >> 2) & 0x0F, id);
+    BOOST_CHECK_EQUAL(((word.data_word.data[2] & 0x03) << 8) | word.data_word.data[1], addr);
+  }
+}
+
+
+///@brief Set pixels in a new event in the matrix, and read out the frame with the frame model
+///@return Readout duration in clock cycles returned by readoutFrame()
+static uint64_t readoutPixels(const AlpideFrameModel& model,
+                              const std::vector<std::pair<unsigned int, unsigned int>>& pixels,
+                              std::deque<FrameModelWord>& words)
+{
+  PixelMatrix matrix;
+  uint64_t time_now = 0;
+
+  matrix.newEvent(time_now);
+
+  for(auto it = pixels.begin(); it != pixels.end(); it++)
+    matrix.setPixel(it->first, it->second);
+
+  return model.readoutFrame(matrix, START_CYCLE, time_now, words);
+}
+
+
+BOOST_AUTO_TEST_CASE( frame_model_readout_cycles_test )
+{
+  AlpideFrameModel fast_model(true, true);
+  AlpideFrameModel slow_model(false, true);
+
+  // 7 cycles for an empty frame, else 8 + P*(N+1) with P = 2 (fast) or 3 (slow)
+  BOOST_CHECK_EQUAL(fast_model.getReadoutCycles(0), 7);
+  BOOST_CHECK_EQUAL(fast_model.getReadoutCycles(1), 12);
+  BOOST_CHECK_EQUAL(fast_model.getReadoutCycles(3), 16);
+  BOOST_CHECK_EQUAL(slow_model.getReadoutCycles(0), 7);
+  BOOST_CHECK_EQUAL(slow_model.getReadoutCycles(1), 14);
+  BOOST_CHECK_EQUAL(slow_model.getReadoutCycles(3), 20);
+}
+
+
+BOOST_AUTO_TEST_CASE( frame_model_readout_frame_test )
+{
+  AlpideFrameModel fast_model(true, true);
+  AlpideFrameModel slow_model(false, true);
+  AlpideFrameModel fast_no_clustering_model(true, false);
+
+  BOOST_TEST_MESSAGE("Empty frame.");
+  {
+    std::deque<FrameModelWord> words;
+    BOOST_CHECK_EQUAL(readoutPixels(fast_model, {}, words), 7);
+    BOOST_CHECK(words.empty());
+  }
+
+  BOOST_TEST_MESSAGE("Single pixel, fast readout.");
+  {
+    std::deque<FrameModelWord> words;
+    BOOST_CHECK_EQUAL(readoutPixels(fast_model, {{0, 0}}, words), 12);
+    BOOST_REQUIRE_EQUAL(words.size(), 2);
+
+    // Pixel read at cycle 3+2, DATA SHORT one cycle after the next (empty) pixel read
+    checkWord(words[0], ALPIDE_REGION_HEADER, 0, 0, 8);
+    checkWord(words[1], ALPIDE_DATA_SHORT, 0, 0, 8);
+  }
+
+  BOOST_TEST_MESSAGE("Cluster of three pixels, fast readout.");
+  {
+    std::deque<FrameModelWord> words;
+
+    // Priority encoder addresses 0, 1 and 2
+    BOOST_CHECK_EQUAL(readoutPixels(fast_model, {{0, 0}, {1, 0}, {1, 1}}, words), 16);
+    BOOST_REQUIRE_EQUAL(words.size(), 2);
+
+    checkWord(words[0], ALPIDE_REGION_HEADER, 0, 0, 12);
+    checkWord(words[1], ALPIDE_DATA_LONG, 0, 0, 12);
+    BOOST_CHECK_EQUAL(words[1].data_word.data[0], 0x03);
+  }
+
+  BOOST_TEST_MESSAGE("Two pixels too far apart for a cluster, slow readout.");
+  {
+    std::deque<FrameModelWord> words;
+
+    // Priority encoder addresses 0 and 8
+    BOOST_CHECK_EQUAL(readoutPixels(slow_model, {{0, 0}, {0, 4}}, words), 17);
+    BOOST_REQUIRE_EQUAL(words.size(), 3);
+
+    checkWord(words[0], ALPIDE_REGION_HEADER, 0, 0, 10);
+    checkWord(words[1], ALPIDE_DATA_SHORT, 0, 0, 10);
+    checkWord(words[2], ALPIDE_DATA_SHORT, 0, 8, 13);
+  }
+
+  BOOST_TEST_MESSAGE("Two regions without clustering, fast readout.");
+  {
+    std::deque<FrameModelWord> words;
+
+    // One pixel in region 0, three in priority encoder 0 of region 1.
+    // The readout time is given by the region with most hits.
+    BOOST_CHECK_EQUAL(readoutPixels(fast_no_clustering_model,
+                                    {{0, 0}, {32, 0}, {33, 0}, {33, 1}}, words), 16);
+    BOOST_REQUIRE_EQUAL(words.size(), 6);
+
+    // Without clustering each DATA SHORT is ready one cycle after its own pixel was read
+    checkWord(words[0], ALPIDE_REGION_HEADER, 0, 0, 6);
+    checkWord(words[1], ALPIDE_DATA_SHORT, 0, 0, 6);
+    checkWord(words[2], ALPIDE_REGION_HEADER, 1, 0, 6);
+    checkWord(words[3], ALPIDE_DATA_SHORT, 0, 0, 6);
+    checkWord(words[4], ALPIDE_DATA_SHORT, 0, 1, 8);
+    checkWord(words[5], ALPIDE_DATA_SHORT, 0, 2, 10);
+  }
+}
+
+
+// Triggers for the comparison with the cycle accurate model. The triggers are far enough
+// apart for the readout of a frame to complete before the next strobe.
+static const uint64_t FIRST_TRIGGER_NS = 1000;
+static const uint64_t TRIGGER_PERIOD_NS = 10000;
+static const unsigned int NUM_TRIGGERS = 8;
+
+
+///@brief Sends the same triggers to a group of chips
+class TriggerSource : sc_core::sc_module {
+  std::vector<Alpide*> mChips;
+  unsigned int mTriggerCount = 0;
+  sc_event E_trigger;
+
+  void triggerMethod(void) {
+    ControlRequestPayload trigger_word;
+
+    trigger_word.opcode = 0x55; // Trigger
+    trigger_word.chipId = 0x00;
+    trigger_word.address = 0x0000;
+    trigger_word.data = 1;
+
+    for(auto it = mChips.begin(); it != mChips.end(); it++)
+      (*it)->s_control_input.transport(trigger_word);
+
+    if(++mTriggerCount < NUM_TRIGGERS)
+      E_trigger.notify(TRIGGER_PERIOD_NS, SC_NS);
+  }
+
+public:
+  SC_HAS_PROCESS(TriggerSource);
+  TriggerSource(sc_core::sc_module_name name, const std::vector<Alpide*>& chips)
+    : sc_core::sc_module(name)
+    , mChips(chips)
+  {
+    SC_METHOD(triggerMethod);
+    sensitive << E_trigger;
+    dont_initialize();
+
+    E_trigger.notify(FIRST_TRIGGER_NS, SC_NS);
+  }
+};
+
+
+///@brief Create a chip config for the comparison between the frame model and the cycle
+///       accurate model. Frame model validation is enabled for the cycle accurate chip.
+static AlpideConfig createChipConfig(bool frame_model)
+{
+  AlpideConfig chip_cfg;
+
+  chip_cfg.dtu_delay_cycles = 10;
+  chip_cfg.strobe_length_ns = 100;
+  chip_cfg.min_busy_cycles = 8;
+  chip_cfg.strobe_extension = false;
+  chip_cfg.data_long_en = true;
+  chip_cfg.chip_continuous_mode = false;
+  chip_cfg.matrix_readout_speed = true;
+  chip_cfg.clock_skipping = false;
+  chip_cfg.frame_model = frame_model;
+  chip_cfg.frame_model_validation = !frame_model;
+  chip_cfg.hybrid_model = false;
+  chip_cfg.hybrid_meb_threshold = 2;
+  chip_cfg.hybrid_frame_fifo_threshold = 2;
+
+  return chip_cfg;
+}
+
+
+///@brief Feed the same events to a cycle accurate chip and a frame model chip, and check
+///       that the frame model reads out the same data words as the cycle accurate RRUs and
+///       TRU, and that it predicts the readout duration of each frame in the cycle accurate
+///       chip. This is the only test case that runs the SystemC simulation.
+BOOST_AUTO_TEST_CASE( frame_model_cycle_accurate_test )
+{
+  Alpide cycle_accurate_chip("cycle_accurate_chip", 0, 0, createChipConfig(false));
+  Alpide frame_model_chip("frame_model_chip", 0, 0, createChipConfig(true));
+  std::vector<Alpide*> chips = {&cycle_accurate_chip, &frame_model_chip};
+
+  sc_clock clock_40MHz("clock_40MHz", 25, 0.5, 25, true);
+  TriggerSource trigger_source("trigger_source", chips);
+
+  // The event builders do not need the data rate, use one interval for the whole simulation
+  uint64_t sim_time_ns = FIRST_TRIGGER_NS + NUM_TRIGGERS*TRIGGER_PERIOD_NS;
+  AlpideEventBuilder cycle_accurate_events(sim_time_ns, true, true);
+  AlpideEventBuilder frame_model_events(sim_time_ns, true, true);
+  std::vector<AlpideEventBuilder*> event_builders = {&cycle_accurate_events, &frame_model_events};
+
+  DataTargetSocket data_sockets[2];
+
+  for(unsigned int i = 0; i < chips.size(); i++) {
+    AlpideEventBuilder* event_builder = event_builders[i];
+
+    chips[i]->s_system_clk_in(clock_40MHz);
+    chips[i]->s_data_output.bind(data_sockets[i]);
+
+    data_sockets[i].register_put([event_builder](const DataPayload& dw) {
+        uint32_t data = ((uint32_t)dw.data[0] << 16) | ((uint32_t)dw.data[1] << 8) | dw.data[2];
+        event_builder->inputDataWord(data, 3, 0, sc_time_stamp().value());
+      });
+  }
+
+  // Random hits, and a few clusters, in all but the first event. The number of hits
+  // increases with each event.
+  std::vector<std::set<PixelHit>> event_hits(NUM_TRIGGERS);
+  boost::random::mt19937 rand_gen;
+  boost::random::uniform_int_distribution<int> rand_col_dist(0, N_PIXEL_COLS-2);
+  boost::random::uniform_int_distribution<int> rand_row_dist(0, N_PIXEL_ROWS-2);
+
+  for(unsigned int event = 1; event < NUM_TRIGGERS; event++) {
+    uint64_t trigger_time_ns = FIRST_TRIGGER_NS + event*TRIGGER_PERIOD_NS;
+
+    for(unsigned int hit = 0; hit < event*event*4; hit++) {
+      int col = rand_col_dist(rand_gen);
+      int row = rand_row_dist(rand_gen);
+
+      // Every fourth hit is a cluster of four pixels
+      unsigned int cluster_size = (hit % 4 == 0) ? 4 : 1;
+
+      for(unsigned int i = 0; i < cluster_size; i++) {
+        event_hits[event].insert(PixelHit(col + i/2, row + i%2, 0));
+
+        for(auto chip_it = chips.begin(); chip_it != chips.end(); chip_it++) {
+          PixelHitPtr p = makePixelHit(col + i/2, row + i%2, 0);
+          p->setActiveTimeStart(trigger_time_ns - 100);
+          p->setActiveTimeEnd(trigger_time_ns + 500);
+          (*chip_it)->pixelFrontEndInput(p);
+        }
+      }
+    }
+  }
+
+  sc_start(sim_time_ns, SC_NS);
+
+  BOOST_REQUIRE_EQUAL(cycle_accurate_events.getNumEvents(), NUM_TRIGGERS);
+  BOOST_REQUIRE_EQUAL(frame_model_events.getNumEvents(), NUM_TRIGGERS);
+
+  // Same data words, apart from IDLEs that depend on when the words were ready
+  for(unsigned int type = ALPIDE_CHIP_HEADER; type < ALPIDE_NUM_DATA_TYPES; type++) {
+    BOOST_CHECK_EQUAL(cycle_accurate_events.getProtocolStats()[type],
+                      frame_model_events.getProtocolStats()[type]);
+  }
+
+  for(unsigned int event = 0; event < NUM_TRIGGERS; event++) {
+    const AlpideEventFrame* cycle_accurate_frame = cycle_accurate_events.getNextEvent();
+    const AlpideEventFrame* frame_model_frame = frame_model_events.getNextEvent();
+
+    BOOST_TEST_MESSAGE("Event " << event << ", " << cycle_accurate_frame->getEventSize() << " hits.");
+
+    BOOST_CHECK_EQUAL(frame_model_frame->getBunchCounterValue(),
+                      cycle_accurate_frame->getBunchCounterValue());
+    BOOST_CHECK_EQUAL(frame_model_frame->getBusyViolation(),
+                      cycle_accurate_frame->getBusyViolation());
+    BOOST_REQUIRE_EQUAL(cycle_accurate_frame->getEventSize(), event_hits[event].size());
+    BOOST_REQUIRE_EQUAL(frame_model_frame->getEventSize(), event_hits[event].size());
+    BOOST_CHECK(std::equal(event_hits[event].begin(), event_hits[event].end(),
+                           cycle_accurate_frame->getPixelSetIterator()));
+    BOOST_CHECK(std::equal(event_hits[event].begin(), event_hits[event].end(),
+                           frame_model_frame->getPixelSetIterator()));
+
+    cycle_accurate_events.popEvent();
+    frame_model_events.popEvent();
+  }
+
+  // The readout duration predicted by the frame model for the MEB in the cycle accurate chip
+  const FrameModelDeviation& deviation = cycle_accurate_chip.getFrameModelDeviation();
+
+  BOOST_CHECK_EQUAL(deviation.frames, NUM_TRIGGERS);
+  BOOST_CHECK_EQUAL(deviation.predicted_cycles_sum, deviation.readout_cycles_sum);
+  BOOST_CHECK_EQUAL(deviation.abs_deviation_max, 0);
+}
+
+
+int sc_main(int argc, char** argv)
+{
+  return boost::unit_test::unit_test_main(&init_unit_test, argc, argv);
+}
@@ -0,0 +1,110 @@
+// Checks that PixelDoubleColumn::readPixel() returns the pixel hits in the order given by the
+// PixelPriorityEncoder comparator. This file is built twice, with the default std::set backend
+// and with the PIXEL_DOUBLE_COLUMN_BITMAP backend (see CMakeLists.txt), so that both backends
+// are checked against the same reference order.
+#include "Alpide/PixelDoubleColumn.hpp"
+#include "Alpide/PixelReadoutStats.hpp"
+#define BOOST_TEST_MODULE PixelDoubleColumnOrderTest
+#include <boost/test/included/unit_test.hpp>
+#include <algorithm>
+#include <map>
+#include <random>
+
+
+BOOST_AUTO_TEST_CASE( pixel_col_order_test )
+{
+#ifdef PIXEL_DOUBLE_COLUMN_BITMAP
+  BOOST_TEST_MESSAGE("Testing bitmap PixelDoubleColumn backend.");
+#else
+  BOOST_TEST_MESSAGE("Testing std::set PixelDoubleColumn backend.");
+#endif
+
+  const unsigned int double_col_num = 5;
+  const unsigned int num_hits = 400;
+
+  std::shared_ptr<PixelReadoutStats> readout_stats = std::make_shared<PixelReadoutStats>();
+  std::mt19937 rand_gen(1234);
+  std::uniform_int_distribution<unsigned int> rand_row(0, N_PIXEL_ROWS-1);
+  std::uniform_int_distribution<unsigned int> rand_col(2*double_col_num, 2*double_col_num+1);
+
+  PixelDoubleColumn pixcol;
+  pixcol.setDoubleColumnNum(double_col_num);
+
+  // First pixel hit that was set for each pixel (col, row), or a null pointer when the
+  // pixel was set with setPixel(col, row). Duplicates are ignored by the double column.
+  std::map<std::pair<unsigned int, unsigned int>, PixelHitPtr> pixels_set;
+
+  for(unsigned int i = 0; i < num_hits; i++) {
+    unsigned int col = rand_col(rand_gen);
+    unsigned int row = rand_row(rand_gen);
+
+    // Every third hit has readout stats, and is kept as a PixelHit object by both backends
+    if(i % 3 == 0) {
+      PixelHitPtr pixel = makePixelHit(col, row, 0, readout_stats);
+      pixcol.setPixel(pixel);
+      pixels_set.insert(std::make_pair(std::make_pair(col, row), pixel));
+    } else {
+      pixcol.setPixel(col, row);
+      pixels_set.insert(std::make_pair(std::make_pair(col, row), PixelHitPtr()));
+    }
+  }
+
+  BOOST_CHECK_EQUAL(pixcol.pixelHitsRemaining(), pixels_set.size());
+
+  // Reference readout order
+  std::vector<PixelHitPtr> expected;
+
+  for(auto it = pixels_set.begin(); it != pixels_set.end(); it++)
+    expected.push_back(makePixelHit(it->first.first, it->first.second));
+
+  std::sort(expected.begin(), expected.end(), PixelPriorityEncoder());
+
+  for(auto it = expected.begin(); it != expected.end(); it++) {
+    PixelHitPtr pixel = pixcol.readPixel();
+
+    BOOST_REQUIRE(*pixel != NoPixelHit);
+    BOOST_CHECK_EQUAL(pixel->getCol(), (*it)->getCol());
+    BOOST_CHECK_EQUAL(pixel->getRow(), (*it)->getRow());
+
+    // Hits with readout stats must come back as the same object
+    const PixelHitPtr& pixel_set = pixels_set[std::make_pair(pixel->getCol(), pixel->getRow())];
+    if(pixel_set)
+      BOOST_CHECK(pixel == pixel_set);
+  }
+
+  BOOST_CHECK_EQUAL(pixcol.pixelHitsRemaining(), 0);
+  BOOST_CHECK(*pixcol.readPixel() == NoPixelHit);
+}
+
+
+BOOST_AUTO_TEST_CASE( pixel_col_duplicate_stats_test )
+{
+  const unsigned int double_col_num = 7;
+  const unsigned int col = 2*double_col_num;
+  std::shared_ptr<PixelReadoutStats> readout_stats = std::make_shared<PixelReadoutStats>();
+
+  {
+    PixelDoubleColumn pixcol;
+    pixcol.setDoubleColumnNum(double_col_num);
+
+    // Pixel first hit without readout stats, then by two hits with readout stats.
+    // Pixel next to it hit with readout stats first, then without.
+    BOOST_CHECK(pixcol.setPixel(col, 10) == true);
+    BOOST_CHECK(pixcol.setPixel(makePixelHit(col, 10, 0, readout_stats)) == false);
+    BOOST_CHECK(pixcol.setPixel(makePixelHit(col, 10, 0, readout_stats)) == false);
+    BOOST_CHECK(pixcol.setPixel(makePixelHit(col, 11, 0, readout_stats)) == true);
+    BOOST_CHECK(pixcol.setPixel(col, 11) == false);
+
+    BOOST_CHECK_EQUAL(pixcol.pixelHitsRemaining(), 2);
+
+    for(unsigned int i = 0; i < 2; i++) {
+      PixelHitPtr pixel = pixcol.readPixel();
+      BOOST_REQUIRE(*pixel != NoPixelHit);
+      pixel->increaseReadoutCount();
+    }
+  }
+
+  // All three hits with readout stats must have been counted as read out once
+  BOOST_CHECK_EQUAL(readout_stats->getReadOutCount(0), 3);
+  BOOST_CHECK_EQUAL(readout_stats->getNotReadOutCount(0), 0);
+}
@@ -0,0 +1,249 @@
+#include "ReadoutUnit/RUEventLog.hpp"
+#define BOOST_TEST_MODULE RUEventLogTest
+#include <boost/test/included/unit_test.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+
+static const char* TEST_LOG_FILENAME = "ru_event_log_test.dat";
+
+
+///@brief Create a record with contents that depend on link and record number
+static RUTriggerEventRecord makeRecord(std::uint32_t link_id, std::uint64_t record_num)
+{
+  RUTriggerEventRecord record;
+  record.trigger_id = 1000*link_id + record_num;
+  record.chip_id = link_id;
+  record.reserved = 0;
+  return record;
+}
+
+
+///@brief Remove the last num_bytes bytes from a file
+static void truncateFile(const char* filename, unsigned int num_bytes)
+{
+  std::ifstream in_file(filename, std::ios::in | std::ios::binary);
+  std::vector<char> data((std::istreambuf_iterator<char>(in_file)),
+                         std::istreambuf_iterator<char>());
+  in_file.close();
+
+  std::ofstream out_file(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+  out_file.write(data.data(), data.size()-num_bytes);
+}
+
+
+BOOST_AUTO_TEST_CASE( ru_event_log_round_trip_test )
+{
+  const std::uint32_t num_links = 3;
+  const std::uint32_t chunk_records = 4;
+
+  // Different number of records per link, so that some links end with a partly filled
+  // chunk, and the chunks for the links are interleaved in the file
+  const std::uint64_t num_records[num_links] = {10, 0, 7};
+
+  BOOST_TEST_MESSAGE("Writing per link event log.");
+  {
+    RUEventLogWriter writer(TEST_LOG_FILENAME, RU_LOG_BUSYV_EVENTS, num_links,
+                            sizeof(RUTriggerEventRecord), chunk_records);
+
+    for(std::uint64_t record_num = 0; record_num < 10; record_num++) {
+      for(std::uint32_t link_id = 0; link_id < num_links; link_id++) {
+        if(record_num < num_records[link_id]) {
+          RUTriggerEventRecord record = makeRecord(link_id, record_num);
+          writer.addRecord(link_id, &record);
+        }
+      }
+    }
+    writer.flush();
+  }
+
+  RUEventLogFileHeader header;
+  BOOST_REQUIRE(readRUEventLogFileHeader(TEST_LOG_FILENAME, header));
+  BOOST_CHECK_EQUAL(header.log_type, RU_LOG_BUSYV_EVENTS);
+
+  BOOST_TEST_MESSAGE("Reading back per link event log.");
+  RUEventLogReader reader(TEST_LOG_FILENAME, RU_LOG_BUSYV_EVENTS);
+
+  BOOST_CHECK(reader.getTruncated() == false);
+  BOOST_CHECK_EQUAL(reader.getNumLinks(), num_links);
+  BOOST_CHECK_EQUAL(reader.getRecordSize(), sizeof(RUTriggerEventRecord));
+
+  for(std::uint32_t link_id = 0; link_id < num_links; link_id++) {
+    BOOST_REQUIRE_EQUAL(reader.getNumRecords(link_id), num_records[link_id]);
+
+    for(std::uint64_t record_num = 0; record_num < num_records[link_id]; record_num++) {
+      RUTriggerEventRecord record;
+      RUTriggerEventRecord expected = makeRecord(link_id, record_num);
+
+      std::memcpy(&record, reader.getRecord(link_id, record_num), sizeof(record));
+      BOOST_CHECK_EQUAL(record.trigger_id, expected.trigger_id);
+      BOOST_CHECK_EQUAL(record.chip_id, expected.chip_id);
+    }
+  }
+
+  BOOST_CHECK_THROW(reader.getRecord(0, num_records[0]), std::out_of_range);
+  BOOST_CHECK_THROW(RUEventLogReader(TEST_LOG_FILENAME, RU_LOG_FLUSH_EVENTS),
+                    std::runtime_error);
+
+  std::remove(TEST_LOG_FILENAME);
+}
+
+
+BOOST_AUTO_TEST_CASE( ru_event_log_truncated_test )
+{
+  const std::uint32_t chunk_records = 4;
+  const std::uint64_t num_records = 10;
+
+  // Chunks of 4, 4 and 2 records
+  {
+    RUEventLogWriter writer(TEST_LOG_FILENAME, RU_LOG_FATAL_EVENTS, 1,
+                            sizeof(RUTriggerEventRecord), chunk_records);
+
+    for(std::uint64_t record_num = 0; record_num < num_records; record_num++) {
+      RUTriggerEventRecord record = makeRecord(0, record_num);
+      writer.addRecord(0, &record);
+    }
+  }
+
+  BOOST_TEST_MESSAGE("Reading event log with incomplete last chunk.");
+  truncateFile(TEST_LOG_FILENAME, sizeof(RUTriggerEventRecord)/2);
+  {
+    RUEventLogReader reader(TEST_LOG_FILENAME, RU_LOG_FATAL_EVENTS);
+
+    BOOST_CHECK(reader.getTruncated());
+    BOOST_REQUIRE_EQUAL(reader.getNumRecords(0), 2*chunk_records);
+
+    RUTriggerEventRecord record;
+    std::memcpy(&record, reader.getRecord(0, 2*chunk_records-1), sizeof(record));
+    BOOST_CHECK_EQUAL(record.trigger_id, makeRecord(0, 2*chunk_records-1).trigger_id);
+  }
+
+  BOOST_TEST_MESSAGE("Reading event log with incomplete last chunk header.");
+  truncateFile(TEST_LOG_FILENAME,
+               2*sizeof(RUTriggerEventRecord) - sizeof(RUTriggerEventRecord)/2 +
+               sizeof(RUEventLogChunkHeader)/2);
+  {
+    RUEventLogReader reader(TEST_LOG_FILENAME, RU_LOG_FATAL_EVENTS);
+
+    BOOST_CHECK(reader.getTruncated());
+    BOOST_CHECK_EQUAL(reader.getNumRecords(0), 2*chunk_records);
+  }
+
+  std::remove(TEST_LOG_FILENAME);
+}
+
+
+///@brief Trigger actions decoded from the run-length encoded log. Consecutive records with
+///       the same actions are merged, the same way as ReadoutUnitStats::addTriggerActionRun()
+///       does it (ReadoutUnitStats depends on ROOT and is not built with the unit tests).
+struct DecodedTriggerActionRun {
+  std::uint64_t first_trigger_id;
+  std::vector<std::uint8_t> trig_actions;
+};
+
+
+BOOST_AUTO_TEST_CASE( ru_trigger_actions_rle_test )
+{
+  const char* rle_filename = "ru_event_log_test_rle.dat";
+  const std::uint32_t num_ctrl_links = 3;
+  const std::uint32_t flush_triggers = 5;
+  const std::uint64_t num_triggers = 200;
+
+  // Trigger actions for the uncompressed log, with long runs that are split by the encoder,
+  // and runs of a single trigger
+  std::vector<std::vector<std::uint8_t>> trig_actions(num_triggers);
+
+  for(std::uint64_t trigger_id = 0; trigger_id < num_triggers; trigger_id++) {
+    std::uint8_t action = (trigger_id < 120) ? (trigger_id / 40) % 2 : trigger_id % 3;
+    trig_actions[trigger_id].assign(num_ctrl_links, action);
+
+    // Some triggers differ only on one link
+    if(trigger_id % 17 == 0)
+      trig_actions[trigger_id][1] = 2;
+  }
+
+  BOOST_TEST_MESSAGE("Writing uncompressed and run-length encoded trigger actions logs.");
+  {
+    RUEventLogWriter writer(TEST_LOG_FILENAME, RU_LOG_TRIGGER_ACTIONS, num_ctrl_links,
+                            num_ctrl_links);
+    RUTriggerActionRunEncoder encoder(num_ctrl_links, flush_triggers);
+    RUEventLogWriter rle_writer(rle_filename, RU_LOG_TRIGGER_ACTIONS_RLE, num_ctrl_links,
+                                encoder.getRecordSize());
+
+    for(std::uint64_t trigger_id = 0; trigger_id < num_triggers; trigger_id++) {
+      writer.addRecord(RU_EVENT_LOG_ALL_LINKS, trig_actions[trigger_id].data());
+      encoder.addTrigger(trig_actions[trigger_id].data(), &rle_writer);
+
+      // The open run is written and the log flushed every flush_triggers triggers
+      if((trigger_id+1) % flush_triggers == 0) {
+        RUEventLogReader partial_reader(rle_filename, RU_LOG_TRIGGER_ACTIONS_RLE);
+        std::uint64_t triggers_on_disk = 0;
+
+        for(std::uint64_t i = 0; i < partial_reader.getNumRecords(0); i++) {
+          RUTriggerActionRunHeader run_header;
+          std::memcpy(&run_header, partial_reader.getRecord(0, i), sizeof(run_header));
+          triggers_on_disk += run_header.num_triggers;
+        }
+        BOOST_CHECK_EQUAL(triggers_on_disk, trigger_id+1);
+      }
+    }
+    encoder.writeRun(&rle_writer);
+  }
+
+  BOOST_TEST_MESSAGE("Decoding run-length encoded log and comparing with uncompressed log.");
+  RUEventLogReader reader(TEST_LOG_FILENAME, RU_LOG_TRIGGER_ACTIONS);
+  RUEventLogReader rle_reader(rle_filename, RU_LOG_TRIGGER_ACTIONS_RLE);
+
+  BOOST_REQUIRE_EQUAL(reader.getNumRecords(0), num_triggers);
+  BOOST_REQUIRE_EQUAL(rle_reader.getRecordSize(),
+                      sizeof(RUTriggerActionRunHeader) + num_ctrl_links);
+
+  std::vector<DecodedTriggerActionRun> runs;
+  std::uint64_t decoded_triggers = 0;
+  bool split_run_found = false;
+
+  for(std::uint64_t i = 0; i < rle_reader.getNumRecords(0); i++) {
+    const char* record = rle_reader.getRecord(0, i);
+    const std::uint8_t* actions =
+      reinterpret_cast<const std::uint8_t*>(record + sizeof(RUTriggerActionRunHeader));
+    RUTriggerActionRunHeader run_header;
+
+    std::memcpy(&run_header, record, sizeof(run_header));
+
+    BOOST_CHECK(run_header.num_triggers > 0);
+    BOOST_CHECK(run_header.num_triggers <= flush_triggers);
+
+    if(!runs.empty() &&
+       std::equal(actions, actions+num_ctrl_links, runs.back().trig_actions.begin())) {
+      split_run_found = true;
+    } else {
+      DecodedTriggerActionRun run;
+      run.first_trigger_id = decoded_triggers;
+      run.trig_actions.assign(actions, actions+num_ctrl_links);
+      runs.push_back(run);
+    }
+
+    decoded_triggers += run_header.num_triggers;
+  }
+
+  BOOST_CHECK(split_run_found);
+  BOOST_REQUIRE_EQUAL(decoded_triggers, num_triggers);
+
+  for(std::uint64_t trigger_id = 0; trigger_id < num_triggers; trigger_id++) {
+    // Find the run for the trigger, as in ReadoutUnitStats::getTriggerActionRun()
+    auto run_it = std::upper_bound(runs.begin(), runs.end(), trigger_id,
+                                   [](std::uint64_t id, const DecodedTriggerActionRun& run) {
+                                     return id < run.first_trigger_id;
+                                   });
+    --run_it;
+
+    const char* record = reader.getRecord(0, trigger_id);
+
+    BOOST_CHECK(std::equal(run_it->trig_actions.begin(), run_it->trig_actions.end(),
+                           reinterpret_cast<const std::uint8_t*>(record)));
+  }
+
+  std::remove(TEST_LOG_FILENAME);
+  std::remove(rle_filename);
+}